@@ -89,12 +89,289 @@ enum ECYErrorCode
     CYERR_CAPTURE_RUN_FAILED = 0x06,         // Capture Run Failed.
 };
 
+enum ECYAudioChannelLayout
+{
+    TYPE_CYAUDIO_LAYOUT_NATIVE = 0x00,          // Keep the device channels
+    TYPE_CYAUDIO_LAYOUT_MONO = 0x01,
+    TYPE_CYAUDIO_LAYOUT_STEREO = 0x02,
+    TYPE_CYAUDIO_LAYOUT_5POINT1 = 0x03,         // FL FR FC LFE SL SR
+    TYPE_CYAUDIO_LAYOUT_7POINT1 = 0x04,         // FL FR FC LFE BL BR SL SR
+    TYPE_CYAUDIO_LAYOUT_CUSTOM = 0x05,          // TAudioConfig custom matrix
+};
+
+enum ECYAudioSampleFormat
+{
+    TYPE_CYAUDIO_SAMPLE_F32 = 0x00,             // float in [-1, 1]
+    TYPE_CYAUDIO_SAMPLE_S16 = 0x01,
+    TYPE_CYAUDIO_SAMPLE_S32 = 0x02,
+};
+
+enum ECYAudioResampleQuality
+{
+    TYPE_CYAUDIO_RESAMPLE_LINEAR = 0x00,
+    TYPE_CYAUDIO_RESAMPLE_POLYPHASE = 0x01,     // windowed sinc filter bank, rational ratios only
+    TYPE_CYAUDIO_RESAMPLE_SINC_FASTEST = 0x02,  // libsamplerate
+    TYPE_CYAUDIO_RESAMPLE_SINC_MEDIUM = 0x03,   // libsamplerate
+};
+
+enum ECYAudioGateMode
+{
+    TYPE_CYAUDIO_GATE_OFF = 0x00,
+    TYPE_CYAUDIO_GATE_FLAG = 0x01,              // silent periods are delivered marked bSilent
+    TYPE_CYAUDIO_GATE_SKIP = 0x02,              // silent periods are not delivered
+};
+
+enum ECYAudioStageType
+{
+    TYPE_CYAUDIO_STAGE_BIQUAD = 0x00,           // cascaded biquad sections
+    TYPE_CYAUDIO_STAGE_DC_REMOVAL = 0x01,       // first order DC blocker
+    TYPE_CYAUDIO_STAGE_HIGHPASS = 0x02,         // Butterworth high-pass
+    TYPE_CYAUDIO_STAGE_AGC = 0x03,              // automatic gain control
+    TYPE_CYAUDIO_STAGE_CUSTOM = 0x04,           // ICYAudioStage
+};
+
+enum ECYThreadPolicy
+{
+    TYPE_CYTHREAD_POLICY_DEFAULT = 0x00,        // time sharing
+    TYPE_CYTHREAD_POLICY_FIFO = 0x01,           // real-time, runs until it blocks
+    TYPE_CYTHREAD_POLICY_RR = 0x02,             // real-time, time sliced among equal priorities
+};
+
+enum ECYAudioSource
+{
+    TYPE_CYAUDIO_SOURCE_DEVICE = 0x00,          // the named audio input device
+    TYPE_CYAUDIO_SOURCE_SYNTHETIC = 0x01,       // generated tone, no device, available on every platform
+};
+
 //////////////////////////////////////////////////////////////////////////
 struct TDeviceInfo
 {
     char szDeviceName[512];
     char szDeviceId[512];
 };
+
+//////////////////////////////////////////////////////////////////////////
+class CYDEVICE_API ICYAudioStage
+{
+public:
+    ICYAudioStage() {}
+    virtual ~ICYAudioStage() {}
+
+public:
+    /**
+     * @brief Process interleaved float frames in place, called from the thread that takes the periods.
+    */
+    virtual void Process(float* pBuffer, uint32_t nNumberAudioFrames, uint32_t nChannel, uint32_t nSampleRate) = 0;
+};
+
+constexpr uint32_t g_nMaxAudioStages = 8;
+constexpr uint32_t g_nMaxAudioBiquads = 8;
+
+// Normalized biquad section, y = b0 x + b1 x[-1] + b2 x[-2] - a1 y[-1] - a2 y[-2].
+struct TAudioBiquad
+{
+    float fB0 = 1.0f;
+    float fB1 = 0.0f;
+    float fB2 = 0.0f;
+    float fA1 = 0.0f;
+    float fA2 = 0.0f;
+};
+
+struct TAudioStage
+{
+    ECYAudioStageType eType = TYPE_CYAUDIO_STAGE_BIQUAD;
+
+    // BIQUAD, sections run in order on every channel.
+    uint32_t nBiquads = 0;
+    TAudioBiquad arrBiquads[g_nMaxAudioBiquads];
+
+    // DC_REMOVAL and HIGHPASS corner in Hz, 0 takes 10 Hz and 80 Hz. HIGHPASS order 1 to 16.
+    float fFrequency = 0.0f;
+    uint32_t nOrder = 2;
+
+    // AGC, moves the RMS of all channels towards fTargetDb (dBFS) by at most fMaxGainDb either way.
+    // Periods under fNoiseFloorDb hold the gain, so silence is not pulled up. The gain falls with
+    // the attack and rises with the release time constant.
+    float fTargetDb = -20.0f;
+    float fMaxGainDb = 20.0f;
+    float fNoiseFloorDb = -60.0f;
+    uint32_t nAttackUs = 20000;
+    uint32_t nReleaseUs = 1000000;
+
+    // CUSTOM
+    ICYAudioStage* pStage = nullptr;
+};
+
+//////////////////////////////////////////////////////////////////////////
+constexpr uint32_t g_nMaxAudioBatchPeriods = 16;
+
+struct TAudioConfig
+{
+    ECYAudioChannelLayout eChannelLayout = TYPE_CYAUDIO_LAYOUT_STEREO;
+
+    // Custom layout only, nCustomOutChannels rows of nCustomInChannels coefficients (row major),
+    // the matrix is copied at Init and falls back to stereo if the device channel count differs.
+    uint32_t nCustomInChannels = 0;
+    uint32_t nCustomOutChannels = 0;
+    const float* pCustomMatrix = nullptr;
+
+    // Linear capture gain, folded into the remix matrix so it costs nothing extra. The renderer
+    // monitor volume of Init is separate and does not affect the delivered audio.
+    float fGain = 1.0f;
+
+    // Delivery period in microseconds, 2500 (2.5 ms) to 100000 (100 ms). Periods that are not a whole
+    // number of frames alternate in length so the average rate stays exact.
+    uint32_t nPeriodUs = 10000;
+
+    // Delivery period in output frames instead, for consumers that work on fixed packets such as 960 frames
+    // (20 ms Opus at 48 kHz), 1024 (AAC) or 320 (20 ms at 16 kHz). Every period then holds exactly this
+    // many frames, within the same 2.5 ms to 100 ms. At the device rate the packets are read in place from
+    // the ring, resampled audio is collected until a packet is complete. 0 uses nPeriodUs.
+    uint32_t nPeriodFrames = 0;
+
+    // Delivered sample format. Planar periods hold one plane of nFrames samples per channel, back to
+    // back. Dither adds TPDF noise of one LSB before rounding to S16, it is off by default so S16 device
+    // audio comes out bit exact. S32 is never dithered because a float sample does not carry enough bits
+    // for it to matter.
+    ECYAudioSampleFormat eSampleFormat = TYPE_CYAUDIO_SAMPLE_F32;
+    bool bPlanar = false;
+    bool bDither = false;
+
+    // Resampler used when the device rate differs from the requested rate. Ratios the polyphase bank
+    // cannot cover (more than 1024 phases after reduction) fall back to SINC_FASTEST.
+    ECYAudioResampleQuality eResampleQuality = TYPE_CYAUDIO_RESAMPLE_POLYPHASE;
+
+    // Lock the delivered sample count to the host clock. The device clock drift is always measured and
+    // timestamps follow the host clock, with this set the resampler also absorbs the drift, so an hour of
+    // periods holds an hour of host time worth of frames. Needs a sinc tier, which is used even when the
+    // device rate already matches.
+    bool bDriftCompensation = false;
+
+    // Source timestamps further than this from the end of the previous packet are a gap, filled with
+    // silence up to half a second, or an overlap, which is trimmed. Both are concealed with a short fade
+    // so the periods stay continuous. 0 disables the check.
+    uint32_t nGapToleranceUs = 5000;
+
+    // Measure per channel peak, RMS and clipped samples of every delivered period. The levels are
+    // handed out with the period and can be polled with ICYDevice::GetAudioLevels from any thread.
+    bool bMetering = false;
+
+    // Energy gate for idle inputs. A period opens the gate when its loudest channel reaches fGateOpenDb
+    // RMS (dBFS), the gate closes once every channel stayed below fGateCloseDb for nGateHoldUs. OnAudioData
+    // is not called for silent periods, skipped ones are dropped before the output conversion. Timestamps
+    // keep following the device clock, so the next delivered period carries the time of the gap.
+    ECYAudioGateMode eGateMode = TYPE_CYAUDIO_GATE_OFF;
+    float fGateOpenDb = -45.0f;
+    float fGateCloseDb = -55.0f;
+    uint32_t nGateHoldUs = 300000;
+
+    // Jitter buffer for devices that deliver audio in bursts. The callback periods are released on the
+    // device clock, delayed by the latest arrival measured over the last seconds, between nJitterMinUs
+    // and nJitterMaxUs (at most half the ingest ring). The delay grows at once when a burst arrives later
+    // and shrinks slowly after. GetNextBuffer and ReadAudio consumers pace themselves and are not delayed.
+    bool bJitterBuffer = false;
+    uint32_t nJitterMinUs = 0;
+    uint32_t nJitterMaxUs = 250000;
+
+    // Periods handed to OnAudioPeriods in one call, at most g_nMaxAudioBatchPeriods. The delivery thread
+    // wakes once when the batch is complete, or when its first period has been held back nBatchLatencyUs,
+    // and delivers what is ready then, so a batch can be shorter. 0 or 1 calls OnAudioPeriod for every
+    // period, nBatchLatencyUs 0 waits for the whole batch with a period to spare for late device writes.
+    uint32_t nBatchPeriods = 0;
+    uint32_t nBatchLatencyUs = 0;
+
+    // Processing stages run in order on the float periods after the resampler, before the levels are
+    // taken and the output format is written. At most g_nMaxAudioStages, the array is copied by Init
+    // and can be replaced while capturing with ICYDevice::SetAudioStages.
+    const TAudioStage* pStages = nullptr;
+    uint32_t nStages = 0;
+
+    // Scheduling of the thread that calls OnAudioPeriod. FIFO and RR run it real-time at nThreadPriority,
+    // 1 to 99 on Linux, Windows raises it to the highest priority or to time critical from 50 on. Without
+    // CAP_SYS_NICE Linux falls back to the RLIMIT_RTPRIO limit, or to the default policy. nThreadCpuMask
+    // pins the thread to CPUs 0 to 63, nTimerSlackNs sets its Linux timer slack (0 keeps 50 us) and
+    // bLockMemory locks the process memory so the thread does not fault on paged out memory. What was
+    // granted and how late the thread wakes are reported by ICYDevice::GetAudioSchedulingStats.
+    ECYThreadPolicy eThreadPolicy = TYPE_CYTHREAD_POLICY_DEFAULT;
+    int32_t nThreadPriority = 0;
+    uint64_t nThreadCpuMask = 0;
+    uint32_t nTimerSlackNs = 0;
+    bool bLockMemory = false;
+};
+
+//////////////////////////////////////////////////////////////////////////
+constexpr uint32_t g_nMaxAudioLevelChannels = 32;
+
+struct TAudioChannelLevel
+{
+    float fPeak = 0.0f;                         // largest magnitude, 1.0 is full scale
+    float fRms = 0.0f;
+    uint32_t nClipCount = 0;                    // samples at or beyond full scale
+};
+
+struct TAudioLevels
+{
+    uint32_t nChannels = 0;                     // metered channels, at most g_nMaxAudioLevelChannels
+    uint32_t nFrames = 0;                       // frames of the metered period
+    uint64_t nTimeStamp = 0;                    // of the metered period
+    uint64_t nClipCount = 0;                    // clipped samples of all channels since the capture started
+    TAudioChannelLevel arrChannels[g_nMaxAudioLevelChannels];
+};
+
+//////////////////////////////////////////////////////////////////////////
+struct TAudioSchedulingStats
+{
+    // Scheduling the delivery thread was granted.
+    ECYThreadPolicy eThreadPolicy = TYPE_CYTHREAD_POLICY_DEFAULT;
+    int32_t nThreadPriority = 0;
+    bool bMemoryLocked = false;
+
+    // How late the delivery thread ran after a period was due, complete in the ring or at its jitter
+    // buffer release time, since the capture started. Only wake-ups after a wait are counted, late ones
+    // took longer than a period. The percentile is the upper edge of a power of two bucket.
+    uint64_t nWakeups = 0;
+    uint64_t nLateWakeups = 0;
+    uint32_t nMeanLatencyUs = 0;
+    uint32_t nP99LatencyUs = 0;
+    uint32_t nMaxLatencyUs = 0;
+};
+
+//////////////////////////////////////////////////////////////////////////
+struct TAudioPeriod
+{
+    const void* pData = nullptr;                // interleaved frames, or nChannels planes of nFrames samples
+    uint32_t nFrames = 0;
+    uint32_t nChannels = 0;
+    uint32_t nSampleRate = 0;
+    ECYAudioSampleFormat eSampleFormat = TYPE_CYAUDIO_SAMPLE_F32;
+    bool bPlanar = false;
+    uint64_t nTimeStamp = 0;                    // milliseconds of host clock since the first device frame
+    uint64_t nTimeStampUs = 0;                  // the same in microseconds, exact to the frame
+    uint64_t nFramePos = 0;                     // output frames since Init before this period, skipped ones included
+    double dClockDriftPpm = 0.0;                // device clock against the host clock, positive when fast
+
+    // Discontinuities concealed inside this period, and the totals of gaps, overlaps and overruns so far
+    // with the frames of silence inserted and of device audio dropped for them.
+    bool bDiscontinuity = false;
+    uint32_t nDiscontinuityCount = 0;
+    uint64_t nInsertedFrames = 0;
+    uint64_t nDroppedFrames = 0;
+
+    // Levels of this period when metering is on, nullptr otherwise.
+    const TAudioLevels* pLevels = nullptr;
+
+    // Gate state, bResume marks the first open period after silent ones and nGatedFrames counts the
+    // frames of the periods skipped right before it.
+    bool bSilent = false;
+    bool bResume = false;
+    uint64_t nGatedFrames = 0;
+
+    // Audio waiting in the ingest ring when the period was taken, this one included, and the delay the
+    // jitter buffer adds to it. Underruns count the periods that were not complete at their release time.
+    uint32_t nBufferedUs = 0;
+    uint32_t nJitterDelayUs = 0;
+    uint32_t nJitterUnderrunCount = 0;
+};
 //////////////////////////////////////////////////////////////////////////
 class CYDEVICE_API ICYAudioDataCallBack
 {
@@ -103,7 +380,94 @@ public:
     virtual ~ICYAudioDataCallBack() {}
 
 public:
-    virtual void OnAudioData(float* pBuffer, uint32_t nNumberAudioFrames, uint32_t nChannel, uint64_t nTimeStamps) = 0;
+    /**
+     * @brief Interleaved float periods, only called while the configured output format is F32 interleaved
+     * and not for periods the gate marks silent.
+    */
+    virtual void OnAudioData(float* /*pBuffer*/, uint32_t /*nNumberAudioFrames*/, uint32_t /*nChannel*/, uint64_t /*nTimeStamps*/) {}
+
+    /**
+     * @brief Every period in the configured output format, the data is only valid during the call.
+    */
+    virtual void OnAudioPeriod(const TAudioPeriod& objPeriod)
+    {
+        if (objPeriod.eSampleFormat == TYPE_CYAUDIO_SAMPLE_F32 && !objPeriod.bPlanar && !objPeriod.bSilent)
+            OnAudioData(static_cast<float*>(const_cast<void*>(objPeriod.pData)), objPeriod.nFrames, objPeriod.nChannels, objPeriod.nTimeStamp);
+    }
+
+    /**
+     * @brief Batched periods in stream order when TAudioConfig::nBatchPeriods is above 1, each with its own
+     * data and levels, all only valid during the call.
+    */
+    virtual void OnAudioPeriods(const TAudioPeriod* pPeriods, uint32_t nPeriods)
+    {
+        for (uint32_t i = 0; i < nPeriods; ++i)
+            OnAudioPeriod(pPeriods[i]);
+    }
+};
+
+//////////////////////////////////////////////////////////////////////////
+// An extra consumer of the captured audio. Every subscription gets its own rate, layout, sample format,
+// period, gain and gate from objConfig and its own delivery thread. The device audio is converted and
+// checked for gaps once for all of them.
+struct TAudioSubscription
+{
+    uint32_t nSampleRate = 0;                   // 0 keeps the device rate
+    TAudioConfig objConfig;
+    ICYAudioDataCallBack* pAudioDataCallBack = nullptr;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Several captured devices mixed into one feed, see ICYAudioMixer. Every input is resampled with drift
+// compensation onto the host clock, which is the master clock the mixer runs on.
+constexpr uint32_t g_nMaxAudioMixerInputs = 32;
+
+struct TAudioMixerConfig
+{
+    uint32_t nSampleRate = 48000;
+
+    // Mixed period in microseconds, 2500 to 100000, rounded to whole frames. The inputs deliver the
+    // same number of frames.
+    uint32_t nPeriodUs = 10000;
+
+    // MONO or STEREO, the mix is delivered as F32 interleaved periods.
+    ECYAudioChannelLayout eChannelLayout = TYPE_CYAUDIO_LAYOUT_STEREO;
+
+    // Resampler of the inputs, drift compensation needs a sinc tier so the others take SINC_FASTEST.
+    ECYAudioResampleQuality eResampleQuality = TYPE_CYAUDIO_RESAMPLE_SINC_FASTEST;
+
+    // Periods an input queues before it joins the mix, and again after an underrun. The queue is kept
+    // under nPrimePeriods + 2 by dropping the oldest period, which bounds the latency of each input.
+    uint32_t nPrimePeriods = 2;
+
+    // Scheduling of the mixing thread and of the input delivery threads, as in TAudioConfig.
+    ECYThreadPolicy eThreadPolicy = TYPE_CYTHREAD_POLICY_DEFAULT;
+    int32_t nThreadPriority = 0;
+    uint64_t nThreadCpuMask = 0;
+    uint32_t nTimerSlackNs = 0;
+};
+
+struct TAudioMixerInput
+{
+    float fGain = 1.0f;                         // linear
+    float fPan = 0.0f;                          // -1 left to 1 right, stereo mix only
+    bool bMute = false;
+
+    // Keep the stereo image of the device, the pan then works as balance. Otherwise the device is mixed
+    // down to mono and panned with a -3 dB constant power law. Fixed when the input is added.
+    bool bStereo = false;
+};
+
+struct TAudioMixerInputStats
+{
+    // Audio of the input waiting to be mixed, in its queue and in its subscription.
+    uint32_t nLatencyUs = 0;
+    uint32_t nQueuedPeriods = 0;
+    double dClockDriftPpm = 0.0;                // device clock against the host clock, absorbed by the resampler
+
+    uint64_t nMixedPeriods = 0;
+    uint64_t nUnderrunCount = 0;                // mixed periods the input had no audio for
+    uint64_t nDroppedPeriods = 0;               // input periods dropped to bound the queue
 };
 
 class CYDEVICE_API ICYVideoDataCallBack
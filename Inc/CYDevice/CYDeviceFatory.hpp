@@ -44,6 +44,7 @@
 #define __CYDEVICE_FACTORY_HPP__
 
 #include "CYDevice/ICYDevice.hpp"
+#include "CYDevice/ICYAudioMixer.hpp"
 
 CYDEVICE_NAMESPACE_BEGIN
 
@@ -56,6 +57,9 @@ public:
 public:
     static ICYDevice* CreateDevice();
     static void DestroyDevice(ICYDevice*& pDevice);
+
+    static ICYAudioMixer* CreateAudioMixer();
+    static void DestroyAudioMixer(ICYAudioMixer*& pMixer);
 };
 
 CYDEVICE_NAMESPACE_END
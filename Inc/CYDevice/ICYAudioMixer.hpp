@@ -0,0 +1,97 @@
+/*
+* CYDevice License
+* -----------
+*
+* CYDevice is licensed under the terms of the MIT license reproduced below.
+* This means that CYDevice is free software and can be used for both academic
+* and commercial purposes at absolutely no cost.
+*
+*
+* ===============================================================================
+*
+* Copyright (C) 2023-2024 ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*
+* ===============================================================================
+*/
+/*
+* AUTHORS:  ShiLiang.Hao <newhaosl@163.com>, foobra<vipgs99@gmail.com>
+* VERSION:  1.0.0
+* PURPOSE:  A cross platform audio and video collection library.
+* CREATION: 2025.04.08
+* LCHANGE:  2025.04.08
+* LICENSE:  Expat/MIT License, See Copyright Notice at the begin of this file.
+*/
+
+#ifndef __I_CYAUDIO_MIXER_HPP__
+#define __I_CYAUDIO_MIXER_HPP__
+
+#include <stdint.h>
+#include "CYDevice/ICYDevice.hpp"
+
+CYDEVICE_NAMESPACE_BEGIN
+
+class CYDEVICE_API ICYAudioMixer
+{
+public:
+    ICYAudioMixer()
+    {
+    }
+    virtual ~ICYAudioMixer()
+    {
+    }
+
+public:
+    /**
+     * @brief Initialization and de-initialization of the mixer, UnInit removes every input.
+    */
+    virtual int16_t Init(const TAudioMixerConfig& objConfig) = 0;
+    virtual int16_t UnInit() = 0;
+
+    /**
+     * @brief Mix the audio of an initialized device through a subscription of that device, at most
+     * g_nMaxAudioMixerInputs. The device is started and stopped by its owner and contributes while it
+     * captures, it must stay valid until RemoveInput or UnInit.
+    */
+    virtual int16_t AddInput(ICYDevice* pDevice, const TAudioMixerInput& objInput, uint32_t& nInputId) = 0;
+    virtual int16_t RemoveInput(uint32_t nInputId) = 0;
+
+    /**
+     * @brief Change the gain, pan and mute of an input, ramped over the next mixed period.
+    */
+    virtual int16_t SetInput(uint32_t nInputId, const TAudioMixerInput& objInput) = 0;
+
+    /**
+     * @brief Start mixing, the callback gets every mixed period from the mixing thread.
+    */
+    virtual int16_t Start(ICYAudioDataCallBack* pAudioDataCallBack) = 0;
+    virtual int16_t Stop() = 0;
+
+    /**
+     * @brief Latency, drift and queue statistics of an input, and how late the mixing thread woke,
+     * callable from any thread.
+    */
+    virtual int16_t GetInputStats(uint32_t nInputId, TAudioMixerInputStats& objStats) = 0;
+    virtual int16_t GetSchedulingStats(TAudioSchedulingStats& objStats) = 0;
+};
+
+CYDEVICE_NAMESPACE_END
+
+#endif //__I_CYAUDIO_MIXER_HPP__
\ No newline at end of file
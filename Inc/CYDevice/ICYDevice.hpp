@@ -61,10 +61,18 @@ public:
 public:
     /**
      * @brief Initialization and de-initialization of cry device.
+     * pAudioConfig selects the delivered audio layout, nullptr delivers stereo.
     */
-    virtual int16_t Init(int nWidth/* = 1024*/, int nHeight/* = 768*/, int nFPS/* = 25*/, const wchar_t* pszDeviceName, const wchar_t* pszDeviceId, int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, bool bUseRender = true) = 0;
+    virtual int16_t Init(int nWidth/* = 1024*/, int nHeight/* = 768*/, int nFPS/* = 25*/, const wchar_t* pszDeviceName, const wchar_t* pszDeviceId, int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, bool bUseRender = true, const TAudioConfig* pAudioConfig = nullptr) = 0;
     virtual int16_t UnInit() = 0;
 
+    /**
+     * @brief Initialize an audio only session, instead of Init. No video device is opened and no video
+     * buffers or threads are created, the video callback of StartCapture is ignored. The synthetic
+     * source ignores the device name and id and delivers a 1 kHz tone at -20 dBFS.
+    */
+    virtual int16_t InitAudio(ECYAudioSource eSource, int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, const TAudioConfig* pAudioConfig = nullptr) = 0;
+
     /**
      * @brief Start Capture.
     */
@@ -72,9 +80,44 @@ public:
     virtual int16_t StopCapture() = 0;
 
     /**
-     * @brief Get Audio Data.
+     * @brief Get Audio Data, only available while the configured output format is F32 interleaved.
     */
     virtual int16_t GetNextAudioBuffer(float*& pBuffer, uint32_t& nNumFrames, uint64_t& nTimestamp) = 0;
+
+    /**
+     * @brief Read up to nNumFrames frames of the configured output format into pBuffer, planar output is
+     * written as planes of nNumFrames samples. Waits up to nTimeoutMs for the frames, 0 does not wait,
+     * and returns the frames read so far when the wait times out. nTimestamp is the time of the first
+     * frame read. Only available while capturing without an audio callback, not to be mixed with
+     * GetNextAudioBuffer.
+    */
+    virtual int16_t ReadAudio(void* pBuffer, uint32_t nNumFrames, uint32_t nTimeoutMs, uint32_t& nReadFrames, uint64_t& nTimestamp) = 0;
+
+    /**
+     * @brief Levels of the last delivered period, lock free and callable from any thread. Fails unless
+     * the audio config enables metering and a period has been delivered.
+    */
+    virtual int16_t GetAudioLevels(TAudioLevels& objLevels) = 0;
+
+    /**
+     * @brief Scheduling the audio delivery thread was granted and how late it woke for the periods of
+     * the running capture, callable from any thread. Only counted while delivering to a callback.
+    */
+    virtual int16_t GetAudioSchedulingStats(TAudioSchedulingStats& objStats) = 0;
+
+    /**
+     * @brief Replace the audio processing stages after Init, before or during capture. The stages are
+     * copied, the next period crossfades from the old chain to the new one, nullptr or 0 stages remove
+     * them. Custom stages must stay valid until they are replaced or UnInit.
+    */
+    virtual int16_t SetAudioStages(const TAudioStage* pStages, uint32_t nStages) = 0;
+
+    /**
+     * @brief Attach another audio consumer after Init, before or during capture. The callback is called
+     * from its own thread until UnsubscribeAudio or UnInit.
+    */
+    virtual int16_t SubscribeAudio(const TAudioSubscription& objSubscription, uint32_t& nSubscriptionId) = 0;
+    virtual int16_t UnsubscribeAudio(uint32_t nSubscriptionId) = 0;
 };
 
 CYDEVICE_NAMESPACE_END
@@ -0,0 +1,112 @@
+#include "Audio/CYAudioClock.hpp"
+#include "Common/CYDevicePrivDefine.hpp"
+
+#include <math.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+CYAudioClock::CYAudioClock()
+{
+}
+
+CYAudioClock::~CYAudioClock()
+{
+}
+
+void CYAudioClock::Init(uint32_t nSampleRate)
+{
+    m_nSampleRate = nSampleRate;
+    m_dNominalPeriod = nSampleRate ? 1.0 / nSampleRate : 0.0;
+    m_dMinPeriod = m_dNominalPeriod / (1.0 + g_dMaxClockDriftPpm * 1e-6);
+    m_dMaxPeriod = m_dNominalPeriod / (1.0 - g_dMaxClockDriftPpm * 1e-6);
+    m_nResyncCount = 0;
+    m_dResyncError = 0.0;
+    Reset();
+}
+
+void CYAudioClock::Reset()
+{
+    m_bValid = false;
+    m_nFramePos = 0;
+    m_dTime = 0.0;
+    m_dPeriod = m_dNominalPeriod;
+    m_dLockTime = 0.0;
+}
+
+void CYAudioClock::Restart(uint64_t nFramePos, int64_t nHostUs)
+{
+    // the first write is taken as it is, the loop pulls the phase in from there.
+    m_bValid = true;
+    m_nOriginUs = nHostUs;
+    m_nFramePos = nFramePos;
+    m_dTime = 0.0;
+    m_dPeriod = m_dNominalPeriod;
+    m_dLockTime = 0.0;
+}
+
+void CYAudioClock::Update(uint64_t nFramePos, int64_t nHostUs)
+{
+    if (!m_nSampleRate)
+        return;
+
+    if (!m_bValid || nFramePos < m_nFramePos)
+    {
+        Restart(nFramePos, nHostUs);
+        return;
+    }
+
+    const uint64_t nFrames = nFramePos - m_nFramePos;
+    if (!nFrames)
+        return;
+
+    const double dPredict = m_dTime + double(nFrames) * m_dPeriod;
+    const double dError = double(nHostUs - m_nOriginUs) * 1e-6 - dPredict;
+    if (fabs(dError) > g_dClockResyncSeconds)
+    {
+        // called on the capture thread, the owner logs the count later.
+        ++m_nResyncCount;
+        m_dResyncError = dError;
+        Restart(nFramePos, nHostUs);
+        return;
+    }
+
+    // bandwidth narrows geometrically from lock to tracking, omega is per update so uneven writes are fine.
+    const double dNarrow = MIN(m_dLockTime / g_dClockLockSeconds, 1.0);
+    const double dBandwidth = g_dClockLockBandwidth * pow(g_dClockTrackBandwidth / g_dClockLockBandwidth, dNarrow);
+    const double dPi = 3.14159265358979323846;
+    const double dOmega = MIN(2.0 * dPi * dBandwidth * double(nFrames) * m_dPeriod, 0.5);
+
+    m_dTime = dPredict + 1.41421356237309504880 * dOmega * dError;
+    m_dPeriod += dOmega * dOmega * dError / double(nFrames);
+    m_dPeriod = MIN(MAX(m_dPeriod, m_dMinPeriod), m_dMaxPeriod);
+
+    m_nFramePos = nFramePos;
+    m_dLockTime += double(nFrames) * m_dPeriod;
+
+    // keep the relative times small so the doubles stay exact over long captures.
+    if (m_dTime > 3600.0)
+    {
+        const int64_t nShiftUs = int64_t(m_dTime * 1e6);
+        m_nOriginUs += nShiftUs;
+        m_dTime -= double(nShiftUs) * 1e-6;
+    }
+}
+
+void CYAudioClock::Skip(uint64_t nFrames)
+{
+    if (m_bValid)
+        m_dTime += double(nFrames) * m_dPeriod;
+}
+
+int64_t CYAudioClock::GetFrameTimeUs(uint64_t nFramePos) const
+{
+    const double dOffset = (nFramePos >= m_nFramePos) ? double(nFramePos - m_nFramePos) : -double(m_nFramePos - nFramePos);
+    return m_nOriginUs + int64_t(llround((m_dTime + dOffset * m_dPeriod) * 1e6));
+}
+
+double CYAudioClock::GetDriftPpm() const
+{
+    return m_bValid ? (m_dNominalPeriod / m_dPeriod - 1.0) * 1e6 : 0.0;
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
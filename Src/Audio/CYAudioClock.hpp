@@ -0,0 +1,111 @@
+#ifndef __CY_AUDIO_CLOCK_HPP__
+#define __CY_AUDIO_CLOCK_HPP__
+
+#include "Audio/CYAudioDefine.hpp"
+
+#include <chrono>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Clock loop tuning. The loop starts wide to lock within a few writes and narrows to the tracking
+ * bandwidth over g_dClockLockSeconds, an error above g_dClockResyncSeconds restarts it.
+ */
+constexpr double g_dClockLockBandwidth = 0.5;           // Hz
+constexpr double g_dClockTrackBandwidth = 0.01;         // Hz
+constexpr double g_dClockLockSeconds = 10.0;
+constexpr double g_dClockResyncSeconds = 0.25;
+constexpr double g_dMaxClockDriftPpm = 1000.0;
+
+/**
+ * Drift compensation pulls the delivered frames back onto the host clock by g_dClockPhaseGain of the
+ * phase error per second, never faster than g_dMaxClockPhaseAdjust.
+ */
+constexpr double g_dClockPhaseGain = 0.1;
+constexpr double g_dMaxClockPhaseAdjust = 0.0005;
+
+/**
+ * Monotonic host clock in microseconds, the reference the device clock is measured against.
+ */
+inline int64_t GetHostTimeUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Second order delay locked loop between the device sample clock and the host clock.
+ *
+ * Every write reports the frame position reached and the host time it arrived at. The loop filters
+ * the delivery jitter out of those pairs and keeps a smoothed host time for the last position and
+ * the host duration of one device frame, which gives the host time of any nearby frame and the
+ * drift of the device clock. Not thread safe.
+ */
+class CYAudioClock
+{
+public:
+    CYAudioClock();
+    ~CYAudioClock();
+
+public:
+    void Init(uint32_t nSampleRate);
+    void Reset();
+
+    /**
+     * @brief The stream reached nFramePos at host time nHostUs.
+    */
+    void Update(uint64_t nFramePos, int64_t nHostUs);
+
+    /**
+     * @brief nFrames device frames passed without entering the stream (dropped on overrun).
+    */
+    void Skip(uint64_t nFrames);
+
+    /**
+     * @brief Host time of stream frame nFramePos, only meaningful once IsValid.
+    */
+    int64_t GetFrameTimeUs(uint64_t nFramePos) const;
+
+    bool IsValid() const { return m_bValid; }
+    bool IsLocked() const { return m_bValid && m_dLockTime >= g_dClockLockSeconds; }
+
+    /**
+     * @brief Device clock against the host clock in parts per million, positive when the device runs fast.
+    */
+    double GetDriftPpm() const;
+
+    /**
+     * @brief Host duration of one device frame in nominal frames, the ratio correction for the drift.
+    */
+    double GetRateRatio() const { return m_dPeriod / m_dNominalPeriod; }
+
+    uint64_t GetResyncCount() const { return m_nResyncCount; }
+
+    /**
+     * @brief How far off the host clock the loop was at the last resync, in seconds.
+    */
+    double GetResyncError() const { return m_dResyncError; }
+
+private:
+    void Restart(uint64_t nFramePos, int64_t nHostUs);
+
+private:
+    uint32_t m_nSampleRate = 0;
+    double m_dNominalPeriod = 0.0;
+    double m_dMinPeriod = 0.0;
+    double m_dMaxPeriod = 0.0;
+
+    // Loop state in seconds relative to m_nOriginUs.
+    bool m_bValid = false;
+    int64_t m_nOriginUs = 0;
+    uint64_t m_nFramePos = 0;
+    double m_dTime = 0.0;                       // smoothed host time of m_nFramePos
+    double m_dPeriod = 0.0;                     // host seconds per device frame
+    double m_dLockTime = 0.0;                   // seconds since the loop (re)started
+
+    uint64_t m_nResyncCount = 0;
+    double m_dResyncError = 0.0;
+};
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_AUDIO_CLOCK_HPP__
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "Audio/CYAudioConvert.hpp"
+#include "Audio/Simd/CYAudioKernels.hpp"
+
+#include <string.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+uint32_t GetPcmBytesPerSample(ECYPcmFormat eFormat)
+{
+    switch (eFormat)
+    {
+    case TYPE_PCM_S8:
+        return 1;
+    case TYPE_PCM_S16:
+        return 2;
+    case TYPE_PCM_S24:
+        return 3;
+    case TYPE_PCM_S32:
+    case TYPE_PCM_F32:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+bool ConvertToFloat(ECYPcmFormat eFormat, const void* pSrc, float* pDst, size_t nSamples)
+{
+    const TAudioKernels& objKernels = GetAudioKernels();
+
+    switch (eFormat)
+    {
+    case TYPE_PCM_S8:
+        objKernels.pfnS8ToFloat(pSrc, pDst, nSamples);
+        return true;
+    case TYPE_PCM_S16:
+        objKernels.pfnS16ToFloat(pSrc, pDst, nSamples);
+        return true;
+    case TYPE_PCM_S24:
+        objKernels.pfnS24ToFloat(pSrc, pDst, nSamples);
+        return true;
+    case TYPE_PCM_S32:
+        objKernels.pfnS32ToFloat(pSrc, pDst, nSamples);
+        return true;
+    case TYPE_PCM_F32:
+        memcpy(pDst, pSrc, nSamples * sizeof(float));
+        return true;
+    default:
+        return false;
+    }
+}
+
+uint32_t GetSampleFormatBytes(ECYAudioSampleFormat eFormat)
+{
+    return (eFormat == TYPE_CYAUDIO_SAMPLE_S16) ? 2 : 4;
+}
+
+ECYPcmFormat GetPassthroughPcmFormat(ECYAudioSampleFormat eFormat)
+{
+    switch (eFormat)
+    {
+    case TYPE_CYAUDIO_SAMPLE_F32:
+        return TYPE_PCM_F32;
+    case TYPE_CYAUDIO_SAMPLE_S16:
+        return TYPE_PCM_S16;
+    case TYPE_CYAUDIO_SAMPLE_S32:
+        return TYPE_PCM_S32;
+    default:
+        return TYPE_PCM_UNKNOWN;
+    }
+}
+
+void InitDitherState(TDitherState& objState, uint32_t nSeed)
+{
+    // spread the seed over the lanes with an LCG step per lane.
+    uint32_t nValue = nSeed ? nSeed : 0x9E3779B9u;
+    for (uint32_t i = 0; i < g_nDitherLanes; ++i)
+    {
+        nValue = nValue * 1664525u + 1013904223u;
+        objState.arrState[i] = nValue ? nValue : 1;
+    }
+}
+
+bool ConvertFromFloat(ECYAudioSampleFormat eFormat, bool bPlanar, const float* pSrc, uint32_t nChannels, size_t nFrames, void* pDst, TDitherState* pDither, size_t nPlaneStride)
+{
+    const TAudioKernels& objKernels = GetAudioKernels();
+
+    PFN_FloatToPcm pfnConvert = nullptr;
+    switch (eFormat)
+    {
+    case TYPE_CYAUDIO_SAMPLE_F32:
+        pfnConvert = objKernels.pfnFloatToF32;
+        break;
+    case TYPE_CYAUDIO_SAMPLE_S16:
+        pfnConvert = objKernels.pfnFloatToS16;
+        break;
+    case TYPE_CYAUDIO_SAMPLE_S32:
+        pfnConvert = objKernels.pfnFloatToS32;
+        break;
+    default:
+        return false;
+    }
+
+    if (!bPlanar || nChannels == 1)
+    {
+        if (eFormat == TYPE_CYAUDIO_SAMPLE_F32)
+            memcpy(pDst, pSrc, nFrames * nChannels * sizeof(float));
+        else
+            pfnConvert(pSrc, 1, pDst, nFrames * nChannels, pDither);
+        return true;
+    }
+
+    // one strided pass per channel writes the planes straight from the interleaved frames.
+    uint8_t* pPlane = static_cast<uint8_t*>(pDst);
+    const size_t nPlaneBytes = (nPlaneStride ? nPlaneStride : nFrames) * GetSampleFormatBytes(eFormat);
+    for (uint32_t nChannel = 0; nChannel < nChannels; ++nChannel, pPlane += nPlaneBytes)
+        pfnConvert(pSrc + nChannel, nChannels, pPlane, nFrames, pDither);
+
+    return true;
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef __CY_AUDIO_CONVERT_HPP__
+#define __CY_AUDIO_CONVERT_HPP__
+
+#include "Audio/CYAudioDefine.hpp"
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Bytes per sample of a device PCM format, 0 for unknown formats.
+ */
+uint32_t GetPcmBytesPerSample(ECYPcmFormat eFormat);
+
+/**
+ * Convert interleaved device PCM to float in [-1, 1] with the dispatched SIMD kernels.
+ * nSamples counts samples of all channels, source and destination must not overlap.
+ */
+bool ConvertToFloat(ECYPcmFormat eFormat, const void* pSrc, float* pDst, size_t nSamples);
+
+/**
+ * Bytes per sample of an output format.
+ */
+uint32_t GetSampleFormatBytes(ECYAudioSampleFormat eFormat);
+
+/**
+ * The device format an output format can be passed through from, TYPE_PCM_UNKNOWN if none.
+ */
+ECYPcmFormat GetPassthroughPcmFormat(ECYAudioSampleFormat eFormat);
+
+/**
+ * Seed every dither lane, a zero seed is replaced because xorshift never leaves zero.
+ */
+void InitDitherState(TDitherState& objState, uint32_t nSeed);
+
+/**
+ * Write interleaved float frames in an output format, interleaved or as nChannels planes that start
+ * nPlaneStride samples apart (0 packs them at nFrames). pDither nullptr disables the dither, source
+ * and destination must not overlap.
+ */
+bool ConvertFromFloat(ECYAudioSampleFormat eFormat, bool bPlanar, const float* pSrc, uint32_t nChannels, size_t nFrames, void* pDst, TDitherState* pDither, size_t nPlaneStride = 0);
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_AUDIO_CONVERT_HPP__
\ No newline at end of file
@@ -0,0 +1,182 @@
+#ifndef __CY_AUDIO_DEFINE_HPP__
+#define __CY_AUDIO_DEFINE_HPP__
+
+#include "CYDevice/CYDeviceDefine.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Cache line size used to pad data shared between the capture and delivery threads.
+ */
+constexpr size_t g_nCacheLineSize = 64;
+
+/**
+ * Seconds of device audio the ingest ring can hold before it overruns.
+ */
+constexpr uint32_t g_nAudioRingSeconds = 1;
+
+/**
+ * Delivery period limits in microseconds, the ring always holds at least g_nAudioRingPeriods periods.
+ */
+constexpr uint32_t g_nMinAudioPeriodUs = 2500;
+constexpr uint32_t g_nMaxAudioPeriodUs = 100000;
+constexpr uint32_t g_nDefaultAudioPeriodUs = 10000;
+constexpr uint32_t g_nAudioRingPeriods = 4;
+
+/**
+ * Discontinuity concealment. Gaps in the source timestamps are filled with silence up to
+ * g_nMaxAudioGapFillUs, every splice is faded over g_nAudioSpliceFadeUs, and at most
+ * g_nMaxAudioSplices splices wait for the consumer at a time.
+ */
+constexpr uint32_t g_nAudioSpliceFadeUs = 2000;
+constexpr uint32_t g_nMaxAudioGapFillUs = 500000;
+constexpr uint32_t g_nMaxAudioSplices = 16;
+
+/**
+ * Point in the stream where the source audio is not continuous. nGapFrames of silence follow
+ * nFramePos, the source audio resumes behind them.
+ */
+struct TAudioSplice
+{
+    uint64_t nFramePos = 0;
+    uint64_t nGapFrames = 0;
+};
+
+/**
+ * Device PCM sample formats, S24 is packed little endian (3 bytes per sample).
+ */
+enum ECYPcmFormat
+{
+    TYPE_PCM_UNKNOWN = 0x00,
+    TYPE_PCM_S8,
+    TYPE_PCM_S16,
+    TYPE_PCM_S24,
+    TYPE_PCM_S32,
+    TYPE_PCM_F32,
+};
+
+/**
+ * Map a wave format description to a PCM format.
+ */
+inline ECYPcmFormat GetPcmFormat(uint32_t nBitsPerSample, bool bFloat)
+{
+    if (bFloat)
+        return (nBitsPerSample == 32) ? TYPE_PCM_F32 : TYPE_PCM_UNKNOWN;
+
+    switch (nBitsPerSample)
+    {
+    case 8:
+        return TYPE_PCM_S8;
+    case 16:
+        return TYPE_PCM_S16;
+    case 24:
+        return TYPE_PCM_S24;
+    case 32:
+        return TYPE_PCM_S32;
+    default:
+        return TYPE_PCM_UNKNOWN;
+    }
+}
+
+/**
+ * Device audio format fed into the pipeline.
+ */
+struct TAudioSourceFormat
+{
+    ECYPcmFormat ePcmFormat = TYPE_PCM_UNKNOWN;
+    uint32_t nChannels = 0;
+    uint32_t nChannelMask = 0;                  // 0 uses the default mask for the channel count
+    uint32_t nSampleRate = 0;
+    uint32_t nBlockAlign = 0;
+};
+
+/**
+ * Speaker positions, the bits match the WAVEFORMATEXTENSIBLE channel mask.
+ */
+enum ECYSpeakerPosition
+{
+    TYPE_SPEAKER_FRONT_LEFT = 0x1,
+    TYPE_SPEAKER_FRONT_RIGHT = 0x2,
+    TYPE_SPEAKER_FRONT_CENTER = 0x4,
+    TYPE_SPEAKER_LOW_FREQUENCY = 0x8,
+    TYPE_SPEAKER_BACK_LEFT = 0x10,
+    TYPE_SPEAKER_BACK_RIGHT = 0x20,
+    TYPE_SPEAKER_FRONT_LEFT_OF_CENTER = 0x40,
+    TYPE_SPEAKER_FRONT_RIGHT_OF_CENTER = 0x80,
+    TYPE_SPEAKER_BACK_CENTER = 0x100,
+    TYPE_SPEAKER_SIDE_LEFT = 0x200,
+    TYPE_SPEAKER_SIDE_RIGHT = 0x400,
+    TYPE_SPEAKER_TOP_CENTER = 0x800,
+    TYPE_SPEAKER_TOP_FRONT_LEFT = 0x1000,
+    TYPE_SPEAKER_TOP_FRONT_CENTER = 0x2000,
+    TYPE_SPEAKER_TOP_FRONT_RIGHT = 0x4000,
+    TYPE_SPEAKER_TOP_BACK_LEFT = 0x8000,
+    TYPE_SPEAKER_TOP_BACK_CENTER = 0x10000,
+    TYPE_SPEAKER_TOP_BACK_RIGHT = 0x20000,
+};
+
+/**
+ * Number of speaker position bits.
+ */
+constexpr uint32_t g_nSpeakerPositions = 18;
+
+/**
+ * Largest channel count a remix matrix handles on either side.
+ */
+constexpr uint32_t g_nMaxRemixChannels = 32;
+
+/**
+ * Output side of a remix plan, picks the fused kernel that runs it. SCALE applies one gain to every
+ * sample and keeps the layout.
+ */
+enum ECYRemixShape
+{
+    TYPE_REMIX_SCALE = 0x00,
+    TYPE_REMIX_MONO,
+    TYPE_REMIX_STEREO,
+    TYPE_REMIX_ANY,
+};
+
+/**
+ * Remix matrix reduced to the input channels that contribute to the output.
+ */
+struct TRemixPlan
+{
+    ECYRemixShape eShape = TYPE_REMIX_ANY;
+    uint32_t nInChannels = 0;                                       // interleaved input stride
+    uint32_t nOutChannels = 0;
+    uint32_t nUsedChannels = 0;
+    float    fScale = 1.0f;                                         // gain of a SCALE plan
+    uint32_t arrUsedChannels[g_nMaxRemixChannels] = {};             // input channel of every used column
+    float    arrCoeffs[g_nMaxRemixChannels * g_nMaxRemixChannels] = {};   // [out * g_nMaxRemixChannels + used]
+};
+
+/**
+ * Widest SIMD vector in 32 bit lanes, every lane runs its own dither generator.
+ */
+constexpr uint32_t g_nDitherLanes = 16;
+
+/**
+ * xorshift32 generator state for TPDF dither, no lane may be zero.
+ */
+struct TDitherState
+{
+    uint32_t arrState[g_nDitherLanes] = {};
+};
+
+/**
+ * Level sums of one period, the metering kernels add to them so a caller starts from zero.
+ */
+struct TAudioMeter
+{
+    float arrPeak[g_nMaxAudioLevelChannels] = {};
+    float arrSquares[g_nMaxAudioLevelChannels] = {};
+    uint32_t arrClips[g_nMaxAudioLevelChannels] = {};
+};
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_AUDIO_DEFINE_HPP__
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include "Audio/CYAudioFanout.hpp"
+#include "Common/CYDevicePrivDefine.hpp"
+
+CYDEVICE_NAMESPACE_BEGIN
+
+CYAudioFanout::CYAudioFanout()
+{
+}
+
+CYAudioFanout::~CYAudioFanout()
+{
+    UnInit();
+}
+
+bool CYAudioFanout::Init(const TAudioSourceFormat& objFormat, const TAudioConfig& objConfig)
+{
+    UnInit();
+
+    TAudioConfig objFrontConfig;
+    objFrontConfig.eChannelLayout = TYPE_CYAUDIO_LAYOUT_NATIVE;
+    objFrontConfig.eSampleFormat = TYPE_CYAUDIO_SAMPLE_F32;
+    objFrontConfig.bDither = false;
+    objFrontConfig.nPeriodUs = g_nAudioFanoutPeriodUs;
+    objFrontConfig.nGapToleranceUs = objConfig.nGapToleranceUs;
+    objFrontConfig.eThreadPolicy = objConfig.eThreadPolicy;
+    objFrontConfig.nThreadPriority = objConfig.nThreadPriority;
+    objFrontConfig.nThreadCpuMask = objConfig.nThreadCpuMask;
+    objFrontConfig.nTimerSlackNs = objConfig.nTimerSlackNs;
+    if (!m_frontPipeline.Init(objFormat, 0, objFrontConfig))
+        return false;
+
+    m_objFormat = objFormat;
+    m_bInit = true;
+    return true;
+}
+
+void CYAudioFanout::UnInit()
+{
+    Stop();
+
+    std::vector<TSubscriber> vecSubscribers;
+    {
+        UniqueLock locker(m_subscriberMutex);
+        vecSubscribers.swap(m_vecSubscribers);
+        m_nSubscribers = 0;
+    }
+    for (TSubscriber& objSubscriber : vecSubscribers)
+        objSubscriber.ptrPipeline->Stop();
+
+    m_frontPipeline.UnInit();
+    m_bInit = false;
+}
+
+bool CYAudioFanout::Start()
+{
+    if (!m_bInit)
+        return false;
+
+    UniqueLock locker(m_subscriberMutex);
+    if (m_bRunning)
+        return false;
+
+    for (TSubscriber& objSubscriber : m_vecSubscribers)
+        objSubscriber.ptrPipeline->Start(objSubscriber.pAudioDataCallBack);
+    m_bRunning = true;
+    return m_frontPipeline.Start(this);
+}
+
+void CYAudioFanout::Stop()
+{
+    // the front thread is joined first, it must not feed a subscription that is already stopped.
+    m_frontPipeline.Stop();
+
+    UniqueLock locker(m_subscriberMutex);
+    for (TSubscriber& objSubscriber : m_vecSubscribers)
+        objSubscriber.ptrPipeline->Stop();
+    m_bRunning = false;
+}
+
+void CYAudioFanout::Write(const void* pData, size_t nBytes, int64_t nHostUs, int64_t nStreamUs)
+{
+    if (m_nSubscribers.load(std::memory_order_relaxed))
+        m_frontPipeline.Write(pData, nBytes, nHostUs, nStreamUs);
+}
+
+void CYAudioFanout::Flush()
+{
+    m_frontPipeline.Flush();
+}
+
+bool CYAudioFanout::Subscribe(const TAudioSubscription& objSubscription, uint32_t& nSubscriptionId)
+{
+    if (!m_bInit || !objSubscription.pAudioDataCallBack)
+        return false;
+
+    // the front stage already concealed the gaps, the subscription sees a continuous float stream.
+    TAudioSourceFormat objFormat;
+    objFormat.ePcmFormat = TYPE_PCM_F32;
+    objFormat.nChannels = m_objFormat.nChannels;
+    objFormat.nChannelMask = m_objFormat.nChannelMask;
+    objFormat.nSampleRate = m_objFormat.nSampleRate;
+    objFormat.nBlockAlign = m_objFormat.nChannels * sizeof(float);
+
+    TAudioConfig objConfig = objSubscription.objConfig;
+    objConfig.nGapToleranceUs = 0;
+
+    TSubscriber objSubscriber;
+    objSubscriber.ptrPipeline = MakeUnique<CYAudioPipeline>();
+    objSubscriber.pAudioDataCallBack = objSubscription.pAudioDataCallBack;
+    if (!objSubscriber.ptrPipeline->Init(objFormat, objSubscription.nSampleRate, objConfig))
+        return false;
+    const uint32_t nOutSampleRate = objSubscriber.ptrPipeline->GetOutSampleRate();
+
+    UniqueLock locker(m_subscriberMutex);
+    objSubscriber.nId = m_nNextId++;
+    if (m_bRunning)
+        objSubscriber.ptrPipeline->Start(objSubscriber.pAudioDataCallBack);
+
+    // the front ring holds nothing while nobody is subscribed, the first subscription starts it afresh.
+    if (m_vecSubscribers.empty())
+        m_frontPipeline.Flush();
+
+    nSubscriptionId = objSubscriber.nId;
+    m_vecSubscribers.push_back(std::move(objSubscriber));
+    m_nSubscribers = uint32_t(m_vecSubscribers.size());
+
+    CY_LOG_TRACE(TEXT("CYDevice: Audio subscription %u, %u Hz, layout %d, format %d, period %u us"), nSubscriptionId,
+        nOutSampleRate, (int)objConfig.eChannelLayout, (int)objConfig.eSampleFormat, objConfig.nPeriodUs);
+    return true;
+}
+
+bool CYAudioFanout::Unsubscribe(uint32_t nSubscriptionId)
+{
+    UniquePtr<CYAudioPipeline> ptrPipeline;
+    {
+        UniqueLock locker(m_subscriberMutex);
+        for (auto it = m_vecSubscribers.begin(); it != m_vecSubscribers.end(); ++it)
+        {
+            if (it->nId == nSubscriptionId)
+            {
+                ptrPipeline = std::move(it->ptrPipeline);
+                m_vecSubscribers.erase(it);
+                break;
+            }
+        }
+        m_nSubscribers = uint32_t(m_vecSubscribers.size());
+    }
+
+    // stopped outside the lock, its last callback may still be running.
+    if (!ptrPipeline)
+        return false;
+    ptrPipeline->Stop();
+    return true;
+}
+
+void CYAudioFanout::OnAudioPeriod(const TAudioPeriod& objPeriod)
+{
+    // the host time of the period end on the front clock, the subscription clocks follow it exactly.
+    const int64_t nPeriodUs = m_frontPipeline.GetPeriodHostUs();
+    const int64_t nHostUs = (nPeriodUs >= 0) ? nPeriodUs + int64_t(uint64_t(objPeriod.nFrames) * 1000000 / objPeriod.nSampleRate) : -1;
+    const int64_t nOriginUs = (nPeriodUs >= 0) ? m_frontPipeline.GetTimeOriginUs() : -1;
+    const size_t nBytes = size_t(objPeriod.nFrames) * objPeriod.nChannels * sizeof(float);
+
+    UniqueLock locker(m_subscriberMutex);
+    for (TSubscriber& objSubscriber : m_vecSubscribers)
+    {
+        if (!objSubscriber.bTimed && nOriginUs >= 0)
+        {
+            objSubscriber.ptrPipeline->SetTimeOriginUs(nOriginUs);
+            objSubscriber.bTimed = true;
+        }
+        objSubscriber.ptrPipeline->Write(objPeriod.pData, nBytes, nHostUs, -1);
+    }
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,82 @@
+#ifndef __CY_AUDIO_FANOUT_HPP__
+#define __CY_AUDIO_FANOUT_HPP__
+
+#include "Audio/CYAudioDefine.hpp"
+#include "Audio/CYAudioPipeline.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Period of the shared front stage, the latency it adds to every subscription.
+ */
+constexpr uint32_t g_nAudioFanoutPeriodUs = 5000;
+
+/**
+ * Audio subscriptions on top of one capture.
+ *
+ * A front pipeline turns the device PCM into float at the device rate and layout once, with the gaps
+ * in the source timestamps already concealed. Its delivery thread writes every period into the
+ * pipeline of each subscription, which remixes, resamples, cuts and formats it for that consumer and
+ * delivers it from its own thread. The subscriptions read the front clock and timeline, so their
+ * timestamps and drift match the main pipeline of the same device.
+ */
+class CYAudioFanout : public ICYAudioDataCallBack
+{
+public:
+    CYAudioFanout();
+    ~CYAudioFanout();
+
+    CYAudioFanout(const CYAudioFanout&) = delete;
+    CYAudioFanout& operator=(const CYAudioFanout&) = delete;
+
+public:
+    /**
+     * @brief Device format, objConfig only lends the gap tolerance and the thread scheduling to
+     * the front stage.
+    */
+    bool Init(const TAudioSourceFormat& objFormat, const TAudioConfig& objConfig);
+    void UnInit();
+
+    bool Start();
+    void Stop();
+
+    /**
+     * @brief Producer side, ignored while nobody is subscribed.
+    */
+    void Write(const void* pData, size_t nBytes, int64_t nHostUs, int64_t nStreamUs);
+    void Flush();
+
+    bool Subscribe(const TAudioSubscription& objSubscription, uint32_t& nSubscriptionId);
+    bool Unsubscribe(uint32_t nSubscriptionId);
+
+private:
+    virtual void OnAudioPeriod(const TAudioPeriod& objPeriod) override;
+
+private:
+    struct TSubscriber
+    {
+        uint32_t nId = 0;
+        bool bTimed = false;                    // took over the front time origin
+        UniquePtr<CYAudioPipeline> ptrPipeline;
+        ICYAudioDataCallBack* pAudioDataCallBack = nullptr;
+    };
+
+    bool m_bInit = false;
+    TAudioSourceFormat m_objFormat;
+    CYAudioPipeline m_frontPipeline;
+
+    // the subscription list is changed by the API threads and walked by the front delivery thread.
+    std::mutex m_subscriberMutex;
+    std::vector<TSubscriber> m_vecSubscribers;
+    std::atomic<uint32_t> m_nSubscribers{ 0 };
+    uint32_t m_nNextId = 1;
+    bool m_bRunning = false;
+};
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_AUDIO_FANOUT_HPP__
\ No newline at end of file
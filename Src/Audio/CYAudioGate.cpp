@@ -0,0 +1,51 @@
+#include "Audio/CYAudioGate.hpp"
+#include "Common/CYDevicePrivDefine.hpp"
+
+#include <math.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+CYAudioGate::CYAudioGate()
+{
+}
+
+CYAudioGate::~CYAudioGate()
+{
+}
+
+void CYAudioGate::Init(const TAudioConfig& objConfig, uint32_t nSampleRate)
+{
+    // a close threshold above the open one would make the gate chatter, it is held at the open one.
+    m_fOpenRms = powf(10.0f, objConfig.fGateOpenDb / 20.0f);
+    m_fCloseRms = MIN(powf(10.0f, objConfig.fGateCloseDb / 20.0f), m_fOpenRms);
+    m_nHoldFrames = uint64_t(nSampleRate) * objConfig.nGateHoldUs / 1000000;
+    Reset();
+}
+
+void CYAudioGate::Reset()
+{
+    m_bOpen = false;
+    m_nQuietFrames = 0;
+}
+
+bool CYAudioGate::Process(const TAudioLevels& objLevels)
+{
+    float fRms = 0.0f;
+    for (uint32_t nChannel = 0; nChannel < objLevels.nChannels; ++nChannel)
+        fRms = MAX(fRms, objLevels.arrChannels[nChannel].fRms);
+
+    if (fRms >= m_fOpenRms)
+    {
+        m_bOpen = true;
+        m_nQuietFrames = 0;
+    }
+    else if (m_bOpen)
+    {
+        m_nQuietFrames = (fRms < m_fCloseRms) ? m_nQuietFrames + objLevels.nFrames : 0;
+        m_bOpen = m_nQuietFrames <= m_nHoldFrames;
+    }
+
+    return m_bOpen;
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef __CY_AUDIO_GATE_HPP__
+#define __CY_AUDIO_GATE_HPP__
+
+#include "Audio/CYAudioDefine.hpp"
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Energy based voice activity gate over the delivered periods.
+ *
+ * The loudest channel RMS of a period is compared with two thresholds. Reaching the open threshold
+ * opens the gate, it closes once the level stayed under the lower close threshold for the hold time,
+ * so speech pauses and decaying tails are not cut. Not thread safe.
+ */
+class CYAudioGate
+{
+public:
+    CYAudioGate();
+    ~CYAudioGate();
+
+public:
+    void Init(const TAudioConfig& objConfig, uint32_t nSampleRate);
+    void Reset();
+
+    /**
+     * @brief Feeds the levels of one period, true when the period passes the gate.
+    */
+    bool Process(const TAudioLevels& objLevels);
+
+private:
+    float m_fOpenRms = 0.0f;
+    float m_fCloseRms = 0.0f;
+    uint64_t m_nHoldFrames = 0;
+
+    bool m_bOpen = false;
+    uint64_t m_nQuietFrames = 0;                // frames in a row under the close threshold
+};
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_AUDIO_GATE_HPP__
\ No newline at end of file
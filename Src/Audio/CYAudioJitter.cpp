@@ -0,0 +1,53 @@
+#include "Audio/CYAudioJitter.hpp"
+#include "Common/CYDevicePrivDefine.hpp"
+
+CYDEVICE_NAMESPACE_BEGIN
+
+CYAudioJitter::CYAudioJitter()
+{
+}
+
+CYAudioJitter::~CYAudioJitter()
+{
+}
+
+void CYAudioJitter::Init(const TAudioConfig& objConfig, uint32_t nMaxDelayUs)
+{
+    m_nMaxDelayUs = MIN(objConfig.nJitterMaxUs, nMaxDelayUs);
+    m_nMinDelayUs = MIN(objConfig.nJitterMinUs, m_nMaxDelayUs);
+    Reset();
+}
+
+void CYAudioJitter::Reset()
+{
+    m_nWindowStartUs = -1;
+    m_nLateUs = 0;
+    m_nLastLateUs = 0;
+    m_nLastHostUs = -1;
+    m_dDelayUs = m_nMinDelayUs;
+}
+
+void CYAudioJitter::Update(int64_t nLateUs, int64_t nHostUs)
+{
+    // the window slides by halves, the older half still holds the last burst while the new one fills.
+    if (m_nWindowStartUs < 0 || nHostUs - m_nWindowStartUs >= int64_t(g_nAudioJitterWindowUs / 2))
+    {
+        m_nLastLateUs = (m_nWindowStartUs < 0) ? nLateUs : m_nLateUs;
+        m_nLateUs = nLateUs;
+        m_nWindowStartUs = nHostUs;
+    }
+    else
+    {
+        m_nLateUs = MAX(m_nLateUs, nLateUs);
+    }
+
+    const int64_t nTargetUs = MAX(m_nLateUs, m_nLastLateUs) + g_nAudioJitterMarginUs;
+    const double dTargetUs = double(MIN(MAX(nTargetUs, int64_t(m_nMinDelayUs)), int64_t(m_nMaxDelayUs)));
+    if (dTargetUs >= m_dDelayUs || m_nLastHostUs < 0)
+        m_dDelayUs = dTargetUs;
+    else
+        m_dDelayUs = MAX(dTargetUs, m_dDelayUs - double(nHostUs - m_nLastHostUs) * g_dAudioJitterReleaseRate);
+    m_nLastHostUs = nHostUs;
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
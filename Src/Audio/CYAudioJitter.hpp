@@ -0,0 +1,59 @@
+#ifndef __CY_AUDIO_JITTER_HPP__
+#define __CY_AUDIO_JITTER_HPP__
+
+#include "Audio/CYAudioDefine.hpp"
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Jitter buffer tuning. The delay covers the latest arrival seen over the last g_nAudioJitterWindowUs
+ * plus g_nAudioJitterMarginUs, it grows at once and shrinks by at most g_dAudioJitterReleaseRate
+ * seconds per second, so the release clock only speeds up by that much while it does.
+ */
+constexpr uint32_t g_nAudioJitterWindowUs = 4000000;
+constexpr uint32_t g_nAudioJitterMarginUs = 1000;
+constexpr double g_dAudioJitterReleaseRate = 0.01;
+
+/**
+ * Adaptive delay of the jitter buffer between ingest and delivery.
+ *
+ * Every write reports how late its first frame arrived against the host time the device clock loop
+ * expects for it. A period is complete once the write holding its first frames arrived, so releasing
+ * it that much after its expected end time finds it in the ring. Not thread safe.
+ */
+class CYAudioJitter
+{
+public:
+    CYAudioJitter();
+    ~CYAudioJitter();
+
+public:
+    void Init(const TAudioConfig& objConfig, uint32_t nMaxDelayUs);
+    void Reset();
+
+    /**
+     * @brief A write arrived at nHostUs, nLateUs after the expected host time of its first frame.
+    */
+    void Update(int64_t nLateUs, int64_t nHostUs);
+
+    /**
+     * @brief Delay from the expected end time of a period to its release.
+    */
+    uint32_t GetDelayUs() const { return uint32_t(m_dDelayUs); }
+
+private:
+    uint32_t m_nMinDelayUs = 0;
+    uint32_t m_nMaxDelayUs = 0;
+
+    // latest arrival of the current and the previous half window.
+    int64_t m_nWindowStartUs = -1;
+    int64_t m_nLateUs = 0;
+    int64_t m_nLastLateUs = 0;
+
+    int64_t m_nLastHostUs = -1;
+    double m_dDelayUs = 0.0;
+};
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_AUDIO_JITTER_HPP__
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "Audio/CYAudioMeter.hpp"
+#include "Audio/Simd/CYAudioKernels.hpp"
+#include "Common/CYDevicePrivDefine.hpp"
+
+#include <math.h>
+#include <string.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+CYAudioMeter::CYAudioMeter()
+{
+}
+
+CYAudioMeter::~CYAudioMeter()
+{
+}
+
+void CYAudioMeter::Init(uint32_t nChannels)
+{
+    m_nChannels = MIN(nChannels, g_nMaxAudioLevelChannels);
+    Reset();
+}
+
+void CYAudioMeter::Reset()
+{
+    m_nClipCount = 0;
+    m_objLevels = TAudioLevels();
+    m_nSequence.store(0, std::memory_order_release);
+}
+
+const TAudioLevels* CYAudioMeter::Process(const float* pData, uint32_t nFrames, uint64_t nTimeStamp)
+{
+    TAudioMeter objMeter;
+    GetAudioKernels().pfnMeter(pData, m_nChannels, nFrames, objMeter);
+
+    m_objLevels.nChannels = m_nChannels;
+    m_objLevels.nFrames = nFrames;
+    m_objLevels.nTimeStamp = nTimeStamp;
+    for (uint32_t nChannel = 0; nChannel < m_nChannels; ++nChannel)
+    {
+        TAudioChannelLevel& objLevel = m_objLevels.arrChannels[nChannel];
+        objLevel.fPeak = objMeter.arrPeak[nChannel];
+        objLevel.fRms = nFrames ? sqrtf(objMeter.arrSquares[nChannel] / nFrames) : 0.0f;
+        objLevel.nClipCount = objMeter.arrClips[nChannel];
+        m_nClipCount += objMeter.arrClips[nChannel];
+    }
+    m_objLevels.nClipCount = m_nClipCount;
+    return &m_objLevels;
+}
+
+void CYAudioMeter::Publish()
+{
+    uint32_t arrWords[g_nAudioLevelWords];
+    memcpy(arrWords, &m_objLevels, sizeof(arrWords));
+
+    // single writer, the odd sequence keeps readers off the words until the even store releases them.
+    const uint32_t nSequence = m_nSequence.load(std::memory_order_relaxed);
+    m_nSequence.store(nSequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < g_nAudioLevelWords; ++i)
+        m_arrWords[i].store(arrWords[i], std::memory_order_relaxed);
+    m_nSequence.store(nSequence + 2, std::memory_order_release);
+}
+
+bool CYAudioMeter::GetLevels(TAudioLevels& objLevels) const
+{
+    uint32_t arrWords[g_nAudioLevelWords];
+    for (;;)
+    {
+        const uint32_t nSequence = m_nSequence.load(std::memory_order_acquire);
+        if (nSequence == 0)
+            return false;
+        if (nSequence & 1)
+            continue;
+
+        for (size_t i = 0; i < g_nAudioLevelWords; ++i)
+            arrWords[i] = m_arrWords[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_nSequence.load(std::memory_order_relaxed) == nSequence)
+            break;
+    }
+
+    memcpy(&objLevels, arrWords, sizeof(arrWords));
+    return true;
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
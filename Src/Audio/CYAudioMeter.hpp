@@ -0,0 +1,63 @@
+#ifndef __CY_AUDIO_METER_HPP__
+#define __CY_AUDIO_METER_HPP__
+
+#include "Audio/CYAudioDefine.hpp"
+
+#include <atomic>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * TAudioLevels is published in 32 bit words.
+ */
+constexpr size_t g_nAudioLevelWords = sizeof(TAudioLevels) / sizeof(uint32_t);
+static_assert(sizeof(TAudioLevels) % sizeof(uint32_t) == 0, "TAudioLevels must be a whole number of words");
+
+/**
+ * Per channel levels of the delivered periods.
+ *
+ * The consumer meters every period with the SIMD kernel while the float audio is still in cache and
+ * publishes the result through a sequence lock, so any thread can poll the last levels without ever
+ * blocking the audio path. A reader that overlaps a publish retries.
+ */
+class CYAudioMeter
+{
+public:
+    CYAudioMeter();
+    ~CYAudioMeter();
+
+public:
+    /**
+     * @brief nChannels is at most g_nMaxAudioLevelChannels.
+    */
+    void Init(uint32_t nChannels);
+    void Reset();
+
+    /**
+     * @brief Consumer side, meters nFrames interleaved frames. The levels stay valid until the next call.
+    */
+    const TAudioLevels* Process(const float* pData, uint32_t nFrames, uint64_t nTimeStamp);
+
+    /**
+     * @brief Consumer side, hands the levels of the last Process to GetLevels.
+    */
+    void Publish();
+
+    /**
+     * @brief Any thread, false until a period has been metered.
+    */
+    bool GetLevels(TAudioLevels& objLevels) const;
+
+private:
+    uint32_t m_nChannels = 0;
+    uint64_t m_nClipCount = 0;
+    TAudioLevels m_objLevels;
+
+    // odd while a publish is in progress, 0 until the first one.
+    std::atomic<uint32_t> m_nSequence{ 0 };
+    std::atomic<uint32_t> m_arrWords[g_nAudioLevelWords] = {};
+};
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_AUDIO_METER_HPP__
\ No newline at end of file
@@ -0,0 +1,447 @@
+#include "Audio/CYAudioMixer.hpp"
+#include "Audio/CYAudioClock.hpp"
+#include "Audio/CYAudioFanout.hpp"
+#include "Audio/Simd/CYAudioKernels.hpp"
+#include "Common/CYAllocCheck.hpp"
+#include "Common/CYDevicePrivDefine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Periods above the prime level an input may queue before the oldest are dropped, and the spare
+ * room of the queue beyond that for a burst between two mixed periods.
+ */
+constexpr uint32_t g_nMixerQueueSlackPeriods = 2;
+constexpr uint32_t g_nMixerQueueSparePeriods = 2;
+
+void CYAudioMixer::TMixerInput::OnAudioPeriod(const TAudioPeriod& objPeriod)
+{
+    // packet mode keeps every period at the mix period, anything else would shear the planes.
+    if (objPeriod.nFrames != nPeriodFrames || objPeriod.nChannels != nChannels)
+    {
+        nDroppedPeriods.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    audioQueue.Write(objPeriod.pData, nPeriodBytes);
+    dClockDriftPpm.store(objPeriod.dClockDriftPpm, std::memory_order_relaxed);
+    nBufferedUs.store(objPeriod.nBufferedUs, std::memory_order_relaxed);
+}
+
+CYAudioMixer::CYAudioMixer()
+{
+}
+
+CYAudioMixer::~CYAudioMixer()
+{
+    UnInit();
+}
+
+int16_t CYAudioMixer::Init(const TAudioMixerConfig& objConfig)
+{
+    UnInit();
+
+    if (!objConfig.nSampleRate || (objConfig.eChannelLayout != TYPE_CYAUDIO_LAYOUT_MONO && objConfig.eChannelLayout != TYPE_CYAUDIO_LAYOUT_STEREO))
+    {
+        CY_LOG_ERROR(TEXT("CYDevice: The audio mixer needs a sample rate and a mono or stereo layout"));
+        return CYERR_FAILED;
+    }
+
+    m_objConfig = objConfig;
+    m_nSampleRate = objConfig.nSampleRate;
+    m_nChannels = (objConfig.eChannelLayout == TYPE_CYAUDIO_LAYOUT_MONO) ? 1 : 2;
+    m_nPrimePeriods = MAX(objConfig.nPrimePeriods, 1u);
+
+    const uint32_t nPeriodUs = MIN(MAX(objConfig.nPeriodUs, g_nMinAudioPeriodUs), g_nMaxAudioPeriodUs);
+    m_nPeriodFrames = MAX(static_cast<uint32_t>((uint64_t(m_nSampleRate) * nPeriodUs + 500000) / 1000000), 1u);
+    m_nPeriodUs = static_cast<uint32_t>(uint64_t(m_nPeriodFrames) * 1000000 / m_nSampleRate);
+
+    m_vecBus.assign(size_t(m_nPeriodFrames) * m_nChannels, 0.0f);
+    m_vecOutput.assign(size_t(m_nPeriodFrames) * m_nChannels, 0.0f);
+
+    m_objSchedule.ePolicy = objConfig.eThreadPolicy;
+    m_objSchedule.nPriority = objConfig.nThreadPriority;
+    m_objSchedule.nCpuMask = objConfig.nThreadCpuMask;
+    m_objSchedule.nTimerSlackNs = objConfig.nTimerSlackNs;
+
+    m_bInit = true;
+    return CYERR_SUCESS;
+}
+
+int16_t CYAudioMixer::UnInit()
+{
+    Stop();
+
+    UniqueLock locker(m_apiMutex);
+    for (TMixerInput& objInput : m_arrInputs)
+    {
+        if (objInput.bReserved)
+            ReleaseInput(objInput);
+    }
+
+    m_bInit = false;
+    return CYERR_SUCESS;
+}
+
+int16_t CYAudioMixer::AddInput(ICYDevice* pDevice, const TAudioMixerInput& objInput, uint32_t& nInputId)
+{
+    UniqueLock locker(m_apiMutex);
+    if (!m_bInit || !pDevice)
+        return CYERR_FAILED;
+
+    TMixerInput* pInput = nullptr;
+    for (TMixerInput& objSlot : m_arrInputs)
+    {
+        if (!objSlot.bReserved)
+        {
+            pInput = &objSlot;
+            break;
+        }
+    }
+    if (!pInput)
+    {
+        CY_LOG_ERROR(TEXT("CYDevice: The audio mixer already has %u inputs"), g_nMaxAudioMixerInputs);
+        return CYERR_FAILED;
+    }
+
+    // a mono mix takes every input mono, the subscription folds the device channels down.
+    pInput->bStereo = objInput.bStereo && m_nChannels == 2;
+    pInput->nChannels = pInput->bStereo ? 2 : 1;
+    pInput->nPeriodFrames = m_nPeriodFrames;
+    pInput->nPeriodBytes = size_t(m_nPeriodFrames) * pInput->nChannels * sizeof(float);
+
+    const uint32_t nQueuePeriods = m_nPrimePeriods + g_nMixerQueueSlackPeriods + g_nMixerQueueSparePeriods;
+    if (!pInput->audioQueue.Init(pInput->nPeriodBytes * nQueuePeriods, pInput->nPeriodBytes, pInput->nPeriodBytes))
+        return CYERR_FAILED;
+    pInput->vecLastPeriod.assign(size_t(m_nPeriodFrames) * pInput->nChannels, 0.0f);
+
+    pInput->fGain.store(objInput.fGain, std::memory_order_relaxed);
+    pInput->fPan.store(objInput.fPan, std::memory_order_relaxed);
+    pInput->bMute.store(objInput.bMute, std::memory_order_relaxed);
+    pInput->dClockDriftPpm.store(0.0, std::memory_order_relaxed);
+    pInput->nBufferedUs.store(0, std::memory_order_relaxed);
+    pInput->nMixedPeriods.store(0, std::memory_order_relaxed);
+    pInput->nUnderrunCount.store(0, std::memory_order_relaxed);
+    pInput->nDroppedPeriods.store(0, std::memory_order_relaxed);
+
+    // planar packets of the mix period, locked to the host clock the mixing thread runs on.
+    TAudioSubscription objSubscription;
+    objSubscription.nSampleRate = m_nSampleRate;
+    objSubscription.objConfig.eChannelLayout = pInput->bStereo ? TYPE_CYAUDIO_LAYOUT_STEREO : TYPE_CYAUDIO_LAYOUT_MONO;
+    objSubscription.objConfig.eSampleFormat = TYPE_CYAUDIO_SAMPLE_F32;
+    objSubscription.objConfig.bPlanar = true;
+    objSubscription.objConfig.bDither = false;
+    objSubscription.objConfig.nPeriodFrames = m_nPeriodFrames;
+    objSubscription.objConfig.eResampleQuality = (m_objConfig.eResampleQuality == TYPE_CYAUDIO_RESAMPLE_SINC_MEDIUM) ? TYPE_CYAUDIO_RESAMPLE_SINC_MEDIUM : TYPE_CYAUDIO_RESAMPLE_SINC_FASTEST;
+    objSubscription.objConfig.bDriftCompensation = true;
+    objSubscription.objConfig.eThreadPolicy = m_objConfig.eThreadPolicy;
+    objSubscription.objConfig.nThreadPriority = m_objConfig.nThreadPriority;
+    objSubscription.objConfig.nThreadCpuMask = m_objConfig.nThreadCpuMask;
+    objSubscription.objConfig.nTimerSlackNs = m_objConfig.nTimerSlackNs;
+    objSubscription.pAudioDataCallBack = pInput;
+
+    pInput->bReserved = true;
+    if (pDevice->SubscribeAudio(objSubscription, pInput->nSubscriptionId) != CYERR_SUCESS)
+    {
+        CY_LOG_ERROR(TEXT("CYDevice: Could not subscribe the audio mixer to the device"));
+        pInput->audioQueue.UnInit();
+        pInput->bReserved = false;
+        return CYERR_FAILED;
+    }
+
+    pInput->pDevice = pDevice;
+    pInput->nId = m_nNextId++;
+    {
+        UniqueLock mixLocker(m_mixMutex);
+        pInput->bPrimed = false;
+        pInput->arrGains[0] = pInput->arrGains[1] = 0.0f;
+        pInput->bActive = true;
+    }
+
+    nInputId = pInput->nId;
+    return CYERR_SUCESS;
+}
+
+int16_t CYAudioMixer::RemoveInput(uint32_t nInputId)
+{
+    UniqueLock locker(m_apiMutex);
+    TMixerInput* pInput = FindInput(nInputId);
+    if (!pInput)
+        return CYERR_FAILED;
+
+    ReleaseInput(*pInput);
+    return CYERR_SUCESS;
+}
+
+int16_t CYAudioMixer::SetInput(uint32_t nInputId, const TAudioMixerInput& objInput)
+{
+    UniqueLock locker(m_apiMutex);
+    TMixerInput* pInput = FindInput(nInputId);
+    if (!pInput)
+        return CYERR_FAILED;
+
+    // the mixing thread picks these up at its next period and ramps to them.
+    pInput->fGain.store(objInput.fGain, std::memory_order_relaxed);
+    pInput->fPan.store(objInput.fPan, std::memory_order_relaxed);
+    pInput->bMute.store(objInput.bMute, std::memory_order_relaxed);
+    return CYERR_SUCESS;
+}
+
+int16_t CYAudioMixer::Start(ICYAudioDataCallBack* pAudioDataCallBack)
+{
+    UniqueLock locker(m_apiMutex);
+    if (!m_bInit || m_bRunning)
+        return CYERR_REPEAT_START_CAPTURE;
+
+    {
+        UniqueLock mixLocker(m_mixMutex);
+        for (TMixerInput& objInput : m_arrInputs)
+        {
+            if (!objInput.bActive)
+                continue;
+
+            // whatever queued before the start would only add latency.
+            objInput.audioQueue.Flush();
+            objInput.bPrimed = false;
+            objInput.arrGains[0] = objInput.arrGains[1] = 0.0f;
+        }
+        m_bRunning = true;
+    }
+
+    m_pAudioDataCallBack = pAudioDataCallBack;
+    m_nFramePos = 0;
+    m_wakeLatency.Reset();
+    m_mixThread = std::thread(&CYAudioMixer::OnMixEntry, this);
+    return CYERR_SUCESS;
+}
+
+int16_t CYAudioMixer::Stop()
+{
+    UniqueLock locker(m_apiMutex);
+    {
+        UniqueLock mixLocker(m_mixMutex);
+        if (!m_bRunning)
+            return CYEER_NOT_START_CAPTURE;
+        m_bRunning = false;
+    }
+    m_mixCV.notify_all();
+
+    if (m_mixThread.joinable())
+        m_mixThread.join();
+
+    m_pAudioDataCallBack = nullptr;
+    return CYERR_SUCESS;
+}
+
+int16_t CYAudioMixer::GetInputStats(uint32_t nInputId, TAudioMixerInputStats& objStats)
+{
+    UniqueLock locker(m_apiMutex);
+    TMixerInput* pInput = FindInput(nInputId);
+    if (!pInput)
+        return CYERR_FAILED;
+
+    const uint64_t nQueuedBytes = pInput->audioQueue.GetWritePos() - pInput->audioQueue.GetReadPos();
+    objStats.nQueuedPeriods = static_cast<uint32_t>(nQueuedBytes / pInput->nPeriodBytes);
+
+    // the front stage of the device subscriptions adds one of its periods ahead of the subscription.
+    objStats.nLatencyUs = objStats.nQueuedPeriods * m_nPeriodUs + pInput->nBufferedUs.load(std::memory_order_relaxed) + g_nAudioFanoutPeriodUs;
+    objStats.dClockDriftPpm = pInput->dClockDriftPpm.load(std::memory_order_relaxed);
+    objStats.nMixedPeriods = pInput->nMixedPeriods.load(std::memory_order_relaxed);
+    objStats.nUnderrunCount = pInput->nUnderrunCount.load(std::memory_order_relaxed);
+    objStats.nDroppedPeriods = pInput->nDroppedPeriods.load(std::memory_order_relaxed) + pInput->audioQueue.GetOverrunCount();
+    return CYERR_SUCESS;
+}
+
+int16_t CYAudioMixer::GetSchedulingStats(TAudioSchedulingStats& objStats)
+{
+    m_wakeLatency.Get(objStats);
+    return CYERR_SUCESS;
+}
+
+CYAudioMixer::TMixerInput* CYAudioMixer::FindInput(uint32_t nInputId)
+{
+    for (TMixerInput& objInput : m_arrInputs)
+    {
+        if (objInput.bReserved && objInput.nId == nInputId)
+            return &objInput;
+    }
+    return nullptr;
+}
+
+void CYAudioMixer::ReleaseInput(TMixerInput& objInput)
+{
+    {
+        UniqueLock mixLocker(m_mixMutex);
+        objInput.bActive = false;
+    }
+
+    // the subscription thread is joined here, nothing writes into the queue after it.
+    if (objInput.pDevice)
+        objInput.pDevice->UnsubscribeAudio(objInput.nSubscriptionId);
+
+    objInput.audioQueue.UnInit();
+    objInput.pDevice = nullptr;
+    objInput.nId = 0;
+    objInput.bReserved = false;
+}
+
+void CYAudioMixer::GetTargetGains(const TMixerInput& objInput, float* pGains) const
+{
+    const float fGain = objInput.bMute.load(std::memory_order_relaxed) ? 0.0f : objInput.fGain.load(std::memory_order_relaxed);
+    if (m_nChannels == 1)
+    {
+        pGains[0] = fGain;
+        return;
+    }
+
+    const float fPan = MIN(MAX(objInput.fPan.load(std::memory_order_relaxed), -1.0f), 1.0f);
+    if (objInput.bStereo)
+    {
+        // balance, the far side is attenuated and the near side kept.
+        pGains[0] = fGain * MIN(1.0f - fPan, 1.0f);
+        pGains[1] = fGain * MIN(1.0f + fPan, 1.0f);
+    }
+    else
+    {
+        const float fAngle = (fPan + 1.0f) * 0.785398163f;
+        pGains[0] = fGain * std::cos(fAngle);
+        pGains[1] = fGain * std::sin(fAngle);
+    }
+}
+
+void CYAudioMixer::MixInput(TMixerInput& objInput)
+{
+    uint64_t nQueued = objInput.audioQueue.GetReadable() / objInput.nPeriodBytes;
+    if (!objInput.bPrimed)
+    {
+        if (nQueued < m_nPrimePeriods)
+            return;
+        objInput.bPrimed = true;
+    }
+
+    if (!nQueued)
+    {
+        // rejoins from silence once primed again, its gains ramp up from zero.
+        objInput.nUnderrunCount.fetch_add(1, std::memory_order_relaxed);
+        objInput.bPrimed = false;
+        FadeOutInput(objInput);
+        return;
+    }
+
+    for (; nQueued > m_nPrimePeriods + g_nMixerQueueSlackPeriods; --nQueued)
+    {
+        objInput.audioQueue.Consume(objInput.nPeriodBytes);
+        objInput.nDroppedPeriods.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    TRingView objView;
+    if (!objInput.audioQueue.Peek(objInput.nPeriodBytes, objView))
+        return;
+
+    const float* pPlanes = reinterpret_cast<const float*>(objView.pFirst);
+    float arrTarget[2] = {};
+    GetTargetGains(objInput, arrTarget);
+    RampInput(objInput, pPlanes, arrTarget);
+
+    // kept for an underrun in the next period, the queue slot is reused once consumed.
+    memcpy(objInput.vecLastPeriod.data(), pPlanes, objInput.nPeriodBytes);
+    objInput.audioQueue.Consume(objInput.nPeriodBytes);
+    objInput.nMixedPeriods.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CYAudioMixer::RampInput(TMixerInput& objInput, const float* pPlanes, const float* pTarget)
+{
+    const TAudioKernels& objKernels = GetAudioKernels();
+    const float fFrames = float(m_nPeriodFrames);
+    for (uint32_t nChannel = 0; nChannel < m_nChannels; ++nChannel)
+    {
+        const float* pSrc = pPlanes + (objInput.bStereo ? size_t(nChannel) * m_nPeriodFrames : 0);
+        const float fStart = objInput.arrGains[nChannel];
+        const float fStep = (pTarget[nChannel] - fStart) / fFrames;
+        if (fStart != 0.0f || fStep != 0.0f)
+            objKernels.pfnMulAddRamp(pSrc, fStart, fStep, m_vecBus.data() + size_t(nChannel) * m_nPeriodFrames, m_nPeriodFrames);
+        objInput.arrGains[nChannel] = pTarget[nChannel];
+    }
+}
+
+void CYAudioMixer::FadeOutInput(TMixerInput& objInput)
+{
+    // played backwards the last period starts on the sample the input stopped on, so cutting to the
+    // fade does not step. Reversed in place, it is not needed again before the input is primed.
+    for (uint32_t nPlane = 0; nPlane < objInput.nChannels; ++nPlane)
+    {
+        float* pPlane = objInput.vecLastPeriod.data() + size_t(nPlane) * m_nPeriodFrames;
+        std::reverse(pPlane, pPlane + m_nPeriodFrames);
+    }
+
+    const float arrSilent[2] = {};
+    RampInput(objInput, objInput.vecLastPeriod.data(), arrSilent);
+}
+
+void CYAudioMixer::MixPeriod(TAudioPeriod& objPeriod)
+{
+    memset(m_vecBus.data(), 0, m_vecBus.size() * sizeof(float));
+    for (TMixerInput& objInput : m_arrInputs)
+    {
+        if (objInput.bActive)
+            MixInput(objInput);
+    }
+
+    const float* pOutput = m_vecBus.data();
+    if (m_nChannels == 2)
+    {
+        GetAudioKernels().pfnInterleaveStereo(m_vecBus.data(), m_vecBus.data() + m_nPeriodFrames, m_vecOutput.data(), m_nPeriodFrames);
+        pOutput = m_vecOutput.data();
+    }
+
+    const uint64_t nTimeStampUs = m_nFramePos * 1000000 / m_nSampleRate;
+    objPeriod.pData = pOutput;
+    objPeriod.nFrames = m_nPeriodFrames;
+    objPeriod.nChannels = m_nChannels;
+    objPeriod.nSampleRate = m_nSampleRate;
+    objPeriod.eSampleFormat = TYPE_CYAUDIO_SAMPLE_F32;
+    objPeriod.bPlanar = false;
+    objPeriod.nTimeStamp = nTimeStampUs / 1000;
+    objPeriod.nTimeStampUs = nTimeStampUs;
+    objPeriod.nFramePos = m_nFramePos;
+    m_nFramePos += m_nPeriodFrames;
+}
+
+void CYAudioMixer::OnMixEntry()
+{
+    TThreadScheduleResult objSchedule;
+    ApplyThreadSchedule(m_objSchedule, objSchedule);
+    m_wakeLatency.SetSchedule(objSchedule);
+
+    // periods fall due on the host clock from the start, the clock every input is resampled onto.
+    const int64_t nStartUs = GetHostTimeUs();
+    UniqueLock locker(m_mixMutex);
+    while (m_bRunning)
+    {
+        const int64_t nDueUs = nStartUs + static_cast<int64_t>((m_nFramePos + m_nPeriodFrames) * 1000000 / m_nSampleRate);
+        const std::chrono::steady_clock::time_point tpDue{ std::chrono::microseconds(nDueUs) };
+        if (m_mixCV.wait_until(locker, tpDue, [this]() { return !m_bRunning; }))
+            break;
+
+        m_wakeLatency.Add(GetHostTimeUs() - nDueUs, m_nPeriodUs);
+
+        TAudioPeriod objPeriod;
+        {
+            CY_ALLOC_CHECK_SCOPE();
+            MixPeriod(objPeriod);
+        }
+
+        // the callback runs without the mix mutex, so removing an input never waits for it.
+        locker.unlock();
+        if (m_pAudioDataCallBack)
+            m_pAudioDataCallBack->OnAudioPeriod(objPeriod);
+        locker.lock();
+    }
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
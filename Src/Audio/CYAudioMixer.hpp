@@ -0,0 +1,127 @@
+#ifndef __CY_AUDIO_MIXER_HPP__
+#define __CY_AUDIO_MIXER_HPP__
+
+#include "CYDevice/ICYAudioMixer.hpp"
+#include "Audio/CYAudioDefine.hpp"
+#include "Audio/CYAudioRingBuffer.hpp"
+#include "Common/CYThreadSchedule.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Mixer of several capture devices into one feed.
+ *
+ * Every input is a subscription of its device, resampled to the mix rate with drift compensation so
+ * it delivers exactly as many frames as the host clock advances, in planar float periods of the mix
+ * period. Its delivery thread queues the periods in a lock free ring. The mixing thread wakes on the
+ * host clock once per period, ramps every queued input from its previous gains to its current ones
+ * into a planar bus with the SIMD kernels, and delivers the interleaved mix. An input without a
+ * period fades out over the last one it mixed played backwards, which continues from the sample it
+ * stopped on, then is silent and rejoins once it queued nPrimePeriods again, fading in from zero.
+ */
+class CYAudioMixer : public ICYAudioMixer
+{
+public:
+    CYAudioMixer();
+    virtual ~CYAudioMixer();
+
+    CYAudioMixer(const CYAudioMixer&) = delete;
+    CYAudioMixer& operator=(const CYAudioMixer&) = delete;
+
+public:
+    virtual int16_t Init(const TAudioMixerConfig& objConfig) override;
+    virtual int16_t UnInit() override;
+
+    virtual int16_t AddInput(ICYDevice* pDevice, const TAudioMixerInput& objInput, uint32_t& nInputId) override;
+    virtual int16_t RemoveInput(uint32_t nInputId) override;
+    virtual int16_t SetInput(uint32_t nInputId, const TAudioMixerInput& objInput) override;
+
+    virtual int16_t Start(ICYAudioDataCallBack* pAudioDataCallBack) override;
+    virtual int16_t Stop() override;
+
+    virtual int16_t GetInputStats(uint32_t nInputId, TAudioMixerInputStats& objStats) override;
+    virtual int16_t GetSchedulingStats(TAudioSchedulingStats& objStats) override;
+
+private:
+    struct TMixerInput : public ICYAudioDataCallBack
+    {
+        virtual void OnAudioPeriod(const TAudioPeriod& objPeriod) override;
+
+        // slot ownership, changed by the API threads under the API mutex.
+        bool bReserved = false;
+        uint32_t nId = 0;
+        ICYDevice* pDevice = nullptr;
+        uint32_t nSubscriptionId = 0;
+
+        uint32_t nChannels = 1;
+        uint32_t nPeriodFrames = 0;
+        size_t nPeriodBytes = 0;
+        CYAudioRingBuffer audioQueue;
+
+        // mixed while set, changed under the mix mutex.
+        bool bActive = false;
+
+        // mixing thread only, the gains the last period ended on and a copy of its planes.
+        bool bPrimed = false;
+        float arrGains[2] = {};
+        std::vector<float> vecLastPeriod;
+
+        std::atomic<float> fGain{ 1.0f };
+        std::atomic<float> fPan{ 0.0f };
+        std::atomic<bool> bMute{ false };
+        bool bStereo = false;
+
+        std::atomic<double> dClockDriftPpm{ 0.0 };
+        std::atomic<uint32_t> nBufferedUs{ 0 };
+        std::atomic<uint64_t> nMixedPeriods{ 0 };
+        std::atomic<uint64_t> nUnderrunCount{ 0 };
+        std::atomic<uint64_t> nDroppedPeriods{ 0 };
+    };
+
+    TMixerInput* FindInput(uint32_t nInputId);
+    void ReleaseInput(TMixerInput& objInput);
+    void GetTargetGains(const TMixerInput& objInput, float* pGains) const;
+    void RampInput(TMixerInput& objInput, const float* pPlanes, const float* pTarget);
+    void FadeOutInput(TMixerInput& objInput);
+    void MixInput(TMixerInput& objInput);
+    void MixPeriod(TAudioPeriod& objPeriod);
+    void OnMixEntry();
+
+private:
+    bool m_bInit = false;
+    uint32_t m_nSampleRate = 0;
+    uint32_t m_nChannels = 0;
+    uint32_t m_nPeriodFrames = 0;
+    uint32_t m_nPeriodUs = 0;
+    uint32_t m_nPrimePeriods = 0;
+    TAudioMixerConfig m_objConfig;
+
+    TMixerInput m_arrInputs[g_nMaxAudioMixerInputs];
+    uint32_t m_nNextId = 1;
+
+    // planar bus of m_nChannels planes and the interleaved period it is delivered in.
+    std::vector<float> m_vecBus;
+    std::vector<float> m_vecOutput;
+    uint64_t m_nFramePos = 0;
+
+    ICYAudioDataCallBack* m_pAudioDataCallBack = nullptr;
+    TThreadSchedule m_objSchedule;
+    CYWakeLatency m_wakeLatency;
+
+    // the API mutex serializes input changes, the mix mutex is held by the mixing thread while it mixes.
+    std::mutex m_apiMutex;
+    std::mutex m_mixMutex;
+    std::condition_variable m_mixCV;
+    bool m_bRunning = false;
+    std::thread m_mixThread;
+};
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_AUDIO_MIXER_HPP__
\ No newline at end of file
@@ -0,0 +1,300 @@
+#include "Audio/CYAudioNegotiate.hpp"
+#include "Audio/CYAudioConvert.hpp"
+#include "Audio/CYAudioRemixer.hpp"
+#include "Audio/Resample/CYDecimator.hpp"
+#include "Audio/Resample/CYPolyphaseResampler.hpp"
+#include "Common/CYDevicePrivDefine.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <numeric>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Cost of a candidate that loses audio against the request, far above what any processing costs.
+ * A lower rate or a missing channel pays the whole of it, every missing bit a sixteenth.
+ */
+constexpr float g_fNegotiateLossCost = 1.0e6f;
+
+/**
+ * Most whole multiples of the requested rate tried per capability.
+ */
+constexpr uint32_t g_nMaxNegotiateMultiples = 8;
+
+/**
+ * Rough cycles per sample of the vectorized kernels, only their ratios matter.
+ */
+constexpr float g_fCostCopy = 0.25f;
+constexpr float g_fCostRemixTap = 0.5f;
+constexpr float g_fCostStore = 0.5f;
+constexpr float g_fCostLinear = 2.0f;
+constexpr float g_fCostDecimator = 6.0f;
+constexpr float g_fCostPolyphase = 16.0f;
+constexpr float g_fCostSincFastest = 40.0f;
+constexpr float g_fCostSincMedium = 120.0f;
+
+static float GetLoadCost(ECYPcmFormat ePcmFormat)
+{
+    switch (ePcmFormat)
+    {
+    case TYPE_PCM_S24:
+        return 2.0f;            // three byte loads and a shift
+    case TYPE_PCM_S32:
+        return 1.5f;
+    default:
+        return 1.0f;
+    }
+}
+
+/**
+ * Bits of resolution that reach the output, the pipeline works in float.
+ */
+static uint32_t GetPcmBits(ECYPcmFormat ePcmFormat)
+{
+    switch (ePcmFormat)
+    {
+    case TYPE_PCM_S8:
+        return 8;
+    case TYPE_PCM_S16:
+        return 16;
+    case TYPE_PCM_S24:
+    case TYPE_PCM_S32:
+    case TYPE_PCM_F32:
+        return 24;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * Bits the output format asks the device for. A float output takes whatever the device has, only S32
+ * is a request for more than 16 bits.
+ */
+static uint32_t GetSampleFormatBits(ECYAudioSampleFormat eSampleFormat)
+{
+    return (eSampleFormat == TYPE_CYAUDIO_SAMPLE_S32) ? 24 : 16;
+}
+
+/**
+ * Per output sample cost of the tier the pipeline ends up with, following its fallbacks.
+ */
+static float GetResampleCost(ECYAudioResampleQuality eQuality, uint32_t nInRate, uint32_t nOutRate, bool bDriftCompensation)
+{
+    if (bDriftCompensation && eQuality != TYPE_CYAUDIO_RESAMPLE_SINC_MEDIUM)
+        eQuality = TYPE_CYAUDIO_RESAMPLE_SINC_FASTEST;
+
+    switch (eQuality)
+    {
+    case TYPE_CYAUDIO_RESAMPLE_LINEAR:
+        return g_fCostLinear;
+    case TYPE_CYAUDIO_RESAMPLE_POLYPHASE:
+        if (CYDecimator::IsSupported(nInRate, nOutRate))
+            return g_fCostDecimator;
+        if (nOutRate / std::gcd(nInRate, nOutRate) <= g_nMaxPolyphases)
+            return g_fCostPolyphase;
+        return g_fCostSincFastest;
+    case TYPE_CYAUDIO_RESAMPLE_SINC_MEDIUM:
+        return g_fCostSincMedium;
+    default:
+        return g_fCostSincFastest;
+    }
+}
+
+void TAudioNegotiateTarget::Set(uint32_t nOutSampleRate, const TAudioConfig& objConfig)
+{
+    nSampleRate = nOutSampleRate;
+    eSampleFormat = objConfig.eSampleFormat;
+    eResampleQuality = objConfig.eResampleQuality;
+    bDriftCompensation = objConfig.bDriftCompensation;
+
+    nCustomInChannels = 0;
+    if (objConfig.eChannelLayout == TYPE_CYAUDIO_LAYOUT_CUSTOM && objConfig.pCustomMatrix)
+    {
+        nChannels = objConfig.nCustomOutChannels;
+        nCustomInChannels = objConfig.nCustomInChannels;
+    }
+    else if (objConfig.eChannelLayout == TYPE_CYAUDIO_LAYOUT_CUSTOM)
+        nChannels = 2;
+    else
+        nChannels = (uint32_t)std::popcount(CYAudioRemixer::GetLayoutChannelMask(objConfig.eChannelLayout));
+}
+
+float CYAudioNegotiate::EstimateCost(const TAudioSourceFormat& objFormat, const TAudioNegotiateTarget& objTarget)
+{
+    if (!objFormat.nChannels || !objFormat.nSampleRate || objFormat.ePcmFormat == TYPE_PCM_UNKNOWN)
+        return std::numeric_limits<float>::max();
+
+    const uint32_t nOutRate = objTarget.nSampleRate ? objTarget.nSampleRate : objFormat.nSampleRate;
+    const float fRatio = float(objFormat.nSampleRate) / float(nOutRate);
+    float fCost = 0.0f;
+
+    // a custom matrix built for other device channels falls back to stereo.
+    uint32_t nOutChannels = objTarget.nChannels ? objTarget.nChannels : objFormat.nChannels;
+    if (objTarget.nCustomInChannels && objTarget.nCustomInChannels != objFormat.nChannels)
+    {
+        nOutChannels = 2;
+        fCost += g_fNegotiateLossCost;
+    }
+
+    const bool bRemix = nOutChannels != objFormat.nChannels || objTarget.nCustomInChannels;
+    const bool bResample = objFormat.nSampleRate != nOutRate || objTarget.bDriftCompensation;
+
+    if (!bRemix && !bResample && objFormat.ePcmFormat == GetPassthroughPcmFormat(objTarget.eSampleFormat))
+        fCost += g_fCostCopy * nOutChannels;
+    else
+    {
+        // converted and remixed at the device rate, resampled for the output channels, then stored.
+        fCost += fRatio * objFormat.nChannels * GetLoadCost(objFormat.ePcmFormat);
+        if (bRemix)
+            fCost += fRatio * objFormat.nChannels * nOutChannels * g_fCostRemixTap;
+        if (bResample)
+            fCost += GetResampleCost(objTarget.eResampleQuality, objFormat.nSampleRate, nOutRate, objTarget.bDriftCompensation) * nOutChannels * MAX(fRatio, 1.0f);
+        fCost += g_fCostStore * nOutChannels;
+    }
+
+    if (objFormat.nSampleRate < nOutRate)
+        fCost += g_fNegotiateLossCost * (1.0f + float(nOutRate - objFormat.nSampleRate) / float(nOutRate));
+    if (objTarget.nChannels && objFormat.nChannels < objTarget.nChannels && !objTarget.nCustomInChannels)
+        fCost += g_fNegotiateLossCost * float(objTarget.nChannels - objFormat.nChannels);
+
+    const uint32_t nInBits = GetPcmBits(objFormat.ePcmFormat);
+    const uint32_t nOutBits = GetSampleFormatBits(objTarget.eSampleFormat);
+    if (nInBits < nOutBits)
+        fCost += g_fNegotiateLossCost / 16.0f * float(nOutBits - nInBits);
+
+    return fCost;
+}
+
+void CYAudioNegotiate::GetCandidateRates(const TAudioCapability& objCap, uint32_t nTargetRate, std::vector<uint32_t>& vecRates)
+{
+    vecRates.clear();
+    if (!objCap.nMinSampleRate || objCap.nMaxSampleRate < objCap.nMinSampleRate)
+        return;
+
+    auto IsAllowed = [&objCap](uint64_t nRate)
+    {
+        if (nRate < objCap.nMinSampleRate || nRate > objCap.nMaxSampleRate)
+            return false;
+        if (!objCap.nSampleRateStep)
+            return nRate == objCap.nMinSampleRate || nRate == objCap.nMaxSampleRate;
+        return (nRate - objCap.nMinSampleRate) % objCap.nSampleRateStep == 0;
+    };
+
+    auto Add = [&vecRates](uint32_t nRate)
+    {
+        if (std::find(vecRates.begin(), vecRates.end(), nRate) == vecRates.end())
+            vecRates.push_back(nRate);
+    };
+
+    Add(objCap.nMinSampleRate);
+    Add(objCap.nMaxSampleRate);
+    if (!nTargetRate)
+        return;
+
+    if (IsAllowed(nTargetRate))
+        Add(nTargetRate);
+    else if (objCap.nSampleRateStep && nTargetRate > objCap.nMinSampleRate && nTargetRate < objCap.nMaxSampleRate)
+    {
+        // the grid points either side of the requested rate.
+        const uint32_t nBelow = objCap.nMinSampleRate + (nTargetRate - objCap.nMinSampleRate) / objCap.nSampleRateStep * objCap.nSampleRateStep;
+        Add(nBelow);
+        if (IsAllowed(uint64_t(nBelow) + objCap.nSampleRateStep))
+            Add(nBelow + objCap.nSampleRateStep);
+    }
+
+    for (uint32_t i = 2; i <= g_nMaxNegotiateMultiples; ++i)
+    {
+        if (IsAllowed(uint64_t(nTargetRate) * i))
+            Add(nTargetRate * i);
+    }
+}
+
+void CYAudioNegotiate::GetCandidateChannels(const TAudioCapability& objCap, const TAudioNegotiateTarget& objTarget, std::vector<uint32_t>& vecChannels)
+{
+    vecChannels.clear();
+    if (!objCap.nMinChannels || objCap.nMaxChannels < objCap.nMinChannels)
+        return;
+
+    const uint32_t nStep = MAX(objCap.nChannelStep, 1u);
+    auto Add = [&vecChannels](uint32_t nChannels)
+    {
+        if (std::find(vecChannels.begin(), vecChannels.end(), nChannels) == vecChannels.end())
+            vecChannels.push_back(nChannels);
+    };
+
+    // the native layout keeps everything the device captures.
+    Add(objCap.nMaxChannels);
+    if (!objTarget.nChannels)
+        return;
+
+    Add(objCap.nMinChannels);
+
+    const uint32_t nWanted = objTarget.nCustomInChannels ? objTarget.nCustomInChannels : objTarget.nChannels;
+    if (nWanted > objCap.nMinChannels && nWanted < objCap.nMaxChannels)
+    {
+        const uint32_t nBelow = objCap.nMinChannels + (nWanted - objCap.nMinChannels) / nStep * nStep;
+        Add(nBelow);
+        if (nBelow != nWanted && nBelow + nStep <= objCap.nMaxChannels)
+            Add(nBelow + nStep);
+    }
+}
+
+bool CYAudioNegotiate::Select(const TAudioCapability* pCaps, uint32_t nCaps, const TAudioNegotiateTarget& objTarget, TAudioNegotiateResult& objResult)
+{
+    if (!pCaps || !nCaps)
+        return false;
+
+    // the native layout has no channel count to hold the device to, the widest capability sets it.
+    uint32_t nNativeChannels = 0;
+    if (!objTarget.nChannels)
+    {
+        for (uint32_t i = 0; i < nCaps; ++i)
+            nNativeChannels = MAX(nNativeChannels, pCaps[i].nMaxChannels);
+    }
+
+    std::vector<uint32_t> vecRates;
+    std::vector<uint32_t> vecChannels;
+    bool bFound = false;
+
+    for (uint32_t i = 0; i < nCaps; ++i)
+    {
+        const TAudioCapability& objCap = pCaps[i];
+        const uint32_t nBytes = GetPcmBytesPerSample(objCap.ePcmFormat);
+        if (!nBytes)
+            continue;
+
+        GetCandidateRates(objCap, objTarget.nSampleRate, vecRates);
+        GetCandidateChannels(objCap, objTarget, vecChannels);
+
+        for (uint32_t nChannels : vecChannels)
+        {
+            for (uint32_t nRate : vecRates)
+            {
+                TAudioSourceFormat objFormat;
+                objFormat.ePcmFormat = objCap.ePcmFormat;
+                objFormat.nChannels = nChannels;
+                objFormat.nSampleRate = nRate;
+                objFormat.nBlockAlign = nBytes * nChannels;
+
+                float fCost = EstimateCost(objFormat, objTarget);
+                if (nChannels < nNativeChannels)
+                    fCost += g_fNegotiateLossCost * float(nNativeChannels - nChannels);
+
+                // strictly cheaper only, so equal candidates keep the order the device listed them in.
+                if (!bFound || fCost < objResult.fCost)
+                {
+                    objResult.nCapability = i;
+                    objResult.objFormat = objFormat;
+                    objResult.fCost = fCost;
+                    bFound = true;
+                }
+            }
+        }
+    }
+
+    return bFound;
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
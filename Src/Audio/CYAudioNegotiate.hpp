@@ -0,0 +1,83 @@
+#ifndef __CY_AUDIO_NEGOTIATE_HPP__
+#define __CY_AUDIO_NEGOTIATE_HPP__
+
+#include "Audio/CYAudioDefine.hpp"
+
+#include <vector>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * One entry of the formats a device offers. Rates and channel counts are ranges stepped by their
+ * granularity, a single value has the same minimum and maximum.
+ */
+struct TAudioCapability
+{
+    ECYPcmFormat ePcmFormat = TYPE_PCM_UNKNOWN;
+    uint32_t nMinChannels = 0;
+    uint32_t nMaxChannels = 0;
+    uint32_t nChannelStep = 1;
+    uint32_t nMinSampleRate = 0;
+    uint32_t nMaxSampleRate = 0;
+    uint32_t nSampleRateStep = 0;               // 0 allows only the minimum and the maximum
+};
+
+/**
+ * What the pipeline is asked to deliver, taken from the Init arguments.
+ */
+struct TAudioNegotiateTarget
+{
+    uint32_t nSampleRate = 0;
+    uint32_t nChannels = 0;                     // 0 keeps the device channels
+    uint32_t nCustomInChannels = 0;             // custom matrix only, the device channels it was built for
+    ECYAudioSampleFormat eSampleFormat = TYPE_CYAUDIO_SAMPLE_F32;
+    ECYAudioResampleQuality eResampleQuality = TYPE_CYAUDIO_RESAMPLE_POLYPHASE;
+    bool bDriftCompensation = false;
+
+    /**
+     * @brief Take the output rate and the layout, format and resampler of an Init configuration.
+    */
+    void Set(uint32_t nOutSampleRate, const TAudioConfig& objConfig);
+};
+
+/**
+ * The chosen entry and the concrete format to ask the device for.
+ */
+struct TAudioNegotiateResult
+{
+    uint32_t nCapability = 0;
+    TAudioSourceFormat objFormat;
+    float fCost = 0.0f;
+};
+
+/**
+ * Audio format negotiation by estimated cost.
+ *
+ * Every capability is expanded into the rates and channel counts worth trying, the requested ones
+ * when the device offers them, the nearest ones around them and whole multiples of the requested rate,
+ * which the decimator takes cheaply. Each candidate is scored in cycles per delivered frame by what the
+ * pipeline would run for it: the device samples read and converted, the remix, the resampler of the
+ * configured tier for the output channels. A candidate that loses audio against the request, a lower
+ * rate, fewer channels than the layout or fewer bits than the output format, carries a penalty above
+ * any processing cost, so the device is only downgraded when nothing else is offered. Ties keep the
+ * first capability, which devices list as their preferred one. Platform neutral, the device layer
+ * fills the capability table.
+ */
+class CYAudioNegotiate
+{
+public:
+    static bool Select(const TAudioCapability* pCaps, uint32_t nCaps, const TAudioNegotiateTarget& objTarget, TAudioNegotiateResult& objResult);
+
+    /**
+     * @brief Estimated cycles per delivered frame, with the quality penalties.
+    */
+    static float EstimateCost(const TAudioSourceFormat& objFormat, const TAudioNegotiateTarget& objTarget);
+
+private:
+    static void GetCandidateRates(const TAudioCapability& objCap, uint32_t nTargetRate, std::vector<uint32_t>& vecRates);
+    static void GetCandidateChannels(const TAudioCapability& objCap, const TAudioNegotiateTarget& objTarget, std::vector<uint32_t>& vecChannels);
+};
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_AUDIO_NEGOTIATE_HPP__
\ No newline at end of file
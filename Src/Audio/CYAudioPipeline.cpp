@@ -0,0 +1,1059 @@
+#include "Audio/CYAudioPipeline.hpp"
+#include "Audio/CYAudioConvert.hpp"
+#include "Common/CYAllocCheck.hpp"
+#include "Common/CYDevicePrivDefine.hpp"
+
+#include <chrono>
+#include <math.h>
+#include <string.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+CYAudioPipeline::CYAudioPipeline()
+{
+}
+
+CYAudioPipeline::~CYAudioPipeline()
+{
+    Stop();
+    UnInit();
+}
+
+bool CYAudioPipeline::Init(const TAudioSourceFormat& objFormat, uint32_t nOutSampleRate, const TAudioConfig& objConfig)
+{
+    UnInit();
+
+    if (!objFormat.nChannels || !objFormat.nSampleRate || !objFormat.nBlockAlign || GetPcmBytesPerSample(objFormat.ePcmFormat) == 0)
+    {
+        CY_LOG_ERROR(TEXT("CYDevice: Unsupported audio format, %u channels, %u Hz, block size %u"), objFormat.nChannels, objFormat.nSampleRate, objFormat.nBlockAlign);
+        return false;
+    }
+
+    m_objFormat = objFormat;
+    m_nOutSampleRate = nOutSampleRate ? nOutSampleRate : objFormat.nSampleRate;
+
+    if (!m_audioRemixer.Init(objFormat.nChannels, objFormat.nChannelMask, objConfig))
+    {
+        CY_LOG_WARN(TEXT("CYDevice: Audio channel config does not fit %u device channels, delivering stereo"), objFormat.nChannels);
+
+        TAudioConfig objFallback;
+        if (!m_audioRemixer.Init(objFormat.nChannels, objFormat.nChannelMask, objFallback))
+        {
+            objFallback.eChannelLayout = TYPE_CYAUDIO_LAYOUT_NATIVE;
+            m_audioRemixer.Init(objFormat.nChannels, objFormat.nChannelMask, objFallback);
+        }
+    }
+
+    // a packet length replaces the period time. Resampled packets are collected from periods just long
+    // enough to complete them, one output frame more than they miss at most.
+    m_bDriftCompensation = objConfig.bDriftCompensation;
+    m_nPacketFrames = 0;
+    m_bCarry = false;
+    m_nCarryFrames = 0;
+    if (objConfig.nPeriodFrames)
+    {
+        const uint64_t nMinFrames = (uint64_t(m_nOutSampleRate) * g_nMinAudioPeriodUs + 999999) / 1000000;
+        const uint64_t nMaxFrames = uint64_t(m_nOutSampleRate) * g_nMaxAudioPeriodUs / 1000000;
+        m_nPacketFrames = uint32_t(MIN(MAX(uint64_t(objConfig.nPeriodFrames), nMinFrames), nMaxFrames));
+        m_nPeriodUs = uint32_t(uint64_t(m_nPacketFrames) * 1000000 / m_nOutSampleRate);
+        m_bCarry = m_nOutSampleRate != objFormat.nSampleRate || m_bDriftCompensation;
+        m_nMaxPeriodFrames = !m_bCarry ? m_nPacketFrames
+            : uint32_t((uint64_t(m_nPacketFrames + 1) * objFormat.nSampleRate + m_nOutSampleRate - 1) / m_nOutSampleRate);
+    }
+    else
+    {
+        m_nPeriodUs = objConfig.nPeriodUs ? objConfig.nPeriodUs : g_nDefaultAudioPeriodUs;
+        m_nPeriodUs = MIN(MAX(m_nPeriodUs, g_nMinAudioPeriodUs), g_nMaxAudioPeriodUs);
+        m_nMaxPeriodFrames = uint32_t((uint64_t(objFormat.nSampleRate) * m_nPeriodUs + 999999) / 1000000);
+    }
+    m_nPeriodRemainder = 0;
+    AdvancePeriod();
+
+    m_audioClock.Init(objFormat.nSampleRate);
+    m_nTimeOriginUs = -1;
+    m_nPeriodHostUs = -1;
+    m_bClockLocked = false;
+    m_nOutFrames = 0;
+
+    const uint32_t nOutChannels = m_audioRemixer.GetOutChannels();
+    m_nGapToleranceUs = objConfig.nGapToleranceUs;
+    m_nNextStreamUs = -1;
+    m_nSpliceRead = 0;
+    m_nSpliceCount = 0;
+    m_nDiscontinuityCount = 0;
+    m_nInsertedFrames = 0;
+    m_nDroppedFrames = 0;
+    m_bSpliceActive = false;
+    m_nTailEnd = 0;
+
+    m_bMetering = objConfig.bMetering;
+    m_eGateMode = (objConfig.eGateMode <= TYPE_CYAUDIO_GATE_SKIP) ? objConfig.eGateMode : TYPE_CYAUDIO_GATE_OFF;
+    m_bLevels = m_bMetering || m_eGateMode != TYPE_CYAUDIO_GATE_OFF;
+    if (m_bLevels && nOutChannels > g_nMaxAudioLevelChannels)
+    {
+        CY_LOG_WARN(TEXT("CYDevice: Audio metering supports %u channels, %u are delivered, metering and gate are off"), g_nMaxAudioLevelChannels, nOutChannels);
+        m_bLevels = m_bMetering = false;
+        m_eGateMode = TYPE_CYAUDIO_GATE_OFF;
+    }
+    m_audioMeter.Init(nOutChannels);
+    m_audioGate.Init(objConfig, m_nOutSampleRate);
+    m_bGateClosed = false;
+    m_nGatedFrames = 0;
+
+    // the fade is never longer than a period, so the tail of the last period always covers it.
+    const double dPi = 3.14159265358979323846;
+    m_nFadeFrames = uint32_t(uint64_t(objFormat.nSampleRate) * g_nAudioSpliceFadeUs / 1000000);
+    m_nFadeFrames = MAX(MIN(m_nFadeFrames, m_nMaxPeriodFrames - 1), 1u);
+    m_vecFade.resize(m_nFadeFrames);
+    for (uint32_t i = 0; i < m_nFadeFrames; ++i)
+        m_vecFade[i] = float(0.5 - 0.5 * cos(dPi * (i + 0.5) / m_nFadeFrames));
+    m_vecMirror.assign(size_t(m_nFadeFrames) * nOutChannels, 0.0f);
+    m_vecTail.assign(size_t(m_nFadeFrames) * nOutChannels, 0.0f);
+
+    // a batch waits in the ring on top of the usual periods. It holds its first period back for the
+    // periods after it at most, and a period more for writes that arrive late.
+    m_nBatchPeriods = MIN(objConfig.nBatchPeriods, g_nMaxAudioBatchPeriods);
+    m_nBatchPeriods = (m_nBatchPeriods > 1) ? m_nBatchPeriods : 0;
+    m_nBatchLatencyUs = m_nBatchPeriods * m_nPeriodUs;
+    if (objConfig.nBatchLatencyUs)
+        m_nBatchLatencyUs = MIN(m_nBatchLatencyUs, objConfig.nBatchLatencyUs);
+
+    // one period is mirrored behind the ring end so every period can be read in place.
+    size_t nRingFrames = MAX(size_t(objFormat.nSampleRate) * g_nAudioRingSeconds, size_t(m_nMaxPeriodFrames) * (g_nAudioRingPeriods + m_nBatchPeriods));
+    m_bJitterBuffer = objConfig.bJitterBuffer;
+    m_objSchedule.ePolicy = objConfig.eThreadPolicy;
+    m_objSchedule.nPriority = objConfig.nThreadPriority;
+    m_objSchedule.nCpuMask = objConfig.nThreadCpuMask;
+    m_objSchedule.nTimerSlackNs = objConfig.nTimerSlackNs;
+    m_objSchedule.bLockMemory = objConfig.bLockMemory;
+    m_audioJitter.Init(objConfig, uint32_t(uint64_t(nRingFrames) * 1000000 / objFormat.nSampleRate / 2));
+    m_nJitterUnderrunCount = 0;
+    m_nUnderrunPos = 0;
+    size_t nMaxPeriodBytes = size_t(m_nMaxPeriodFrames) * objFormat.nBlockAlign;
+    if (!m_audioRing.Init(nRingFrames * objFormat.nBlockAlign, objFormat.nBlockAlign, nMaxPeriodBytes))
+    {
+        CY_LOG_ERROR(TEXT("CYDevice: Could not allocate the audio ring buffer"));
+        return false;
+    }
+
+    // a remix converts on the way, otherwise F32 device audio is only copied into the convert buffer
+    // when a splice is concealed in it or stages run on it, and integer audio handed out as it is when
+    // it is metered.
+    if (!m_audioRemixer.IsPassthrough())
+        m_vecRemix.resize(size_t(m_nMaxPeriodFrames) * nOutChannels);
+    else
+        m_vecConvert.resize(size_t(m_nMaxPeriodFrames) * objFormat.nChannels);
+
+    // drift compensation needs a variable ratio, so it resamples even at the device rate.
+    m_nMaxOutFrames = m_nMaxPeriodFrames;
+    if ((m_nOutSampleRate != objFormat.nSampleRate || m_bDriftCompensation) && !InitResampler(objConfig.eResampleQuality))
+        return false;
+    if (m_bCarry)
+        m_nMaxOutFrames = m_nPacketFrames;
+
+    // stages that do not build are left out rather than failing the capture, SetStages can still add some.
+    if (!m_audioStages.Init(nOutChannels, m_nOutSampleRate, m_nMaxOutFrames, objConfig.pStages, objConfig.nStages))
+        CY_LOG_WARN(TEXT("CYDevice: Audio stages are not valid, delivering without them"));
+
+    //------------------------------------------------------------
+    // output format
+
+    m_eSampleFormat = (objConfig.eSampleFormat <= TYPE_CYAUDIO_SAMPLE_S32) ? objConfig.eSampleFormat : TYPE_CYAUDIO_SAMPLE_F32;
+    m_bPlanar = objConfig.bPlanar;
+    m_bDither = objConfig.bDither && m_eSampleFormat == TYPE_CYAUDIO_SAMPLE_S16;
+    InitDitherState(m_objDither, 0);
+
+    const uint32_t nSampleBytes = GetSampleFormatBytes(m_eSampleFormat);
+    // a single plane is laid out like interleaved mono.
+    const bool bInterleaved = !m_bPlanar || nOutChannels == 1;
+    m_bPassthrough = !m_ptrResampler && m_audioRemixer.IsPassthrough() && bInterleaved
+        && objFormat.ePcmFormat == GetPassthroughPcmFormat(m_eSampleFormat) && objFormat.nBlockAlign == objFormat.nChannels * nSampleBytes;
+
+    if (m_eSampleFormat != TYPE_CYAUDIO_SAMPLE_F32 || !bInterleaved)
+        m_vecOutput.resize(size_t(m_nMaxOutFrames) * nOutChannels * nSampleBytes);
+
+    if (m_nBatchPeriods)
+    {
+        m_nBatchSlotBytes = (size_t(m_nMaxOutFrames) * nOutChannels * nSampleBytes + g_nCacheLineSize - 1) & ~(g_nCacheLineSize - 1);
+        m_vecBatch.resize(m_nBatchPeriods);
+        m_vecBatchData.resize(m_nBatchSlotBytes * m_nBatchPeriods);
+        m_vecBatchLevels.resize(m_bMetering ? m_nBatchPeriods : 0);
+    }
+
+    CY_LOG_TRACE(TEXT("CYDevice: Audio pipeline period %u us, %u device frames, packet %u frames, %u output channels, %u Hz, format %d, planar %d, passthrough %d, batch %u"),
+        m_nPeriodUs, m_nMaxPeriodFrames, m_nPacketFrames, nOutChannels, m_nOutSampleRate, (int)m_eSampleFormat, (int)m_bPlanar, (int)m_bPassthrough, m_nBatchPeriods);
+    return true;
+}
+
+void CYAudioPipeline::UnInit()
+{
+    m_ptrResampler.reset();
+
+    m_audioRing.UnInit();
+    m_audioRemixer.UnInit();
+    m_audioStages.UnInit();
+    m_nPeriodFrames.store(0, std::memory_order_relaxed);
+    m_nMaxPeriodFrames = 0;
+    m_nMaxOutFrames = 0;
+    m_nPacketFrames = 0;
+    m_bCarry = false;
+    m_bPacketPending = false;
+    m_bCarryDiscontinuity = false;
+    m_nCarryFrames = 0;
+    m_nPendingBytes = 0;
+    m_nLoggedOverrunCount = 0;
+    m_nLoggedResyncCount = 0;
+    m_bPassthrough = false;
+    m_objReadPeriod = TAudioPeriod();
+    m_nReadOffset = 0;
+    m_nBatchPeriods = 0;
+}
+
+bool CYAudioPipeline::InitResampler(ECYAudioResampleQuality eQuality)
+{
+    const uint32_t nOutChannels = m_audioRemixer.GetOutChannels();
+
+    m_ptrResampler = CreateAudioResampler(eQuality, m_objFormat.nSampleRate, m_nOutSampleRate);
+    if (m_bDriftCompensation && !m_ptrResampler->SetRatioAdjust(1.0))
+    {
+        CY_LOG_TRACE(TEXT("CYDevice: Resampler tier %d runs a fixed ratio, drift compensation uses SINC_FASTEST"), (int)eQuality);
+        m_ptrResampler = CreateAudioResampler(TYPE_CYAUDIO_RESAMPLE_SINC_FASTEST, m_objFormat.nSampleRate, m_nOutSampleRate);
+    }
+
+    if (!m_ptrResampler->Init(m_objFormat.nSampleRate, m_nOutSampleRate, nOutChannels, m_nMaxPeriodFrames))
+    {
+        CY_LOG_WARN(TEXT("CYDevice: Resampler tier %d does not support %u Hz to %u Hz, using SINC_FASTEST"), (int)eQuality, m_objFormat.nSampleRate, m_nOutSampleRate);
+
+        m_ptrResampler = CreateAudioResampler(TYPE_CYAUDIO_RESAMPLE_SINC_FASTEST, m_objFormat.nSampleRate, m_nOutSampleRate);
+        if (!m_ptrResampler->Init(m_objFormat.nSampleRate, m_nOutSampleRate, nOutChannels, m_nMaxPeriodFrames))
+        {
+            m_ptrResampler.reset();
+            return false;
+        }
+    }
+
+    // a packet still being collected stays in front of the next output.
+    m_nMaxOutFrames = m_ptrResampler->GetMaxOutFrames(m_nMaxPeriodFrames);
+    m_vecResample.resize(size_t(m_nMaxOutFrames + (m_bCarry ? m_nPacketFrames : 0)) * nOutChannels);
+    return true;
+}
+
+void CYAudioPipeline::AdvancePeriod()
+{
+    // a packet at the device rate is one period, a resampled one takes what it still misses.
+    if (m_nPacketFrames)
+    {
+        const uint64_t nMissing = (m_nCarryFrames < m_nPacketFrames) ? m_nPacketFrames - m_nCarryFrames : 0;
+        m_nPeriodFrames.store(!m_bCarry ? m_nPacketFrames
+            : uint32_t(((nMissing + 1) * m_objFormat.nSampleRate + m_nOutSampleRate - 1) / m_nOutSampleRate), std::memory_order_relaxed);
+        return;
+    }
+
+    // whole frames of the next period, the fraction is carried so the average period is exact.
+    m_nPeriodRemainder += uint64_t(m_objFormat.nSampleRate) * m_nPeriodUs;
+    m_nPeriodFrames.store(uint32_t(m_nPeriodRemainder / 1000000), std::memory_order_relaxed);
+    m_nPeriodRemainder %= 1000000;
+}
+
+void CYAudioPipeline::UpdateClock(uint64_t nFramePos, TAudioPeriod& objPeriod, uint32_t nLeadFrames)
+{
+    // the period starts nLeadFrames output frames before device frame nFramePos.
+    const int64_t nLeadUs = int64_t(uint64_t(nLeadFrames) * 1000000 / m_nOutSampleRate);
+
+    UniqueLock locker(m_clockMutex);
+    objPeriod.dClockDriftPpm = 0.0;
+    objPeriod.nJitterDelayUs = 0;
+    if (!m_audioClock.IsValid() || m_nTimeOriginUs < 0)
+    {
+        objPeriod.nTimeStampUs = uint64_t(MAX(int64_t(nFramePos * 1000000 / m_objFormat.nSampleRate) - nLeadUs, int64_t(0)));
+        objPeriod.nTimeStamp = objPeriod.nTimeStampUs / 1000;
+        m_nPeriodHostUs = -1;
+        return;
+    }
+
+    const int64_t nDeviceUs = m_audioClock.GetFrameTimeUs(nFramePos);
+    const int64_t nFrameUs = nDeviceUs - nLeadUs;
+    m_nPeriodHostUs = nFrameUs;
+    objPeriod.nTimeStampUs = uint64_t(MAX(nFrameUs - m_nTimeOriginUs, int64_t(0)));
+    objPeriod.nTimeStamp = objPeriod.nTimeStampUs / 1000;
+    objPeriod.dClockDriftPpm = m_audioClock.GetDriftPpm();
+    objPeriod.nJitterDelayUs = (m_bJitterBuffer && m_pAudioDataCallBack) ? m_audioJitter.GetDelayUs() : 0;
+
+    if (!m_bDriftCompensation || !m_ptrResampler)
+        return;
+
+    // hold the nominal ratio until the loop settles, the phase is measured from the lock on.
+    if (!m_audioClock.IsLocked())
+    {
+        m_bClockLocked = false;
+        m_ptrResampler->SetRatioAdjust(1.0);
+        return;
+    }
+
+    if (!m_bClockLocked)
+    {
+        m_bClockLocked = true;
+        m_nLockTimeUs = nDeviceUs;
+        m_nLockOutFrames = m_nOutFrames;
+    }
+
+    // frames the host clock expects since the lock against the frames produced, in seconds.
+    const double dExpected = double(nDeviceUs - m_nLockTimeUs) * 1e-6 * m_nOutSampleRate;
+    const double dPhase = (dExpected - double(m_nOutFrames - m_nLockOutFrames)) / m_nOutSampleRate;
+    const double dCorrection = MIN(MAX(dPhase * g_dClockPhaseGain, -g_dMaxClockPhaseAdjust), g_dMaxClockPhaseAdjust);
+    m_ptrResampler->SetRatioAdjust(m_audioClock.GetRateRatio() * (1.0 + dCorrection));
+}
+
+bool CYAudioPipeline::UpdateSplice(uint64_t nFramePos, uint32_t nFrames, TAudioPeriod& objPeriod)
+{
+    UniqueLock locker(m_clockMutex);
+
+    objPeriod.bDiscontinuity = false;
+    objPeriod.nDiscontinuityCount = m_nDiscontinuityCount;
+    objPeriod.nInsertedFrames = m_nInsertedFrames;
+    objPeriod.nDroppedFrames = m_nDroppedFrames;
+
+    // a later splice replaces the one still fading, a splice a flush skipped over starts here.
+    while (m_nSpliceCount && m_arrSplices[m_nSpliceRead].nFramePos < nFramePos + nFrames)
+    {
+        m_objSplice = m_arrSplices[m_nSpliceRead];
+        if (m_objSplice.nFramePos < nFramePos)
+        {
+            m_objSplice.nGapFrames -= MIN(m_objSplice.nGapFrames, nFramePos - m_objSplice.nFramePos);
+            m_objSplice.nFramePos = nFramePos;
+        }
+
+        m_nSpliceRead = (m_nSpliceRead + 1) % g_nMaxAudioSplices;
+        --m_nSpliceCount;
+        m_bSpliceActive = true;
+        objPeriod.bDiscontinuity = true;
+    }
+
+    if (m_bSpliceActive && nFramePos >= m_objSplice.nFramePos + m_objSplice.nGapFrames + m_nFadeFrames)
+        m_bSpliceActive = false;
+
+    return m_bSpliceActive;
+}
+
+void CYAudioPipeline::ConcealSplice(float* pData, uint64_t nFramePos, uint32_t nFrames)
+{
+    const uint32_t nChannels = m_audioRemixer.GetOutChannels();
+    const uint64_t nSplice = m_objSplice.nFramePos;
+    const uint64_t nResume = nSplice + m_objSplice.nGapFrames;
+    const uint64_t nEnd = nFramePos + nFrames;
+
+    // the audio before the splice, newest frame first, from this period or the tail of the last one.
+    if (nSplice >= nFramePos && nSplice < nEnd)
+    {
+        const bool bTail = (m_nTailEnd == nFramePos);
+        for (uint32_t i = 0; i < m_nFadeFrames; ++i)
+        {
+            float* pMirror = m_vecMirror.data() + size_t(i) * nChannels;
+            const float* pSrc = nullptr;
+            if (nSplice > i)
+            {
+                const uint64_t nFrame = nSplice - 1 - i;
+                if (nFrame >= nFramePos)
+                    pSrc = pData + (nFrame - nFramePos) * nChannels;
+                else if (bTail && nFrame + m_nFadeFrames >= nFramePos)
+                    pSrc = m_vecTail.data() + (nFrame + m_nFadeFrames - nFramePos) * nChannels;
+            }
+
+            if (pSrc)
+                memcpy(pMirror, pSrc, nChannels * sizeof(float));
+            else
+                memset(pMirror, 0, nChannels * sizeof(float));
+        }
+    }
+
+    // the audio behind the gap fades in ...
+    for (uint64_t nFrame = MAX(nResume, nFramePos); nFrame < MIN(nResume + m_nFadeFrames, nEnd); ++nFrame)
+    {
+        const float fGain = m_vecFade[nFrame - nResume];
+        float* pFrame = pData + (nFrame - nFramePos) * nChannels;
+        for (uint32_t nChannel = 0; nChannel < nChannels; ++nChannel)
+            pFrame[nChannel] *= fGain;
+    }
+
+    // ... while the audio before it runs on mirrored and fades out, the two gains always sum to one.
+    for (uint64_t nFrame = MAX(nSplice, nFramePos); nFrame < MIN(nSplice + m_nFadeFrames, nEnd); ++nFrame)
+    {
+        const float fGain = m_vecFade[m_nFadeFrames - 1 - (nFrame - nSplice)];
+        const float* pMirror = m_vecMirror.data() + (nFrame - nSplice) * nChannels;
+        float* pFrame = pData + (nFrame - nFramePos) * nChannels;
+        for (uint32_t nChannel = 0; nChannel < nChannels; ++nChannel)
+            pFrame[nChannel] += pMirror[nChannel] * fGain;
+    }
+}
+
+void CYAudioPipeline::SaveTail(const void* pData, ECYPcmFormat ePcmFormat, uint32_t nFrames, uint64_t nTailEnd)
+{
+    // a period shorter than the fade pushes the tail on, behind a jump the older frames are silence.
+    const size_t nChannels = m_audioRemixer.GetOutChannels();
+    const uint32_t nCopyFrames = MIN(nFrames, m_nFadeFrames);
+    const size_t nKeep = size_t(m_nFadeFrames - nCopyFrames) * nChannels;
+    if (nKeep && m_nTailEnd + nFrames == nTailEnd)
+        memmove(m_vecTail.data(), m_vecTail.data() + m_vecTail.size() - nKeep, nKeep * sizeof(float));
+    else if (nKeep)
+        memset(m_vecTail.data(), 0, nKeep * sizeof(float));
+
+    const uint8_t* pTail = static_cast<const uint8_t*>(pData) + size_t(nFrames - nCopyFrames) * nChannels * GetPcmBytesPerSample(ePcmFormat);
+    ConvertToFloat(ePcmFormat, pTail, m_vecTail.data() + nKeep, size_t(nCopyFrames) * nChannels);
+    m_nTailEnd = nTailEnd;
+}
+
+bool CYAudioPipeline::Start(ICYAudioDataCallBack* pAudioDataCallBack)
+{
+    if (m_bRunning)
+        return false;
+
+    m_pAudioDataCallBack = pAudioDataCallBack;
+    m_wakeLatency.Reset();
+    m_nReadyUs = 0;
+    m_nWakeBytes = 0;
+    m_bRunning = true;
+
+    if (m_pAudioDataCallBack)
+        m_deliveryThread = std::thread(&CYAudioPipeline::OnDeliveryEntry, this);
+
+    return true;
+}
+
+void CYAudioPipeline::Stop()
+{
+    m_bRunning = false;
+    m_deliveryCV.notify_all();
+
+    if (m_deliveryThread.joinable())
+        m_deliveryThread.join();
+
+    LogCounters();
+    m_pAudioDataCallBack = nullptr;
+    ReleasePeriod();
+    Flush();
+    m_objReadPeriod = TAudioPeriod();
+    m_nReadOffset = 0;
+    m_nCarryFrames = 0;
+    m_bCarryDiscontinuity = false;
+    if (m_bCarry)
+        AdvancePeriod();
+
+    // the device clock restarts with the capture, the loop relocks without counting a resync.
+    UniqueLock locker(m_clockMutex);
+    m_audioClock.Reset();
+    m_audioJitter.Reset();
+    m_bClockLocked = false;
+    m_nNextStreamUs = -1;
+    m_nSpliceCount = 0;
+    m_bSpliceActive = false;
+}
+
+int64_t CYAudioPipeline::GetTimeOriginUs()
+{
+    UniqueLock locker(m_clockMutex);
+    return m_nTimeOriginUs;
+}
+
+void CYAudioPipeline::SetTimeOriginUs(int64_t nOriginUs)
+{
+    UniqueLock locker(m_clockMutex);
+    m_nTimeOriginUs = nOriginUs;
+}
+
+void CYAudioPipeline::Write(const void* pData, size_t nBytes, int64_t nHostUs, int64_t nStreamUs)
+{
+    if (!nBytes || !m_audioRing.GetCapacity())
+        return;
+
+    if (nHostUs < 0)
+        nHostUs = GetHostTimeUs();
+
+    const uint32_t nBlockAlign = m_objFormat.nBlockAlign;
+    const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+    uint64_t nFrames = nBytes / nBlockAlign;
+
+    // a gap is filled with silence up to the limit, an overlap is trimmed off the front of the packet.
+    // a jump back further than that is the source restarting its timeline and is only spliced.
+    const int64_t nOffsetFrames = CheckStreamTime(nStreamUs, nFrames);
+    const int64_t nMaxFillFrames = int64_t(uint64_t(m_objFormat.nSampleRate) * g_nMaxAudioGapFillUs / 1000000);
+    const uint64_t nSplicePos = m_audioRing.GetWritePos() / nBlockAlign;
+    uint64_t nGapFrames = 0, nSkipFrames = 0, nTrimFrames = 0;
+    if (nOffsetFrames > 0)
+    {
+        nGapFrames = m_audioRing.WriteSilence(size_t(MIN(nOffsetFrames, nMaxFillFrames)) * nBlockAlign) / nBlockAlign;
+        nSkipFrames = uint64_t(nOffsetFrames) - nGapFrames;
+    }
+    else if (nOffsetFrames < 0 && nOffsetFrames >= -nMaxFillFrames)
+    {
+        nTrimFrames = MIN(uint64_t(-nOffsetFrames), nFrames);
+        pBytes += nTrimFrames * nBlockAlign;
+        nFrames -= nTrimFrames;
+    }
+
+    const uint64_t nStored = nFrames ? m_audioRing.Write(pBytes, size_t(nFrames) * nBlockAlign) / nBlockAlign : 0;
+    const uint64_t nOverrunFrames = nFrames - nStored;
+
+    {
+        UniqueLock locker(m_clockMutex);
+        if (nOffsetFrames)
+        {
+            ++m_nDiscontinuityCount;
+            m_nInsertedFrames += nGapFrames;
+            m_nDroppedFrames += nTrimFrames;
+            PushSplice(nSplicePos, nGapFrames);
+        }
+        if (nOverrunFrames)
+        {
+            ++m_nDiscontinuityCount;
+            m_nDroppedFrames += nOverrunFrames;
+            PushSplice(nSplicePos + nGapFrames + nStored, 0);
+        }
+
+        // device frames that passed without entering the stream keep the clock loop in step.
+        if (nSkipFrames + nOverrunFrames)
+            m_audioClock.Skip(nSkipFrames + nOverrunFrames);
+
+        m_audioClock.Update(m_audioRing.GetWritePos() / nBlockAlign, nHostUs);
+        if (m_nTimeOriginUs < 0)
+            m_nTimeOriginUs = m_audioClock.GetFrameTimeUs(0);
+
+        // a burst arrives late by its own length, its first frame could have been delivered that much earlier.
+        if (m_bJitterBuffer && m_audioClock.IsValid())
+            m_audioJitter.Update(nHostUs - m_audioClock.GetFrameTimeUs(nSplicePos), nHostUs);
+    }
+
+    // nobody waits for less than a period, a batch is only woken for once it is complete.
+    if (m_audioRing.GetReadableForProducer() < MAX(m_nWakeBytes.load(std::memory_order_relaxed), GetPeriodBytes()))
+        return;
+    if (!m_nReadyUs.load(std::memory_order_relaxed))
+        m_nReadyUs.store(GetHostTimeUs(), std::memory_order_relaxed);
+
+    // passing through the lock orders the notify after the waiter either checked its predicate or blocked.
+    {
+        UniqueLock locker(m_deliveryMutex);
+    }
+    m_deliveryCV.notify_one();
+}
+
+int64_t CYAudioPipeline::CheckStreamTime(int64_t nStreamUs, uint64_t nFrames)
+{
+    if (nStreamUs < 0)
+    {
+        m_nNextStreamUs = -1;
+        return 0;
+    }
+
+    int64_t nOffsetFrames = 0;
+    const int64_t nDeltaUs = (m_nNextStreamUs >= 0) ? nStreamUs - m_nNextStreamUs : 0;
+    if (m_nGapToleranceUs && (nDeltaUs > int64_t(m_nGapToleranceUs) || nDeltaUs < -int64_t(m_nGapToleranceUs)))
+        nOffsetFrames = (nDeltaUs * int64_t(m_objFormat.nSampleRate) + ((nDeltaUs > 0) ? 500000 : -500000)) / 1000000;
+
+    // every packet sets the expectation for the next one, so timestamp jitter never adds up.
+    m_nNextStreamUs = nStreamUs + int64_t(nFrames * 1000000 / m_objFormat.nSampleRate);
+    return nOffsetFrames;
+}
+
+void CYAudioPipeline::PushSplice(uint64_t nFramePos, uint64_t nGapFrames)
+{
+    // a full queue only loses the fade, the stream itself stays continuous.
+    if (m_nSpliceCount == g_nMaxAudioSplices)
+        return;
+
+    TAudioSplice& objSplice = m_arrSplices[(m_nSpliceRead + m_nSpliceCount) % g_nMaxAudioSplices];
+    objSplice.nFramePos = nFramePos;
+    objSplice.nGapFrames = nGapFrames;
+    ++m_nSpliceCount;
+}
+
+void CYAudioPipeline::Flush()
+{
+    m_audioRing.Flush();
+}
+
+bool CYAudioPipeline::GetNextBuffer(TAudioPeriod& objPeriod)
+{
+    return NextPeriod(objPeriod, nullptr, 0);
+}
+
+bool CYAudioPipeline::Read(void* pDst, uint32_t nFrames, uint32_t nTimeoutMs, uint32_t& nReadFrames, uint64_t& nTimeStamp)
+{
+    nReadFrames = 0;
+    nTimeStamp = 0;
+    // the wait below ends on Stop, before Start it would not wait at all.
+    if (!pDst || !m_nPeriodFrames.load(std::memory_order_relaxed) || m_pAudioDataCallBack || !m_bRunning)
+        return false;
+
+    const uint32_t nOutChannels = m_audioRemixer.GetOutChannels();
+    const bool bPlanar = m_bPlanar && nOutChannels > 1;
+    const size_t nSampleBytes = GetSampleFormatBytes(m_eSampleFormat);
+    const size_t nFrameBytes = bPlanar ? nSampleBytes : nSampleBytes * nOutChannels;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(nTimeoutMs);
+    uint8_t* pBytes = static_cast<uint8_t*>(pDst);
+
+    while (nReadFrames < nFrames)
+    {
+        if (m_nReadOffset == m_objReadPeriod.nFrames)
+        {
+            // a whole period that fits is written to the caller memory by the output conversion.
+            const bool bDirect = nFrames - nReadFrames >= m_nMaxOutFrames;
+            void* pTarget = bDirect ? pBytes + nReadFrames * nFrameBytes : nullptr;
+            m_nReadOffset = 0;
+            if (!NextPeriod(m_objReadPeriod, pTarget, bPlanar ? nFrames : 0))
+            {
+                m_objReadPeriod.nFrames = 0;
+                UniqueLock locker(m_deliveryMutex);
+                if (!m_deliveryCV.wait_until(locker, deadline, [this]() { return !m_bRunning || m_audioRing.GetReadable() >= GetPeriodBytes(); }) || !m_bRunning)
+                    break;
+                continue;
+            }
+
+            if (bDirect)
+            {
+                if (!nReadFrames)
+                    nTimeStamp = m_objReadPeriod.nTimeStamp;
+                nReadFrames += m_objReadPeriod.nFrames;
+                m_nReadOffset = m_objReadPeriod.nFrames;
+                continue;
+            }
+        }
+
+        // the rest of the current period, or the part of it the caller has room for.
+        const uint32_t nCopyFrames = MIN(nFrames - nReadFrames, m_objReadPeriod.nFrames - m_nReadOffset);
+        const uint8_t* pSrc = static_cast<const uint8_t*>(m_objReadPeriod.pData);
+        if (!nReadFrames)
+            nTimeStamp = (m_objReadPeriod.nTimeStampUs + uint64_t(m_nReadOffset) * 1000000 / m_objReadPeriod.nSampleRate) / 1000;
+        if (!bPlanar)
+        {
+            memcpy(pBytes + nReadFrames * nFrameBytes, pSrc + m_nReadOffset * nFrameBytes, nCopyFrames * nFrameBytes);
+        }
+        else
+        {
+            for (uint32_t nChannel = 0; nChannel < nOutChannels; ++nChannel)
+            {
+                memcpy(pBytes + (size_t(nChannel) * nFrames + nReadFrames) * nSampleBytes,
+                    pSrc + (size_t(nChannel) * m_objReadPeriod.nFrames + m_nReadOffset) * nSampleBytes, nCopyFrames * nSampleBytes);
+            }
+        }
+        nReadFrames += nCopyFrames;
+        m_nReadOffset += nCopyFrames;
+    }
+
+    return true;
+}
+
+void CYAudioPipeline::GetSchedulingStats(TAudioSchedulingStats& objStats)
+{
+    LogCounters();
+    m_wakeLatency.Get(objStats);
+}
+
+void CYAudioPipeline::LogCounters()
+{
+    // the capture and delivery threads only count, what changed since the last call is logged here.
+    uint64_t nOverrunCount = 0, nLoggedOverrunCount = 0;
+    uint64_t nResyncCount = 0, nLoggedResyncCount = 0;
+    double dResyncError = 0.0;
+    {
+        UniqueLock locker(m_clockMutex);
+        nOverrunCount = m_audioRing.GetOverrunCount();
+        nLoggedOverrunCount = m_nLoggedOverrunCount;
+        m_nLoggedOverrunCount = nOverrunCount;
+        nResyncCount = m_audioClock.GetResyncCount();
+        nLoggedResyncCount = m_nLoggedResyncCount;
+        m_nLoggedResyncCount = nResyncCount;
+        dResyncError = m_audioClock.GetResyncError();
+    }
+
+    if (nOverrunCount != nLoggedOverrunCount)
+        CY_LOG_WARN(TEXT("CYDevice: Audio ring overrun, %llu times, %llu bytes dropped in total"), nOverrunCount, m_audioRing.GetOverrunBytes());
+    if (nResyncCount != nLoggedResyncCount)
+        CY_LOG_WARN(TEXT("CYDevice: Audio clock lost lock %llu times, the last %.1f ms off"), nResyncCount - nLoggedResyncCount, dResyncError * 1000.0);
+}
+
+bool CYAudioPipeline::NextPeriod(TAudioPeriod& objPeriod, void* pTarget, size_t nTargetStride)
+{
+    // periods the gate skips are consumed here, the caller only sees the next one that passes.
+    for (;;)
+    {
+        if (!ReadPeriod(objPeriod, pTarget, nTargetStride))
+            return false;
+        if (!objPeriod.bSilent || m_eGateMode != TYPE_CYAUDIO_GATE_SKIP)
+            return true;
+    }
+}
+
+bool CYAudioPipeline::ReadPeriod(TAudioPeriod& objPeriod, void* pTarget, size_t nTargetStride)
+{
+    ReleasePeriod();
+
+    const uint32_t nOutChannels = m_audioRemixer.GetOutChannels();
+    const bool bStages = m_audioStages.IsActive();
+    objPeriod.nChannels = nOutChannels;
+    objPeriod.nSampleRate = m_nOutSampleRate;
+    objPeriod.eSampleFormat = m_eSampleFormat;
+    objPeriod.bPlanar = m_bPlanar;
+    objPeriod.pLevels = nullptr;
+    objPeriod.bSilent = false;
+    objPeriod.bResume = false;
+    objPeriod.nGatedFrames = 0;
+
+    const float* pOutput = nullptr;
+    float* pWork = nullptr;
+    uint32_t nFrames = 0;
+    if (m_bCarry)
+    {
+        if (!CollectPacket(objPeriod))
+            return false;
+
+        nFrames = m_nPacketFrames;
+        pWork = m_vecResample.data();
+        pOutput = pWork;
+        m_bPacketPending = true;
+    }
+    else
+    {
+        // the period stays in the ring until it is released, the mirror keeps it contiguous.
+        size_t nPeriodBytes = GetPeriodBytes();
+        TRingView objView;
+        if (!nPeriodBytes || !m_audioRing.Peek(nPeriodBytes, objView))
+            return false;
+
+        m_nPendingBytes = nPeriodBytes;
+        objPeriod.nBufferedUs = uint32_t(uint64_t(m_audioRing.GetReadable() / m_objFormat.nBlockAlign) * 1000000 / m_objFormat.nSampleRate);
+        objPeriod.nJitterUnderrunCount = m_nJitterUnderrunCount;
+        objPeriod.nFramePos = m_nOutFrames;
+
+        const uint64_t nFramePos = m_audioRing.GetReadPos() / m_objFormat.nBlockAlign;
+        nFrames = m_nPeriodFrames.load(std::memory_order_relaxed);
+        UpdateClock(nFramePos, objPeriod);
+        const bool bSplice = UpdateSplice(nFramePos, nFrames, objPeriod);
+        AdvancePeriod();
+
+        if (m_bPassthrough && !bSplice && !bStages)
+        {
+            SaveTail(objView.pFirst, m_objFormat.ePcmFormat, nFrames, nFramePos + nFrames);
+            m_nOutFrames += nFrames;
+            objPeriod.pData = objView.pFirst;
+            objPeriod.nFrames = nFrames;
+            if (m_bLevels)
+            {
+                const float* pLevelData = reinterpret_cast<const float*>(objView.pFirst);
+                if (m_objFormat.ePcmFormat != TYPE_PCM_F32)
+                {
+                    ConvertToFloat(m_objFormat.ePcmFormat, objView.pFirst, m_vecConvert.data(), size_t(nFrames) * nOutChannels);
+                    pLevelData = m_vecConvert.data();
+                }
+                if (!UpdateLevels(pLevelData, nFrames, objPeriod))
+                    return true;
+            }
+            if (pTarget)
+            {
+                memcpy(pTarget, objView.pFirst, size_t(nFrames) * m_objFormat.nBlockAlign);
+                objPeriod.pData = pTarget;
+            }
+            return true;
+        }
+
+        nFrames = ProcessPeriod(objView.pFirst, nFramePos, nFrames, bSplice, bStages, m_vecResample.data(), pOutput, pWork);
+    }
+
+    //------------------------------------------------------------
+    // processing stages, in place on the buffer the period is in now.
+
+    if (bStages)
+        m_audioStages.Process(pWork, nFrames);
+
+    //------------------------------------------------------------
+    // output format, interleaved float is delivered as it is. The levels are taken on the way while
+    // the period is still in cache.
+
+    objPeriod.nFrames = nFrames;
+    if (m_bLevels && !UpdateLevels(pOutput, nFrames, objPeriod))
+        return true;
+
+    objPeriod.pData = pOutput;
+    if (pTarget)
+    {
+        ConvertFromFloat(m_eSampleFormat, m_bPlanar, pOutput, nOutChannels, nFrames, pTarget, m_bDither ? &m_objDither : nullptr, nTargetStride);
+        objPeriod.pData = pTarget;
+    }
+    else if (m_eSampleFormat != TYPE_CYAUDIO_SAMPLE_F32 || (m_bPlanar && nOutChannels > 1))
+    {
+        ConvertFromFloat(m_eSampleFormat, m_bPlanar, pOutput, nOutChannels, nFrames, m_vecOutput.data(), m_bDither ? &m_objDither : nullptr);
+        objPeriod.pData = m_vecOutput.data();
+    }
+
+    return true;
+}
+
+bool CYAudioPipeline::CollectPacket(TAudioPeriod& objPeriod)
+{
+    // periods are resampled behind the collected output until a packet is complete, a period that is
+    // not in the ring yet leaves the output collected so far for the next call.
+    const uint32_t nOutChannels = m_audioRemixer.GetOutChannels();
+    while (m_nCarryFrames < m_nPacketFrames)
+    {
+        const size_t nPeriodBytes = GetPeriodBytes();
+        TRingView objView;
+        if (!m_audioRing.Peek(nPeriodBytes, objView))
+            return false;
+
+        const uint64_t nFramePos = m_audioRing.GetReadPos() / m_objFormat.nBlockAlign;
+        const uint32_t nFrames = m_nPeriodFrames.load(std::memory_order_relaxed);
+        const bool bSplice = UpdateSplice(nFramePos, nFrames, objPeriod);
+        m_bCarryDiscontinuity = m_bCarryDiscontinuity || objPeriod.bDiscontinuity;
+
+        const float* pOutput = nullptr;
+        float* pWork = nullptr;
+        m_nCarryFrames += ProcessPeriod(objView.pFirst, nFramePos, nFrames, bSplice, false, m_vecResample.data() + size_t(m_nCarryFrames) * nOutChannels, pOutput, pWork);
+        m_audioRing.Consume(nPeriodBytes);
+        AdvancePeriod();
+    }
+
+    // the packet starts the collected frames before the next device frame, which times it to the frame.
+    const uint64_t nFramePos = m_audioRing.GetReadPos() / m_objFormat.nBlockAlign;
+    objPeriod.nBufferedUs = uint32_t(uint64_t(m_audioRing.GetReadable() / m_objFormat.nBlockAlign) * 1000000 / m_objFormat.nSampleRate);
+    objPeriod.nJitterUnderrunCount = m_nJitterUnderrunCount;
+    objPeriod.nFramePos = m_nOutFrames - m_nCarryFrames;
+    UpdateClock(nFramePos, objPeriod, m_nCarryFrames);
+    UpdateSplice(nFramePos, 0, objPeriod);
+    objPeriod.bDiscontinuity = objPeriod.bDiscontinuity || m_bCarryDiscontinuity;
+    m_bCarryDiscontinuity = false;
+    return true;
+}
+
+uint32_t CYAudioPipeline::ProcessPeriod(const uint8_t* pData, uint64_t nFramePos, uint32_t nFrames, bool bSplice, bool bStages, float* pResampled, const float*& pOutput, float*& pWork)
+{
+    //------------------------------------------------------------
+    // convert + channel remix + gain, one pass over the device audio
+
+    pOutput = reinterpret_cast<const float*>(pData);
+    pWork = nullptr;
+    if (!m_audioRemixer.IsPassthrough())
+    {
+        m_audioRemixer.Process(m_objFormat.ePcmFormat, pData, m_vecRemix.data(), nFrames);
+        pWork = m_vecRemix.data();
+    }
+    else if (m_objFormat.ePcmFormat != TYPE_PCM_F32 || bSplice || (bStages && !m_ptrResampler))
+    {
+        ConvertToFloat(m_objFormat.ePcmFormat, pData, m_vecConvert.data(), size_t(nFrames) * m_objFormat.nChannels);
+        pWork = m_vecConvert.data();
+    }
+
+    // the remix is linear, so concealing on the output channels equals concealing the device audio.
+    if (pWork)
+        pOutput = pWork;
+    if (bSplice)
+        ConcealSplice(pWork, nFramePos, nFrames);
+    SaveTail(pOutput, TYPE_PCM_F32, nFrames, nFramePos + nFrames);
+
+    //------------------------------------------------------------
+    // resample
+
+    if (m_ptrResampler)
+    {
+        nFrames = m_ptrResampler->Process(pOutput, nFrames, pResampled);
+        pWork = pResampled;
+        pOutput = pWork;
+    }
+    m_nOutFrames += nFrames;
+    return nFrames;
+}
+
+void CYAudioPipeline::ReleasePeriod()
+{
+    if (m_nPendingBytes)
+    {
+        m_audioRing.Consume(m_nPendingBytes);
+        m_nPendingBytes = 0;
+    }
+
+    // what the last period resampled beyond the packet is the start of the next one.
+    if (m_bPacketPending)
+    {
+        const size_t nOutChannels = m_audioRemixer.GetOutChannels();
+        m_nCarryFrames -= m_nPacketFrames;
+        memmove(m_vecResample.data(), m_vecResample.data() + size_t(m_nPacketFrames) * nOutChannels, size_t(m_nCarryFrames) * nOutChannels * sizeof(float));
+        m_bPacketPending = false;
+        AdvancePeriod();
+    }
+}
+
+bool CYAudioPipeline::UpdateLevels(const float* pData, uint32_t nFrames, TAudioPeriod& objPeriod)
+{
+    const TAudioLevels* pLevels = m_audioMeter.Process(pData, nFrames, objPeriod.nTimeStamp);
+    if (m_bMetering)
+    {
+        m_audioMeter.Publish();
+        objPeriod.pLevels = pLevels;
+    }
+
+    if (m_eGateMode == TYPE_CYAUDIO_GATE_OFF)
+        return true;
+
+    // false when the period is skipped, it is not converted to the output format then.
+    const bool bOpen = m_audioGate.Process(*pLevels);
+    objPeriod.bSilent = !bOpen;
+    objPeriod.bResume = bOpen && m_bGateClosed;
+    m_bGateClosed = !bOpen;
+    if (bOpen)
+    {
+        objPeriod.nGatedFrames = m_nGatedFrames;
+        m_nGatedFrames = 0;
+        return true;
+    }
+
+    if (m_eGateMode == TYPE_CYAUDIO_GATE_FLAG)
+        return true;
+    m_nGatedFrames += nFrames;
+    return false;
+}
+
+bool CYAudioPipeline::GetLevels(TAudioLevels& objLevels) const
+{
+    return m_audioMeter.GetLevels(objLevels);
+}
+
+void CYAudioPipeline::WaitRelease()
+{
+    const uint64_t nEndPos = m_audioRing.GetReadPos() / m_objFormat.nBlockAlign + m_nPeriodFrames.load(std::memory_order_relaxed);
+    int64_t nReleaseUs = -1;
+    {
+        UniqueLock locker(m_clockMutex);
+        if (m_audioClock.IsValid())
+            nReleaseUs = m_audioClock.GetFrameTimeUs(nEndPos) + m_audioJitter.GetDelayUs();
+    }
+    if (nReleaseUs < 0)
+        return;
+
+    const bool bWait = nReleaseUs > GetHostTimeUs();
+    {
+        const std::chrono::steady_clock::time_point releaseTime{ std::chrono::microseconds(nReleaseUs) };
+        UniqueLock locker(m_deliveryMutex);
+        m_deliveryCV.wait_until(locker, releaseTime, [this]() { return !m_bRunning; });
+    }
+    if (bWait && m_bRunning)
+        m_wakeLatency.Add(GetHostTimeUs() - nReleaseUs, m_nPeriodUs);
+
+    // counted once per period, the delivery loop waits for the rest of it as without the buffer.
+    if (m_bRunning && m_audioRing.GetReadable() < GetPeriodBytes() && nEndPos != m_nUnderrunPos)
+    {
+        m_nUnderrunPos = nEndPos;
+        ++m_nJitterUnderrunCount;
+        m_audioRing.CountUnderrun();
+    }
+}
+
+int64_t CYAudioPipeline::GetBatchDeadlineUs()
+{
+    // the first period of the batch is due when the device clock reaches its last frame, or at its
+    // release time with the jitter buffer, and is held back by the latency bound at most.
+    const uint64_t nEndPos = m_audioRing.GetReadPos() / m_objFormat.nBlockAlign + m_nPeriodFrames.load(std::memory_order_relaxed);
+    {
+        UniqueLock locker(m_clockMutex);
+        if (m_audioClock.IsValid())
+            return m_audioClock.GetFrameTimeUs(nEndPos) + (m_bJitterBuffer ? m_audioJitter.GetDelayUs() : 0) + m_nBatchLatencyUs;
+    }
+    return GetHostTimeUs() + m_nPeriodUs + m_nBatchLatencyUs;
+}
+
+void CYAudioPipeline::DeliverBatch()
+{
+    // every ready period up to the batch size, each converted into its own slot and released at once.
+    uint32_t nPeriods = 0;
+    {
+        CY_ALLOC_CHECK_SCOPE();
+        for (; nPeriods < m_nBatchPeriods; ++nPeriods)
+        {
+            TAudioPeriod& objPeriod = m_vecBatch[nPeriods];
+            if (!NextPeriod(objPeriod, m_vecBatchData.data() + m_nBatchSlotBytes * nPeriods, 0))
+                break;
+            if (objPeriod.pLevels && nPeriods < m_vecBatchLevels.size())
+            {
+                m_vecBatchLevels[nPeriods] = *objPeriod.pLevels;
+                objPeriod.pLevels = &m_vecBatchLevels[nPeriods];
+            }
+            ReleasePeriod();
+        }
+    }
+
+    if (nPeriods)
+        m_pAudioDataCallBack->OnAudioPeriods(m_vecBatch.data(), nPeriods);
+}
+
+void CYAudioPipeline::OnDeliveryEntry()
+{
+    const std::chrono::microseconds waitTime(m_nPeriodUs);
+
+    TThreadScheduleResult objSchedule;
+    ApplyThreadSchedule(m_objSchedule, objSchedule);
+    m_wakeLatency.SetSchedule(objSchedule);
+
+    while (m_bRunning)
+    {
+        if (m_bJitterBuffer)
+            WaitRelease();
+
+        // a batch is waited for in whole, a few frames over its periods cover their alternating lengths.
+        const size_t nWakeBytes = m_nBatchPeriods ? m_nBatchPeriods * (GetPeriodBytes() + m_objFormat.nBlockAlign) : GetPeriodBytes();
+        const int64_t nDeadlineUs = m_nBatchPeriods ? GetBatchDeadlineUs() : 0;
+
+        // the ready time is cleared before the check, a write after it stamps the period waited for.
+        bool bWait = false;
+        int64_t nDeadlineWakeUs = -1;
+        {
+            UniqueLock locker(m_deliveryMutex);
+            const auto isReady = [this, nWakeBytes]() { return !m_bRunning || m_audioRing.GetReadable() >= nWakeBytes; };
+            m_nReadyUs.store(0, std::memory_order_relaxed);
+            m_nWakeBytes.store(nWakeBytes, std::memory_order_relaxed);
+            bWait = !isReady();
+            if (bWait && m_nBatchPeriods)
+                m_deliveryCV.wait_until(locker, std::chrono::steady_clock::time_point{ std::chrono::microseconds(nDeadlineUs) }, isReady);
+            else if (bWait)
+                m_deliveryCV.wait_for(locker, waitTime, isReady);
+
+            // past the deadline the first period alone is enough, a late burst is not spun on. A batch cut
+            // short by the latency bound counts the wake-up against its deadline.
+            const auto isPeriodReady = [this]() { return !m_bRunning || m_audioRing.GetReadable() >= GetPeriodBytes(); };
+            if (bWait && m_nBatchPeriods && !isReady() && isPeriodReady())
+                nDeadlineWakeUs = GetHostTimeUs() - nDeadlineUs;
+            else if (m_nBatchPeriods && !isPeriodReady())
+            {
+                m_nWakeBytes.store(0, std::memory_order_relaxed);
+                m_deliveryCV.wait_for(locker, waitTime, isPeriodReady);
+            }
+
+            // a wait that ran out a whole period without one arriving missed a due period, the jitter
+            // buffer counts its own underruns at the release time.
+            if (bWait && !m_bJitterBuffer && !isPeriodReady())
+                m_audioRing.CountUnderrun();
+        }
+
+        if (!m_bRunning) break;
+
+        const int64_t nReadyUs = m_nReadyUs.load(std::memory_order_relaxed);
+        if (nDeadlineWakeUs >= 0)
+            m_wakeLatency.Add(nDeadlineWakeUs, m_nPeriodUs);
+        else if (bWait && nReadyUs && m_audioRing.GetReadable() >= nWakeBytes)
+            m_wakeLatency.Add(GetHostTimeUs() - nReadyUs, m_nPeriodUs);
+
+        if (m_nBatchPeriods)
+        {
+            DeliverBatch();
+            continue;
+        }
+
+        // released before the next wait, a flush seen by the wait must not be consumed into.
+        TAudioPeriod objPeriod;
+        bool bPeriod = false;
+        {
+            CY_ALLOC_CHECK_SCOPE();
+            bPeriod = GetNextBuffer(objPeriod);
+        }
+        if (bPeriod)
+            m_pAudioDataCallBack->OnAudioPeriod(objPeriod);
+        ReleasePeriod();
+    }
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,276 @@
+#ifndef __CY_AUDIO_PIPELINE_HPP__
+#define __CY_AUDIO_PIPELINE_HPP__
+
+#include "Audio/CYAudioDefine.hpp"
+#include "Audio/CYAudioClock.hpp"
+#include "Audio/CYAudioGate.hpp"
+#include "Audio/CYAudioJitter.hpp"
+#include "Audio/CYAudioMeter.hpp"
+#include "Audio/CYAudioRingBuffer.hpp"
+#include "Audio/CYAudioRemixer.hpp"
+#include "Audio/CYAudioStages.hpp"
+#include "Audio/Resample/ICYAudioResampler.hpp"
+#include "Common/CYThreadSchedule.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Platform independent audio path between a capture source and the consumer.
+ *
+ * The source writes device PCM from its own thread, the pipeline cuts it into periods of the
+ * configured length or into packets of a fixed frame count, converts and remixes them in one pass,
+ * resamples them, and timestamps every period with the host time of its first frame as tracked by the
+ * device clock loop. Gaps and overlaps in the source timestamps are filled or trimmed on the way in
+ * and faded out of the audio on the way out, so the periods stay continuous at a constant rate.
+ * Processing stages run on the float periods after the resampler and can be swapped while periods
+ * flow. The last stage writes the configured output format, a period the device already delivers in
+ * that format is handed out straight from the ring.
+ * With metering or the gate on, the levels of every period are measured just before the output
+ * conversion, periods the gate skips are consumed without being converted.
+ * With a callback the periods are pushed from a delivery thread that wakes once per period, or with
+ * the jitter buffer on when a period is due on the device clock plus the measured arrival jitter,
+ * otherwise they are pulled with GetNextBuffer, or read into caller memory with Read. The delivery
+ * thread applies the configured scheduling to itself and measures how late it wakes for each period.
+ * Batched delivery lets the producer wake it only once a whole batch is in the ring, or the device clock
+ * time of the first period plus the latency bound has passed, and hands out every ready period in one call.
+ */
+class CYAudioPipeline
+{
+public:
+    CYAudioPipeline();
+    ~CYAudioPipeline();
+
+    CYAudioPipeline(const CYAudioPipeline&) = delete;
+    CYAudioPipeline& operator=(const CYAudioPipeline&) = delete;
+
+public:
+    /**
+     * @brief Size every buffer for the format and configuration, nOutSampleRate 0 keeps the device rate.
+    */
+    bool Init(const TAudioSourceFormat& objFormat, uint32_t nOutSampleRate, const TAudioConfig& objConfig);
+    void UnInit();
+
+    /**
+     * @brief Push periods to the callback from the delivery thread.
+    */
+    bool Start(ICYAudioDataCallBack* pAudioDataCallBack);
+    void Stop();
+
+    /**
+     * @brief Producer side, called from the capture thread. nHostUs is the host time the data arrived
+     * at (GetHostTimeUs), -1 reads the clock. nStreamUs is the source timestamp of the first frame,
+     * -1 if the source has none.
+    */
+    void Write(const void* pData, size_t nBytes, int64_t nHostUs = -1, int64_t nStreamUs = -1);
+    void Flush();
+
+    /**
+     * @brief Consumer side, the period stays valid until ReleasePeriod or the next call.
+    */
+    bool GetNextBuffer(TAudioPeriod& objPeriod);
+    void ReleasePeriod();
+
+    /**
+     * @brief Consumer side, fill pDst with up to nFrames frames of the output format, planar output
+     * is written as planes of nFrames samples. Whole periods that fit are converted straight into
+     * pDst. Waits up to nTimeoutMs for data, 0 returns what is ready, and returns the frames read so
+     * far on timeout. nTimeStamp is the time of the first frame read. Only between Start without a
+     * callback and Stop, so a Stop wakes a waiting Read. Not to be mixed with GetNextBuffer.
+    */
+    bool Read(void* pDst, uint32_t nFrames, uint32_t nTimeoutMs, uint32_t& nReadFrames, uint64_t& nTimeStamp);
+
+    /**
+     * @brief Replace the processing stages from any thread, the next period fades over to them.
+    */
+    bool SetStages(const TAudioStage* pStages, uint32_t nStages) { return m_audioStages.Set(pStages, nStages); }
+
+    /**
+     * @brief Levels of the last delivered period, callable from any thread.
+    */
+    bool GetLevels(TAudioLevels& objLevels) const;
+
+    /**
+     * @brief Scheduling and wake-up latency of the delivery thread, callable from any thread. Logs the
+     * overruns and clock resyncs counted since the last call.
+    */
+    void GetSchedulingStats(TAudioSchedulingStats& objStats);
+
+    /**
+     * @brief Host time of the first device frame, -1 until the clock has seen a write. A pipeline fed
+     * from another one takes over its origin so both deliver on the same timeline.
+    */
+    int64_t GetTimeOriginUs();
+    void SetTimeOriginUs(int64_t nOriginUs);
+
+    /**
+     * @brief Consumer side, host time of the first frame of the last period, -1 before the clock is valid.
+    */
+    int64_t GetPeriodHostUs() const { return m_nPeriodHostUs; }
+
+    uint32_t GetOutChannels() const { return m_audioRemixer.GetOutChannels(); }
+    ECYAudioSampleFormat GetSampleFormat() const { return m_eSampleFormat; }
+    bool IsPlanar() const { return m_bPlanar; }
+    uint32_t GetOutSampleRate() const { return m_nOutSampleRate; }
+    uint32_t GetPeriodUs() const { return m_nPeriodUs; }
+
+    /**
+     * @brief Whether periods the device delivers in the output format are handed out straight from the ring.
+    */
+    bool IsPassthrough() const { return m_bPassthrough; }
+
+private:
+    bool InitResampler(ECYAudioResampleQuality eQuality);
+    bool NextPeriod(TAudioPeriod& objPeriod, void* pTarget, size_t nTargetStride);
+    bool ReadPeriod(TAudioPeriod& objPeriod, void* pTarget, size_t nTargetStride);
+    bool CollectPacket(TAudioPeriod& objPeriod);
+    uint32_t ProcessPeriod(const uint8_t* pData, uint64_t nFramePos, uint32_t nFrames, bool bSplice, bool bStages, float* pResampled, const float*& pOutput, float*& pWork);
+    bool UpdateLevels(const float* pData, uint32_t nFrames, TAudioPeriod& objPeriod);
+    void AdvancePeriod();
+    void UpdateClock(uint64_t nFramePos, TAudioPeriod& objPeriod, uint32_t nLeadFrames = 0);
+
+    int64_t CheckStreamTime(int64_t nStreamUs, uint64_t nFrames);
+    void PushSplice(uint64_t nFramePos, uint64_t nGapFrames);
+    bool UpdateSplice(uint64_t nFramePos, uint32_t nFrames, TAudioPeriod& objPeriod);
+    void ConcealSplice(float* pData, uint64_t nFramePos, uint32_t nFrames);
+    void SaveTail(const void* pData, ECYPcmFormat ePcmFormat, uint32_t nFrames, uint64_t nTailEnd);
+    size_t GetPeriodBytes() const { return size_t(m_nPeriodFrames.load(std::memory_order_relaxed)) * m_objFormat.nBlockAlign; }
+
+    void WaitRelease();
+    int64_t GetBatchDeadlineUs();
+    void DeliverBatch();
+    void OnDeliveryEntry();
+    void LogCounters();
+
+private:
+    TAudioSourceFormat m_objFormat;
+    uint32_t m_nOutSampleRate = 0;
+
+    CYAudioRingBuffer m_audioRing;
+    CYAudioRemixer m_audioRemixer;
+
+    UniquePtr<ICYAudioResampler> m_ptrResampler;
+    uint32_t m_nMaxOutFrames = 0;
+
+    ECYAudioSampleFormat m_eSampleFormat = TYPE_CYAUDIO_SAMPLE_F32;
+    bool m_bPlanar = false;
+    bool m_bDither = false;
+    bool m_bPassthrough = false;
+    TDitherState m_objDither;
+
+    // Bytes of the delivered period still in the ring, consumed once the consumer is done with it.
+    size_t m_nPendingBytes = 0;
+
+    // Device frames of the next period, the remainder carries the fractional frames in millionths.
+    // The consumer advances the period, the producer reads it to know when one is ready.
+    uint32_t m_nPeriodUs = g_nDefaultAudioPeriodUs;
+    std::atomic<uint32_t> m_nPeriodFrames{ 0 };
+    uint32_t m_nMaxPeriodFrames = 0;
+    uint64_t m_nPeriodRemainder = 0;
+
+    // Fixed packet length in output frames, 0 cuts the periods by time. With a resampler the output is
+    // collected in m_vecResample until a packet is complete, m_nCarryFrames of it are there already and
+    // the delivered packet is removed from the front on release.
+    uint32_t m_nPacketFrames = 0;
+    bool m_bCarry = false;
+    bool m_bPacketPending = false;
+    bool m_bCarryDiscontinuity = false;
+    uint32_t m_nCarryFrames = 0;
+
+    // Device clock against the host clock and the splice queue, updated by the producer and read by the consumer.
+    std::mutex m_clockMutex;
+    CYAudioClock m_audioClock;
+    int64_t m_nTimeOriginUs = -1;               // host time of the first device frame
+    int64_t m_nPeriodHostUs = -1;
+
+    // Release delay of the callback periods, measured by the producer on the same clock.
+    bool m_bJitterBuffer = false;
+    CYAudioJitter m_audioJitter;
+    uint32_t m_nJitterUnderrunCount = 0;        // consumer side
+    uint64_t m_nUnderrunPos = 0;
+
+    // Drift compensation holds the output frames to the host time passed since the clock locked.
+    bool m_bDriftCompensation = false;
+    bool m_bClockLocked = false;
+    int64_t m_nLockTimeUs = 0;
+    uint64_t m_nLockOutFrames = 0;
+    uint64_t m_nOutFrames = 0;
+
+    // Source timestamp the next write should start at, producer side.
+    uint32_t m_nGapToleranceUs = 0;
+    int64_t m_nNextStreamUs = -1;
+
+    // Splices waiting for the consumer and the totals handed out with every period.
+    TAudioSplice m_arrSplices[g_nMaxAudioSplices];
+    uint32_t m_nSpliceRead = 0;
+    uint32_t m_nSpliceCount = 0;
+    uint32_t m_nDiscontinuityCount = 0;
+    uint64_t m_nInsertedFrames = 0;
+    uint64_t m_nDroppedFrames = 0;
+
+    // Splice being concealed, consumer side, on the remixed channels. The audio before the splice fades
+    // out mirrored into the gap while the audio behind it fades in, the tail keeps the end of the last
+    // period for it.
+    bool m_bSpliceActive = false;
+    TAudioSplice m_objSplice;
+    uint32_t m_nFadeFrames = 0;
+    std::vector<float> m_vecFade;               // raised cosine, 0 to 1
+    std::vector<float> m_vecMirror;
+    std::vector<float> m_vecTail;
+    uint64_t m_nTailEnd = 0;
+
+    CYAudioStages m_audioStages;
+
+    // levels of the delivered periods and the gate on them, consumer side.
+    bool m_bLevels = false;
+    bool m_bMetering = false;
+    CYAudioMeter m_audioMeter;
+    ECYAudioGateMode m_eGateMode = TYPE_CYAUDIO_GATE_OFF;
+    CYAudioGate m_audioGate;
+    bool m_bGateClosed = false;
+    uint64_t m_nGatedFrames = 0;
+
+    std::vector<float> m_vecConvert;
+    std::vector<float> m_vecRemix;
+    std::vector<float> m_vecResample;
+    std::vector<uint8_t> m_vecOutput;
+
+    // counts the capture and delivery threads keep, as far as LogCounters reported them.
+    uint64_t m_nLoggedOverrunCount = 0;
+    uint64_t m_nLoggedResyncCount = 0;
+
+    // Period Read is copying from, frames before m_nReadOffset went to the caller already.
+    TAudioPeriod m_objReadPeriod;
+    uint32_t m_nReadOffset = 0;
+
+    std::atomic<bool> m_bRunning{ false };
+    std::mutex m_deliveryMutex;
+    std::condition_variable m_deliveryCV;
+    std::thread m_deliveryThread;
+    ICYAudioDataCallBack* m_pAudioDataCallBack = nullptr;
+
+    // Batched delivery, every period of a batch is written to a slot of its own and carries its own
+    // copy of the levels, so all of them stay valid during the one callback.
+    uint32_t m_nBatchPeriods = 0;
+    uint32_t m_nBatchLatencyUs = 0;
+    size_t m_nBatchSlotBytes = 0;
+    std::vector<TAudioPeriod> m_vecBatch;
+    std::vector<TAudioLevels> m_vecBatchLevels;
+    std::vector<uint8_t> m_vecBatchData;
+
+    // m_nReadyUs is when the ring filled up to what the delivery thread waits for, 0 before. The producer
+    // only wakes it from there, m_nWakeBytes is at least one period.
+    TThreadSchedule m_objSchedule;
+    CYWakeLatency m_wakeLatency;
+    std::atomic<int64_t> m_nReadyUs{ 0 };
+    std::atomic<size_t> m_nWakeBytes{ 0 };
+};
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_AUDIO_PIPELINE_HPP__
\ No newline at end of file
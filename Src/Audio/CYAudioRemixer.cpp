@@ -0,0 +1,394 @@
+#include "Audio/CYAudioRemixer.hpp"
+#include "Audio/CYAudioConvert.hpp"
+#include "Audio/Simd/CYAudioKernels.hpp"
+#include "Common/CYDevicePrivDefine.hpp"
+
+#include <math.h>
+#include <string.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+static constexpr uint32_t g_nSpeakerMaskMono = TYPE_SPEAKER_FRONT_CENTER;
+static constexpr uint32_t g_nSpeakerMaskStereo = TYPE_SPEAKER_FRONT_LEFT | TYPE_SPEAKER_FRONT_RIGHT;
+static constexpr uint32_t g_nSpeakerMask2Point1 = g_nSpeakerMaskStereo | TYPE_SPEAKER_LOW_FREQUENCY;
+static constexpr uint32_t g_nSpeakerMaskQuad = g_nSpeakerMaskStereo | TYPE_SPEAKER_BACK_LEFT | TYPE_SPEAKER_BACK_RIGHT;
+static constexpr uint32_t g_nSpeakerMask5Point0 = g_nSpeakerMaskQuad | TYPE_SPEAKER_FRONT_CENTER;
+static constexpr uint32_t g_nSpeakerMask5Point1Back = g_nSpeakerMask5Point0 | TYPE_SPEAKER_LOW_FREQUENCY;
+static constexpr uint32_t g_nSpeakerMask5Point1 = g_nSpeakerMaskStereo | TYPE_SPEAKER_FRONT_CENTER | TYPE_SPEAKER_LOW_FREQUENCY | TYPE_SPEAKER_SIDE_LEFT | TYPE_SPEAKER_SIDE_RIGHT;
+static constexpr uint32_t g_nSpeakerMask6Point1 = g_nSpeakerMask5Point1 | TYPE_SPEAKER_BACK_CENTER;
+static constexpr uint32_t g_nSpeakerMask7Point1 = g_nSpeakerMask5Point1 | TYPE_SPEAKER_BACK_LEFT | TYPE_SPEAKER_BACK_RIGHT;
+
+CYAudioRemixer::CYAudioRemixer()
+{
+}
+
+CYAudioRemixer::~CYAudioRemixer()
+{
+}
+
+uint32_t CYAudioRemixer::GetDefaultChannelMask(uint32_t nChannels)
+{
+    switch (nChannels)
+    {
+    case 1:
+        return g_nSpeakerMaskMono;
+    case 2:
+        return g_nSpeakerMaskStereo;
+    case 3:
+        return g_nSpeakerMask2Point1;
+    case 4:
+        return g_nSpeakerMaskQuad;
+    case 5:
+        return g_nSpeakerMask5Point0;
+    case 6:
+        return g_nSpeakerMask5Point1Back;
+    case 7:
+        return g_nSpeakerMask6Point1;
+    default:
+        // channels past the eighth have no position and are dropped.
+        return (nChannels >= 8) ? g_nSpeakerMask7Point1 : 0;
+    }
+}
+
+uint32_t CYAudioRemixer::GetLayoutChannelMask(ECYAudioChannelLayout eLayout)
+{
+    switch (eLayout)
+    {
+    case TYPE_CYAUDIO_LAYOUT_MONO:
+        return g_nSpeakerMaskMono;
+    case TYPE_CYAUDIO_LAYOUT_STEREO:
+        return g_nSpeakerMaskStereo;
+    case TYPE_CYAUDIO_LAYOUT_5POINT1:
+        return g_nSpeakerMask5Point1;
+    case TYPE_CYAUDIO_LAYOUT_7POINT1:
+        return g_nSpeakerMask7Point1;
+    default:
+        return 0;
+    }
+}
+
+bool CYAudioRemixer::Init(uint32_t nInChannels, uint32_t nInChannelMask, const TAudioConfig& objConfig)
+{
+    UnInit();
+
+    if (!nInChannels)
+        return false;
+
+    m_objPlan.nInChannels = nInChannels;
+
+    if (objConfig.eChannelLayout == TYPE_CYAUDIO_LAYOUT_NATIVE)
+    {
+        m_objPlan.nOutChannels = nInChannels;
+        m_nOutChannelMask = nInChannelMask ? nInChannelMask : GetDefaultChannelMask(nInChannels);
+        m_bPassthrough = true;
+        if (objConfig.fGain == 1.0f)
+            return true;
+
+        if (nInChannels > g_nMaxRemixChannels)
+        {
+            CY_LOG_WARN(TEXT("CYDevice: Audio gain ignored, %u channels exceed the remix matrix"), nInChannels);
+            return true;
+        }
+
+        for (uint32_t nChannel = 0; nChannel < nInChannels; ++nChannel)
+            m_arrMatrix[nChannel * g_nMaxRemixChannels + nChannel] = 1.0f;
+    }
+    else if (objConfig.eChannelLayout == TYPE_CYAUDIO_LAYOUT_CUSTOM)
+    {
+        if (!BuildCustomMatrix(objConfig))
+            return false;
+    }
+    else
+    {
+        if (nInChannels > g_nMaxRemixChannels)
+            return false;
+
+        uint32_t nOutChannelMask = GetLayoutChannelMask(objConfig.eChannelLayout);
+        if (!nOutChannelMask)
+            return false;
+
+        if (!BuildSpeakerMatrix(nInChannelMask ? nInChannelMask : GetDefaultChannelMask(nInChannels), nOutChannelMask))
+            return false;
+    }
+
+    ApplyGain(objConfig.fGain);
+    BuildPlan();
+    return true;
+}
+
+void CYAudioRemixer::UnInit()
+{
+    m_objPlan = TRemixPlan();
+    memset(m_arrMatrix, 0, sizeof(m_arrMatrix));
+    m_nOutChannelMask = 0;
+    m_nInChannelMask = 0;
+    m_fSurroundShare = 1.0f;
+    m_bPassthrough = true;
+    memset(m_arrKernels, 0, sizeof(m_arrKernels));
+    m_bMonoToStereo = false;
+}
+
+bool CYAudioRemixer::BuildCustomMatrix(const TAudioConfig& objConfig)
+{
+    const uint32_t nInChannels = m_objPlan.nInChannels;
+    if (!objConfig.pCustomMatrix || objConfig.nCustomInChannels != nInChannels || nInChannels > g_nMaxRemixChannels ||
+        !objConfig.nCustomOutChannels || objConfig.nCustomOutChannels > g_nMaxRemixChannels)
+        return false;
+
+    m_objPlan.nOutChannels = objConfig.nCustomOutChannels;
+    for (uint32_t nOut = 0; nOut < m_objPlan.nOutChannels; ++nOut)
+    {
+        for (uint32_t nIn = 0; nIn < nInChannels; ++nIn)
+            m_arrMatrix[nOut * g_nMaxRemixChannels + nIn] = objConfig.pCustomMatrix[nOut * nInChannels + nIn];
+    }
+
+    return true;
+}
+
+bool CYAudioRemixer::BuildSpeakerMatrix(uint32_t nInChannelMask, uint32_t nOutChannelMask)
+{
+    m_nInChannelMask = nInChannelMask;
+    m_nOutChannelMask = nOutChannelMask;
+
+    uint32_t nOutChannels = 0;
+    for (uint32_t nBit = 0; nBit < g_nSpeakerPositions; ++nBit)
+    {
+        if (nOutChannelMask & (1u << nBit))
+            ++nOutChannels;
+    }
+    m_objPlan.nOutChannels = nOutChannels;
+
+    // back and side pairs that end up on the same speakers are averaged, as a 7.1 to 5.1 fold does.
+    const uint32_t nBackMask = TYPE_SPEAKER_BACK_LEFT | TYPE_SPEAKER_BACK_RIGHT;
+    const uint32_t nSideMask = TYPE_SPEAKER_SIDE_LEFT | TYPE_SPEAKER_SIDE_RIGHT;
+    bool bBothSurrounds = (nInChannelMask & nBackMask) && (nInChannelMask & nSideMask);
+    bool bOutBothSurrounds = (nOutChannelMask & nBackMask) && (nOutChannelMask & nSideMask);
+    m_fSurroundShare = (bBothSurrounds && !bOutBothSurrounds) ? 0.5f : 1.0f;
+
+    // the n-th set bit of the mask belongs to the n-th interleaved channel, the rest have no position.
+    uint32_t nInChannel = 0;
+    for (uint32_t nBit = 0; nBit < g_nSpeakerPositions && nInChannel < m_objPlan.nInChannels; ++nBit)
+    {
+        uint32_t nSpeaker = 1u << nBit;
+        if (!(nInChannelMask & nSpeaker))
+            continue;
+
+        float fGain = (nSpeaker & (nBackMask | nSideMask)) ? m_fSurroundShare : 1.0f;
+        Route(nInChannel++, nSpeaker, fGain, 0);
+    }
+
+    // attenuate the whole matrix when an output could exceed full scale, keeps the balance between outputs.
+    float fMaxSum = 0.0f;
+    for (uint32_t nOut = 0; nOut < nOutChannels; ++nOut)
+    {
+        float fSum = 0.0f;
+        for (uint32_t nIn = 0; nIn < m_objPlan.nInChannels; ++nIn)
+            fSum += fabsf(m_arrMatrix[nOut * g_nMaxRemixChannels + nIn]);
+        fMaxSum = MAX(fMaxSum, fSum);
+    }
+
+    if (fMaxSum > 1.0f)
+    {
+        float fScale = 1.0f / fMaxSum;
+        for (float& fCoeff : m_arrMatrix)
+            fCoeff *= fScale;
+    }
+
+    return true;
+}
+
+int CYAudioRemixer::FindOutChannel(uint32_t nSpeaker) const
+{
+    if (!(m_nOutChannelMask & nSpeaker))
+        return -1;
+
+    int nIndex = 0;
+    for (uint32_t nBit = 1; nBit < nSpeaker; nBit <<= 1)
+    {
+        if (m_nOutChannelMask & nBit)
+            ++nIndex;
+    }
+    return nIndex;
+}
+
+void CYAudioRemixer::Route(uint32_t nInChannel, uint32_t nSpeaker, float fGain, uint32_t nDepth)
+{
+    int nOut = FindOutChannel(nSpeaker);
+    if (nOut >= 0)
+    {
+        m_arrMatrix[nOut * g_nMaxRemixChannels + nInChannel] += fGain;
+        return;
+    }
+
+    // every fold moves towards the front speakers, the output layouts always have those.
+    if (nDepth > 4)
+        return;
+    ++nDepth;
+
+    switch (nSpeaker)
+    {
+    case TYPE_SPEAKER_FRONT_LEFT:
+    case TYPE_SPEAKER_FRONT_RIGHT:
+        Route(nInChannel, TYPE_SPEAKER_FRONT_CENTER, fGain * g_fDbMinus3, nDepth);
+        break;
+    case TYPE_SPEAKER_FRONT_CENTER:
+    {
+        // a mono source is copied to both sides, a real center is mixed in.
+        float fCenterGain = (m_nInChannelMask == g_nSpeakerMaskMono) ? fGain : fGain * g_fCenterMix;
+        Route(nInChannel, TYPE_SPEAKER_FRONT_LEFT, fCenterGain, nDepth);
+        Route(nInChannel, TYPE_SPEAKER_FRONT_RIGHT, fCenterGain, nDepth);
+        break;
+    }
+    case TYPE_SPEAKER_LOW_FREQUENCY:
+        // dropped when the output has no LFE, like the previous downmix did.
+        break;
+    case TYPE_SPEAKER_BACK_LEFT:
+        if (m_nOutChannelMask & TYPE_SPEAKER_SIDE_LEFT)
+            Route(nInChannel, TYPE_SPEAKER_SIDE_LEFT, fGain, nDepth);
+        else
+            Route(nInChannel, TYPE_SPEAKER_FRONT_LEFT, fGain * g_fSurroundMix, nDepth);
+        break;
+    case TYPE_SPEAKER_BACK_RIGHT:
+        if (m_nOutChannelMask & TYPE_SPEAKER_SIDE_RIGHT)
+            Route(nInChannel, TYPE_SPEAKER_SIDE_RIGHT, fGain, nDepth);
+        else
+            Route(nInChannel, TYPE_SPEAKER_FRONT_RIGHT, fGain * g_fSurroundMix, nDepth);
+        break;
+    case TYPE_SPEAKER_SIDE_LEFT:
+        if (m_nOutChannelMask & TYPE_SPEAKER_BACK_LEFT)
+            Route(nInChannel, TYPE_SPEAKER_BACK_LEFT, fGain, nDepth);
+        else
+            Route(nInChannel, TYPE_SPEAKER_FRONT_LEFT, fGain * g_fSurroundMix, nDepth);
+        break;
+    case TYPE_SPEAKER_SIDE_RIGHT:
+        if (m_nOutChannelMask & TYPE_SPEAKER_BACK_RIGHT)
+            Route(nInChannel, TYPE_SPEAKER_BACK_RIGHT, fGain, nDepth);
+        else
+            Route(nInChannel, TYPE_SPEAKER_FRONT_RIGHT, fGain * g_fSurroundMix, nDepth);
+        break;
+    case TYPE_SPEAKER_BACK_CENTER:
+        Route(nInChannel, TYPE_SPEAKER_BACK_LEFT, fGain * g_fDbMinus3, nDepth);
+        Route(nInChannel, TYPE_SPEAKER_BACK_RIGHT, fGain * g_fDbMinus3, nDepth);
+        break;
+    case TYPE_SPEAKER_FRONT_LEFT_OF_CENTER:
+    case TYPE_SPEAKER_TOP_FRONT_LEFT:
+        Route(nInChannel, TYPE_SPEAKER_FRONT_LEFT, fGain, nDepth);
+        break;
+    case TYPE_SPEAKER_FRONT_RIGHT_OF_CENTER:
+    case TYPE_SPEAKER_TOP_FRONT_RIGHT:
+        Route(nInChannel, TYPE_SPEAKER_FRONT_RIGHT, fGain, nDepth);
+        break;
+    case TYPE_SPEAKER_TOP_CENTER:
+    case TYPE_SPEAKER_TOP_FRONT_CENTER:
+        Route(nInChannel, TYPE_SPEAKER_FRONT_CENTER, fGain, nDepth);
+        break;
+    case TYPE_SPEAKER_TOP_BACK_LEFT:
+        Route(nInChannel, TYPE_SPEAKER_BACK_LEFT, fGain, nDepth);
+        break;
+    case TYPE_SPEAKER_TOP_BACK_CENTER:
+        Route(nInChannel, TYPE_SPEAKER_BACK_CENTER, fGain, nDepth);
+        break;
+    case TYPE_SPEAKER_TOP_BACK_RIGHT:
+        Route(nInChannel, TYPE_SPEAKER_BACK_RIGHT, fGain, nDepth);
+        break;
+    default:
+        break;
+    }
+}
+
+void CYAudioRemixer::ApplyGain(float fGain)
+{
+    if (fGain == 1.0f)
+        return;
+
+    for (float& fCoeff : m_arrMatrix)
+        fCoeff *= fGain;
+}
+
+void CYAudioRemixer::BuildPlan()
+{
+    const uint32_t nInChannels = MIN(m_objPlan.nInChannels, g_nMaxRemixChannels);
+    const uint32_t nOutChannels = m_objPlan.nOutChannels;
+
+    // keep only the input channels with a coefficient, the kernels never touch the others.
+    m_objPlan.nUsedChannels = 0;
+    for (uint32_t nIn = 0; nIn < nInChannels; ++nIn)
+    {
+        bool bUsed = false;
+        for (uint32_t nOut = 0; nOut < nOutChannels && !bUsed; ++nOut)
+            bUsed = (m_arrMatrix[nOut * g_nMaxRemixChannels + nIn] != 0.0f);
+
+        if (!bUsed)
+            continue;
+
+        uint32_t nUsed = m_objPlan.nUsedChannels++;
+        m_objPlan.arrUsedChannels[nUsed] = nIn;
+        for (uint32_t nOut = 0; nOut < nOutChannels; ++nOut)
+            m_objPlan.arrCoeffs[nOut * g_nMaxRemixChannels + nUsed] = m_arrMatrix[nOut * g_nMaxRemixChannels + nIn];
+    }
+
+    // a diagonal matrix with one gain keeps the layout, unity gain skips the remix altogether.
+    bool bScale = (m_objPlan.nInChannels == nOutChannels);
+    const float fScale = m_arrMatrix[0];
+    for (uint32_t nOut = 0; nOut < nOutChannels && bScale; ++nOut)
+    {
+        for (uint32_t nIn = 0; nIn < nInChannels && bScale; ++nIn)
+            bScale = (m_arrMatrix[nOut * g_nMaxRemixChannels + nIn] == ((nOut == nIn) ? fScale : 0.0f));
+    }
+
+    if (bScale)
+        m_objPlan.eShape = TYPE_REMIX_SCALE;
+    else if (nOutChannels == 1)
+        m_objPlan.eShape = TYPE_REMIX_MONO;
+    else if (nOutChannels == 2)
+        m_objPlan.eShape = TYPE_REMIX_STEREO;
+    else
+        m_objPlan.eShape = TYPE_REMIX_ANY;
+
+    m_objPlan.fScale = bScale ? fScale : 1.0f;
+    m_bPassthrough = bScale && (fScale == 1.0f);
+    BindKernels();
+}
+
+void CYAudioRemixer::BindKernels()
+{
+    const TAudioKernels& objKernels = GetAudioKernels();
+    const bool bFixed = (m_objPlan.eShape == TYPE_REMIX_MONO || m_objPlan.eShape == TYPE_REMIX_STEREO)
+        && m_objPlan.nUsedChannels >= 1 && m_objPlan.nUsedChannels <= g_nMaxFixedRemixChannels;
+
+    for (uint32_t nFormat = 0; nFormat < g_nRemixPcmFormats; ++nFormat)
+    {
+        m_arrKernels[nFormat] = bFixed ? objKernels.arrConvertRemixFixed[nFormat][m_objPlan.eShape - TYPE_REMIX_MONO][m_objPlan.nUsedChannels - 1]
+            : objKernels.arrConvertRemix[nFormat][m_objPlan.eShape];
+    }
+
+    // unity mono to stereo float is a plain duplicate.
+    m_bMonoToStereo = m_objPlan.nInChannels == 1 && m_objPlan.nOutChannels == 2 && m_objPlan.nUsedChannels == 1 &&
+        m_objPlan.arrCoeffs[0] == 1.0f && m_objPlan.arrCoeffs[g_nMaxRemixChannels] == 1.0f;
+}
+
+void CYAudioRemixer::Process(const float* pSrc, float* pDst, size_t nFrames) const
+{
+    Process(TYPE_PCM_F32, pSrc, pDst, nFrames);
+}
+
+bool CYAudioRemixer::Process(ECYPcmFormat ePcmFormat, const void* pSrc, float* pDst, size_t nFrames) const
+{
+    if (m_bPassthrough)
+    {
+        if (pSrc == pDst)
+            return ePcmFormat == TYPE_PCM_F32;
+        return ConvertToFloat(ePcmFormat, pSrc, pDst, nFrames * m_objPlan.nOutChannels);
+    }
+
+    if (ePcmFormat < TYPE_PCM_S8 || ePcmFormat > TYPE_PCM_F32 || !m_arrKernels[ePcmFormat - TYPE_PCM_S8])
+        return false;
+
+    if (ePcmFormat == TYPE_PCM_F32 && m_bMonoToStereo)
+        GetAudioKernels().pfnMonoToStereo(static_cast<const float*>(pSrc), pDst, nFrames);
+    else
+        m_arrKernels[ePcmFormat - TYPE_PCM_S8](m_objPlan, pSrc, pDst, nFrames);
+    return true;
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
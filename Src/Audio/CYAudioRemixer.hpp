@@ -0,0 +1,88 @@
+#ifndef __CY_AUDIO_REMIXER_HPP__
+#define __CY_AUDIO_REMIXER_HPP__
+
+#include "Audio/CYAudioDefine.hpp"
+#include "Audio/Simd/CYAudioKernels.hpp"
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * N to M channel remixer with gain for interleaved device PCM.
+ *
+ * The coefficient matrix is built once from the input channel mask and the requested layout (or taken
+ * from a custom matrix) and scaled by the configured gain. Input channels without a coefficient are
+ * never read. Process converts, remixes and applies the gain in one pass through the fused kernel of
+ * the input format and plan shape (gain only, any to mono, any to stereo, generic). Init picks the kernel
+ * of every input format once, mono and stereo plans of one or two used channels get the drivers compiled
+ * for that count.
+ *
+ * This is the whole of the compile time specialization. The fused convert and remix pass is where the
+ * per period branches on format and channels were, so only its drivers are instantiated per format,
+ * shape and used channel count and taken from a table at Init. The resampler, the stages and the output
+ * conversion keep their own runtime dispatch rather than being composed into one template pipeline per
+ * combination, and the generic driver is the fallback for every other plan. CYBenchFixedRemix compares
+ * the fixed drivers with the generic one.
+ */
+class CYAudioRemixer
+{
+public:
+    CYAudioRemixer();
+    ~CYAudioRemixer();
+
+public:
+    /**
+     * @brief Build the matrix. A zero mask uses the default mask for the channel count. Not thread safe.
+    */
+    bool Init(uint32_t nInChannels, uint32_t nInChannelMask, const TAudioConfig& objConfig);
+    void UnInit();
+
+    /**
+     * @brief Remix nFrames interleaved frames, pDst holds nFrames * GetOutChannels() floats.
+    */
+    void Process(const float* pSrc, float* pDst, size_t nFrames) const;
+
+    /**
+     * @brief Convert and remix nFrames interleaved device frames of ePcmFormat in one pass.
+    */
+    bool Process(ECYPcmFormat ePcmFormat, const void* pSrc, float* pDst, size_t nFrames) const;
+
+    /**
+     * @brief The output is the input unchanged apart from the float conversion, callers can skip Process.
+    */
+    bool IsPassthrough() const { return m_bPassthrough; }
+
+    uint32_t GetInChannels() const { return m_objPlan.nInChannels; }
+    uint32_t GetOutChannels() const { return m_objPlan.nOutChannels; }
+    uint32_t GetOutChannelMask() const { return m_nOutChannelMask; }
+
+    /**
+     * @brief Channel masks.
+    */
+    static uint32_t GetDefaultChannelMask(uint32_t nChannels);
+    static uint32_t GetLayoutChannelMask(ECYAudioChannelLayout eLayout);
+
+private:
+    bool BuildSpeakerMatrix(uint32_t nInChannelMask, uint32_t nOutChannelMask);
+    bool BuildCustomMatrix(const TAudioConfig& objConfig);
+    void Route(uint32_t nInChannel, uint32_t nSpeaker, float fGain, uint32_t nDepth);
+    int FindOutChannel(uint32_t nSpeaker) const;
+    void ApplyGain(float fGain);
+    void BuildPlan();
+    void BindKernels();
+
+private:
+    TRemixPlan m_objPlan;
+    float m_arrMatrix[g_nMaxRemixChannels * g_nMaxRemixChannels] = {};    // [out * g_nMaxRemixChannels + in]
+
+    uint32_t m_nOutChannelMask = 0;
+    uint32_t m_nInChannelMask = 0;
+    float m_fSurroundShare = 1.0f;
+    bool m_bPassthrough = true;
+
+    PFN_ConvertRemix m_arrKernels[g_nRemixPcmFormats] = {};
+    bool m_bMonoToStereo = false;
+};
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_AUDIO_REMIXER_HPP__
\ No newline at end of file
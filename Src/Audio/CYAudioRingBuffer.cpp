@@ -0,0 +1,209 @@
+#include "Audio/CYAudioRingBuffer.hpp"
+
+#include <new>
+#include <string.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+CYAudioRingBuffer::CYAudioRingBuffer()
+{
+}
+
+CYAudioRingBuffer::~CYAudioRingBuffer()
+{
+    UnInit();
+}
+
+bool CYAudioRingBuffer::Init(size_t nCapacity, size_t nBlockAlign, size_t nMirrorSize)
+{
+    UnInit();
+
+    if (!nCapacity || !nBlockAlign)
+        return false;
+
+    m_nBlockAlign = nBlockAlign;
+    m_nCapacity = ((nCapacity + nBlockAlign - 1) / nBlockAlign) * nBlockAlign;
+    m_nMirrorSize = (nMirrorSize < m_nCapacity) ? nMirrorSize : m_nCapacity;
+
+    // One extra cache line so the data can start on a cache line boundary.
+    m_ptrStorage.reset(new (std::nothrow) uint8_t[m_nCapacity + m_nMirrorSize + g_nCacheLineSize]);
+    if (!m_ptrStorage)
+    {
+        m_nCapacity = 0;
+        return false;
+    }
+
+    uintptr_t nAddress = reinterpret_cast<uintptr_t>(m_ptrStorage.get());
+    m_pBuffer = m_ptrStorage.get() + ((g_nCacheLineSize - (nAddress % g_nCacheLineSize)) % g_nCacheLineSize);
+    memset(m_pBuffer, 0, m_nCapacity + m_nMirrorSize);
+
+    m_nWritePos.store(0, std::memory_order_relaxed);
+    m_nReadPos.store(0, std::memory_order_relaxed);
+    m_nFlushPos.store(0, std::memory_order_relaxed);
+    m_nOverrunCount.store(0, std::memory_order_relaxed);
+    m_nOverrunBytes.store(0, std::memory_order_relaxed);
+    m_nUnderrunCount.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+void CYAudioRingBuffer::UnInit()
+{
+    m_ptrStorage.reset();
+    m_pBuffer = nullptr;
+    m_nCapacity = 0;
+    m_nMirrorSize = 0;
+}
+
+size_t CYAudioRingBuffer::Write(const void* pData, size_t nBytes)
+{
+    if (!pData)
+        return 0;
+
+    return Store(static_cast<const uint8_t*>(pData), nBytes);
+}
+
+size_t CYAudioRingBuffer::WriteSilence(size_t nBytes)
+{
+    return Store(nullptr, nBytes);
+}
+
+size_t CYAudioRingBuffer::Store(const uint8_t* pSrc, size_t nBytes)
+{
+    if (!m_pBuffer || !nBytes)
+        return 0;
+
+    const uint64_t nWritePos = m_nWritePos.load(std::memory_order_relaxed);
+    const uint64_t nReadPos = m_nReadPos.load(std::memory_order_acquire);
+
+    size_t nFree = m_nCapacity - size_t(nWritePos - nReadPos);
+    size_t nStore = (nBytes < nFree) ? nBytes : nFree;
+    nStore -= nStore % m_nBlockAlign;
+
+    if (nStore < nBytes)
+    {
+        m_nOverrunCount.fetch_add(1, std::memory_order_relaxed);
+        m_nOverrunBytes.fetch_add(nBytes - nStore, std::memory_order_relaxed);
+    }
+
+    if (!nStore)
+        return 0;
+
+    const size_t nOffset = size_t(nWritePos % m_nCapacity);
+    const size_t nFirst = (nStore < m_nCapacity - nOffset) ? nStore : (m_nCapacity - nOffset);
+    const size_t nSecond = nStore - nFirst;
+
+    // a null source stores silence, every PCM format is silent at zero.
+    auto fnCopy = [pSrc](uint8_t* pDst, size_t nSrcOffset, size_t nCount)
+    {
+        if (pSrc)
+            memcpy(pDst, pSrc + nSrcOffset, nCount);
+        else
+            memset(pDst, 0, nCount);
+    };
+
+    fnCopy(m_pBuffer + nOffset, 0, nFirst);
+    if (nSecond)
+        fnCopy(m_pBuffer, nFirst, nSecond);
+
+    // Keep the mirror of the ring head up to date.
+    if (nOffset < m_nMirrorSize)
+    {
+        size_t nEnd = nOffset + nFirst;
+        if (nEnd > m_nMirrorSize)
+            nEnd = m_nMirrorSize;
+        fnCopy(m_pBuffer + m_nCapacity + nOffset, 0, nEnd - nOffset);
+    }
+    if (nSecond && m_nMirrorSize)
+        fnCopy(m_pBuffer + m_nCapacity, nFirst, (nSecond < m_nMirrorSize) ? nSecond : m_nMirrorSize);
+
+    m_nWritePos.store(nWritePos + nStore, std::memory_order_release);
+    return nStore;
+}
+
+size_t CYAudioRingBuffer::GetReadable()
+{
+    ApplyFlush();
+    return size_t(m_nWritePos.load(std::memory_order_acquire) - m_nReadPos.load(std::memory_order_relaxed));
+}
+
+size_t CYAudioRingBuffer::GetReadableForProducer() const
+{
+    // the read position belongs to the consumer, only the consumer moves it past a flush.
+    const uint64_t nWritePos = m_nWritePos.load(std::memory_order_relaxed);
+    const uint64_t nReadPos = m_nReadPos.load(std::memory_order_acquire);
+    const uint64_t nFlushPos = m_nFlushPos.load(std::memory_order_acquire);
+    return size_t(nWritePos - ((nFlushPos > nReadPos) ? nFlushPos : nReadPos));
+}
+
+bool CYAudioRingBuffer::Peek(size_t nBytes, TRingView& objView)
+{
+    objView = TRingView();
+    if (!m_pBuffer)
+        return false;
+
+    ApplyFlush();
+
+    const uint64_t nReadPos = m_nReadPos.load(std::memory_order_relaxed);
+    const uint64_t nWritePos = m_nWritePos.load(std::memory_order_acquire);
+    if (nWritePos - nReadPos < nBytes)
+        return false;
+
+    const size_t nOffset = size_t(nReadPos % m_nCapacity);
+    objView.pFirst = m_pBuffer + nOffset;
+    if (nOffset + nBytes <= m_nCapacity + m_nMirrorSize)
+    {
+        objView.nFirstBytes = nBytes;
+    }
+    else
+    {
+        objView.nFirstBytes = m_nCapacity - nOffset;
+        objView.pSecond = m_pBuffer;
+        objView.nSecondBytes = nBytes - objView.nFirstBytes;
+    }
+
+    return true;
+}
+
+size_t CYAudioRingBuffer::Read(void* pDest, size_t nBytes)
+{
+    size_t nReadable = GetReadable();
+    if (nBytes > nReadable)
+        nBytes = nReadable - (nReadable % m_nBlockAlign);
+
+    TRingView objView;
+    if (!nBytes || !Peek(nBytes, objView))
+        return 0;
+
+    uint8_t* pDst = static_cast<uint8_t*>(pDest);
+    memcpy(pDst, objView.pFirst, objView.nFirstBytes);
+    if (objView.nSecondBytes)
+        memcpy(pDst + objView.nFirstBytes, objView.pSecond, objView.nSecondBytes);
+
+    Consume(nBytes);
+    return nBytes;
+}
+
+void CYAudioRingBuffer::Consume(size_t nBytes)
+{
+    const uint64_t nReadPos = m_nReadPos.load(std::memory_order_relaxed);
+    const uint64_t nWritePos = m_nWritePos.load(std::memory_order_acquire);
+
+    if (nBytes > nWritePos - nReadPos)
+        nBytes = size_t(nWritePos - nReadPos);
+
+    m_nReadPos.store(nReadPos + nBytes, std::memory_order_release);
+}
+
+void CYAudioRingBuffer::Flush()
+{
+    m_nFlushPos.store(m_nWritePos.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+void CYAudioRingBuffer::ApplyFlush()
+{
+    const uint64_t nFlushPos = m_nFlushPos.load(std::memory_order_acquire);
+    if (nFlushPos > m_nReadPos.load(std::memory_order_relaxed))
+        m_nReadPos.store(nFlushPos, std::memory_order_release);
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,117 @@
+#ifndef __CY_AUDIO_RING_BUFFER_HPP__
+#define __CY_AUDIO_RING_BUFFER_HPP__
+
+#include "Audio/CYAudioDefine.hpp"
+
+#include <atomic>
+#include <memory>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Read view into the ring, the second span is only used when the data wraps.
+ */
+struct TRingView
+{
+    const uint8_t* pFirst = nullptr;
+    size_t nFirstBytes = 0;
+    const uint8_t* pSecond = nullptr;
+    size_t nSecondBytes = 0;
+
+    inline size_t Size() const
+    {
+        return nFirstBytes + nSecondBytes;
+    }
+};
+
+/**
+ * Fixed capacity single-producer/single-consumer byte ring for device audio.
+ *
+ * The producer (capture thread) never takes a lock, the consumer (audio thread) reads at O(1) cost.
+ * The first bytes of the ring are mirrored behind its end, so any read up to the mirror size is
+ * returned as one contiguous span even when it crosses the wrap point.
+ */
+class CYAudioRingBuffer
+{
+public:
+    CYAudioRingBuffer();
+    ~CYAudioRingBuffer();
+
+    CYAudioRingBuffer(const CYAudioRingBuffer&) = delete;
+    CYAudioRingBuffer& operator=(const CYAudioRingBuffer&) = delete;
+
+public:
+    /**
+     * @brief Allocate the ring, capacity is rounded up to whole blocks. Not thread safe.
+    */
+    bool Init(size_t nCapacity, size_t nBlockAlign, size_t nMirrorSize);
+    void UnInit();
+
+    /**
+     * @brief Producer side, returns the bytes stored. Blocks that do not fit are dropped and counted as overrun.
+    */
+    size_t Write(const void* pData, size_t nBytes);
+    size_t WriteSilence(size_t nBytes);
+
+    /**
+     * @brief Producer side view of the readable bytes, a pending flush is accounted for but not applied.
+    */
+    size_t GetReadableForProducer() const;
+
+    /**
+     * @brief Consumer side.
+    */
+    size_t GetReadable();
+    bool Peek(size_t nBytes, TRingView& objView);
+    size_t Read(void* pDest, size_t nBytes);
+    void Consume(size_t nBytes);
+
+    /**
+     * @brief Consumer side, counts a period that was due but not in the ring. A Peek that finds too few
+     * bytes is only a poll and is not counted.
+    */
+    void CountUnderrun() { m_nUnderrunCount.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * @brief Discard everything written so far, may be called from any thread.
+    */
+    void Flush();
+
+    /**
+     * @brief Bytes written and consumed since Init, a flush counts as consumed.
+    */
+    uint64_t GetWritePos() const { return m_nWritePos.load(std::memory_order_acquire); }
+    uint64_t GetReadPos() const { return m_nReadPos.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Statistics.
+    */
+    size_t GetCapacity() const { return m_nCapacity; }
+    uint64_t GetOverrunCount() const { return m_nOverrunCount.load(std::memory_order_relaxed); }
+    uint64_t GetOverrunBytes() const { return m_nOverrunBytes.load(std::memory_order_relaxed); }
+    uint64_t GetUnderrunCount() const { return m_nUnderrunCount.load(std::memory_order_relaxed); }
+
+private:
+    size_t Store(const uint8_t* pSrc, size_t nBytes);
+    void ApplyFlush();
+
+private:
+    std::unique_ptr<uint8_t[]> m_ptrStorage;
+    uint8_t* m_pBuffer = nullptr;
+    size_t m_nCapacity = 0;
+    size_t m_nBlockAlign = 1;
+    size_t m_nMirrorSize = 0;
+
+    // Positions are monotonic byte counters, the offset in the ring is position % capacity.
+    alignas(g_nCacheLineSize) std::atomic<uint64_t> m_nWritePos{ 0 };
+    alignas(g_nCacheLineSize) std::atomic<uint64_t> m_nReadPos{ 0 };
+    alignas(g_nCacheLineSize) std::atomic<uint64_t> m_nFlushPos{ 0 };
+
+    alignas(g_nCacheLineSize) std::atomic<uint64_t> m_nOverrunCount{ 0 };
+    std::atomic<uint64_t> m_nOverrunBytes{ 0 };
+    std::atomic<uint64_t> m_nUnderrunCount{ 0 };
+};
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_AUDIO_RING_BUFFER_HPP__
\ No newline at end of file
@@ -0,0 +1,348 @@
+#include "Audio/CYAudioStages.hpp"
+#include "Audio/Simd/CYAudioKernels.hpp"
+
+#include <math.h>
+#include <string.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+// state this small decays into denormals, which are slow on most FPUs.
+constexpr float g_fMinStageState = 1e-20f;
+
+// Butterworth high-pass as cascaded sections, the pole pairs sit at 2k + 1 (even order) or 2k + 2
+// (odd order) times pi / 2N from the real axis, an odd order adds a first order section.
+static uint32_t DesignHighpass(double dFrequency, uint32_t nOrder, uint32_t nSampleRate, TAudioBiquad* pSections)
+{
+    const double dPi = 3.14159265358979323846;
+    const double dW0 = 2.0 * dPi * dFrequency / nSampleRate;
+    const double dCos = cos(dW0);
+    const double dSin = sin(dW0);
+
+    uint32_t nSections = 0;
+    for (uint32_t k = 0; k < nOrder / 2; ++k)
+    {
+        const double dQ = 1.0 / (2.0 * cos(dPi * (2 * k + 1 + nOrder % 2) / (2.0 * nOrder)));
+        const double dAlpha = dSin / (2.0 * dQ);
+        const double dA0 = 1.0 + dAlpha;
+
+        TAudioBiquad& objSection = pSections[nSections++];
+        objSection.fB0 = float((1.0 + dCos) / 2.0 / dA0);
+        objSection.fB1 = float(-(1.0 + dCos) / dA0);
+        objSection.fB2 = objSection.fB0;
+        objSection.fA1 = float(-2.0 * dCos / dA0);
+        objSection.fA2 = float((1.0 - dAlpha) / dA0);
+    }
+
+    if (nOrder % 2)
+    {
+        const double dK = tan(dW0 / 2.0);
+        TAudioBiquad& objSection = pSections[nSections++];
+        objSection.fB0 = float(1.0 / (1.0 + dK));
+        objSection.fB1 = -objSection.fB0;
+        objSection.fB2 = 0.0f;
+        objSection.fA1 = float((dK - 1.0) / (dK + 1.0));
+        objSection.fA2 = 0.0f;
+    }
+
+    return nSections;
+}
+
+static inline float DbToGain(float fDb)
+{
+    return powf(10.0f, fDb / 20.0f);
+}
+
+CYAudioStageChain::CYAudioStageChain()
+{
+}
+
+CYAudioStageChain::~CYAudioStageChain()
+{
+}
+
+bool CYAudioStageChain::Init(const TAudioStage* pStages, uint32_t nStages, uint32_t nChannels, uint32_t nSampleRate)
+{
+    if (nStages > g_nMaxAudioStages || (nStages && !pStages) || !nChannels || !nSampleRate)
+    {
+        CY_LOG_ERROR(TEXT("CYDevice: %u audio stages do not fit, at most %u are supported"), nStages, g_nMaxAudioStages);
+        return false;
+    }
+
+    m_nChannels = nChannels;
+    m_nSampleRate = nSampleRate;
+    m_nStages = nStages;
+    for (uint32_t i = 0; i < nStages; ++i)
+    {
+        if (!InitStage(pStages[i], m_arrStages[i]))
+        {
+            CY_LOG_ERROR(TEXT("CYDevice: Audio stage %u (type %d) is not valid at %u Hz"), i, (int)pStages[i].eType, nSampleRate);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool CYAudioStageChain::InitStage(const TAudioStage& objConfig, TStage& objStage)
+{
+    const float fNyquist = m_nSampleRate / 2.0f;
+    objStage.eType = objConfig.eType;
+    objStage.nSections = 0;
+
+    switch (objConfig.eType)
+    {
+    case TYPE_CYAUDIO_STAGE_BIQUAD:
+        if (!objConfig.nBiquads || objConfig.nBiquads > g_nMaxAudioBiquads)
+            return false;
+        objStage.nSections = objConfig.nBiquads;
+        memcpy(objStage.arrSections, objConfig.arrBiquads, objConfig.nBiquads * sizeof(TAudioBiquad));
+        break;
+
+    case TYPE_CYAUDIO_STAGE_DC_REMOVAL:
+    {
+        // one pole at R and a zero at DC, scaled to unity gain at Nyquist.
+        const float fFrequency = (objConfig.fFrequency > 0.0f) ? objConfig.fFrequency : g_fDefaultDcRemovalHz;
+        if (fFrequency >= fNyquist)
+            return false;
+        const double dPole = exp(-2.0 * 3.14159265358979323846 * fFrequency / m_nSampleRate);
+        TAudioBiquad& objSection = objStage.arrSections[0];
+        objSection.fB0 = float((1.0 + dPole) / 2.0);
+        objSection.fB1 = -objSection.fB0;
+        objSection.fB2 = 0.0f;
+        objSection.fA1 = float(-dPole);
+        objSection.fA2 = 0.0f;
+        objStage.nSections = 1;
+        break;
+    }
+
+    case TYPE_CYAUDIO_STAGE_HIGHPASS:
+    {
+        const float fFrequency = (objConfig.fFrequency > 0.0f) ? objConfig.fFrequency : g_fDefaultHighpassHz;
+        if (fFrequency >= fNyquist || !objConfig.nOrder || objConfig.nOrder > g_nMaxHighpassOrder)
+            return false;
+        objStage.nSections = DesignHighpass(fFrequency, objConfig.nOrder, m_nSampleRate, objStage.arrSections);
+        break;
+    }
+
+    case TYPE_CYAUDIO_STAGE_AGC:
+        if (objConfig.fMaxGainDb < 0.0f)
+            return false;
+        objStage.fTargetPower = powf(10.0f, objConfig.fTargetDb / 10.0f);
+        objStage.fNoisePower = powf(10.0f, objConfig.fNoiseFloorDb / 10.0f);
+        objStage.fMaxGainDb = objConfig.fMaxGainDb;
+        objStage.fAttackFrames = float(double(objConfig.nAttackUs) * m_nSampleRate / 1000000.0);
+        objStage.fReleaseFrames = float(double(objConfig.nReleaseUs) * m_nSampleRate / 1000000.0);
+        objStage.fGainDb = 0.0f;
+        break;
+
+    case TYPE_CYAUDIO_STAGE_CUSTOM:
+        if (!objConfig.pStage)
+            return false;
+        objStage.pStage = objConfig.pStage;
+        break;
+
+    default:
+        return false;
+    }
+
+    objStage.vecState.assign(size_t(objStage.nSections) * 2 * m_nChannels, 0.0f);
+    return true;
+}
+
+void CYAudioStageChain::InheritState(const CYAudioStageChain& objOld)
+{
+    for (uint32_t i = 0; i < MIN(m_nStages, objOld.m_nStages); ++i)
+    {
+        TStage& objStage = m_arrStages[i];
+        const TStage& objOldStage = objOld.m_arrStages[i];
+        if (objStage.eType != objOldStage.eType || objStage.vecState.size() != objOldStage.vecState.size())
+            continue;
+
+        // same shape, new coefficients run on from the old delay line.
+        if (!objStage.vecState.empty())
+            memcpy(objStage.vecState.data(), objOldStage.vecState.data(), objStage.vecState.size() * sizeof(float));
+        objStage.fGainDb = MIN(MAX(objOldStage.fGainDb, -objStage.fMaxGainDb), objStage.fMaxGainDb);
+    }
+}
+
+bool CYAudioStageChain::HasCustomStage(const ICYAudioStage* pStage) const
+{
+    for (uint32_t i = 0; i < m_nStages; ++i)
+    {
+        if (m_arrStages[i].pStage == pStage)
+            return true;
+    }
+    return false;
+}
+
+void CYAudioStageChain::Process(float* pData, uint32_t nFrames, const CYAudioStageChain* pShared)
+{
+    const TAudioKernels& objKernels = GetAudioKernels();
+    for (uint32_t i = 0; i < m_nStages; ++i)
+    {
+        TStage& objStage = m_arrStages[i];
+        switch (objStage.eType)
+        {
+        case TYPE_CYAUDIO_STAGE_AGC:
+            ProcessAgc(objStage, pData, nFrames);
+            break;
+
+        case TYPE_CYAUDIO_STAGE_CUSTOM:
+            if (!pShared || !pShared->HasCustomStage(objStage.pStage))
+                objStage.pStage->Process(pData, nFrames, m_nChannels, m_nSampleRate);
+            break;
+
+        default:
+            objKernels.pfnBiquad(pData, m_nChannels, nFrames, objStage.arrSections, objStage.nSections, objStage.vecState.data());
+            for (float& fState : objStage.vecState)
+            {
+                if (fabsf(fState) < g_fMinStageState)
+                    fState = 0.0f;
+            }
+            break;
+        }
+    }
+}
+
+void CYAudioStageChain::ProcessAgc(TStage& objStage, float* pData, uint32_t nFrames)
+{
+    const TAudioKernels& objKernels = GetAudioKernels();
+    const size_t nSamples = size_t(nFrames) * m_nChannels;
+    if (!nSamples)
+        return;
+
+    // the gain follows the level of the period it is applied to, periods under the floor keep it.
+    const float fPower = objKernels.pfnDotProduct(pData, pData, nSamples) / float(nSamples);
+    const float fStartDb = objStage.fGainDb;
+    if (fPower > objStage.fNoisePower)
+    {
+        const float fWantDb = MIN(MAX(10.0f * log10f(objStage.fTargetPower / fPower), -objStage.fMaxGainDb), objStage.fMaxGainDb);
+        const float fTimeFrames = (fWantDb < objStage.fGainDb) ? objStage.fAttackFrames : objStage.fReleaseFrames;
+        const float fCoeff = (fTimeFrames > 0.0f) ? 1.0f - expf(-float(nFrames) / fTimeFrames) : 1.0f;
+        objStage.fGainDb += (fWantDb - objStage.fGainDb) * fCoeff;
+    }
+
+    const float fStart = DbToGain(fStartDb);
+    const float fEnd = DbToGain(objStage.fGainDb);
+    if (fStart == fEnd)
+    {
+        if (fStart != 1.0f)
+            objKernels.pfnScale(pData, fStart, nSamples);
+        return;
+    }
+
+    // the gain moves across the period in short steps, which keeps the change free of zipper noise.
+    const uint32_t nSteps = (nFrames + g_nAudioStageRampFrames - 1) / g_nAudioStageRampFrames;
+    for (uint32_t nStep = 0; nStep < nSteps; ++nStep)
+    {
+        const uint32_t nFirst = nStep * g_nAudioStageRampFrames;
+        const uint32_t nCount = MIN(g_nAudioStageRampFrames, nFrames - nFirst);
+        const float fGain = fStart + (fEnd - fStart) * float(nStep + 1) / float(nSteps);
+        objKernels.pfnScale(pData + size_t(nFirst) * m_nChannels, fGain, size_t(nCount) * m_nChannels);
+    }
+}
+
+//------------------------------------------------------------
+
+CYAudioStages::CYAudioStages()
+{
+}
+
+CYAudioStages::~CYAudioStages()
+{
+    UnInit();
+}
+
+bool CYAudioStages::Init(uint32_t nChannels, uint32_t nSampleRate, uint32_t nMaxFrames, const TAudioStage* pStages, uint32_t nStages)
+{
+    UnInit();
+
+    m_nChannels = nChannels;
+    m_nSampleRate = nSampleRate;
+    m_vecFade.assign(size_t(nMaxFrames) * nChannels, 0.0f);
+    return BuildChain(pStages, nStages, m_ptrChain);
+}
+
+void CYAudioStages::UnInit()
+{
+    UniqueLock locker(m_pendingMutex);
+    m_ptrChain.reset();
+    m_ptrPending.reset();
+    m_ptrRetired.reset();
+    m_bPending = false;
+    m_nChannels = 0;
+}
+
+bool CYAudioStages::BuildChain(const TAudioStage* pStages, uint32_t nStages, UniquePtr<CYAudioStageChain>& ptrChain)
+{
+    ptrChain.reset();
+    if (!nStages)
+        return true;
+
+    UniquePtr<CYAudioStageChain> ptrNew = MakeUnique<CYAudioStageChain>();
+    if (!ptrNew->Init(pStages, nStages, m_nChannels, m_nSampleRate))
+        return false;
+
+    ptrChain = std::move(ptrNew);
+    return true;
+}
+
+bool CYAudioStages::Set(const TAudioStage* pStages, uint32_t nStages)
+{
+    if (!m_nChannels)
+        return false;
+
+    UniquePtr<CYAudioStageChain> ptrChain;
+    if (!BuildChain(pStages, nStages, ptrChain))
+        return false;
+
+    UniqueLock locker(m_pendingMutex);
+    m_ptrRetired.reset();
+    m_ptrPending = std::move(ptrChain);
+    m_bPending = true;
+    return true;
+}
+
+void CYAudioStages::Process(float* pData, uint32_t nFrames)
+{
+    if (!m_bPending)
+    {
+        if (m_ptrChain)
+            m_ptrChain->Process(pData, nFrames);
+        return;
+    }
+
+    UniquePtr<CYAudioStageChain> ptrOld;
+    {
+        UniqueLock locker(m_pendingMutex);
+        ptrOld = std::move(m_ptrChain);
+        m_ptrChain = std::move(m_ptrPending);
+        m_bPending = false;
+    }
+
+    // the old chain runs on a copy of the period, the new one in place, then one fades into the other.
+    const TAudioKernels& objKernels = GetAudioKernels();
+    const size_t nSamples = size_t(nFrames) * m_nChannels;
+    if (ptrOld && m_ptrChain)
+        m_ptrChain->InheritState(*ptrOld);
+    memcpy(m_vecFade.data(), pData, nSamples * sizeof(float));
+    if (ptrOld)
+        ptrOld->Process(m_vecFade.data(), nFrames, m_ptrChain.get());
+    if (m_ptrChain)
+        m_ptrChain->Process(pData, nFrames);
+
+    const uint32_t nSteps = (nFrames + g_nAudioStageRampFrames - 1) / g_nAudioStageRampFrames;
+    for (uint32_t nStep = 0; nStep < nSteps; ++nStep)
+    {
+        const size_t nFirst = size_t(nStep) * g_nAudioStageRampFrames * m_nChannels;
+        const size_t nCount = size_t(MIN(g_nAudioStageRampFrames, nFrames - nStep * g_nAudioStageRampFrames)) * m_nChannels;
+        const float fWeight = (nStep + 0.5f) / nSteps;
+        objKernels.pfnScale(pData + nFirst, fWeight, nCount);
+        objKernels.pfnMulAdd(m_vecFade.data() + nFirst, 1.0f - fWeight, pData + nFirst, nCount);
+    }
+
+    UniqueLock locker(m_pendingMutex);
+    m_ptrRetired = std::move(ptrOld);
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,130 @@
+#ifndef __CY_AUDIO_STAGES_HPP__
+#define __CY_AUDIO_STAGES_HPP__
+
+#include "Audio/CYAudioDefine.hpp"
+#include "Common/CYDevicePrivDefine.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Stage defaults and the ramp the gain changes are applied in, a gain or a crossfade weight holds for
+ * g_nAudioStageRampFrames frames.
+ */
+constexpr float g_fDefaultDcRemovalHz = 10.0f;
+constexpr float g_fDefaultHighpassHz = 80.0f;
+constexpr uint32_t g_nMaxHighpassOrder = g_nMaxAudioBiquads * 2;
+constexpr uint32_t g_nAudioStageRampFrames = 16;
+
+/**
+ * Built stages for one channel count and rate, run in place on interleaved float frames.
+ *
+ * The filter stages share the biquad kernel, the DC blocker is a first order section and the
+ * high-pass a Butterworth cascade. The AGC measures every period and ramps its gain across it. Not
+ * thread safe.
+ */
+class CYAudioStageChain
+{
+public:
+    CYAudioStageChain();
+    ~CYAudioStageChain();
+
+public:
+    bool Init(const TAudioStage* pStages, uint32_t nStages, uint32_t nChannels, uint32_t nSampleRate);
+
+    /**
+     * @brief Continue from the filter state and gain of the stages of objOld at the same position and
+     * of the same shape.
+    */
+    void InheritState(const CYAudioStageChain& objOld);
+
+    /**
+     * @brief pShared skips the custom stages it runs too, they must not see a period twice.
+    */
+    void Process(float* pData, uint32_t nFrames, const CYAudioStageChain* pShared = nullptr);
+
+private:
+    struct TStage
+    {
+        ECYAudioStageType eType = TYPE_CYAUDIO_STAGE_BIQUAD;
+        uint32_t nSections = 0;
+        TAudioBiquad arrSections[g_nMaxAudioBiquads];
+        std::vector<float> vecState;
+
+        // AGC, levels as power, time constants in frames.
+        float fTargetPower = 0.0f;
+        float fNoisePower = 0.0f;
+        float fMaxGainDb = 0.0f;
+        float fAttackFrames = 0.0f;
+        float fReleaseFrames = 0.0f;
+        float fGainDb = 0.0f;
+
+        ICYAudioStage* pStage = nullptr;
+    };
+
+    bool InitStage(const TAudioStage& objConfig, TStage& objStage);
+    void ProcessAgc(TStage& objStage, float* pData, uint32_t nFrames);
+    bool HasCustomStage(const ICYAudioStage* pStage) const;
+
+private:
+    uint32_t m_nChannels = 0;
+    uint32_t m_nSampleRate = 0;
+    uint32_t m_nStages = 0;
+    TStage m_arrStages[g_nMaxAudioStages];
+};
+
+/**
+ * Stage chain of a pipeline and its replacement while periods flow.
+ *
+ * A new chain is built on the caller thread and handed over at the next period. That period runs
+ * through both chains and crossfades from the old output to the new one, and the new chain continues
+ * from the state of the old stages it keeps, so a change never clicks. The old chain is freed by the
+ * next change or UnInit, never on the consumer thread.
+ */
+class CYAudioStages
+{
+public:
+    CYAudioStages();
+    ~CYAudioStages();
+
+public:
+    bool Init(uint32_t nChannels, uint32_t nSampleRate, uint32_t nMaxFrames, const TAudioStage* pStages, uint32_t nStages);
+    void UnInit();
+
+    /**
+     * @brief Any thread, takes effect with the next period.
+    */
+    bool Set(const TAudioStage* pStages, uint32_t nStages);
+
+    /**
+     * @brief Consumer side, true when the next period has stages to run or a change to fade in.
+    */
+    bool IsActive() const { return m_ptrChain || m_bPending; }
+
+    /**
+     * @brief Consumer side, nFrames is at most the nMaxFrames of Init.
+    */
+    void Process(float* pData, uint32_t nFrames);
+
+private:
+    bool BuildChain(const TAudioStage* pStages, uint32_t nStages, UniquePtr<CYAudioStageChain>& ptrChain);
+
+private:
+    uint32_t m_nChannels = 0;
+    uint32_t m_nSampleRate = 0;
+
+    UniquePtr<CYAudioStageChain> m_ptrChain;
+    std::vector<float> m_vecFade;
+
+    std::mutex m_pendingMutex;
+    std::atomic<bool> m_bPending{ false };
+    UniquePtr<CYAudioStageChain> m_ptrPending;  // nullptr with m_bPending removes the stages
+    UniquePtr<CYAudioStageChain> m_ptrRetired;
+};
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_AUDIO_STAGES_HPP__
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "Audio/Resample/ICYAudioResampler.hpp"
+#include "Audio/Resample/CYDecimator.hpp"
+#include "Audio/Resample/CYLinearResampler.hpp"
+#include "Audio/Resample/CYPolyphaseResampler.hpp"
+#include "Audio/Resample/CYSincResampler.hpp"
+
+#include <math.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+// zeroth order modified Bessel function, the Kaiser window kernel.
+static double BesselI0(double dValue)
+{
+    double dSum = 1.0, dTerm = 1.0;
+    for (int k = 1; k < 64 && dTerm > dSum * 1e-12; ++k)
+    {
+        double dHalf = dValue / (2.0 * k);
+        dTerm *= dHalf * dHalf;
+        dSum += dTerm;
+    }
+    return dSum;
+}
+
+double KaiserWindow(double dRatio, double dBeta)
+{
+    return BesselI0(dBeta * sqrt(MAX(0.0, 1.0 - dRatio * dRatio))) / BesselI0(dBeta);
+}
+
+UniquePtr<ICYAudioResampler> CreateAudioResampler(ECYAudioResampleQuality eQuality, uint32_t nInRate, uint32_t nOutRate)
+{
+    switch (eQuality)
+    {
+    case TYPE_CYAUDIO_RESAMPLE_LINEAR:
+        return MakeUnique<CYLinearResampler>();
+    case TYPE_CYAUDIO_RESAMPLE_POLYPHASE:
+        if (CYDecimator::IsSupported(nInRate, nOutRate))
+            return MakeUnique<CYDecimator>();
+        return MakeUnique<CYPolyphaseResampler>();
+    case TYPE_CYAUDIO_RESAMPLE_SINC_MEDIUM:
+        return MakeUnique<CYSincResampler>(TYPE_CYAUDIO_RESAMPLE_SINC_MEDIUM);
+    default:
+        return MakeUnique<CYSincResampler>(TYPE_CYAUDIO_RESAMPLE_SINC_FASTEST);
+    }
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include "Audio/Resample/CYDecimator.hpp"
+#include "Audio/Simd/CYAudioKernels.hpp"
+
+#include <math.h>
+#include <string.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+CYDecimator::CYDecimator()
+{
+}
+
+CYDecimator::~CYDecimator()
+{
+}
+
+bool CYDecimator::IsSupported(uint32_t nInRate, uint32_t nOutRate)
+{
+    if (!nOutRate || nInRate % nOutRate)
+        return false;
+
+    uint32_t nFactor = nInRate / nOutRate;
+    if (nFactor < 2 || nFactor > g_nMaxDecimation)
+        return false;
+
+    while (nFactor % 2 == 0) nFactor /= 2;
+    while (nFactor % 3 == 0) nFactor /= 3;
+    return nFactor == 1;
+}
+
+void CYDecimator::BuildStage(TDecimatorStage& objStage, uint32_t nFactor, uint32_t nInRate, uint32_t nFinalRate)
+{
+    // Kaiser design: the band from the final passband edge to the first alias of it is the transition.
+    const double dOutRate = double(nInRate) / nFactor;
+    const double dPassband = g_dDecimatorPassband * nFinalRate;
+    const double dTransition = MAX((dOutRate - 2.0 * dPassband) / nInRate, 0.01);
+    const double dBeta = 0.1102 * (g_dDecimatorAttenuation - 8.7);
+
+    uint32_t nLength = uint32_t(ceil((g_dDecimatorAttenuation - 7.95) / (14.357 * dTransition))) + 1;
+    nLength = MIN(nLength | 1, g_nMaxDecimatorTaps);
+
+    const double dCutoff = 0.5 / nFactor;
+    const double dCenter = (nLength - 1) * 0.5;
+    const double dPi = 3.14159265358979323846;
+
+    std::vector<double> vecPrototype(nLength);
+    double dSum = 0.0;
+    for (uint32_t i = 0; i < nLength; ++i)
+    {
+        double dOffset = double(i) - dCenter;
+        // half-band: every second coefficient away from the center is exactly zero.
+        if (nFactor == 2 && dOffset != 0.0 && (int64_t(dOffset) % 2) == 0)
+            continue;
+
+        double dSinc = (dOffset == 0.0) ? 2.0 * dCutoff : sin(2.0 * dPi * dCutoff * dOffset) / (dPi * dOffset);
+        vecPrototype[i] = dSinc * KaiserWindow(2.0 * i / (nLength - 1) - 1.0, dBeta);
+        dSum += vecPrototype[i];
+    }
+
+    objStage.nFactor = nFactor;
+    objStage.nTaps = (nLength + nFactor - 1) / nFactor * nFactor;
+    objStage.objClock.nUp = 1;
+    objStage.objClock.nDown = nFactor;
+    objStage.objClock.nIndex = objStage.objClock.nPhase = 0;
+
+    // reversed and front padded to whole phases, tap m multiplies input frame m of the window.
+    objStage.vecTaps.clear();
+    const uint32_t nPadding = objStage.nTaps - nLength;
+    for (uint32_t m = nPadding; m < objStage.nTaps; ++m)
+    {
+        double dCoeff = vecPrototype[objStage.nTaps - 1 - m] / dSum;
+        if (dCoeff == 0.0)
+            continue;
+
+        TDecimatorTap objTap;
+        objTap.nPhase = m % nFactor;
+        objTap.nOffset = m / nFactor;
+        objTap.fCoeff = float(dCoeff);
+        objStage.vecTaps.push_back(objTap);
+    }
+}
+
+bool CYDecimator::Init(uint32_t nInRate, uint32_t nOutRate, uint32_t nChannels, uint32_t nMaxInFrames)
+{
+    m_vecStages.clear();
+    if (!nChannels || !nMaxInFrames || !IsSupported(nInRate, nOutRate))
+        return false;
+
+    // half-bands first, they are the cheapest per output and run at the highest rates.
+    std::vector<uint32_t> vecFactors;
+    uint32_t nFactor = nInRate / nOutRate;
+    for (; nFactor % 2 == 0; nFactor /= 2) vecFactors.push_back(2);
+    for (; nFactor % 3 == 0; nFactor /= 3) vecFactors.push_back(3);
+
+    m_nChannels = nChannels;
+    m_nMaxInFrames = nMaxInFrames;
+    m_vecStages.resize(vecFactors.size());
+
+    uint32_t nStageRate = nInRate;
+    uint32_t nStageFrames = nMaxInFrames;
+    for (size_t i = 0; i < vecFactors.size(); ++i)
+    {
+        TDecimatorStage& objStage = m_vecStages[i];
+        BuildStage(objStage, vecFactors[i], nStageRate, nOutRate);
+
+        objStage.nMaxInFrames = nStageFrames;
+        objStage.nMaxOutFrames = objStage.objClock.GetMaxOutFrames(nStageFrames);
+        objStage.nInputStride = size_t(objStage.nTaps - 1) + nStageFrames;
+        objStage.vecInput.assign(objStage.nInputStride * nChannels, 0.0f);
+        objStage.nPhaseStride = size_t(objStage.nMaxOutFrames) + objStage.nTaps / objStage.nFactor;
+        objStage.vecPhases.assign(objStage.nPhaseStride * objStage.nFactor, 0.0f);
+
+        nStageRate /= vecFactors[i];
+        nStageFrames = objStage.nMaxOutFrames;
+    }
+
+    m_nOutputStride = nStageFrames;
+    m_vecOutput.assign(m_nOutputStride * nChannels, 0.0f);
+    return true;
+}
+
+void CYDecimator::Reset()
+{
+    for (TDecimatorStage& objStage : m_vecStages)
+    {
+        objStage.objClock.nIndex = 0;
+        memset(objStage.vecInput.data(), 0, objStage.vecInput.size() * sizeof(float));
+    }
+}
+
+uint32_t CYDecimator::GetOutFrames(uint32_t nInFrames) const
+{
+    for (const TDecimatorStage& objStage : m_vecStages)
+        nInFrames = objStage.objClock.GetOutFrames(nInFrames);
+    return nInFrames;
+}
+
+uint32_t CYDecimator::GetMaxOutFrames(uint32_t nInFrames) const
+{
+    for (const TDecimatorStage& objStage : m_vecStages)
+        nInFrames = objStage.objClock.GetMaxOutFrames(nInFrames);
+    return nInFrames;
+}
+
+uint32_t CYDecimator::ProcessStage(TDecimatorStage& objStage, uint32_t nInFrames, float* pOut, size_t nOutStride)
+{
+    const TAudioKernels& objKernels = GetAudioKernels();
+    const uint32_t nFactor = objStage.nFactor;
+    const uint32_t nOutFrames = objStage.objClock.GetOutFrames(nInFrames);
+    const uint32_t nStart = objStage.objClock.nIndex;
+    const size_t nPhaseFrames = size_t(nOutFrames) + objStage.nTaps / nFactor - 1;
+
+    for (uint32_t nChannel = 0; nChannel < m_nChannels; ++nChannel)
+    {
+        float* pInput = objStage.vecInput.data() + nChannel * objStage.nInputStride;
+        if (nOutFrames)
+        {
+            // phase plane r holds input frames nStart + r, nStart + r + nFactor, ...
+            float* pPhases = objStage.vecPhases.data();
+            for (uint32_t r = 0; r < nFactor; ++r)
+                objKernels.pfnFloatToF32(pInput + nStart + r, nFactor, pPhases + r * objStage.nPhaseStride, nPhaseFrames, nullptr);
+
+            float* pDst = pOut + nChannel * nOutStride;
+            memset(pDst, 0, nOutFrames * sizeof(float));
+            for (const TDecimatorTap& objTap : objStage.vecTaps)
+                objKernels.pfnMulAdd(pPhases + objTap.nPhase * objStage.nPhaseStride + objTap.nOffset, objTap.fCoeff, pDst, nOutFrames);
+        }
+
+        memmove(pInput, pInput + nInFrames, (objStage.nTaps - 1) * sizeof(float));
+    }
+
+    objStage.objClock.nIndex = nStart + nOutFrames * nFactor - nInFrames;
+    return nOutFrames;
+}
+
+uint32_t CYDecimator::Process(const float* pIn, uint32_t nInFrames, float* pOut)
+{
+    if (m_vecStages.empty())
+        return 0;
+    if (nInFrames > m_nMaxInFrames)
+        nInFrames = m_nMaxInFrames;
+
+    const TAudioKernels& objKernels = GetAudioKernels();
+
+    TDecimatorStage& objFirst = m_vecStages.front();
+    for (uint32_t nChannel = 0; nChannel < m_nChannels; ++nChannel)
+        objKernels.pfnFloatToF32(pIn + nChannel, m_nChannels, objFirst.vecInput.data() + nChannel * objFirst.nInputStride + objFirst.nTaps - 1, nInFrames, nullptr);
+
+    // every stage writes straight behind the history of the next one.
+    uint32_t nFrames = nInFrames;
+    for (size_t i = 0; i < m_vecStages.size(); ++i)
+    {
+        if (i + 1 < m_vecStages.size())
+        {
+            TDecimatorStage& objNext = m_vecStages[i + 1];
+            nFrames = ProcessStage(m_vecStages[i], nFrames, objNext.vecInput.data() + objNext.nTaps - 1, objNext.nInputStride);
+        }
+        else
+        {
+            nFrames = ProcessStage(m_vecStages[i], nFrames, m_vecOutput.data(), m_nOutputStride);
+        }
+    }
+
+    if (m_nChannels == 1)
+    {
+        memcpy(pOut, m_vecOutput.data(), nFrames * sizeof(float));
+        return nFrames;
+    }
+
+    for (uint32_t nFrame = 0; nFrame < nFrames; ++nFrame)
+    {
+        for (uint32_t nChannel = 0; nChannel < m_nChannels; ++nChannel)
+            *(pOut++) = m_vecOutput[nChannel * m_nOutputStride + nFrame];
+    }
+
+    return nFrames;
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef __CY_DECIMATOR_HPP__
+#define __CY_DECIMATOR_HPP__
+
+#include "Audio/Resample/ICYAudioResampler.hpp"
+
+#include <vector>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Decimator design. Each stage keeps the final passband free of aliases and lets the rest fold into
+ * its transition band, so only the last stage needs a sharp filter.
+ */
+constexpr uint32_t g_nMaxDecimation = 12;
+constexpr double g_dDecimatorPassband = 0.40;           // of the output rate
+constexpr double g_dDecimatorAttenuation = 80.0;        // dB
+constexpr uint32_t g_nMaxDecimatorTaps = 511;
+
+/**
+ * One non-zero FIR coefficient, applied to phase plane nPhase starting at output nOffset.
+ */
+struct TDecimatorTap
+{
+    uint32_t nPhase = 0;
+    uint32_t nOffset = 0;
+    float    fCoeff = 0.0f;
+};
+
+/**
+ * Decimate by 2 (half-band) or 3, planar per channel.
+ */
+struct TDecimatorStage
+{
+    uint32_t nFactor = 0;
+    uint32_t nTaps = 0;                         // multiple of nFactor
+    std::vector<TDecimatorTap> vecTaps;
+    TRationalClock objClock;
+
+    uint32_t nMaxInFrames = 0;
+    uint32_t nMaxOutFrames = 0;
+    size_t   nInputStride = 0;                  // nTaps - 1 frames of history followed by the block
+    std::vector<float> vecInput;
+    size_t   nPhaseStride = 0;
+    std::vector<float> vecPhases;               // nFactor planes, reused for every channel
+};
+
+/**
+ * Integer factor decimator (2, 3, 4, 6, 8, 12) for speech rates such as 48k -> 16k or 8k.
+ *
+ * The factor is split into cascaded half-band and decimate by 3 stages. Every stage splits its
+ * input into polyphase planes and accumulates one coefficient at a time over all outputs of the
+ * block, so only output rate products are computed and the inner loop is a plain SIMD multiply-add.
+ */
+class CYDecimator : public ICYAudioResampler
+{
+public:
+    CYDecimator();
+    virtual ~CYDecimator();
+
+public:
+    bool Init(uint32_t nInRate, uint32_t nOutRate, uint32_t nChannels, uint32_t nMaxInFrames) override;
+    void Reset() override;
+
+    uint32_t GetOutFrames(uint32_t nInFrames) const override;
+    uint32_t GetMaxOutFrames(uint32_t nInFrames) const override;
+
+    uint32_t Process(const float* pIn, uint32_t nInFrames, float* pOut) override;
+
+    ECYAudioResampleQuality GetQuality() const override { return TYPE_CYAUDIO_RESAMPLE_POLYPHASE; }
+
+    /**
+     * @brief Whether nInRate -> nOutRate is a decimation this class supports.
+    */
+    static bool IsSupported(uint32_t nInRate, uint32_t nOutRate);
+
+private:
+    void BuildStage(TDecimatorStage& objStage, uint32_t nFactor, uint32_t nInRate, uint32_t nFinalRate);
+    uint32_t ProcessStage(TDecimatorStage& objStage, uint32_t nInFrames, float* pOut, size_t nOutStride);
+
+private:
+    std::vector<TDecimatorStage> m_vecStages;
+    uint32_t m_nChannels = 0;
+    uint32_t m_nMaxInFrames = 0;
+
+    // Planar output of the last stage.
+    size_t m_nOutputStride = 0;
+    std::vector<float> m_vecOutput;
+};
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_DECIMATOR_HPP__
\ No newline at end of file
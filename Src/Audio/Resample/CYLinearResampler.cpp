@@ -0,0 +1,61 @@
+#include "Audio/Resample/CYLinearResampler.hpp"
+
+#include <string.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+CYLinearResampler::CYLinearResampler()
+{
+}
+
+CYLinearResampler::~CYLinearResampler()
+{
+}
+
+bool CYLinearResampler::Init(uint32_t nInRate, uint32_t nOutRate, uint32_t nChannels, uint32_t nMaxInFrames)
+{
+    if (!nChannels || !nMaxInFrames || !m_objClock.Init(nInRate, nOutRate))
+        return false;
+
+    m_nChannels = nChannels;
+    m_nMaxInFrames = nMaxInFrames;
+    m_vecHistory.assign(size_t(nMaxInFrames + 1) * nChannels, 0.0f);
+    return true;
+}
+
+void CYLinearResampler::Reset()
+{
+    m_objClock.nIndex = m_objClock.nPhase = 0;
+    memset(m_vecHistory.data(), 0, m_nChannels * sizeof(float));
+}
+
+uint32_t CYLinearResampler::Process(const float* pIn, uint32_t nInFrames, float* pOut)
+{
+    if (nInFrames > m_nMaxInFrames)
+        nInFrames = m_nMaxInFrames;
+
+    float* pHistory = m_vecHistory.data();
+    memcpy(pHistory + m_nChannels, pIn, size_t(nInFrames) * m_nChannels * sizeof(float));
+
+    // output n sits between history frames nIndex and nIndex + 1, nPhase / nUp of the way.
+    const float fPhaseScale = 1.0f / float(m_objClock.nUp);
+    uint32_t nOutFrames = 0;
+    while (m_objClock.nIndex < nInFrames)
+    {
+        const float* pPrev = pHistory + size_t(m_objClock.nIndex) * m_nChannels;
+        const float* pNext = pPrev + m_nChannels;
+        const float fFrac = float(m_objClock.nPhase) * fPhaseScale;
+
+        for (uint32_t nChannel = 0; nChannel < m_nChannels; ++nChannel)
+            *(pOut++) = pPrev[nChannel] + (pNext[nChannel] - pPrev[nChannel]) * fFrac;
+
+        ++nOutFrames;
+        m_objClock.Advance();
+    }
+
+    m_objClock.nIndex -= nInFrames;
+    memmove(pHistory, pHistory + size_t(nInFrames) * m_nChannels, m_nChannels * sizeof(float));
+    return nOutFrames;
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
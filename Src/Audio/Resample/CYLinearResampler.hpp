@@ -0,0 +1,41 @@
+#ifndef __CY_LINEAR_RESAMPLER_HPP__
+#define __CY_LINEAR_RESAMPLER_HPP__
+
+#include "Audio/Resample/ICYAudioResampler.hpp"
+
+#include <vector>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Linear interpolation between neighbouring frames, the cheapest tier. One frame of history.
+ */
+class CYLinearResampler : public ICYAudioResampler
+{
+public:
+    CYLinearResampler();
+    virtual ~CYLinearResampler();
+
+public:
+    bool Init(uint32_t nInRate, uint32_t nOutRate, uint32_t nChannels, uint32_t nMaxInFrames) override;
+    void Reset() override;
+
+    uint32_t GetOutFrames(uint32_t nInFrames) const override { return m_objClock.GetOutFrames(nInFrames); }
+    uint32_t GetMaxOutFrames(uint32_t nInFrames) const override { return m_objClock.GetMaxOutFrames(nInFrames); }
+
+    uint32_t Process(const float* pIn, uint32_t nInFrames, float* pOut) override;
+
+    ECYAudioResampleQuality GetQuality() const override { return TYPE_CYAUDIO_RESAMPLE_LINEAR; }
+
+private:
+    TRationalClock m_objClock;
+    uint32_t m_nChannels = 0;
+    uint32_t m_nMaxInFrames = 0;
+
+    // Last frame of the previous block followed by the current block.
+    std::vector<float> m_vecHistory;
+};
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_LINEAR_RESAMPLER_HPP__
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "Audio/Resample/CYPolyphaseResampler.hpp"
+#include "Audio/Simd/CYAudioKernels.hpp"
+
+#include <algorithm>
+#include <map>
+#include <math.h>
+#include <string.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+CYPolyphaseResampler::CYPolyphaseResampler()
+{
+}
+
+CYPolyphaseResampler::~CYPolyphaseResampler()
+{
+}
+
+SharePtr<TPolyphaseBank> CYPolyphaseResampler::BuildBank(uint32_t nUp, uint32_t nDown)
+{
+    uint32_t nTaps = g_nPolyphaseTaps;
+    if (nDown > nUp)
+        nTaps = uint32_t((uint64_t(g_nPolyphaseTaps) * nDown + nUp - 1) / nUp);
+    nTaps = MIN((nTaps + 7) & ~7u, g_nMaxPolyphaseTaps);
+
+    SharePtr<TPolyphaseBank> ptrBank = MakeShared<TPolyphaseBank>();
+    ptrBank->nUp = nUp;
+    ptrBank->nDown = nDown;
+    ptrBank->nTaps = nTaps;
+
+    // prototype low pass at the upsampled rate, cut below the lower of the two Nyquist rates.
+    const uint32_t nLength = nTaps * nUp;
+    const double dCutoff = g_dPolyphaseRolloff * 0.5 / double(MAX(nUp, nDown));
+    const double dCenter = (nLength - 1) * 0.5;
+    const double dPi = 3.14159265358979323846;
+
+    std::vector<double> vecPrototype(nLength);
+    double dSum = 0.0;
+    for (uint32_t i = 0; i < nLength; ++i)
+    {
+        double dOffset = double(i) - dCenter;
+        double dSinc = (dOffset == 0.0) ? 2.0 * dCutoff : sin(2.0 * dPi * dCutoff * dOffset) / (dPi * dOffset);
+        double dRatio = (nLength > 1) ? (2.0 * i / (nLength - 1) - 1.0) : 0.0;
+        vecPrototype[i] = dSinc * KaiserWindow(dRatio, g_dPolyphaseKaiserBeta);
+        dSum += vecPrototype[i];
+    }
+
+    // unity gain at DC for every phase on average.
+    const double dGain = double(nUp) / dSum;
+    ptrBank->vecCoeffs.resize(size_t(nUp) * nTaps);
+    for (uint32_t nPhase = 0; nPhase < nUp; ++nPhase)
+    {
+        float* pCoeffs = ptrBank->vecCoeffs.data() + size_t(nPhase) * nTaps;
+        for (uint32_t nTap = 0; nTap < nTaps; ++nTap)
+            pCoeffs[nTaps - 1 - nTap] = float(vecPrototype[nPhase + size_t(nTap) * nUp] * dGain);
+    }
+
+    return ptrBank;
+}
+
+SharePtr<const TPolyphaseBank> CYPolyphaseResampler::GetBank(uint32_t nUp, uint32_t nDown)
+{
+    if (!nUp || !nDown || nUp > g_nMaxPolyphases)
+        return nullptr;
+
+    static std::mutex s_bankMutex;
+    static std::map<uint64_t, std::weak_ptr<const TPolyphaseBank>> s_mapBanks;
+
+    const uint64_t nKey = (uint64_t(nUp) << 32) | nDown;
+    UniqueLock locker(s_bankMutex);
+
+    SharePtr<const TPolyphaseBank> ptrBank = s_mapBanks[nKey].lock();
+    if (!ptrBank)
+    {
+        ptrBank = BuildBank(nUp, nDown);
+        s_mapBanks[nKey] = ptrBank;
+    }
+
+    return ptrBank;
+}
+
+bool CYPolyphaseResampler::Init(uint32_t nInRate, uint32_t nOutRate, uint32_t nChannels, uint32_t nMaxInFrames)
+{
+    if (!nChannels || !nMaxInFrames || !m_objClock.Init(nInRate, nOutRate))
+        return false;
+
+    m_ptrBank = GetBank(m_objClock.nUp, m_objClock.nDown);
+    if (!m_ptrBank)
+        return false;
+
+    m_nChannels = nChannels;
+    m_nMaxInFrames = nMaxInFrames;
+    m_nHistoryStride = size_t(m_ptrBank->nTaps - 1) + nMaxInFrames;
+    m_vecHistory.assign(m_nHistoryStride * nChannels, 0.0f);
+    return true;
+}
+
+void CYPolyphaseResampler::Reset()
+{
+    m_objClock.nIndex = m_objClock.nPhase = 0;
+    std::fill(m_vecHistory.begin(), m_vecHistory.end(), 0.0f);
+}
+
+uint32_t CYPolyphaseResampler::Process(const float* pIn, uint32_t nInFrames, float* pOut)
+{
+    if (nInFrames > m_nMaxInFrames)
+        nInFrames = m_nMaxInFrames;
+
+    const TAudioKernels& objKernels = GetAudioKernels();
+    const uint32_t nTaps = m_ptrBank->nTaps;
+    const float* pBank = m_ptrBank->vecCoeffs.data();
+    float* pHistory = m_vecHistory.data();
+
+    // split the block into the channel planes behind their history.
+    for (uint32_t nChannel = 0; nChannel < m_nChannels; ++nChannel)
+        objKernels.pfnFloatToF32(pIn + nChannel, m_nChannels, pHistory + nChannel * m_nHistoryStride + nTaps - 1, nInFrames, nullptr);
+
+    // output n uses history frames nIndex .. nIndex + nTaps - 1, the newest being input frame nIndex.
+    uint32_t nOutFrames = 0;
+    while (m_objClock.nIndex < nInFrames)
+    {
+        const float* pCoeffs = pBank + size_t(m_objClock.nPhase) * nTaps;
+        const float* pFrames = pHistory + m_objClock.nIndex;
+        for (uint32_t nChannel = 0; nChannel < m_nChannels; ++nChannel)
+            *(pOut++) = objKernels.pfnDotProduct(pFrames + nChannel * m_nHistoryStride, pCoeffs, nTaps);
+
+        ++nOutFrames;
+        m_objClock.Advance();
+    }
+
+    m_objClock.nIndex -= nInFrames;
+    for (uint32_t nChannel = 0; nChannel < m_nChannels; ++nChannel)
+    {
+        float* pPlane = pHistory + nChannel * m_nHistoryStride;
+        memmove(pPlane, pPlane + nInFrames, (nTaps - 1) * sizeof(float));
+    }
+
+    return nOutFrames;
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
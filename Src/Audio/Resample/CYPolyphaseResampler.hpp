@@ -0,0 +1,77 @@
+#ifndef __CY_POLYPHASE_RESAMPLER_HPP__
+#define __CY_POLYPHASE_RESAMPLER_HPP__
+
+#include "Audio/Resample/ICYAudioResampler.hpp"
+
+#include <vector>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Polyphase filter limits. Taps per phase grow with the decimation factor so the transition band
+ * stays the same width at the input rate, and are kept a multiple of 8 for the SIMD dot product.
+ */
+constexpr uint32_t g_nMaxPolyphases = 1024;
+constexpr uint32_t g_nPolyphaseTaps = 32;
+constexpr uint32_t g_nMaxPolyphaseTaps = 256;
+constexpr double g_dPolyphaseRolloff = 0.92;
+constexpr double g_dPolyphaseKaiserBeta = 8.0;
+
+/**
+ * Filter bank of an L/M ratio, [phase * nTaps + tap] with the taps of every phase reversed so the
+ * inner loop is a plain dot product with the oldest input first.
+ */
+struct TPolyphaseBank
+{
+    uint32_t nUp = 0;
+    uint32_t nDown = 0;
+    uint32_t nTaps = 0;
+    std::vector<float> vecCoeffs;
+};
+
+/**
+ * Windowed sinc resampler for rational ratios (44.1k <-> 48k, 48k -> 16k, 32k -> 48k, ...).
+ *
+ * The bank of a ratio is built once and shared by every stream that uses it. Input is kept per
+ * channel with nTaps - 1 frames of history so every output sample is one contiguous dot product.
+ */
+class CYPolyphaseResampler : public ICYAudioResampler
+{
+public:
+    CYPolyphaseResampler();
+    virtual ~CYPolyphaseResampler();
+
+public:
+    bool Init(uint32_t nInRate, uint32_t nOutRate, uint32_t nChannels, uint32_t nMaxInFrames) override;
+    void Reset() override;
+
+    uint32_t GetOutFrames(uint32_t nInFrames) const override { return m_objClock.GetOutFrames(nInFrames); }
+    uint32_t GetMaxOutFrames(uint32_t nInFrames) const override { return m_objClock.GetMaxOutFrames(nInFrames); }
+
+    uint32_t Process(const float* pIn, uint32_t nInFrames, float* pOut) override;
+
+    ECYAudioResampleQuality GetQuality() const override { return TYPE_CYAUDIO_RESAMPLE_POLYPHASE; }
+
+    /**
+     * @brief Shared bank of a reduced ratio, nullptr if it needs more than g_nMaxPolyphases phases.
+    */
+    static SharePtr<const TPolyphaseBank> GetBank(uint32_t nUp, uint32_t nDown);
+
+private:
+    static SharePtr<TPolyphaseBank> BuildBank(uint32_t nUp, uint32_t nDown);
+
+private:
+    TRationalClock m_objClock;
+    SharePtr<const TPolyphaseBank> m_ptrBank;
+
+    uint32_t m_nChannels = 0;
+    uint32_t m_nMaxInFrames = 0;
+
+    // One plane per channel: nTaps - 1 frames of history followed by the current block.
+    size_t m_nHistoryStride = 0;
+    std::vector<float> m_vecHistory;
+};
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_POLYPHASE_RESAMPLER_HPP__
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "Audio/Resample/CYSincResampler.hpp"
+#include "libsamplerate/samplerate.h"
+
+CYDEVICE_NAMESPACE_BEGIN
+
+CYSincResampler::CYSincResampler(ECYAudioResampleQuality eQuality)
+    : m_eQuality(eQuality)
+{
+}
+
+CYSincResampler::~CYSincResampler()
+{
+    if (m_pState)
+        m_pState = src_delete(m_pState);
+}
+
+bool CYSincResampler::Init(uint32_t nInRate, uint32_t nOutRate, uint32_t nChannels, uint32_t nMaxInFrames)
+{
+    if (m_pState)
+        m_pState = src_delete(m_pState);
+
+    if (!nInRate || !nOutRate || !nChannels || !nMaxInFrames)
+        return false;
+
+    int nError = 0;
+    int nConverter = (m_eQuality == TYPE_CYAUDIO_RESAMPLE_SINC_MEDIUM) ? SRC_SINC_MEDIUM_QUALITY : SRC_SINC_FASTEST;
+    m_pState = src_new(nConverter, int(nChannels), &nError);
+    if (!m_pState)
+    {
+        CY_LOG_ERROR(TEXT("CYDevice: Could not create the audio resampler, error = %d"), nError);
+        return false;
+    }
+
+    m_dRatio = double(nOutRate) / double(nInRate);
+    m_nChannels = nChannels;
+    return true;
+}
+
+void CYSincResampler::Reset()
+{
+    if (m_pState)
+        src_reset(m_pState);
+}
+
+uint32_t CYSincResampler::GetMaxOutFrames(uint32_t nInFrames) const
+{
+    // the rounding carried between calls adds at most one frame, the bound holds for any adjustment.
+    return uint32_t(double(nInFrames) * m_dRatio * (1.0 + g_dMaxResampleRatioAdjust)) + 2;
+}
+
+bool CYSincResampler::SetRatioAdjust(double dAdjust)
+{
+    m_dAdjust = MIN(MAX(dAdjust, 1.0 - g_dMaxResampleRatioAdjust), 1.0 + g_dMaxResampleRatioAdjust);
+    return true;
+}
+
+uint32_t CYSincResampler::Process(const float* pIn, uint32_t nInFrames, float* pOut)
+{
+    if (!m_pState)
+        return 0;
+
+    SRC_DATA data;
+    data.src_ratio = m_dRatio * m_dAdjust;
+    data.data_in = const_cast<float*>(pIn);     // only read by libsamplerate
+    data.input_frames = long(nInFrames);
+    data.data_out = pOut;
+    data.output_frames = long(GetMaxOutFrames(nInFrames));
+    data.end_of_input = 0;
+
+    int nResult = src_process(m_pState, &data);
+    if (nResult)
+    {
+        CY_LOG_ERROR(TEXT("CYDevice: Was unable to resample audio, error = %d"), nResult);
+        return 0;
+    }
+
+    if (data.input_frames_used != long(nInFrames))
+        CY_LOG_WARN(TEXT("CYDevice: Resampler used %ld of %u frames"), data.input_frames_used, nInFrames);
+
+    return uint32_t(data.output_frames_gen);
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef __CY_SINC_RESAMPLER_HPP__
+#define __CY_SINC_RESAMPLER_HPP__
+
+#include "Audio/Resample/ICYAudioResampler.hpp"
+
+typedef struct SRC_STATE_tag SRC_STATE;
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * libsamplerate sinc converters, any ratio. The output of a call is only bounded: the converter
+ * keeps its filter delay internally, so the first calls return fewer frames. The ratio may be
+ * adjusted between calls, libsamplerate glides to the new one across the next block.
+ */
+class CYSincResampler : public ICYAudioResampler
+{
+public:
+    explicit CYSincResampler(ECYAudioResampleQuality eQuality);
+    virtual ~CYSincResampler();
+
+public:
+    bool Init(uint32_t nInRate, uint32_t nOutRate, uint32_t nChannels, uint32_t nMaxInFrames) override;
+    void Reset() override;
+
+    uint32_t GetOutFrames(uint32_t nInFrames) const override { return GetMaxOutFrames(nInFrames); }
+    uint32_t GetMaxOutFrames(uint32_t nInFrames) const override;
+
+    uint32_t Process(const float* pIn, uint32_t nInFrames, float* pOut) override;
+    bool SetRatioAdjust(double dAdjust) override;
+
+    ECYAudioResampleQuality GetQuality() const override { return m_eQuality; }
+
+private:
+    ECYAudioResampleQuality m_eQuality;
+    SRC_STATE* m_pState = nullptr;
+    double m_dRatio = 1.0;
+    double m_dAdjust = 1.0;
+    uint32_t m_nChannels = 0;
+};
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_SINC_RESAMPLER_HPP__
\ No newline at end of file
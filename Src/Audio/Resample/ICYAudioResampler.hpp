@@ -0,0 +1,119 @@
+#ifndef __I_CY_AUDIO_RESAMPLER_HPP__
+#define __I_CY_AUDIO_RESAMPLER_HPP__
+
+#include "Audio/CYAudioDefine.hpp"
+#include "Common/CYDevicePrivDefine.hpp"
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Largest ratio correction a variable ratio resampler accepts, far above any real clock drift.
+ */
+constexpr double g_dMaxResampleRatioAdjust = 0.005;
+
+/**
+ * Streaming sample rate converter for interleaved float frames.
+ *
+ * Every Process call consumes all of its input. The rational tiers (linear, polyphase) report the
+ * exact frame count of the next call, the libsamplerate tiers report an upper bound.
+ */
+class ICYAudioResampler
+{
+public:
+    ICYAudioResampler() { }
+    virtual ~ICYAudioResampler() { }
+
+public:
+    /**
+     * @brief Set up the conversion, nMaxInFrames sizes the internal buffers so Process never allocates.
+    */
+    virtual bool Init(uint32_t nInRate, uint32_t nOutRate, uint32_t nChannels, uint32_t nMaxInFrames) = 0;
+    virtual void Reset() = 0;
+
+    /**
+     * @brief Frames the next Process call of nInFrames writes, and a bound that holds in any state.
+    */
+    virtual uint32_t GetOutFrames(uint32_t nInFrames) const = 0;
+    virtual uint32_t GetMaxOutFrames(uint32_t nInFrames) const = 0;
+
+    /**
+     * @brief Convert nInFrames frames (at most nMaxInFrames), pOut holds GetMaxOutFrames(nInFrames) frames.
+    */
+    virtual uint32_t Process(const float* pIn, uint32_t nInFrames, float* pOut) = 0;
+
+    /**
+     * @brief Scale the output rate by dAdjust (within g_dMaxResampleRatioAdjust of 1) from the next call,
+     * false for the tiers that run a fixed rational ratio.
+    */
+    virtual bool SetRatioAdjust(double /*dAdjust*/) { return false; }
+
+    virtual ECYAudioResampleQuality GetQuality() const = 0;
+};
+
+/**
+ * Position of a rational L/M resampler, the output clock advances by nDown / nUp input frames.
+ * nIndex is the input frame of the next output relative to the next block, nPhase its fraction in 1 / nUp.
+ */
+struct TRationalClock
+{
+    uint32_t nUp = 1;
+    uint32_t nDown = 1;
+    uint32_t nIndex = 0;
+    uint32_t nPhase = 0;
+
+    inline bool Init(uint32_t nInRate, uint32_t nOutRate)
+    {
+        if (!nInRate || !nOutRate)
+            return false;
+
+        uint32_t a = nInRate, b = nOutRate;
+        while (b)
+        {
+            uint32_t t = a % b;
+            a = b;
+            b = t;
+        }
+
+        nUp = nOutRate / a;
+        nDown = nInRate / a;
+        nIndex = nPhase = 0;
+        return true;
+    }
+
+    // count of n with nIndex + (nPhase + n * nDown) / nUp < nInFrames.
+    inline uint32_t GetOutFrames(uint32_t nInFrames) const
+    {
+        if (nIndex >= nInFrames)
+            return 0;
+
+        uint64_t nSpan = uint64_t(nInFrames - nIndex) * nUp - nPhase;
+        return uint32_t((nSpan + nDown - 1) / nDown);
+    }
+
+    inline uint32_t GetMaxOutFrames(uint32_t nInFrames) const
+    {
+        return uint32_t((uint64_t(nInFrames) * nUp + nDown - 1) / nDown);
+    }
+
+    inline void Advance()
+    {
+        nPhase += nDown;
+        nIndex += nPhase / nUp;
+        nPhase %= nUp;
+    }
+};
+
+/**
+ * Kaiser window at dRatio in [-1, 1] across the filter, shared by the FIR designs.
+ */
+double KaiserWindow(double dRatio, double dBeta);
+
+/**
+ * Create the resampler of a quality tier for nInRate -> nOutRate, Init is left to the caller.
+ * The polyphase tier picks the cascaded decimator when nOutRate divides nInRate by 2, 3, 4, 6, 8 or 12.
+ */
+UniquePtr<ICYAudioResampler> CreateAudioResampler(ECYAudioResampleQuality eQuality, uint32_t nInRate, uint32_t nOutRate);
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __I_CY_AUDIO_RESAMPLER_HPP__
\ No newline at end of file
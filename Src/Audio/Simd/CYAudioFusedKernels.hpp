@@ -0,0 +1,550 @@
+#ifndef __CY_AUDIO_FUSED_KERNELS_HPP__
+#define __CY_AUDIO_FUSED_KERNELS_HPP__
+
+#include "Audio/Simd/CYAudioKernels.hpp"
+#include "Common/CYDevicePrivDefine.hpp"
+
+#include <string.h>
+#include <utility>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Fused convert + remix + gain kernels, one instance per (PCM format, remix shape) pair.
+ *
+ * Every instruction set file describes its vector unit with a traits struct and fills the table
+ * with FillConvertRemixKernels. The drivers read every used input sample once straight from the
+ * device PCM and accumulate it into the output frames, so a period never goes through an
+ * intermediate float buffer. The integer to float scale is folded into the coefficients, which
+ * saves the divide of the PcmToFloat kernels and differs from convert-then-remix by an ulp at most.
+ *
+ *  struct TSimd
+ *  {
+ *      typedef ... Vec;                        // nWidth floats
+ *      typedef ... Index;                      // byte offsets of nWidth samples nStride bytes apart
+ *      static constexpr size_t nWidth;
+ *      static Index MakeIndex(size_t nStride);
+ *      template <ECYPcmFormat eFormat> static Vec Load(const uint8_t* pSrc, const Index& vIndex);   // unscaled
+ *      static Vec Zero();
+ *      static Vec Set1(float fValue);
+ *      static Vec Mul(Vec vA, Vec vB);
+ *      static Vec Add(Vec vA, Vec vB);
+ *      static void Store(float* pDst, Vec vValue);
+ *      static void StoreStereo(float* pDst, Vec vLeft, Vec vRight);
+ *      static Vec LoadFloats(const float* pSrc);   // nWidth contiguous floats
+ *      static Vec Abs(Vec vValue);
+ *      static Vec Max(Vec vA, Vec vB);
+ *      static Vec Clipped(Vec vAbs);           // 1.0 where vAbs >= 1.0, else 0.0
+ *      static Vec LoadPair(const float* pSrc); // 2 floats in the low lanes, the others 0.0
+ *      static void StorePair(float* pDst, Vec vValue);
+ *  };
+ *
+ * The biquad drivers take a second, narrower traits struct for the channels a full vector leaves
+ * over, it only needs the float loads and stores and the arithmetic.
+ *
+ * Loads may read up to 4 bytes from the start of every sample, the drivers leave the last bytes
+ * of the block to the scalar code. Everything here is static so each instruction set file keeps
+ * its own copy, compiled with its own code generation.
+ */
+
+template <ECYPcmFormat eFormat>
+constexpr size_t g_nPcmSampleBytes = (eFormat == TYPE_PCM_S8) ? 1 : (eFormat == TYPE_PCM_S16) ? 2 : (eFormat == TYPE_PCM_S24) ? 3 : 4;
+
+// full scale of the integer formats, applied through the coefficients.
+template <ECYPcmFormat eFormat>
+constexpr float g_fPcmSampleScale = (eFormat == TYPE_PCM_S8) ? 1.0f / g_fS8Divisor : (eFormat == TYPE_PCM_S16) ? 1.0f / g_fS16Divisor :
+    (eFormat == TYPE_PCM_S24) ? g_fS24Scale : (eFormat == TYPE_PCM_S32) ? float(g_dS32Scale) : 1.0f;
+
+// one sample as a float, not scaled to full scale.
+template <ECYPcmFormat eFormat>
+static inline float LoadPcmSample(const uint8_t* pSrc)
+{
+    if constexpr (eFormat == TYPE_PCM_S8)
+    {
+        return float(int8_t(pSrc[0]));
+    }
+    else if constexpr (eFormat == TYPE_PCM_S16)
+    {
+        int16_t nVal;
+        memcpy(&nVal, pSrc, sizeof(nVal));
+        return float(nVal);
+    }
+    else if constexpr (eFormat == TYPE_PCM_S24)
+    {
+        uint32_t nVal = (uint32_t(pSrc[0]) << 8) | (uint32_t(pSrc[1]) << 16) | (uint32_t(pSrc[2]) << 24);
+        return float(int32_t(nVal) >> 8);
+    }
+    else if constexpr (eFormat == TYPE_PCM_S32)
+    {
+        int32_t nVal;
+        memcpy(&nVal, pSrc, sizeof(nVal));
+        return float(nVal);
+    }
+    else
+    {
+        float fVal;
+        memcpy(&fVal, pSrc, sizeof(fVal));
+        return fVal;
+    }
+}
+
+//------------------------------------------------------------
+// scalar drivers, also the tails of the vector ones
+
+template <ECYPcmFormat eFormat>
+static void ConvertScaleScalar(const TRemixPlan& objPlan, const void* pSrc, float* pDst, size_t nFrames)
+{
+    const uint8_t* pIn = static_cast<const uint8_t*>(pSrc);
+    const size_t nSamples = nFrames * objPlan.nInChannels;
+    const float fScale = objPlan.fScale * g_fPcmSampleScale<eFormat>;
+    for (size_t i = 0; i < nSamples; ++i, pIn += g_nPcmSampleBytes<eFormat>)
+        pDst[i] = LoadPcmSample<eFormat>(pIn) * fScale;
+}
+
+// plan coefficients with the sample scale folded in, nRows rows of the used channels.
+template <ECYPcmFormat eFormat>
+static inline void ScaleCoeffs(const TRemixPlan& objPlan, uint32_t nRows, float* pCoeffs)
+{
+    for (uint32_t nOut = 0; nOut < nRows; ++nOut)
+    {
+        for (uint32_t nUsed = 0; nUsed < objPlan.nUsedChannels; ++nUsed)
+            pCoeffs[nOut * g_nMaxRemixChannels + nUsed] = objPlan.arrCoeffs[nOut * g_nMaxRemixChannels + nUsed] * g_fPcmSampleScale<eFormat>;
+    }
+}
+
+template <ECYPcmFormat eFormat>
+static void ConvertRemixScalar(const TRemixPlan& objPlan, const void* pSrc, float* pDst, size_t nFrames)
+{
+    const uint8_t* pIn = static_cast<const uint8_t*>(pSrc);
+    const size_t nFrameBytes = size_t(objPlan.nInChannels) * g_nPcmSampleBytes<eFormat>;
+    float arrIn[g_nMaxRemixChannels];
+    float arrCoeffs[g_nMaxRemixChannels * g_nMaxRemixChannels];
+    ScaleCoeffs<eFormat>(objPlan, objPlan.nOutChannels, arrCoeffs);
+
+    for (size_t i = 0; i < nFrames; ++i, pIn += nFrameBytes)
+    {
+        for (uint32_t nUsed = 0; nUsed < objPlan.nUsedChannels; ++nUsed)
+            arrIn[nUsed] = LoadPcmSample<eFormat>(pIn + objPlan.arrUsedChannels[nUsed] * g_nPcmSampleBytes<eFormat>);
+
+        for (uint32_t nOut = 0; nOut < objPlan.nOutChannels; ++nOut)
+        {
+            const float* pCoeffs = arrCoeffs + nOut * g_nMaxRemixChannels;
+            float fSum = 0.0f;
+            for (uint32_t nUsed = 0; nUsed < objPlan.nUsedChannels; ++nUsed)
+                fSum += arrIn[nUsed] * pCoeffs[nUsed];
+            *(pDst++) = fSum;
+        }
+    }
+}
+
+//------------------------------------------------------------
+// vector drivers
+
+// frames the vector loop may cover without its loads running past the block.
+template <class TSimd, ECYPcmFormat eFormat>
+static inline size_t GetVectorFrames(size_t nFrames, size_t nFrameBytes)
+{
+    const size_t nOverread = (g_nPcmSampleBytes<eFormat> < 4) ? 4 - g_nPcmSampleBytes<eFormat> : 0;
+    const size_t nSafe = nFrames - MIN(nFrames, (nOverread + nFrameBytes - 1) / nFrameBytes);
+    return nSafe - nSafe % TSimd::nWidth;
+}
+
+template <class TSimd, ECYPcmFormat eFormat>
+static void ConvertScaleSimd(const TRemixPlan& objPlan, const void* pSrc, float* pDst, size_t nFrames)
+{
+    const uint8_t* pIn = static_cast<const uint8_t*>(pSrc);
+    const size_t nSamples = nFrames * objPlan.nInChannels;
+    const size_t nVector = GetVectorFrames<TSimd, eFormat>(nSamples, g_nPcmSampleBytes<eFormat>);
+    const typename TSimd::Index vIndex = TSimd::MakeIndex(g_nPcmSampleBytes<eFormat>);
+    const typename TSimd::Vec vScale = TSimd::Set1(objPlan.fScale * g_fPcmSampleScale<eFormat>);
+
+    size_t i = 0;
+    for (; i < nVector; i += TSimd::nWidth)
+        TSimd::Store(pDst + i, TSimd::Mul(TSimd::template Load<eFormat>(pIn + i * g_nPcmSampleBytes<eFormat>, vIndex), vScale));
+
+    TRemixPlan objTail;
+    objTail.nInChannels = 1;
+    objTail.fScale = objPlan.fScale;
+    ConvertScaleScalar<eFormat>(objTail, pIn + i * g_nPcmSampleBytes<eFormat>, pDst + i, nSamples - i);
+}
+
+// nFixedUsed 0 reads the used channel count from the plan. A fixed count unrolls the channel loop,
+// so the coefficients and sample offsets stay in registers across the whole period.
+template <class TSimd, ECYPcmFormat eFormat, uint32_t nFixedUsed = 0>
+static void ConvertRemixToMonoSimd(const TRemixPlan& objPlan, const void* pSrc, float* pDst, size_t nFrames)
+{
+    const uint8_t* pIn = static_cast<const uint8_t*>(pSrc);
+    const size_t nFrameBytes = size_t(objPlan.nInChannels) * g_nPcmSampleBytes<eFormat>;
+    const size_t nVector = GetVectorFrames<TSimd, eFormat>(nFrames, nFrameBytes);
+    const typename TSimd::Index vIndex = TSimd::MakeIndex(nFrameBytes);
+    const uint32_t nUsedChannels = nFixedUsed ? nFixedUsed : objPlan.nUsedChannels;
+    float arrCoeffs[g_nMaxRemixChannels];
+    ScaleCoeffs<eFormat>(objPlan, 1, arrCoeffs);
+    const float* pCoeffs = arrCoeffs;
+
+    size_t i = 0;
+    for (; i < nVector; i += TSimd::nWidth)
+    {
+        const uint8_t* pFrames = pIn + i * nFrameBytes;
+        typename TSimd::Vec vSum = TSimd::Zero();
+        for (uint32_t nUsed = 0; nUsed < nUsedChannels; ++nUsed)
+        {
+            typename TSimd::Vec vIn = TSimd::template Load<eFormat>(pFrames + objPlan.arrUsedChannels[nUsed] * g_nPcmSampleBytes<eFormat>, vIndex);
+            vSum = TSimd::Add(vSum, TSimd::Mul(vIn, TSimd::Set1(pCoeffs[nUsed])));
+        }
+        TSimd::Store(pDst + i, vSum);
+    }
+
+    ConvertRemixScalar<eFormat>(objPlan, pIn + i * nFrameBytes, pDst + i, nFrames - i);
+}
+
+template <class TSimd, ECYPcmFormat eFormat, uint32_t nFixedUsed = 0>
+static void ConvertRemixToStereoSimd(const TRemixPlan& objPlan, const void* pSrc, float* pDst, size_t nFrames)
+{
+    const uint8_t* pIn = static_cast<const uint8_t*>(pSrc);
+    const size_t nFrameBytes = size_t(objPlan.nInChannels) * g_nPcmSampleBytes<eFormat>;
+    const size_t nVector = GetVectorFrames<TSimd, eFormat>(nFrames, nFrameBytes);
+    const typename TSimd::Index vIndex = TSimd::MakeIndex(nFrameBytes);
+    const uint32_t nUsedChannels = nFixedUsed ? nFixedUsed : objPlan.nUsedChannels;
+    float arrCoeffs[g_nMaxRemixChannels * 2];
+    ScaleCoeffs<eFormat>(objPlan, 2, arrCoeffs);
+    const float* pCoeffsL = arrCoeffs;
+    const float* pCoeffsR = arrCoeffs + g_nMaxRemixChannels;
+
+    size_t i = 0;
+    for (; i < nVector; i += TSimd::nWidth)
+    {
+        const uint8_t* pFrames = pIn + i * nFrameBytes;
+        typename TSimd::Vec vSumL = TSimd::Zero();
+        typename TSimd::Vec vSumR = TSimd::Zero();
+        for (uint32_t nUsed = 0; nUsed < nUsedChannels; ++nUsed)
+        {
+            typename TSimd::Vec vIn = TSimd::template Load<eFormat>(pFrames + objPlan.arrUsedChannels[nUsed] * g_nPcmSampleBytes<eFormat>, vIndex);
+            vSumL = TSimd::Add(vSumL, TSimd::Mul(vIn, TSimd::Set1(pCoeffsL[nUsed])));
+            vSumR = TSimd::Add(vSumR, TSimd::Mul(vIn, TSimd::Set1(pCoeffsR[nUsed])));
+        }
+        TSimd::StoreStereo(pDst + i * 2, vSumL, vSumR);
+    }
+
+    ConvertRemixScalar<eFormat>(objPlan, pIn + i * nFrameBytes, pDst + i * 2, nFrames - i);
+}
+
+//------------------------------------------------------------
+// level meter
+
+// frames of the shortest run of whole vectors that starts and ends on a frame, the width is a
+// power of two so the common divisor with the channel count is the lowest channel bit.
+static inline uint32_t GetMeterBlockFrames(uint32_t nChannels, uint32_t nWidth)
+{
+    return nWidth / MIN(nChannels & (0u - nChannels), nWidth);
+}
+
+template <class TSimd>
+static inline void MeterVector(const float* pSrc, typename TSimd::Vec& vPeak, typename TSimd::Vec& vSquares, typename TSimd::Vec& vClips)
+{
+    const typename TSimd::Vec vValue = TSimd::LoadFloats(pSrc);
+    const typename TSimd::Vec vAbs = TSimd::Abs(vValue);
+    vPeak = TSimd::Max(vPeak, vAbs);
+    vSquares = TSimd::Add(vSquares, TSimd::Mul(vValue, vValue));
+    vClips = TSimd::Add(vClips, TSimd::Clipped(vAbs));
+}
+
+// nBlocks blocks of nVectors vectors added to the accumulators. The vectors of a block are spelled
+// out so the accumulators stay in registers and the adds of one block do not wait on each other.
+template <class TSimd, uint32_t nVectors>
+static inline void MeterFixedBlocks(const float* pSrc, size_t nBlocks,
+    typename TSimd::Vec* pPeak, typename TSimd::Vec* pSquares, typename TSimd::Vec* pClips)
+{
+    typename TSimd::Vec arrPeak[nVectors];
+    typename TSimd::Vec arrSquares[nVectors];
+    typename TSimd::Vec arrClips[nVectors];
+    auto forEachVector = [&]<size_t... k>(std::index_sequence<k...>, auto fnVector) { (fnVector(k), ...); };
+
+    forEachVector(std::make_index_sequence<nVectors>(), [&](size_t k)
+        {
+            arrPeak[k] = pPeak[k];
+            arrSquares[k] = pSquares[k];
+            arrClips[k] = pClips[k];
+        });
+
+    for (size_t nBlock = 0; nBlock < nBlocks; ++nBlock, pSrc += nVectors * TSimd::nWidth)
+    {
+        forEachVector(std::make_index_sequence<nVectors>(), [&](size_t k)
+            {
+                MeterVector<TSimd>(pSrc + k * TSimd::nWidth, arrPeak[k], arrSquares[k], arrClips[k]);
+            });
+    }
+
+    forEachVector(std::make_index_sequence<nVectors>(), [&](size_t k)
+        {
+            pPeak[k] = arrPeak[k];
+            pSquares[k] = arrSquares[k];
+            pClips[k] = arrClips[k];
+        });
+}
+
+template <class TSimd>
+static void MeterSimd(const float* pSrc, uint32_t nChannels, size_t nFrames, TAudioMeter& objMeter)
+{
+    // a block of lcm(channels, width) samples starts on channel 0 again, so lane j of block vector k
+    // always holds channel (k * width + j) % channels. Short blocks are doubled up to 4 vectors for
+    // independent accumulators and folded back before the lanes are summed. Clip counts stay exact
+    // in float up to 2^24.
+    uint32_t nBlockFrames = GetMeterBlockFrames(nChannels, uint32_t(TSimd::nWidth));
+    const uint32_t nBaseVectors = nChannels * nBlockFrames / uint32_t(TSimd::nWidth);
+    uint32_t nVectors = nBaseVectors;
+    if (4 % nVectors == 0)
+    {
+        nBlockFrames = nBlockFrames * 4 / nVectors;
+        nVectors = 4;
+    }
+    const size_t nBlocks = MIN(nFrames / nBlockFrames, size_t(1) << 22);
+
+    typename TSimd::Vec arrPeak[g_nMaxAudioLevelChannels];
+    typename TSimd::Vec arrSquares[g_nMaxAudioLevelChannels];
+    typename TSimd::Vec arrClips[g_nMaxAudioLevelChannels];
+    for (uint32_t k = 0; k < nVectors; ++k)
+    {
+        arrPeak[k] = TSimd::Zero();
+        arrSquares[k] = TSimd::Zero();
+        arrClips[k] = TSimd::Zero();
+    }
+
+    switch (nVectors)
+    {
+    case 3: MeterFixedBlocks<TSimd, 3>(pSrc, nBlocks, arrPeak, arrSquares, arrClips); break;
+    case 4: MeterFixedBlocks<TSimd, 4>(pSrc, nBlocks, arrPeak, arrSquares, arrClips); break;
+    default:
+        // odd channel counts, the accumulators stay in memory.
+        for (size_t nBlock = 0; nBlock < nBlocks; ++nBlock)
+        {
+            for (uint32_t k = 0; k < nVectors; ++k)
+                MeterVector<TSimd>(pSrc + (nBlock * nVectors + k) * TSimd::nWidth, arrPeak[k], arrSquares[k], arrClips[k]);
+        }
+        break;
+    }
+
+    for (uint32_t k = nBaseVectors; k < nVectors; ++k)
+    {
+        arrPeak[k % nBaseVectors] = TSimd::Max(arrPeak[k % nBaseVectors], arrPeak[k]);
+        arrSquares[k % nBaseVectors] = TSimd::Add(arrSquares[k % nBaseVectors], arrSquares[k]);
+        arrClips[k % nBaseVectors] = TSimd::Add(arrClips[k % nBaseVectors], arrClips[k]);
+    }
+
+    float arrLanes[3][TSimd::nWidth];
+    uint32_t nChannel = 0;
+    for (uint32_t k = 0; k < nBaseVectors; ++k)
+    {
+        TSimd::Store(arrLanes[0], arrPeak[k]);
+        TSimd::Store(arrLanes[1], arrSquares[k]);
+        TSimd::Store(arrLanes[2], arrClips[k]);
+        for (uint32_t j = 0; j < TSimd::nWidth; ++j, nChannel = (nChannel + 1 < nChannels) ? nChannel + 1 : 0)
+        {
+            objMeter.arrPeak[nChannel] = MAX(objMeter.arrPeak[nChannel], arrLanes[0][j]);
+            objMeter.arrSquares[nChannel] += arrLanes[1][j];
+            objMeter.arrClips[nChannel] += uint32_t(arrLanes[2][j]);
+        }
+    }
+
+    const size_t nDone = nBlocks * nBlockFrames;
+    MeterScalar(pSrc + nDone * nChannels, nChannels, nFrames - nDone, objMeter);
+}
+
+//------------------------------------------------------------
+// biquad cascade
+
+// one channel through the sections one after the other, nStride is the channel count of the frames
+// and of the state rows.
+static inline void BiquadChannel(float* pData, size_t nStride, size_t nFrames, const TAudioBiquad* pSections, uint32_t nSections, float* pState)
+{
+    for (uint32_t nSection = 0; nSection < nSections; ++nSection)
+    {
+        const TAudioBiquad& objSection = pSections[nSection];
+        float* pZ = pState + size_t(nSection) * 2 * nStride;
+        float fZ1 = pZ[0];
+        float fZ2 = pZ[nStride];
+
+        float* pSample = pData;
+        for (size_t i = 0; i < nFrames; ++i, pSample += nStride)
+        {
+            const float fIn = *pSample;
+            const float fOut = objSection.fB0 * fIn + fZ1;
+            fZ1 = objSection.fB1 * fIn + -objSection.fA1 * fOut + fZ2;
+            fZ2 = objSection.fB2 * fIn + -objSection.fA2 * fOut;
+            *pSample = fOut;
+        }
+
+        pZ[0] = fZ1;
+        pZ[nStride] = fZ2;
+    }
+}
+
+// nSections sections on a group of channels, the group is a full vector or a pair. A frame runs
+// through all sections before the next one, so the sections of one frame overlap with the next
+// frame of the section before, and coefficients and state stay in registers.
+template <class TSimd, bool bPair, uint32_t nSections>
+static inline void BiquadFixed(float* pData, uint32_t nChannels, size_t nFrames, const TAudioBiquad* pSections, float* pState)
+{
+    typedef typename TSimd::Vec Vec;
+    Vec arrCoeffs[nSections][5];
+    Vec arrZ1[nSections];
+    Vec arrZ2[nSections];
+    auto forEachSection = [&]<size_t... k>(std::index_sequence<k...>, auto fnSection) { (fnSection(k), ...); };
+    auto load = [](const float* pSrc) { if constexpr (bPair) return TSimd::LoadPair(pSrc); else return TSimd::LoadFloats(pSrc); };
+    auto store = [](float* pDst, Vec vValue) { if constexpr (bPair) TSimd::StorePair(pDst, vValue); else TSimd::Store(pDst, vValue); };
+
+    forEachSection(std::make_index_sequence<nSections>(), [&](size_t k)
+        {
+            arrCoeffs[k][0] = TSimd::Set1(pSections[k].fB0);
+            arrCoeffs[k][1] = TSimd::Set1(pSections[k].fB1);
+            arrCoeffs[k][2] = TSimd::Set1(pSections[k].fB2);
+            arrCoeffs[k][3] = TSimd::Set1(-pSections[k].fA1);
+            arrCoeffs[k][4] = TSimd::Set1(-pSections[k].fA2);
+            arrZ1[k] = load(pState + k * 2 * nChannels);
+            arrZ2[k] = load(pState + (k * 2 + 1) * nChannels);
+        });
+
+    for (size_t i = 0; i < nFrames; ++i, pData += nChannels)
+    {
+        Vec vValue = load(pData);
+        forEachSection(std::make_index_sequence<nSections>(), [&](size_t k)
+            {
+                const Vec vIn = vValue;
+                vValue = TSimd::Add(TSimd::Mul(arrCoeffs[k][0], vIn), arrZ1[k]);
+                arrZ1[k] = TSimd::Add(TSimd::Add(TSimd::Mul(arrCoeffs[k][1], vIn), TSimd::Mul(arrCoeffs[k][3], vValue)), arrZ2[k]);
+                arrZ2[k] = TSimd::Add(TSimd::Mul(arrCoeffs[k][2], vIn), TSimd::Mul(arrCoeffs[k][4], vValue));
+            });
+        store(pData, vValue);
+    }
+
+    forEachSection(std::make_index_sequence<nSections>(), [&](size_t k)
+        {
+            store(pState + k * 2 * nChannels, arrZ1[k]);
+            store(pState + (k * 2 + 1) * nChannels, arrZ2[k]);
+        });
+}
+
+template <class TSimd, bool bPair>
+static inline void BiquadGroup(float* pData, uint32_t nChannels, size_t nFrames, const TAudioBiquad* pSections, uint32_t nSections, float* pState)
+{
+    switch (nSections)
+    {
+    case 1: BiquadFixed<TSimd, bPair, 1>(pData, nChannels, nFrames, pSections, pState); break;
+    case 2: BiquadFixed<TSimd, bPair, 2>(pData, nChannels, nFrames, pSections, pState); break;
+    case 3: BiquadFixed<TSimd, bPair, 3>(pData, nChannels, nFrames, pSections, pState); break;
+    default: BiquadFixed<TSimd, bPair, 4>(pData, nChannels, nFrames, pSections, pState); break;
+    }
+}
+
+template <class TSimd, class TNarrow = TSimd>
+static void BiquadSimd(float* pData, uint32_t nChannels, size_t nFrames, const TAudioBiquad* pSections, uint32_t nSections, float* pState)
+{
+    // the channels run in parallel across the lanes, in full vectors, then in narrow ones and pairs.
+    // Longer cascades take one pass over the frames per four sections.
+    for (uint32_t nSection = 0; nSection < nSections; nSection += 4)
+    {
+        const uint32_t nCount = MIN(nSections - nSection, 4u);
+        const TAudioBiquad* pPass = pSections + nSection;
+        float* pPassState = pState + size_t(nSection) * 2 * nChannels;
+
+        uint32_t nChannel = 0;
+        for (; nChannel + TSimd::nWidth <= nChannels; nChannel += uint32_t(TSimd::nWidth))
+            BiquadGroup<TSimd, false>(pData + nChannel, nChannels, nFrames, pPass, nCount, pPassState + nChannel);
+        for (; TNarrow::nWidth < TSimd::nWidth && nChannel + TNarrow::nWidth <= nChannels; nChannel += uint32_t(TNarrow::nWidth))
+            BiquadGroup<TNarrow, false>(pData + nChannel, nChannels, nFrames, pPass, nCount, pPassState + nChannel);
+        for (; nChannel + 2 <= nChannels; nChannel += 2)
+            BiquadGroup<TNarrow, true>(pData + nChannel, nChannels, nFrames, pPass, nCount, pPassState + nChannel);
+        for (; nChannel < nChannels; ++nChannel)
+            BiquadChannel(pData + nChannel, nChannels, nFrames, pPass, nCount, pPassState + nChannel);
+    }
+}
+
+template <class TSimd>
+static void ScaleSimd(float* pData, float fGain, size_t nCount)
+{
+    const typename TSimd::Vec vGain = TSimd::Set1(fGain);
+
+    size_t i = 0;
+    for (; i + TSimd::nWidth <= nCount; i += TSimd::nWidth)
+        TSimd::Store(pData + i, TSimd::Mul(TSimd::LoadFloats(pData + i), vGain));
+
+    ScaleScalar(pData + i, fGain, nCount - i);
+}
+
+template <class TSimd>
+static void MulAddRampSimd(const float* pSrc, float fGain, float fStep, float* pDst, size_t nCount)
+{
+    static const float s_arrLanes[16] = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f };
+    const typename TSimd::Vec vLaneSteps = TSimd::Mul(TSimd::LoadFloats(s_arrLanes), TSimd::Set1(fStep));
+
+    // the gain of every vector is taken from its start index, so the ramp does not accumulate rounding.
+    size_t i = 0;
+    for (; i + TSimd::nWidth <= nCount; i += TSimd::nWidth)
+    {
+        typename TSimd::Vec vGain = TSimd::Add(TSimd::Set1(fGain + fStep * float(i)), vLaneSteps);
+        TSimd::Store(pDst + i, TSimd::Add(TSimd::LoadFloats(pDst + i), TSimd::Mul(TSimd::LoadFloats(pSrc + i), vGain)));
+    }
+
+    MulAddRampScalar(pSrc + i, fGain + fStep * float(i), fStep, pDst + i, nCount - i);
+}
+
+template <class TSimd>
+static void InterleaveStereoSimd(const float* pLeft, const float* pRight, float* pDst, size_t nFrames)
+{
+    size_t i = 0;
+    for (; i + TSimd::nWidth <= nFrames; i += TSimd::nWidth)
+        TSimd::StoreStereo(pDst + i * 2, TSimd::LoadFloats(pLeft + i), TSimd::LoadFloats(pRight + i));
+
+    InterleaveStereoScalar(pLeft + i, pRight + i, pDst + i * 2, nFrames - i);
+}
+
+//------------------------------------------------------------
+// table fill
+
+template <ECYPcmFormat eFormat>
+static inline void FillConvertRemixScalar(TAudioKernels& objKernels)
+{
+    PFN_ConvertRemix* pSlots = objKernels.arrConvertRemix[eFormat - TYPE_PCM_S8];
+    pSlots[TYPE_REMIX_SCALE] = ConvertScaleScalar<eFormat>;
+    pSlots[TYPE_REMIX_MONO] = ConvertRemixScalar<eFormat>;
+    pSlots[TYPE_REMIX_STEREO] = ConvertRemixScalar<eFormat>;
+    pSlots[TYPE_REMIX_ANY] = ConvertRemixScalar<eFormat>;
+
+    for (auto& arrShape : objKernels.arrConvertRemixFixed[eFormat - TYPE_PCM_S8])
+    {
+        for (PFN_ConvertRemix& pfnKernel : arrShape)
+            pfnKernel = ConvertRemixScalar<eFormat>;
+    }
+}
+
+template <class TSimd, ECYPcmFormat eFormat>
+static inline void FillConvertRemixSimd(TAudioKernels& objKernels)
+{
+    // any layout keeps the scalar driver, it would need a scatter for every output channel.
+    PFN_ConvertRemix* pSlots = objKernels.arrConvertRemix[eFormat - TYPE_PCM_S8];
+    pSlots[TYPE_REMIX_SCALE] = ConvertScaleSimd<TSimd, eFormat>;
+    pSlots[TYPE_REMIX_MONO] = ConvertRemixToMonoSimd<TSimd, eFormat>;
+    pSlots[TYPE_REMIX_STEREO] = ConvertRemixToStereoSimd<TSimd, eFormat>;
+
+    auto& arrFixed = objKernels.arrConvertRemixFixed[eFormat - TYPE_PCM_S8];
+    auto fillFixed = [&]<uint32_t... k>(std::integer_sequence<uint32_t, k...>)
+    {
+        ((arrFixed[0][k] = ConvertRemixToMonoSimd<TSimd, eFormat, k + 1>), ...);
+        ((arrFixed[1][k] = ConvertRemixToStereoSimd<TSimd, eFormat, k + 1>), ...);
+    };
+    fillFixed(std::make_integer_sequence<uint32_t, g_nMaxFixedRemixChannels>());
+}
+
+template <class TSimd>
+static inline void FillConvertRemixKernels(TAudioKernels& objKernels)
+{
+    FillConvertRemixSimd<TSimd, TYPE_PCM_S8>(objKernels);
+    FillConvertRemixSimd<TSimd, TYPE_PCM_S16>(objKernels);
+    FillConvertRemixSimd<TSimd, TYPE_PCM_S24>(objKernels);
+    FillConvertRemixSimd<TSimd, TYPE_PCM_S32>(objKernels);
+    FillConvertRemixSimd<TSimd, TYPE_PCM_F32>(objKernels);
+}
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_AUDIO_FUSED_KERNELS_HPP__
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "Audio/Simd/CYAudioKernels.hpp"
+#include "Common/CYDevicePrivDefine.hpp"
+
+CYDEVICE_NAMESPACE_BEGIN
+
+static ECYSimdLevel DetectSimdLevel()
+{
+    const TCpuFeatures& objFeatures = GetCpuFeatures();
+
+    if (objFeatures.bAVX512F && objFeatures.bAVX512BW && objFeatures.bFMA)
+        return TYPE_SIMD_AVX512;
+    if (objFeatures.bAVX2 && objFeatures.bFMA)
+        return TYPE_SIMD_AVX2;
+    if (objFeatures.bSSE2)
+        return TYPE_SIMD_SSE2;
+    if (objFeatures.bNEON)
+        return TYPE_SIMD_NEON;
+    return TYPE_SIMD_SCALAR;
+}
+
+TAudioKernels BuildAudioKernels(ECYSimdLevel eLevel)
+{
+    TAudioKernels objKernels;
+    FillScalarKernels(objKernels);
+
+    // Higher levels only override what they implement, the rest falls through to the level below.
+    switch (eLevel)
+    {
+    case TYPE_SIMD_AVX512:
+        FillSSE2Kernels(objKernels);
+        FillAVX2Kernels(objKernels);
+        FillAVX512Kernels(objKernels);
+        break;
+    case TYPE_SIMD_AVX2:
+        FillSSE2Kernels(objKernels);
+        FillAVX2Kernels(objKernels);
+        break;
+    case TYPE_SIMD_SSE2:
+        FillSSE2Kernels(objKernels);
+        break;
+    case TYPE_SIMD_NEON:
+        FillNEONKernels(objKernels);
+        break;
+    default:
+        break;
+    }
+
+    objKernels.eLevel = eLevel;
+    return objKernels;
+}
+
+const TAudioKernels& GetAudioKernels()
+{
+    static const TAudioKernels s_objKernels = []()
+    {
+        TAudioKernels objKernels = BuildAudioKernels(DetectSimdLevel());
+        CY_LOG_TRACE(TEXT("CYDevice: Audio kernels use SIMD level %d"), (int)objKernels.eLevel);
+        return objKernels;
+    }();
+
+    return s_objKernels;
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
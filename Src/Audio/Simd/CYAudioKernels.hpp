@@ -0,0 +1,190 @@
+#ifndef __CY_AUDIO_KERNELS_HPP__
+#define __CY_AUDIO_KERNELS_HPP__
+
+#include "Audio/CYAudioDefine.hpp"
+#include "Audio/Simd/CYCpuFeatures.hpp"
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Instruction set the kernel table was built for.
+ */
+enum ECYSimdLevel
+{
+    TYPE_SIMD_SCALAR = 0x00,
+    TYPE_SIMD_SSE2,
+    TYPE_SIMD_AVX2,
+    TYPE_SIMD_AVX512,
+    TYPE_SIMD_NEON,
+};
+
+/**
+ * Integer PCM to float scales. 8 and 16 bit divide to stay bit exact with the original scalar code,
+ * for 24 and 32 bit the reciprocal multiply gives identical results for every input value.
+ */
+constexpr float g_fS8Divisor = 127.0f;
+constexpr float g_fS16Divisor = 32767.0f;
+constexpr float g_fS24Scale = float(1.0 / 8388607.0);
+constexpr double g_dS32Scale = 1.0 / 2147483647.0;
+
+/**
+ * Float to integer PCM scales and clamps, the inverse of the input scales. The S32 upper bound is
+ * the largest float below 2^31 so the conversion never overflows.
+ */
+constexpr float g_fS16Scale = 32767.0f;
+constexpr float g_fS16Min = -32768.0f;
+constexpr float g_fS16Max = 32767.0f;
+constexpr float g_fS32Scale = 2147483647.0f;
+constexpr float g_fS32Min = -2147483648.0f;
+constexpr float g_fS32Max = 2147483520.0f;
+
+/**
+ * Turns the difference of two 24 bit uniform values into TPDF noise in (-1, 1) LSB.
+ */
+constexpr float g_fDitherScale = 1.0f / 16777216.0f;
+
+/**
+ * Integer PCM to float, nSamples counts samples of all channels.
+ */
+typedef void (*PFN_PcmToFloat)(const void* pSrc, float* pDst, size_t nSamples);
+
+/**
+ * Duplicate a mono channel into interleaved stereo.
+ */
+typedef void (*PFN_MonoToStereo)(const float* pSrc, float* pDst, size_t nFrames);
+
+/**
+ * Interleaved PCM to float, remixed through a plan in the same pass. The gain is folded into the
+ * plan coefficients, source and destination must not overlap.
+ */
+typedef void (*PFN_ConvertRemix)(const TRemixPlan& objPlan, const void* pSrc, float* pDst, size_t nFrames);
+
+/**
+ * Fused kernel table dimensions, rows are ECYPcmFormat from TYPE_PCM_S8 and columns ECYRemixShape.
+ */
+constexpr uint32_t g_nRemixPcmFormats = TYPE_PCM_F32 - TYPE_PCM_S8 + 1;
+constexpr uint32_t g_nRemixShapes = TYPE_REMIX_ANY + 1;
+
+/**
+ * Used channel counts the mono and stereo drivers are also compiled for, rows are ECYPcmFormat from
+ * TYPE_PCM_S8, then mono and stereo, then the count from 1. Wider plans are bound by their loads and
+ * keep the generic driver.
+ */
+constexpr uint32_t g_nMaxFixedRemixChannels = 2;
+
+/**
+ * Float to output samples, reads pSrc[i * nStride] so one channel of interleaved frames can be
+ * written as a plane. pDither is only used by the S16 kernel, nullptr disables the dither.
+ */
+typedef void (*PFN_FloatToPcm)(const float* pSrc, size_t nStride, void* pDst, size_t nSamples, TDitherState* pDither);
+
+/**
+ * Dot product of two float arrays, the FIR inner loop of the polyphase resampler.
+ */
+typedef float (*PFN_DotProduct)(const float* pA, const float* pB, size_t nCount);
+
+/**
+ * pDst[i] += pSrc[i] * fGain, one tap of an FIR evaluated for a run of outputs.
+ */
+typedef void (*PFN_MulAdd)(const float* pSrc, float fGain, float* pDst, size_t nCount);
+
+/**
+ * Peak, sum of squares and clipped samples of interleaved float frames, nChannels is at most
+ * g_nMaxAudioLevelChannels. A sample clips at a magnitude of 1.0 and above.
+ */
+typedef void (*PFN_Meter)(const float* pSrc, uint32_t nChannels, size_t nFrames, TAudioMeter& objMeter);
+
+/**
+ * Cascaded biquads in transposed direct form II over interleaved float frames, in place. pState holds
+ * z1 and z2 of every channel for every section, [section][z1 | z2][channel].
+ */
+typedef void (*PFN_Biquad)(float* pData, uint32_t nChannels, size_t nFrames, const TAudioBiquad* pSections, uint32_t nSections, float* pState);
+
+/**
+ * pData[i] *= fGain.
+ */
+typedef void (*PFN_Scale)(float* pData, float fGain, size_t nCount);
+
+/**
+ * pDst[i] += pSrc[i] * (fGain + i * fStep), a gain ramped across the run so a change does not click.
+ */
+typedef void (*PFN_MulAddRamp)(const float* pSrc, float fGain, float fStep, float* pDst, size_t nCount);
+
+/**
+ * Two planes into interleaved stereo frames.
+ */
+typedef void (*PFN_InterleaveStereo)(const float* pLeft, const float* pRight, float* pDst, size_t nFrames);
+
+/**
+ * Audio kernel table, every slot is always valid (scalar code is the fallback).
+ */
+struct TAudioKernels
+{
+    ECYSimdLevel eLevel = TYPE_SIMD_SCALAR;
+
+    PFN_PcmToFloat pfnS8ToFloat = nullptr;
+    PFN_PcmToFloat pfnS16ToFloat = nullptr;
+    PFN_PcmToFloat pfnS24ToFloat = nullptr;
+    PFN_PcmToFloat pfnS32ToFloat = nullptr;
+
+    PFN_MonoToStereo pfnMonoToStereo = nullptr;
+    PFN_ConvertRemix arrConvertRemix[g_nRemixPcmFormats][g_nRemixShapes] = {};
+    PFN_ConvertRemix arrConvertRemixFixed[g_nRemixPcmFormats][2][g_nMaxFixedRemixChannels] = {};
+
+    PFN_FloatToPcm pfnFloatToS16 = nullptr;
+    PFN_FloatToPcm pfnFloatToS32 = nullptr;
+    PFN_FloatToPcm pfnFloatToF32 = nullptr;
+
+    PFN_DotProduct pfnDotProduct = nullptr;
+    PFN_MulAdd pfnMulAdd = nullptr;
+
+    PFN_Meter pfnMeter = nullptr;
+
+    PFN_Biquad pfnBiquad = nullptr;
+    PFN_Scale pfnScale = nullptr;
+
+    PFN_MulAddRamp pfnMulAddRamp = nullptr;
+    PFN_InterleaveStereo pfnInterleaveStereo = nullptr;
+};
+
+/**
+ * Kernel table for the running CPU, selected once on first use.
+ */
+const TAudioKernels& GetAudioKernels();
+
+/**
+ * Kernel table for a given level, unsupported levels keep the scalar slots.
+ */
+TAudioKernels BuildAudioKernels(ECYSimdLevel eLevel);
+
+/**
+ * Scalar reference kernels, also used for the tails of the SIMD kernels.
+ */
+void S8ToFloatScalar(const void* pSrc, float* pDst, size_t nSamples);
+void S16ToFloatScalar(const void* pSrc, float* pDst, size_t nSamples);
+void S24ToFloatScalar(const void* pSrc, float* pDst, size_t nSamples);
+void S32ToFloatScalar(const void* pSrc, float* pDst, size_t nSamples);
+void MonoToStereoScalar(const float* pSrc, float* pDst, size_t nFrames);
+void FloatToS16Scalar(const float* pSrc, size_t nStride, void* pDst, size_t nSamples, TDitherState* pDither);
+void FloatToS32Scalar(const float* pSrc, size_t nStride, void* pDst, size_t nSamples, TDitherState* pDither);
+void FloatToF32Scalar(const float* pSrc, size_t nStride, void* pDst, size_t nSamples, TDitherState* pDither);
+float DotProductScalar(const float* pA, const float* pB, size_t nCount);
+void MulAddScalar(const float* pSrc, float fGain, float* pDst, size_t nCount);
+void MeterScalar(const float* pSrc, uint32_t nChannels, size_t nFrames, TAudioMeter& objMeter);
+void BiquadScalar(float* pData, uint32_t nChannels, size_t nFrames, const TAudioBiquad* pSections, uint32_t nSections, float* pState);
+void ScaleScalar(float* pData, float fGain, size_t nCount);
+void MulAddRampScalar(const float* pSrc, float fGain, float fStep, float* pDst, size_t nCount);
+void InterleaveStereoScalar(const float* pLeft, const float* pRight, float* pDst, size_t nFrames);
+
+/**
+ * Per instruction set fillers, each one only overrides the slots it implements.
+ */
+void FillScalarKernels(TAudioKernels& objKernels);
+void FillSSE2Kernels(TAudioKernels& objKernels);
+void FillAVX2Kernels(TAudioKernels& objKernels);
+void FillAVX512Kernels(TAudioKernels& objKernels);
+void FillNEONKernels(TAudioKernels& objKernels);
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_AUDIO_KERNELS_HPP__
\ No newline at end of file
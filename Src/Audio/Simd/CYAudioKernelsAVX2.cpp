@@ -0,0 +1,343 @@
+#include "Audio/Simd/CYAudioKernels.hpp"
+#include "Audio/Simd/CYAudioFusedKernels.hpp"
+
+// Built with AVX2/FMA code generation enabled, only reached when the CPU reports both.
+#if defined(CY_SIMD_X86)
+
+#include <immintrin.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+static void S8ToFloatAVX2(const void* pSrc, float* pDst, size_t nSamples)
+{
+    const int8_t* pIn = static_cast<const int8_t*>(pSrc);
+    const __m256 vDivisor = _mm256_set1_ps(g_fS8Divisor);
+
+    size_t i = 0;
+    for (; i + 16 <= nSamples; i += 16)
+    {
+        __m128i vBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + i));
+        __m256i vLo = _mm256_cvtepi8_epi32(vBytes);
+        __m256i vHi = _mm256_cvtepi8_epi32(_mm_srli_si128(vBytes, 8));
+
+        _mm256_storeu_ps(pDst + i, _mm256_div_ps(_mm256_cvtepi32_ps(vLo), vDivisor));
+        _mm256_storeu_ps(pDst + i + 8, _mm256_div_ps(_mm256_cvtepi32_ps(vHi), vDivisor));
+    }
+
+    S8ToFloatScalar(pIn + i, pDst + i, nSamples - i);
+}
+
+static void S16ToFloatAVX2(const void* pSrc, float* pDst, size_t nSamples)
+{
+    const int16_t* pIn = static_cast<const int16_t*>(pSrc);
+    const __m256 vDivisor = _mm256_set1_ps(g_fS16Divisor);
+
+    size_t i = 0;
+    for (; i + 16 <= nSamples; i += 16)
+    {
+        __m256i vLo = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + i)));
+        __m256i vHi = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + i + 8)));
+
+        _mm256_storeu_ps(pDst + i, _mm256_div_ps(_mm256_cvtepi32_ps(vLo), vDivisor));
+        _mm256_storeu_ps(pDst + i + 8, _mm256_div_ps(_mm256_cvtepi32_ps(vHi), vDivisor));
+    }
+
+    S16ToFloatScalar(pIn + i, pDst + i, nSamples - i);
+}
+
+static void S24ToFloatAVX2(const void* pSrc, float* pDst, size_t nSamples)
+{
+    const uint8_t* pIn = static_cast<const uint8_t*>(pSrc);
+    const __m256 vScale = _mm256_set1_ps(g_fS24Scale);
+
+    // 8 samples are 24 bytes, move bytes 12..27 into the upper lane so both lanes hold 4 samples at offset 0.
+    const __m256i vPermute = _mm256_setr_epi32(0, 1, 2, 3, 3, 4, 5, 6);
+    // put the 3 sample bytes at the top of every dword, the arithmetic shift sign-extends them.
+    const __m256i vShuffle = _mm256_setr_epi8(
+        -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+        -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+
+    // the 32 byte load reads 8 bytes past the 8 samples, stop early enough to stay in bounds.
+    size_t i = 0;
+    for (; i + 11 <= nSamples; i += 8)
+    {
+        __m256i vBytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pIn + i * 3));
+        vBytes = _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(vBytes, vPermute), vShuffle);
+        __m256i vVal = _mm256_srai_epi32(vBytes, 8);
+        _mm256_storeu_ps(pDst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(vVal), vScale));
+    }
+
+    S24ToFloatScalar(pIn + i * 3, pDst + i, nSamples - i);
+}
+
+static void S32ToFloatAVX2(const void* pSrc, float* pDst, size_t nSamples)
+{
+    const int32_t* pIn = static_cast<const int32_t*>(pSrc);
+    const __m256d vScale = _mm256_set1_pd(g_dS32Scale);
+
+    size_t i = 0;
+    for (; i + 8 <= nSamples; i += 8)
+    {
+        __m128i vLo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + i));
+        __m128i vHi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + i + 4));
+
+        _mm_storeu_ps(pDst + i, _mm256_cvtpd_ps(_mm256_mul_pd(_mm256_cvtepi32_pd(vLo), vScale)));
+        _mm_storeu_ps(pDst + i + 4, _mm256_cvtpd_ps(_mm256_mul_pd(_mm256_cvtepi32_pd(vHi), vScale)));
+    }
+
+    S32ToFloatScalar(pIn + i, pDst + i, nSamples - i);
+}
+
+static void MonoToStereoAVX2(const float* pSrc, float* pDst, size_t nFrames)
+{
+    size_t i = 0;
+    for (; i + 8 <= nFrames; i += 8)
+    {
+        __m256 vIn = _mm256_loadu_ps(pSrc + i);
+        __m256 vLo = _mm256_unpacklo_ps(vIn, vIn);
+        __m256 vHi = _mm256_unpackhi_ps(vIn, vIn);
+        _mm256_storeu_ps(pDst + i * 2, _mm256_permute2f128_ps(vLo, vHi, 0x20));
+        _mm256_storeu_ps(pDst + i * 2 + 8, _mm256_permute2f128_ps(vLo, vHi, 0x31));
+    }
+
+    MonoToStereoScalar(pSrc + i, pDst + i * 2, nFrames - i);
+}
+
+// fused kernel traits, samples are gathered as 4 byte words at byte offsets.
+struct TSimdAVX2
+{
+    typedef __m256 Vec;
+    typedef __m256i Index;
+    static constexpr size_t nWidth = 8;
+
+    static Index MakeIndex(size_t nStride)
+    {
+        return _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(int(nStride)));
+    }
+
+    template <ECYPcmFormat eFormat>
+    static Vec Load(const uint8_t* pSrc, const Index& vIndex)
+    {
+        if constexpr (eFormat == TYPE_PCM_F32)
+        {
+            return _mm256_i32gather_ps(reinterpret_cast<const float*>(pSrc), vIndex, 1);
+        }
+        else
+        {
+            // the sample sits in the low bytes of the word, shift it up and back down to sign-extend it.
+            constexpr int nShift = int(32 - g_nPcmSampleBytes<eFormat> * 8);
+            __m256i vVal = _mm256_i32gather_epi32(reinterpret_cast<const int*>(pSrc), vIndex, 1);
+            vVal = _mm256_srai_epi32(_mm256_slli_epi32(vVal, nShift), nShift);
+            return _mm256_cvtepi32_ps(vVal);
+        }
+    }
+
+    static Vec Zero() { return _mm256_setzero_ps(); }
+    static Vec Set1(float fValue) { return _mm256_set1_ps(fValue); }
+    static Vec Mul(Vec vA, Vec vB) { return _mm256_mul_ps(vA, vB); }
+    static Vec Add(Vec vA, Vec vB) { return _mm256_add_ps(vA, vB); }
+    static void Store(float* pDst, Vec vValue) { _mm256_storeu_ps(pDst, vValue); }
+    static Vec LoadFloats(const float* pSrc) { return _mm256_loadu_ps(pSrc); }
+    static Vec Abs(Vec vValue) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), vValue); }
+    static Vec Max(Vec vA, Vec vB) { return _mm256_max_ps(vA, vB); }
+    static Vec Clipped(Vec vAbs) { return _mm256_and_ps(_mm256_cmp_ps(vAbs, _mm256_set1_ps(1.0f), _CMP_GE_OQ), _mm256_set1_ps(1.0f)); }
+
+    static void StoreStereo(float* pDst, Vec vLeft, Vec vRight)
+    {
+        // the unpacks interleave per 128 bit lane, the lane permutes restore frame order.
+        __m256 vLo = _mm256_unpacklo_ps(vLeft, vRight);
+        __m256 vHi = _mm256_unpackhi_ps(vLeft, vRight);
+        _mm256_storeu_ps(pDst, _mm256_permute2f128_ps(vLo, vHi, 0x20));
+        _mm256_storeu_ps(pDst + 8, _mm256_permute2f128_ps(vLo, vHi, 0x31));
+    }
+};
+
+// 128 bit vectors for the channels left over by the 8 lane biquad groups.
+struct TSimdAVX2Narrow
+{
+    typedef __m128 Vec;
+    static constexpr size_t nWidth = 4;
+
+    static Vec Set1(float fValue) { return _mm_set1_ps(fValue); }
+    static Vec Mul(Vec vA, Vec vB) { return _mm_mul_ps(vA, vB); }
+    static Vec Add(Vec vA, Vec vB) { return _mm_add_ps(vA, vB); }
+    static void Store(float* pDst, Vec vValue) { _mm_storeu_ps(pDst, vValue); }
+    static Vec LoadFloats(const float* pSrc) { return _mm_loadu_ps(pSrc); }
+    static Vec LoadPair(const float* pSrc) { return _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(pSrc))); }
+    static void StorePair(float* pDst, Vec vValue) { _mm_store_sd(reinterpret_cast<double*>(pDst), _mm_castps_pd(vValue)); }
+};
+
+// lane offsets of nStride spaced samples for the gather.
+static inline __m256i StrideIndex8(size_t nStride)
+{
+    return _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(int(nStride)));
+}
+
+static inline __m256 LoadStrided8(const float* pSrc, size_t nStride, __m256i vIndex)
+{
+    if (nStride == 1)
+        return _mm256_loadu_ps(pSrc);
+    return _mm256_i32gather_ps(pSrc, vIndex, 4);
+}
+
+static inline __m256i XorShift8(__m256i vState)
+{
+    vState = _mm256_xor_si256(vState, _mm256_slli_epi32(vState, 13));
+    vState = _mm256_xor_si256(vState, _mm256_srli_epi32(vState, 17));
+    return _mm256_xor_si256(vState, _mm256_slli_epi32(vState, 5));
+}
+
+static inline __m256 NextDither8(__m256i& vState)
+{
+    vState = XorShift8(vState);
+    __m256i vFirst = _mm256_srli_epi32(vState, 8);
+    vState = XorShift8(vState);
+    __m256i vDiff = _mm256_sub_epi32(vFirst, _mm256_srli_epi32(vState, 8));
+    return _mm256_mul_ps(_mm256_cvtepi32_ps(vDiff), _mm256_set1_ps(g_fDitherScale));
+}
+
+static void FloatToS16AVX2(const float* pSrc, size_t nStride, void* pDst, size_t nSamples, TDitherState* pDither)
+{
+    int16_t* pOut = static_cast<int16_t*>(pDst);
+    const __m256i vIndex = StrideIndex8(nStride);
+    const __m256 vScale = _mm256_set1_ps(g_fS16Scale);
+    const __m256 vMin = _mm256_set1_ps(g_fS16Min);
+    const __m256 vMax = _mm256_set1_ps(g_fS16Max);
+    __m256i vState = pDither ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pDither->arrState)) : _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 16 <= nSamples; i += 16)
+    {
+        __m256 vLo = _mm256_mul_ps(LoadStrided8(pSrc + i * nStride, nStride, vIndex), vScale);
+        __m256 vHi = _mm256_mul_ps(LoadStrided8(pSrc + (i + 8) * nStride, nStride, vIndex), vScale);
+        if (pDither)
+        {
+            vLo = _mm256_add_ps(vLo, NextDither8(vState));
+            vHi = _mm256_add_ps(vHi, NextDither8(vState));
+        }
+
+        __m256i vLoWord = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(vLo, vMin), vMax));
+        __m256i vHiWord = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(vHi, vMin), vMax));
+        // the pack works per 128 bit lane, the permute restores the sample order.
+        __m256i vPacked = _mm256_permute4x64_epi64(_mm256_packs_epi32(vLoWord, vHiWord), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pOut + i), vPacked);
+    }
+
+    if (pDither)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDither->arrState), vState);
+
+    FloatToS16Scalar(pSrc + i * nStride, nStride, pOut + i, nSamples - i, pDither);
+}
+
+static void FloatToS32AVX2(const float* pSrc, size_t nStride, void* pDst, size_t nSamples, TDitherState* pDither)
+{
+    int32_t* pOut = static_cast<int32_t*>(pDst);
+    const __m256i vIndex = StrideIndex8(nStride);
+    const __m256 vScale = _mm256_set1_ps(g_fS32Scale);
+    const __m256 vMin = _mm256_set1_ps(g_fS32Min);
+    const __m256 vMax = _mm256_set1_ps(g_fS32Max);
+
+    size_t i = 0;
+    for (; i + 8 <= nSamples; i += 8)
+    {
+        __m256 vVal = _mm256_mul_ps(LoadStrided8(pSrc + i * nStride, nStride, vIndex), vScale);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pOut + i), _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(vVal, vMin), vMax)));
+    }
+
+    FloatToS32Scalar(pSrc + i * nStride, nStride, pOut + i, nSamples - i, pDither);
+}
+
+static void FloatToF32AVX2(const float* pSrc, size_t nStride, void* pDst, size_t nSamples, TDitherState* pDither)
+{
+    float* pOut = static_cast<float*>(pDst);
+    const __m256i vIndex = StrideIndex8(nStride);
+
+    size_t i = 0;
+    for (; i + 8 <= nSamples; i += 8)
+        _mm256_storeu_ps(pOut + i, LoadStrided8(pSrc + i * nStride, nStride, vIndex));
+
+    FloatToF32Scalar(pSrc + i * nStride, nStride, pOut + i, nSamples - i, pDither);
+}
+
+static float DotProductAVX2(const float* pA, const float* pB, size_t nCount)
+{
+    __m256 vSum0 = _mm256_setzero_ps();
+    __m256 vSum1 = _mm256_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 16 <= nCount; i += 16)
+    {
+        vSum0 = _mm256_fmadd_ps(_mm256_loadu_ps(pA + i), _mm256_loadu_ps(pB + i), vSum0);
+        vSum1 = _mm256_fmadd_ps(_mm256_loadu_ps(pA + i + 8), _mm256_loadu_ps(pB + i + 8), vSum1);
+    }
+    if (i + 8 <= nCount)
+    {
+        vSum0 = _mm256_fmadd_ps(_mm256_loadu_ps(pA + i), _mm256_loadu_ps(pB + i), vSum0);
+        i += 8;
+    }
+
+    __m256 vSum = _mm256_add_ps(vSum0, vSum1);
+    __m128 vHalf = _mm_add_ps(_mm256_castps256_ps128(vSum), _mm256_extractf128_ps(vSum, 1));
+    vHalf = _mm_add_ps(vHalf, _mm_movehl_ps(vHalf, vHalf));
+    vHalf = _mm_add_ss(vHalf, _mm_shuffle_ps(vHalf, vHalf, 0x55));
+    return _mm_cvtss_f32(vHalf) + DotProductScalar(pA + i, pB + i, nCount - i);
+}
+
+static void MulAddAVX2(const float* pSrc, float fGain, float* pDst, size_t nCount)
+{
+    const __m256 vGain = _mm256_set1_ps(fGain);
+
+    size_t i = 0;
+    for (; i + 16 <= nCount; i += 16)
+    {
+        _mm256_storeu_ps(pDst + i, _mm256_fmadd_ps(_mm256_loadu_ps(pSrc + i), vGain, _mm256_loadu_ps(pDst + i)));
+        _mm256_storeu_ps(pDst + i + 8, _mm256_fmadd_ps(_mm256_loadu_ps(pSrc + i + 8), vGain, _mm256_loadu_ps(pDst + i + 8)));
+    }
+    if (i + 8 <= nCount)
+    {
+        _mm256_storeu_ps(pDst + i, _mm256_fmadd_ps(_mm256_loadu_ps(pSrc + i), vGain, _mm256_loadu_ps(pDst + i)));
+        i += 8;
+    }
+
+    MulAddScalar(pSrc + i, fGain, pDst + i, nCount - i);
+}
+
+void FillAVX2Kernels(TAudioKernels& objKernels)
+{
+    objKernels.pfnS8ToFloat = S8ToFloatAVX2;
+    objKernels.pfnS16ToFloat = S16ToFloatAVX2;
+    objKernels.pfnS24ToFloat = S24ToFloatAVX2;
+    objKernels.pfnS32ToFloat = S32ToFloatAVX2;
+
+    objKernels.pfnMonoToStereo = MonoToStereoAVX2;
+    FillConvertRemixKernels<TSimdAVX2>(objKernels);
+
+    objKernels.pfnFloatToS16 = FloatToS16AVX2;
+    objKernels.pfnFloatToS32 = FloatToS32AVX2;
+    objKernels.pfnFloatToF32 = FloatToF32AVX2;
+
+    objKernels.pfnDotProduct = DotProductAVX2;
+    objKernels.pfnMulAdd = MulAddAVX2;
+
+    objKernels.pfnMeter = MeterSimd<TSimdAVX2>;
+
+    objKernels.pfnBiquad = BiquadSimd<TSimdAVX2, TSimdAVX2Narrow>;
+    objKernels.pfnScale = ScaleSimd<TSimdAVX2>;
+
+    objKernels.pfnMulAddRamp = MulAddRampSimd<TSimdAVX2>;
+    objKernels.pfnInterleaveStereo = InterleaveStereoSimd<TSimdAVX2>;
+}
+
+CYDEVICE_NAMESPACE_END
+
+#else
+
+CYDEVICE_NAMESPACE_BEGIN
+
+void FillAVX2Kernels(TAudioKernels& /*objKernels*/)
+{
+}
+
+CYDEVICE_NAMESPACE_END
+
+#endif
\ No newline at end of file
@@ -0,0 +1,200 @@
+#include "Audio/Simd/CYAudioKernels.hpp"
+
+// Built with AVX-512F/BW code generation enabled, only reached when the CPU reports both.
+#if defined(CY_SIMD_X86)
+
+#include <immintrin.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+// Every lane set, the zero-masked forms with it are the plain instructions. GCC 12 builds the plain
+// forms on an undefined source and warns about it under -Wall, the zero-masked ones have none.
+constexpr __mmask16 g_nAllLanes16 = 0xFFFF;
+constexpr __mmask8 g_nAllLanes8 = 0xFF;
+
+static void S8ToFloatAVX512(const void* pSrc, float* pDst, size_t nSamples)
+{
+    const int8_t* pIn = static_cast<const int8_t*>(pSrc);
+    const __m512 vDivisor = _mm512_set1_ps(g_fS8Divisor);
+
+    size_t i = 0;
+    for (; i + 32 <= nSamples; i += 32)
+    {
+        __m512i vLo = _mm512_maskz_cvtepi8_epi32(g_nAllLanes16, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + i)));
+        __m512i vHi = _mm512_maskz_cvtepi8_epi32(g_nAllLanes16, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + i + 16)));
+
+        _mm512_storeu_ps(pDst + i, _mm512_div_ps(_mm512_maskz_cvtepi32_ps(g_nAllLanes16, vLo), vDivisor));
+        _mm512_storeu_ps(pDst + i + 16, _mm512_div_ps(_mm512_maskz_cvtepi32_ps(g_nAllLanes16, vHi), vDivisor));
+    }
+
+    S8ToFloatScalar(pIn + i, pDst + i, nSamples - i);
+}
+
+static void S16ToFloatAVX512(const void* pSrc, float* pDst, size_t nSamples)
+{
+    const int16_t* pIn = static_cast<const int16_t*>(pSrc);
+    const __m512 vDivisor = _mm512_set1_ps(g_fS16Divisor);
+
+    size_t i = 0;
+    for (; i + 32 <= nSamples; i += 32)
+    {
+        __m512i vLo = _mm512_maskz_cvtepi16_epi32(g_nAllLanes16, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pIn + i)));
+        __m512i vHi = _mm512_maskz_cvtepi16_epi32(g_nAllLanes16, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pIn + i + 16)));
+
+        _mm512_storeu_ps(pDst + i, _mm512_div_ps(_mm512_maskz_cvtepi32_ps(g_nAllLanes16, vLo), vDivisor));
+        _mm512_storeu_ps(pDst + i + 16, _mm512_div_ps(_mm512_maskz_cvtepi32_ps(g_nAllLanes16, vHi), vDivisor));
+    }
+
+    S16ToFloatScalar(pIn + i, pDst + i, nSamples - i);
+}
+
+static void S24ToFloatAVX512(const void* pSrc, float* pDst, size_t nSamples)
+{
+    const uint8_t* pIn = static_cast<const uint8_t*>(pSrc);
+    const __m512 vScale = _mm512_set1_ps(g_fS24Scale);
+
+    // 16 samples are 48 bytes, lane k starts at byte 12 * k after the dword permute.
+    const __m512i vPermute = _mm512_setr_epi32(0, 1, 2, 3, 3, 4, 5, 6, 6, 7, 8, 9, 9, 10, 11, 12);
+    const __m512i vShuffle = _mm512_maskz_broadcast_i32x4(g_nAllLanes16, _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11));
+    // the masked load only touches the 48 bytes that belong to the samples.
+    const __mmask64 nLoadMask = (1ull << 48) - 1;
+
+    size_t i = 0;
+    for (; i + 16 <= nSamples; i += 16)
+    {
+        __m512i vBytes = _mm512_maskz_loadu_epi8(nLoadMask, pIn + i * 3);
+        vBytes = _mm512_shuffle_epi8(_mm512_maskz_permutexvar_epi32(g_nAllLanes16, vPermute, vBytes), vShuffle);
+        __m512i vVal = _mm512_maskz_srai_epi32(g_nAllLanes16, vBytes, 8);
+        _mm512_storeu_ps(pDst + i, _mm512_mul_ps(_mm512_maskz_cvtepi32_ps(g_nAllLanes16, vVal), vScale));
+    }
+
+    S24ToFloatScalar(pIn + i * 3, pDst + i, nSamples - i);
+}
+
+static void S32ToFloatAVX512(const void* pSrc, float* pDst, size_t nSamples)
+{
+    const int32_t* pIn = static_cast<const int32_t*>(pSrc);
+    const __m512d vScale = _mm512_set1_pd(g_dS32Scale);
+
+    size_t i = 0;
+    for (; i + 16 <= nSamples; i += 16)
+    {
+        __m256i vLo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pIn + i));
+        __m256i vHi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pIn + i + 8));
+
+        _mm256_storeu_ps(pDst + i, _mm512_maskz_cvtpd_ps(g_nAllLanes8, _mm512_mul_pd(_mm512_maskz_cvtepi32_pd(g_nAllLanes8, vLo), vScale)));
+        _mm256_storeu_ps(pDst + i + 8, _mm512_maskz_cvtpd_ps(g_nAllLanes8, _mm512_mul_pd(_mm512_maskz_cvtepi32_pd(g_nAllLanes8, vHi), vScale)));
+    }
+
+    S32ToFloatScalar(pIn + i, pDst + i, nSamples - i);
+}
+
+static inline __m512i StrideIndex16(size_t nStride)
+{
+    return _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), _mm512_set1_epi32(int(nStride)));
+}
+
+static inline __m512 LoadStrided16(const float* pSrc, size_t nStride, __m512i vIndex)
+{
+    if (nStride == 1)
+        return _mm512_loadu_ps(pSrc);
+    return _mm512_mask_i32gather_ps(_mm512_setzero_ps(), g_nAllLanes16, vIndex, pSrc, 4);
+}
+
+static inline __m512i XorShift16(__m512i vState)
+{
+    vState = _mm512_xor_si512(vState, _mm512_maskz_slli_epi32(g_nAllLanes16, vState, 13));
+    vState = _mm512_xor_si512(vState, _mm512_maskz_srli_epi32(g_nAllLanes16, vState, 17));
+    return _mm512_xor_si512(vState, _mm512_maskz_slli_epi32(g_nAllLanes16, vState, 5));
+}
+
+static inline __m512 NextDither16(__m512i& vState)
+{
+    vState = XorShift16(vState);
+    __m512i vFirst = _mm512_maskz_srli_epi32(g_nAllLanes16, vState, 8);
+    vState = XorShift16(vState);
+    __m512i vDiff = _mm512_sub_epi32(vFirst, _mm512_maskz_srli_epi32(g_nAllLanes16, vState, 8));
+    return _mm512_mul_ps(_mm512_maskz_cvtepi32_ps(g_nAllLanes16, vDiff), _mm512_set1_ps(g_fDitherScale));
+}
+
+static void FloatToS16AVX512(const float* pSrc, size_t nStride, void* pDst, size_t nSamples, TDitherState* pDither)
+{
+    int16_t* pOut = static_cast<int16_t*>(pDst);
+    const __m512i vIndex = StrideIndex16(nStride);
+    const __m512 vScale = _mm512_set1_ps(g_fS16Scale);
+    const __m512 vMin = _mm512_set1_ps(g_fS16Min);
+    const __m512 vMax = _mm512_set1_ps(g_fS16Max);
+    __m512i vState = pDither ? _mm512_loadu_si512(pDither->arrState) : _mm512_setzero_si512();
+
+    size_t i = 0;
+    for (; i + 16 <= nSamples; i += 16)
+    {
+        __m512 vVal = _mm512_mul_ps(LoadStrided16(pSrc + i * nStride, nStride, vIndex), vScale);
+        if (pDither)
+            vVal = _mm512_add_ps(vVal, NextDither16(vState));
+
+        __m512i vWord = _mm512_maskz_cvtps_epi32(g_nAllLanes16, _mm512_maskz_min_ps(g_nAllLanes16, _mm512_maskz_max_ps(g_nAllLanes16, vVal, vMin), vMax));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pOut + i), _mm512_maskz_cvtsepi32_epi16(g_nAllLanes16, vWord));
+    }
+
+    if (pDither)
+        _mm512_storeu_si512(pDither->arrState, vState);
+
+    FloatToS16Scalar(pSrc + i * nStride, nStride, pOut + i, nSamples - i, pDither);
+}
+
+static void FloatToS32AVX512(const float* pSrc, size_t nStride, void* pDst, size_t nSamples, TDitherState* pDither)
+{
+    int32_t* pOut = static_cast<int32_t*>(pDst);
+    const __m512i vIndex = StrideIndex16(nStride);
+    const __m512 vScale = _mm512_set1_ps(g_fS32Scale);
+    const __m512 vMin = _mm512_set1_ps(g_fS32Min);
+    const __m512 vMax = _mm512_set1_ps(g_fS32Max);
+
+    size_t i = 0;
+    for (; i + 16 <= nSamples; i += 16)
+    {
+        __m512 vVal = _mm512_mul_ps(LoadStrided16(pSrc + i * nStride, nStride, vIndex), vScale);
+        _mm512_storeu_si512(pOut + i, _mm512_maskz_cvtps_epi32(g_nAllLanes16, _mm512_maskz_min_ps(g_nAllLanes16, _mm512_maskz_max_ps(g_nAllLanes16, vVal, vMin), vMax)));
+    }
+
+    FloatToS32Scalar(pSrc + i * nStride, nStride, pOut + i, nSamples - i, pDither);
+}
+
+static void FloatToF32AVX512(const float* pSrc, size_t nStride, void* pDst, size_t nSamples, TDitherState* pDither)
+{
+    float* pOut = static_cast<float*>(pDst);
+    const __m512i vIndex = StrideIndex16(nStride);
+
+    size_t i = 0;
+    for (; i + 16 <= nSamples; i += 16)
+        _mm512_storeu_ps(pOut + i, LoadStrided16(pSrc + i * nStride, nStride, vIndex));
+
+    FloatToF32Scalar(pSrc + i * nStride, nStride, pOut + i, nSamples - i, pDither);
+}
+
+void FillAVX512Kernels(TAudioKernels& objKernels)
+{
+    objKernels.pfnS8ToFloat = S8ToFloatAVX512;
+    objKernels.pfnS16ToFloat = S16ToFloatAVX512;
+    objKernels.pfnS24ToFloat = S24ToFloatAVX512;
+    objKernels.pfnS32ToFloat = S32ToFloatAVX512;
+
+    objKernels.pfnFloatToS16 = FloatToS16AVX512;
+    objKernels.pfnFloatToS32 = FloatToS32AVX512;
+    objKernels.pfnFloatToF32 = FloatToF32AVX512;
+}
+
+CYDEVICE_NAMESPACE_END
+
+#else
+
+CYDEVICE_NAMESPACE_BEGIN
+
+void FillAVX512Kernels(TAudioKernels& /*objKernels*/)
+{
+}
+
+CYDEVICE_NAMESPACE_END
+
+#endif
\ No newline at end of file
@@ -0,0 +1,317 @@
+#include "Audio/Simd/CYAudioKernels.hpp"
+#include "Audio/Simd/CYAudioFusedKernels.hpp"
+
+#if defined(CY_SIMD_NEON)
+
+#include <arm_neon.h>
+#include <string.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+static void S8ToFloatNEON(const void* pSrc, float* pDst, size_t nSamples)
+{
+    const int8_t* pIn = static_cast<const int8_t*>(pSrc);
+    const float32x4_t vDivisor = vdupq_n_f32(g_fS8Divisor);
+
+    size_t i = 0;
+    for (; i + 16 <= nSamples; i += 16)
+    {
+        int8x16_t vBytes = vld1q_s8(pIn + i);
+        int16x8_t vLo16 = vmovl_s8(vget_low_s8(vBytes));
+        int16x8_t vHi16 = vmovl_s8(vget_high_s8(vBytes));
+
+        vst1q_f32(pDst + i, vdivq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(vLo16))), vDivisor));
+        vst1q_f32(pDst + i + 4, vdivq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(vLo16))), vDivisor));
+        vst1q_f32(pDst + i + 8, vdivq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(vHi16))), vDivisor));
+        vst1q_f32(pDst + i + 12, vdivq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(vHi16))), vDivisor));
+    }
+
+    S8ToFloatScalar(pIn + i, pDst + i, nSamples - i);
+}
+
+static void S16ToFloatNEON(const void* pSrc, float* pDst, size_t nSamples)
+{
+    const int16_t* pIn = static_cast<const int16_t*>(pSrc);
+    const float32x4_t vDivisor = vdupq_n_f32(g_fS16Divisor);
+
+    size_t i = 0;
+    for (; i + 8 <= nSamples; i += 8)
+    {
+        int16x8_t vWords = vld1q_s16(pIn + i);
+        vst1q_f32(pDst + i, vdivq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(vWords))), vDivisor));
+        vst1q_f32(pDst + i + 4, vdivq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(vWords))), vDivisor));
+    }
+
+    S16ToFloatScalar(pIn + i, pDst + i, nSamples - i);
+}
+
+static void S24ToFloatNEON(const void* pSrc, float* pDst, size_t nSamples)
+{
+    const uint8_t* pIn = static_cast<const uint8_t*>(pSrc);
+    const float32x4_t vScale = vdupq_n_f32(g_fS24Scale);
+
+    size_t i = 0;
+    for (; i + 8 <= nSamples; i += 8)
+    {
+        // de-interleave the low, middle and high bytes of 8 samples.
+        uint8x8x3_t vBytes = vld3_u8(pIn + i * 3);
+        // high:middle as a signed 16 bit word, widened and shifted up by 8 keeps the sign.
+        int16x8_t vTop = vreinterpretq_s16_u8(vcombine_u8(vzip1_u8(vBytes.val[1], vBytes.val[2]), vzip2_u8(vBytes.val[1], vBytes.val[2])));
+        uint16x8_t vLow = vmovl_u8(vBytes.val[0]);
+
+        int32x4_t vLo = vorrq_s32(vshll_n_s16(vget_low_s16(vTop), 8), vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(vLow))));
+        int32x4_t vHi = vorrq_s32(vshll_n_s16(vget_high_s16(vTop), 8), vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(vLow))));
+
+        vst1q_f32(pDst + i, vmulq_f32(vcvtq_f32_s32(vLo), vScale));
+        vst1q_f32(pDst + i + 4, vmulq_f32(vcvtq_f32_s32(vHi), vScale));
+    }
+
+    S24ToFloatScalar(pIn + i * 3, pDst + i, nSamples - i);
+}
+
+static void S32ToFloatNEON(const void* pSrc, float* pDst, size_t nSamples)
+{
+    const int32_t* pIn = static_cast<const int32_t*>(pSrc);
+    const float64x2_t vScale = vdupq_n_f64(g_dS32Scale);
+
+    size_t i = 0;
+    for (; i + 4 <= nSamples; i += 4)
+    {
+        int32x4_t vVal = vld1q_s32(pIn + i);
+        float64x2_t vLo = vmulq_f64(vcvtq_f64_s64(vmovl_s32(vget_low_s32(vVal))), vScale);
+        float64x2_t vHi = vmulq_f64(vcvtq_f64_s64(vmovl_s32(vget_high_s32(vVal))), vScale);
+        vst1q_f32(pDst + i, vcvt_high_f32_f64(vcvt_f32_f64(vLo), vHi));
+    }
+
+    S32ToFloatScalar(pIn + i, pDst + i, nSamples - i);
+}
+
+static void MonoToStereoNEON(const float* pSrc, float* pDst, size_t nFrames)
+{
+    size_t i = 0;
+    for (; i + 4 <= nFrames; i += 4)
+    {
+        float32x4x2_t vOut;
+        vOut.val[0] = vld1q_f32(pSrc + i);
+        vOut.val[1] = vOut.val[0];
+        vst2q_f32(pDst + i * 2, vOut);
+    }
+
+    MonoToStereoScalar(pSrc + i, pDst + i * 2, nFrames - i);
+}
+
+static inline int32_t LoadWord32(const uint8_t* pIn)
+{
+    int32_t nVal;
+    memcpy(&nVal, pIn, sizeof(nVal));
+    return nVal;
+}
+
+// fused kernel traits, every lane is fetched with a scalar load and converted in the vector.
+struct TSimdNEON
+{
+    typedef float32x4_t Vec;
+    typedef size_t Index;
+    static constexpr size_t nWidth = 4;
+
+    static Index MakeIndex(size_t nStride) { return nStride; }
+
+    template <ECYPcmFormat eFormat>
+    static Vec Load(const uint8_t* pSrc, const Index& nStride)
+    {
+        if constexpr (eFormat == TYPE_PCM_F32)
+        {
+            float32x4_t vIn = vdupq_n_f32(LoadPcmSample<eFormat>(pSrc));
+            vIn = vsetq_lane_f32(LoadPcmSample<eFormat>(pSrc + nStride), vIn, 1);
+            vIn = vsetq_lane_f32(LoadPcmSample<eFormat>(pSrc + nStride * 2), vIn, 2);
+            return vsetq_lane_f32(LoadPcmSample<eFormat>(pSrc + nStride * 3), vIn, 3);
+        }
+        else
+        {
+            // the sample sits in the low bytes of the word, shift it up and back down to sign-extend it.
+            constexpr int nShift = int(32 - g_nPcmSampleBytes<eFormat> * 8);
+            int32x4_t vVal = vdupq_n_s32(LoadWord32(pSrc));
+            vVal = vsetq_lane_s32(LoadWord32(pSrc + nStride), vVal, 1);
+            vVal = vsetq_lane_s32(LoadWord32(pSrc + nStride * 2), vVal, 2);
+            vVal = vsetq_lane_s32(LoadWord32(pSrc + nStride * 3), vVal, 3);
+            if constexpr (nShift > 0)
+                vVal = vshrq_n_s32(vshlq_n_s32(vVal, nShift), nShift);
+            return vcvtq_f32_s32(vVal);
+        }
+    }
+
+    static Vec Zero() { return vdupq_n_f32(0.0f); }
+    static Vec Set1(float fValue) { return vdupq_n_f32(fValue); }
+    static Vec Mul(Vec vA, Vec vB) { return vmulq_f32(vA, vB); }
+    static Vec Add(Vec vA, Vec vB) { return vaddq_f32(vA, vB); }
+    static void Store(float* pDst, Vec vValue) { vst1q_f32(pDst, vValue); }
+    static Vec LoadFloats(const float* pSrc) { return vld1q_f32(pSrc); }
+    static Vec Abs(Vec vValue) { return vabsq_f32(vValue); }
+    static Vec Max(Vec vA, Vec vB) { return vmaxq_f32(vA, vB); }
+
+    static Vec Clipped(Vec vAbs)
+    static Vec LoadPair(const float* pSrc) { return vcombine_f32(vld1_f32(pSrc), vdup_n_f32(0.0f)); }
+    static void StorePair(float* pDst, Vec vValue) { vst1_f32(pDst, vget_low_f32(vValue)); }
+    {
+        const uint32x4_t vMask = vcgeq_f32(vAbs, vdupq_n_f32(1.0f));
+        return vreinterpretq_f32_u32(vandq_u32(vMask, vreinterpretq_u32_f32(vdupq_n_f32(1.0f))));
+    }
+
+    static void StoreStereo(float* pDst, Vec vLeft, Vec vRight)
+    {
+        float32x4x2_t vPair;
+        vPair.val[0] = vLeft;
+        vPair.val[1] = vRight;
+        vst2q_f32(pDst, vPair);
+    }
+};
+
+static inline float32x4_t LoadStrided4(const float* pSrc, size_t nStride)
+{
+    if (nStride == 1)
+        return vld1q_f32(pSrc);
+
+    float32x4_t vIn = vdupq_n_f32(pSrc[0]);
+    vIn = vsetq_lane_f32(pSrc[nStride], vIn, 1);
+    vIn = vsetq_lane_f32(pSrc[nStride * 2], vIn, 2);
+    return vsetq_lane_f32(pSrc[nStride * 3], vIn, 3);
+}
+
+static inline uint32x4_t XorShift4(uint32x4_t vState)
+{
+    vState = veorq_u32(vState, vshlq_n_u32(vState, 13));
+    vState = veorq_u32(vState, vshrq_n_u32(vState, 17));
+    return veorq_u32(vState, vshlq_n_u32(vState, 5));
+}
+
+static inline float32x4_t NextDither4(uint32x4_t& vState)
+{
+    vState = XorShift4(vState);
+    int32x4_t vFirst = vreinterpretq_s32_u32(vshrq_n_u32(vState, 8));
+    vState = XorShift4(vState);
+    int32x4_t vDiff = vsubq_s32(vFirst, vreinterpretq_s32_u32(vshrq_n_u32(vState, 8)));
+    return vmulq_n_f32(vcvtq_f32_s32(vDiff), g_fDitherScale);
+}
+
+static void FloatToS16NEON(const float* pSrc, size_t nStride, void* pDst, size_t nSamples, TDitherState* pDither)
+{
+    int16_t* pOut = static_cast<int16_t*>(pDst);
+    const float32x4_t vMin = vdupq_n_f32(g_fS16Min);
+    const float32x4_t vMax = vdupq_n_f32(g_fS16Max);
+    uint32x4_t vState = pDither ? vld1q_u32(pDither->arrState) : vdupq_n_u32(0);
+
+    size_t i = 0;
+    for (; i + 8 <= nSamples; i += 8)
+    {
+        float32x4_t vLo = vmulq_n_f32(LoadStrided4(pSrc + i * nStride, nStride), g_fS16Scale);
+        float32x4_t vHi = vmulq_n_f32(LoadStrided4(pSrc + (i + 4) * nStride, nStride), g_fS16Scale);
+        if (pDither)
+        {
+            vLo = vaddq_f32(vLo, NextDither4(vState));
+            vHi = vaddq_f32(vHi, NextDither4(vState));
+        }
+
+        int32x4_t vLoWord = vcvtnq_s32_f32(vminq_f32(vmaxq_f32(vLo, vMin), vMax));
+        int32x4_t vHiWord = vcvtnq_s32_f32(vminq_f32(vmaxq_f32(vHi, vMin), vMax));
+        vst1q_s16(pOut + i, vcombine_s16(vqmovn_s32(vLoWord), vqmovn_s32(vHiWord)));
+    }
+
+    if (pDither)
+        vst1q_u32(pDither->arrState, vState);
+
+    FloatToS16Scalar(pSrc + i * nStride, nStride, pOut + i, nSamples - i, pDither);
+}
+
+static void FloatToS32NEON(const float* pSrc, size_t nStride, void* pDst, size_t nSamples, TDitherState* pDither)
+{
+    int32_t* pOut = static_cast<int32_t*>(pDst);
+    const float32x4_t vMin = vdupq_n_f32(g_fS32Min);
+    const float32x4_t vMax = vdupq_n_f32(g_fS32Max);
+
+    size_t i = 0;
+    for (; i + 4 <= nSamples; i += 4)
+    {
+        float32x4_t vVal = vmulq_n_f32(LoadStrided4(pSrc + i * nStride, nStride), g_fS32Scale);
+        vst1q_s32(pOut + i, vcvtnq_s32_f32(vminq_f32(vmaxq_f32(vVal, vMin), vMax)));
+    }
+
+    FloatToS32Scalar(pSrc + i * nStride, nStride, pOut + i, nSamples - i, pDither);
+}
+
+static void FloatToF32NEON(const float* pSrc, size_t nStride, void* pDst, size_t nSamples, TDitherState* pDither)
+{
+    float* pOut = static_cast<float*>(pDst);
+
+    size_t i = 0;
+    for (; i + 4 <= nSamples; i += 4)
+        vst1q_f32(pOut + i, LoadStrided4(pSrc + i * nStride, nStride));
+
+    FloatToF32Scalar(pSrc + i * nStride, nStride, pOut + i, nSamples - i, pDither);
+}
+
+static float DotProductNEON(const float* pA, const float* pB, size_t nCount)
+{
+    float32x4_t vSum0 = vdupq_n_f32(0.0f);
+    float32x4_t vSum1 = vdupq_n_f32(0.0f);
+
+    size_t i = 0;
+    for (; i + 8 <= nCount; i += 8)
+    {
+        vSum0 = vfmaq_f32(vSum0, vld1q_f32(pA + i), vld1q_f32(pB + i));
+        vSum1 = vfmaq_f32(vSum1, vld1q_f32(pA + i + 4), vld1q_f32(pB + i + 4));
+    }
+
+    return vaddvq_f32(vaddq_f32(vSum0, vSum1)) + DotProductScalar(pA + i, pB + i, nCount - i);
+}
+
+static void MulAddNEON(const float* pSrc, float fGain, float* pDst, size_t nCount)
+{
+    size_t i = 0;
+    for (; i + 8 <= nCount; i += 8)
+    {
+        vst1q_f32(pDst + i, vfmaq_n_f32(vld1q_f32(pDst + i), vld1q_f32(pSrc + i), fGain));
+        vst1q_f32(pDst + i + 4, vfmaq_n_f32(vld1q_f32(pDst + i + 4), vld1q_f32(pSrc + i + 4), fGain));
+    }
+
+    MulAddScalar(pSrc + i, fGain, pDst + i, nCount - i);
+}
+
+void FillNEONKernels(TAudioKernels& objKernels)
+{
+    objKernels.pfnS8ToFloat = S8ToFloatNEON;
+    objKernels.pfnS16ToFloat = S16ToFloatNEON;
+    objKernels.pfnS24ToFloat = S24ToFloatNEON;
+    objKernels.pfnS32ToFloat = S32ToFloatNEON;
+
+    objKernels.pfnMonoToStereo = MonoToStereoNEON;
+    FillConvertRemixKernels<TSimdNEON>(objKernels);
+
+    objKernels.pfnFloatToS16 = FloatToS16NEON;
+    objKernels.pfnFloatToS32 = FloatToS32NEON;
+    objKernels.pfnFloatToF32 = FloatToF32NEON;
+
+    objKernels.pfnDotProduct = DotProductNEON;
+    objKernels.pfnMulAdd = MulAddNEON;
+
+    objKernels.pfnMeter = MeterSimd<TSimdNEON>;
+
+    objKernels.pfnBiquad = BiquadSimd<TSimdNEON>;
+    objKernels.pfnScale = ScaleSimd<TSimdNEON>;
+
+    objKernels.pfnMulAddRamp = MulAddRampSimd<TSimdNEON>;
+    objKernels.pfnInterleaveStereo = InterleaveStereoSimd<TSimdNEON>;
+}
+
+CYDEVICE_NAMESPACE_END
+
+#else
+
+CYDEVICE_NAMESPACE_BEGIN
+
+void FillNEONKernels(TAudioKernels& /*objKernels*/)
+{
+}
+
+CYDEVICE_NAMESPACE_END
+
+#endif
\ No newline at end of file
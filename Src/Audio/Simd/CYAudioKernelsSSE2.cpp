@@ -0,0 +1,304 @@
+#include "Audio/Simd/CYAudioKernels.hpp"
+#include "Audio/Simd/CYAudioFusedKernels.hpp"
+
+#if defined(CY_SIMD_X86)
+
+#include <emmintrin.h>
+#include <string.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+static void S8ToFloatSSE2(const void* pSrc, float* pDst, size_t nSamples)
+{
+    const int8_t* pIn = static_cast<const int8_t*>(pSrc);
+    const __m128 vDivisor = _mm_set1_ps(g_fS8Divisor);
+
+    size_t i = 0;
+    for (; i + 16 <= nSamples; i += 16)
+    {
+        __m128i vBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + i));
+        __m128i vLo16 = _mm_srai_epi16(_mm_unpacklo_epi8(vBytes, vBytes), 8);
+        __m128i vHi16 = _mm_srai_epi16(_mm_unpackhi_epi8(vBytes, vBytes), 8);
+
+        _mm_storeu_ps(pDst + i, _mm_div_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(vLo16, vLo16), 16)), vDivisor));
+        _mm_storeu_ps(pDst + i + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(vLo16, vLo16), 16)), vDivisor));
+        _mm_storeu_ps(pDst + i + 8, _mm_div_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(vHi16, vHi16), 16)), vDivisor));
+        _mm_storeu_ps(pDst + i + 12, _mm_div_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(vHi16, vHi16), 16)), vDivisor));
+    }
+
+    S8ToFloatScalar(pIn + i, pDst + i, nSamples - i);
+}
+
+static void S16ToFloatSSE2(const void* pSrc, float* pDst, size_t nSamples)
+{
+    const int16_t* pIn = static_cast<const int16_t*>(pSrc);
+    const __m128 vDivisor = _mm_set1_ps(g_fS16Divisor);
+
+    size_t i = 0;
+    for (; i + 8 <= nSamples; i += 8)
+    {
+        __m128i vWords = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + i));
+        __m128i vLo = _mm_srai_epi32(_mm_unpacklo_epi16(vWords, vWords), 16);
+        __m128i vHi = _mm_srai_epi32(_mm_unpackhi_epi16(vWords, vWords), 16);
+
+        _mm_storeu_ps(pDst + i, _mm_div_ps(_mm_cvtepi32_ps(vLo), vDivisor));
+        _mm_storeu_ps(pDst + i + 4, _mm_div_ps(_mm_cvtepi32_ps(vHi), vDivisor));
+    }
+
+    S16ToFloatScalar(pIn + i, pDst + i, nSamples - i);
+}
+
+static inline int32_t LoadWord32(const uint8_t* pIn)
+{
+    int32_t nVal;
+    memcpy(&nVal, pIn, sizeof(nVal));
+    return nVal;
+}
+
+static void S24ToFloatSSE2(const void* pSrc, float* pDst, size_t nSamples)
+{
+    const uint8_t* pIn = static_cast<const uint8_t*>(pSrc);
+    const __m128 vScale = _mm_set1_ps(g_fS24Scale);
+
+    // every sample is fetched with a 4 byte load, keep one sample for the tail so the last load stays in bounds.
+    size_t i = 0;
+    for (; i + 5 <= nSamples; i += 4)
+    {
+        const uint8_t* p = pIn + i * 3;
+        __m128i vWords = _mm_setr_epi32(LoadWord32(p), LoadWord32(p + 3), LoadWord32(p + 6), LoadWord32(p + 9));
+        __m128i vVal = _mm_srai_epi32(_mm_slli_epi32(vWords, 8), 8);
+        _mm_storeu_ps(pDst + i, _mm_mul_ps(_mm_cvtepi32_ps(vVal), vScale));
+    }
+
+    S24ToFloatScalar(pIn + i * 3, pDst + i, nSamples - i);
+}
+
+static void S32ToFloatSSE2(const void* pSrc, float* pDst, size_t nSamples)
+{
+    const int32_t* pIn = static_cast<const int32_t*>(pSrc);
+    const __m128d vScale = _mm_set1_pd(g_dS32Scale);
+
+    size_t i = 0;
+    for (; i + 4 <= nSamples; i += 4)
+    {
+        __m128i vVal = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + i));
+        __m128 vLo = _mm_cvtpd_ps(_mm_mul_pd(_mm_cvtepi32_pd(vVal), vScale));
+        __m128 vHi = _mm_cvtpd_ps(_mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(vVal, 8)), vScale));
+        _mm_storeu_ps(pDst + i, _mm_movelh_ps(vLo, vHi));
+    }
+
+    S32ToFloatScalar(pIn + i, pDst + i, nSamples - i);
+}
+
+static void MonoToStereoSSE2(const float* pSrc, float* pDst, size_t nFrames)
+{
+    size_t i = 0;
+    for (; i + 4 <= nFrames; i += 4)
+    {
+        __m128 vIn = _mm_loadu_ps(pSrc + i);
+        _mm_storeu_ps(pDst + i * 2, _mm_unpacklo_ps(vIn, vIn));
+        _mm_storeu_ps(pDst + i * 2 + 4, _mm_unpackhi_ps(vIn, vIn));
+    }
+
+    MonoToStereoScalar(pSrc + i, pDst + i * 2, nFrames - i);
+}
+
+// fused kernel traits, SSE2 has no gather so every lane is fetched with a scalar load.
+struct TSimdSSE2
+{
+    typedef __m128 Vec;
+    typedef size_t Index;
+    static constexpr size_t nWidth = 4;
+
+    static Index MakeIndex(size_t nStride) { return nStride; }
+
+    template <ECYPcmFormat eFormat>
+    static Vec Load(const uint8_t* pSrc, const Index& nStride)
+    {
+        if constexpr (eFormat == TYPE_PCM_F32)
+        {
+            return _mm_setr_ps(LoadPcmSample<eFormat>(pSrc), LoadPcmSample<eFormat>(pSrc + nStride),
+                LoadPcmSample<eFormat>(pSrc + nStride * 2), LoadPcmSample<eFormat>(pSrc + nStride * 3));
+        }
+        else
+        {
+            // 4 byte words with the sample in the low bytes, shifted up and back down to sign-extend it.
+            constexpr int nShift = int(32 - g_nPcmSampleBytes<eFormat> * 8);
+            __m128i vVal = _mm_setr_epi32(LoadWord32(pSrc), LoadWord32(pSrc + nStride), LoadWord32(pSrc + nStride * 2), LoadWord32(pSrc + nStride * 3));
+            vVal = _mm_srai_epi32(_mm_slli_epi32(vVal, nShift), nShift);
+            return _mm_cvtepi32_ps(vVal);
+        }
+    }
+
+    static Vec Zero() { return _mm_setzero_ps(); }
+    static Vec Set1(float fValue) { return _mm_set1_ps(fValue); }
+    static Vec Mul(Vec vA, Vec vB) { return _mm_mul_ps(vA, vB); }
+    static Vec Add(Vec vA, Vec vB) { return _mm_add_ps(vA, vB); }
+    static void Store(float* pDst, Vec vValue) { _mm_storeu_ps(pDst, vValue); }
+    static Vec LoadFloats(const float* pSrc) { return _mm_loadu_ps(pSrc); }
+    static Vec Abs(Vec vValue) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), vValue); }
+    static Vec Max(Vec vA, Vec vB) { return _mm_max_ps(vA, vB); }
+    static Vec Clipped(Vec vAbs) { return _mm_and_ps(_mm_cmpge_ps(vAbs, _mm_set1_ps(1.0f)), _mm_set1_ps(1.0f)); }
+    static Vec LoadPair(const float* pSrc) { return _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(pSrc))); }
+    static void StorePair(float* pDst, Vec vValue) { _mm_store_sd(reinterpret_cast<double*>(pDst), _mm_castps_pd(vValue)); }
+
+    static void StoreStereo(float* pDst, Vec vLeft, Vec vRight)
+    {
+        _mm_storeu_ps(pDst, _mm_unpacklo_ps(vLeft, vRight));
+        _mm_storeu_ps(pDst + 4, _mm_unpackhi_ps(vLeft, vRight));
+    }
+};
+
+static inline __m128 LoadStrided4(const float* pSrc, size_t nStride)
+{
+    if (nStride == 1)
+        return _mm_loadu_ps(pSrc);
+    return _mm_set_ps(pSrc[nStride * 3], pSrc[nStride * 2], pSrc[nStride], pSrc[0]);
+}
+
+static inline __m128i XorShift4(__m128i vState)
+{
+    vState = _mm_xor_si128(vState, _mm_slli_epi32(vState, 13));
+    vState = _mm_xor_si128(vState, _mm_srli_epi32(vState, 17));
+    return _mm_xor_si128(vState, _mm_slli_epi32(vState, 5));
+}
+
+// TPDF noise in LSB, the same two generator steps per lane as the scalar code.
+static inline __m128 NextDither4(__m128i& vState)
+{
+    vState = XorShift4(vState);
+    __m128i vFirst = _mm_srli_epi32(vState, 8);
+    vState = XorShift4(vState);
+    __m128i vDiff = _mm_sub_epi32(vFirst, _mm_srli_epi32(vState, 8));
+    return _mm_mul_ps(_mm_cvtepi32_ps(vDiff), _mm_set1_ps(g_fDitherScale));
+}
+
+static void FloatToS16SSE2(const float* pSrc, size_t nStride, void* pDst, size_t nSamples, TDitherState* pDither)
+{
+    int16_t* pOut = static_cast<int16_t*>(pDst);
+    const __m128 vScale = _mm_set1_ps(g_fS16Scale);
+    const __m128 vMin = _mm_set1_ps(g_fS16Min);
+    const __m128 vMax = _mm_set1_ps(g_fS16Max);
+    __m128i vState = pDither ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(pDither->arrState)) : _mm_setzero_si128();
+
+    size_t i = 0;
+    for (; i + 8 <= nSamples; i += 8)
+    {
+        __m128 vLo = _mm_mul_ps(LoadStrided4(pSrc + i * nStride, nStride), vScale);
+        __m128 vHi = _mm_mul_ps(LoadStrided4(pSrc + (i + 4) * nStride, nStride), vScale);
+        if (pDither)
+        {
+            vLo = _mm_add_ps(vLo, NextDither4(vState));
+            vHi = _mm_add_ps(vHi, NextDither4(vState));
+        }
+
+        __m128i vLoWord = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(vLo, vMin), vMax));
+        __m128i vHiWord = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(vHi, vMin), vMax));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + i), _mm_packs_epi32(vLoWord, vHiWord));
+    }
+
+    if (pDither)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDither->arrState), vState);
+
+    FloatToS16Scalar(pSrc + i * nStride, nStride, pOut + i, nSamples - i, pDither);
+}
+
+static void FloatToS32SSE2(const float* pSrc, size_t nStride, void* pDst, size_t nSamples, TDitherState* pDither)
+{
+    int32_t* pOut = static_cast<int32_t*>(pDst);
+    const __m128 vScale = _mm_set1_ps(g_fS32Scale);
+    const __m128 vMin = _mm_set1_ps(g_fS32Min);
+    const __m128 vMax = _mm_set1_ps(g_fS32Max);
+
+    size_t i = 0;
+    for (; i + 4 <= nSamples; i += 4)
+    {
+        __m128 vVal = _mm_mul_ps(LoadStrided4(pSrc + i * nStride, nStride), vScale);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + i), _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(vVal, vMin), vMax)));
+    }
+
+    FloatToS32Scalar(pSrc + i * nStride, nStride, pOut + i, nSamples - i, pDither);
+}
+
+static void FloatToF32SSE2(const float* pSrc, size_t nStride, void* pDst, size_t nSamples, TDitherState* pDither)
+{
+    float* pOut = static_cast<float*>(pDst);
+
+    size_t i = 0;
+    for (; i + 4 <= nSamples; i += 4)
+        _mm_storeu_ps(pOut + i, LoadStrided4(pSrc + i * nStride, nStride));
+
+    FloatToF32Scalar(pSrc + i * nStride, nStride, pOut + i, nSamples - i, pDither);
+}
+
+static float DotProductSSE2(const float* pA, const float* pB, size_t nCount)
+{
+    __m128 vSum0 = _mm_setzero_ps();
+    __m128 vSum1 = _mm_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 8 <= nCount; i += 8)
+    {
+        vSum0 = _mm_add_ps(vSum0, _mm_mul_ps(_mm_loadu_ps(pA + i), _mm_loadu_ps(pB + i)));
+        vSum1 = _mm_add_ps(vSum1, _mm_mul_ps(_mm_loadu_ps(pA + i + 4), _mm_loadu_ps(pB + i + 4)));
+    }
+
+    __m128 vSum = _mm_add_ps(vSum0, vSum1);
+    vSum = _mm_add_ps(vSum, _mm_movehl_ps(vSum, vSum));
+    vSum = _mm_add_ss(vSum, _mm_shuffle_ps(vSum, vSum, 0x55));
+    return _mm_cvtss_f32(vSum) + DotProductScalar(pA + i, pB + i, nCount - i);
+}
+
+static void MulAddSSE2(const float* pSrc, float fGain, float* pDst, size_t nCount)
+{
+    const __m128 vGain = _mm_set1_ps(fGain);
+
+    size_t i = 0;
+    for (; i + 8 <= nCount; i += 8)
+    {
+        _mm_storeu_ps(pDst + i, _mm_add_ps(_mm_loadu_ps(pDst + i), _mm_mul_ps(_mm_loadu_ps(pSrc + i), vGain)));
+        _mm_storeu_ps(pDst + i + 4, _mm_add_ps(_mm_loadu_ps(pDst + i + 4), _mm_mul_ps(_mm_loadu_ps(pSrc + i + 4), vGain)));
+    }
+
+    MulAddScalar(pSrc + i, fGain, pDst + i, nCount - i);
+}
+
+void FillSSE2Kernels(TAudioKernels& objKernels)
+{
+    objKernels.pfnS8ToFloat = S8ToFloatSSE2;
+    objKernels.pfnS16ToFloat = S16ToFloatSSE2;
+    objKernels.pfnS24ToFloat = S24ToFloatSSE2;
+    objKernels.pfnS32ToFloat = S32ToFloatSSE2;
+
+    objKernels.pfnMonoToStereo = MonoToStereoSSE2;
+    FillConvertRemixKernels<TSimdSSE2>(objKernels);
+
+    objKernels.pfnFloatToS16 = FloatToS16SSE2;
+    objKernels.pfnFloatToS32 = FloatToS32SSE2;
+    objKernels.pfnFloatToF32 = FloatToF32SSE2;
+
+    objKernels.pfnDotProduct = DotProductSSE2;
+    objKernels.pfnMulAdd = MulAddSSE2;
+
+    objKernels.pfnMeter = MeterSimd<TSimdSSE2>;
+
+    objKernels.pfnBiquad = BiquadSimd<TSimdSSE2>;
+    objKernels.pfnScale = ScaleSimd<TSimdSSE2>;
+
+    objKernels.pfnMulAddRamp = MulAddRampSimd<TSimdSSE2>;
+    objKernels.pfnInterleaveStereo = InterleaveStereoSimd<TSimdSSE2>;
+}
+
+CYDEVICE_NAMESPACE_END
+
+#else
+
+CYDEVICE_NAMESPACE_BEGIN
+
+void FillSSE2Kernels(TAudioKernels& /*objKernels*/)
+{
+}
+
+CYDEVICE_NAMESPACE_END
+
+#endif
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include "Audio/Simd/CYAudioKernels.hpp"
+#include "Audio/Simd/CYAudioFusedKernels.hpp"
+#include "Common/CYDevicePrivDefine.hpp"
+
+#include <math.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+void S8ToFloatScalar(const void* pSrc, float* pDst, size_t nSamples)
+{
+    const int8_t* pIn = static_cast<const int8_t*>(pSrc);
+    for (size_t i = 0; i < nSamples; ++i)
+        pDst[i] = float(pIn[i]) / g_fS8Divisor;
+}
+
+void S16ToFloatScalar(const void* pSrc, float* pDst, size_t nSamples)
+{
+    const int16_t* pIn = static_cast<const int16_t*>(pSrc);
+    for (size_t i = 0; i < nSamples; ++i)
+        pDst[i] = float(pIn[i]) / g_fS16Divisor;
+}
+
+void S24ToFloatScalar(const void* pSrc, float* pDst, size_t nSamples)
+{
+    const uint8_t* pIn = static_cast<const uint8_t*>(pSrc);
+    for (size_t i = 0; i < nSamples; ++i, pIn += 3)
+    {
+        // place the 24 bits at the top of the word, the arithmetic shift sign-extends them.
+        uint32_t nVal = (uint32_t(pIn[0]) << 8) | (uint32_t(pIn[1]) << 16) | (uint32_t(pIn[2]) << 24);
+        pDst[i] = float(int32_t(nVal) >> 8) * g_fS24Scale;
+    }
+}
+
+void S32ToFloatScalar(const void* pSrc, float* pDst, size_t nSamples)
+{
+    const int32_t* pIn = static_cast<const int32_t*>(pSrc);
+    for (size_t i = 0; i < nSamples; ++i)
+        pDst[i] = float(double(pIn[i]) * g_dS32Scale);
+}
+
+void MonoToStereoScalar(const float* pSrc, float* pDst, size_t nFrames)
+{
+    for (size_t i = 0; i < nFrames; ++i)
+    {
+        pDst[i * 2] = pSrc[i];
+        pDst[i * 2 + 1] = pSrc[i];
+    }
+}
+
+// TPDF noise in LSB from two steps of a xorshift32 lane.
+static inline float NextDither(uint32_t& nState)
+{
+    nState ^= nState << 13; nState ^= nState >> 17; nState ^= nState << 5;
+    int32_t nFirst = int32_t(nState >> 8);
+    nState ^= nState << 13; nState ^= nState >> 17; nState ^= nState << 5;
+    return float(nFirst - int32_t(nState >> 8)) * g_fDitherScale;
+}
+
+void FloatToS16Scalar(const float* pSrc, size_t nStride, void* pDst, size_t nSamples, TDitherState* pDither)
+{
+    int16_t* pOut = static_cast<int16_t*>(pDst);
+    for (size_t i = 0; i < nSamples; ++i, pSrc += nStride)
+    {
+        float fVal = *pSrc * g_fS16Scale;
+        if (pDither)
+            fVal += NextDither(pDither->arrState[0]);
+        fVal = MIN(MAX(fVal, g_fS16Min), g_fS16Max);
+        pOut[i] = int16_t(lrintf(fVal));
+    }
+}
+
+void FloatToS32Scalar(const float* pSrc, size_t nStride, void* pDst, size_t nSamples, TDitherState* /*pDither*/)
+{
+    int32_t* pOut = static_cast<int32_t*>(pDst);
+    for (size_t i = 0; i < nSamples; ++i, pSrc += nStride)
+    {
+        float fVal = MIN(MAX(*pSrc * g_fS32Scale, g_fS32Min), g_fS32Max);
+        pOut[i] = int32_t(lrintf(fVal));
+    }
+}
+
+void FloatToF32Scalar(const float* pSrc, size_t nStride, void* pDst, size_t nSamples, TDitherState* /*pDither*/)
+{
+    float* pOut = static_cast<float*>(pDst);
+    for (size_t i = 0; i < nSamples; ++i, pSrc += nStride)
+        pOut[i] = *pSrc;
+}
+
+float DotProductScalar(const float* pA, const float* pB, size_t nCount)
+{
+    float fSum = 0.0f;
+    for (size_t i = 0; i < nCount; ++i)
+        fSum += pA[i] * pB[i];
+    return fSum;
+}
+
+void MulAddScalar(const float* pSrc, float fGain, float* pDst, size_t nCount)
+{
+    for (size_t i = 0; i < nCount; ++i)
+        pDst[i] += pSrc[i] * fGain;
+}
+
+void MeterScalar(const float* pSrc, uint32_t nChannels, size_t nFrames, TAudioMeter& objMeter)
+{
+    for (size_t i = 0; i < nFrames; ++i, pSrc += nChannels)
+    {
+        for (uint32_t nChannel = 0; nChannel < nChannels; ++nChannel)
+        {
+            const float fValue = pSrc[nChannel];
+            const float fAbs = fabsf(fValue);
+            objMeter.arrPeak[nChannel] = MAX(objMeter.arrPeak[nChannel], fAbs);
+            objMeter.arrSquares[nChannel] += fValue * fValue;
+            objMeter.arrClips[nChannel] += (fAbs >= 1.0f) ? 1 : 0;
+        }
+    }
+}
+
+void BiquadScalar(float* pData, uint32_t nChannels, size_t nFrames, const TAudioBiquad* pSections, uint32_t nSections, float* pState)
+{
+    for (uint32_t nChannel = 0; nChannel < nChannels; ++nChannel)
+        BiquadChannel(pData + nChannel, nChannels, nFrames, pSections, nSections, pState + nChannel);
+}
+
+void ScaleScalar(float* pData, float fGain, size_t nCount)
+{
+    for (size_t i = 0; i < nCount; ++i)
+        pData[i] *= fGain;
+}
+
+void MulAddRampScalar(const float* pSrc, float fGain, float fStep, float* pDst, size_t nCount)
+{
+    for (size_t i = 0; i < nCount; ++i)
+        pDst[i] += pSrc[i] * (fGain + fStep * float(i));
+}
+
+void InterleaveStereoScalar(const float* pLeft, const float* pRight, float* pDst, size_t nFrames)
+{
+    for (size_t i = 0; i < nFrames; ++i)
+    {
+        pDst[i * 2] = pLeft[i];
+        pDst[i * 2 + 1] = pRight[i];
+    }
+}
+
+void FillScalarKernels(TAudioKernels& objKernels)
+{
+    objKernels.pfnS8ToFloat = S8ToFloatScalar;
+    objKernels.pfnS16ToFloat = S16ToFloatScalar;
+    objKernels.pfnS24ToFloat = S24ToFloatScalar;
+    objKernels.pfnS32ToFloat = S32ToFloatScalar;
+
+    objKernels.pfnMonoToStereo = MonoToStereoScalar;
+    FillConvertRemixScalar<TYPE_PCM_S8>(objKernels);
+    FillConvertRemixScalar<TYPE_PCM_S16>(objKernels);
+    FillConvertRemixScalar<TYPE_PCM_S24>(objKernels);
+    FillConvertRemixScalar<TYPE_PCM_S32>(objKernels);
+    FillConvertRemixScalar<TYPE_PCM_F32>(objKernels);
+
+    objKernels.pfnFloatToS16 = FloatToS16Scalar;
+    objKernels.pfnFloatToS32 = FloatToS32Scalar;
+    objKernels.pfnFloatToF32 = FloatToF32Scalar;
+
+    objKernels.pfnDotProduct = DotProductScalar;
+    objKernels.pfnMulAdd = MulAddScalar;
+
+    objKernels.pfnMeter = MeterScalar;
+
+    objKernels.pfnBiquad = BiquadScalar;
+    objKernels.pfnScale = ScaleScalar;
+
+    objKernels.pfnMulAddRamp = MulAddRampScalar;
+    objKernels.pfnInterleaveStereo = InterleaveStereoScalar;
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
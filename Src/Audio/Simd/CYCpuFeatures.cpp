@@ -0,0 +1,87 @@
+#include "Audio/Simd/CYCpuFeatures.hpp"
+
+#if defined(CY_SIMD_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+CYDEVICE_NAMESPACE_BEGIN
+
+#if defined(CY_SIMD_X86)
+static void CpuId(int nLeaf, int nSubLeaf, unsigned int arrRegs[4])
+{
+#if defined(_MSC_VER)
+    int arrInfo[4] = { 0 };
+    __cpuidex(arrInfo, nLeaf, nSubLeaf);
+    for (int i = 0; i < 4; ++i)
+        arrRegs[i] = static_cast<unsigned int>(arrInfo[i]);
+#else
+    __cpuid_count(nLeaf, nSubLeaf, arrRegs[0], arrRegs[1], arrRegs[2], arrRegs[3]);
+#endif
+}
+
+static unsigned long long GetXCR0()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned int nEax = 0, nEdx = 0;
+    __asm__ volatile("xgetbv" : "=a"(nEax), "=d"(nEdx) : "c"(0));
+    return (static_cast<unsigned long long>(nEdx) << 32) | nEax;
+#endif
+}
+
+static TCpuFeatures DetectCpuFeatures()
+{
+    TCpuFeatures objFeatures;
+    unsigned int arrRegs[4] = { 0 };
+
+    CpuId(0, 0, arrRegs);
+    const unsigned int nMaxLeaf = arrRegs[0];
+    if (nMaxLeaf < 1)
+        return objFeatures;
+
+    CpuId(1, 0, arrRegs);
+    objFeatures.bSSE2 = (arrRegs[3] & (1u << 26)) != 0;
+    objFeatures.bSSE41 = (arrRegs[2] & (1u << 19)) != 0;
+
+    // AVX state has to be enabled by the OS as well.
+    const bool bOSXSave = (arrRegs[2] & (1u << 27)) != 0;
+    const bool bFMA = (arrRegs[2] & (1u << 12)) != 0;
+    const unsigned long long nXCR0 = bOSXSave ? GetXCR0() : 0;
+    const bool bAVXState = (nXCR0 & 0x6) == 0x6;
+    const bool bAVX512State = (nXCR0 & 0xE6) == 0xE6;
+
+    if (nMaxLeaf >= 7)
+    {
+        CpuId(7, 0, arrRegs);
+        objFeatures.bAVX2 = bAVXState && (arrRegs[1] & (1u << 5)) != 0;
+        objFeatures.bFMA = objFeatures.bAVX2 && bFMA;
+        objFeatures.bAVX512F = bAVX512State && (arrRegs[1] & (1u << 16)) != 0;
+        objFeatures.bAVX512BW = objFeatures.bAVX512F && (arrRegs[1] & (1u << 30)) != 0;
+    }
+
+    return objFeatures;
+}
+#else
+static TCpuFeatures DetectCpuFeatures()
+{
+    TCpuFeatures objFeatures;
+#if defined(CY_SIMD_NEON)
+    // NEON is mandatory on AArch64.
+    objFeatures.bNEON = true;
+#endif
+    return objFeatures;
+}
+#endif
+
+const TCpuFeatures& GetCpuFeatures()
+{
+    static const TCpuFeatures s_objFeatures = DetectCpuFeatures();
+    return s_objFeatures;
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef __CY_CPU_FEATURES_HPP__
+#define __CY_CPU_FEATURES_HPP__
+
+#include "CYDevice/CYDeviceDefine.hpp"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CY_SIMD_X86 1
+#endif
+
+#if defined(_M_ARM64) || defined(__aarch64__)
+#define CY_SIMD_NEON 1
+#endif
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Instruction set extensions usable by the audio kernels (CPU and OS support both checked).
+ */
+struct TCpuFeatures
+{
+    bool bSSE2 = false;
+    bool bSSE41 = false;
+    bool bAVX2 = false;
+    bool bFMA = false;
+    bool bAVX512F = false;
+    bool bAVX512BW = false;
+    bool bNEON = false;
+};
+
+/**
+ * Detected once on first use.
+ */
+const TCpuFeatures& GetCpuFeatures();
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_CPU_FEATURES_HPP__
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "CYDevice/CYDeviceFatory.hpp"
 #include "CYDeviceImpl.hpp"
+#include "Audio/CYAudioMixer.hpp"
 
 CYDEVICE_NAMESPACE_BEGIN
 
@@ -22,4 +23,15 @@ void CYDeviceFactory::DestroyDevice(ICYDevice*& pDevice)
     pDevice = nullptr;
 }
 
+ICYAudioMixer* CYDeviceFactory::CreateAudioMixer()
+{
+    return new CYAudioMixer();
+}
+
+void CYDeviceFactory::DestroyAudioMixer(ICYAudioMixer*& pMixer)
+{
+    delete pMixer;
+    pMixer = nullptr;
+}
+
 CYDEVICE_NAMESPACE_END
\ No newline at end of file
@@ -25,12 +25,20 @@ CYDeviceImpl::~CYDeviceImpl()
 #endif
 }
 
-int16_t CYDeviceImpl::Init(int nWidth/* = 1024*/, int nHeight/* = 768*/, int nFPS/* = 25*/, const wchar_t* pszDeviceName, const wchar_t* pszDeviceId, int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, bool bUseRender/* = true*/)
+int16_t CYDeviceImpl::Init(int nWidth/* = 1024*/, int nHeight/* = 768*/, int nFPS/* = 25*/, const wchar_t* pszDeviceName, const wchar_t* pszDeviceId, int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, bool bUseRender/* = true*/, const TAudioConfig* pAudioConfig/* = nullptr*/)
 {
     m_ptrControl = MakeUnique<CYDeviceControl>();
     IfTrueThrow(!m_ptrControl, TEXT("Failed to create a control object!"));
 
-    return m_ptrControl->Init(nWidth, nHeight, nFPS, pszDeviceName, pszDeviceId, nSampleRateHz, pszAudioName, pszAudioID, bUseRender);
+    return m_ptrControl->Init(nWidth, nHeight, nFPS, pszDeviceName, pszDeviceId, nSampleRateHz, pszAudioName, pszAudioID, bUseRender, pAudioConfig);
+}
+
+int16_t CYDeviceImpl::InitAudio(ECYAudioSource eSource, int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, const TAudioConfig* pAudioConfig/* = nullptr*/)
+{
+    m_ptrControl = MakeUnique<CYDeviceControl>();
+    IfTrueThrow(!m_ptrControl, TEXT("Failed to create a control object!"));
+
+    return m_ptrControl->InitAudio(eSource, nSampleRateHz, pszAudioName, pszAudioID, pAudioConfig);
 }
 
 int16_t CYDeviceImpl::UnInit()
@@ -59,4 +67,40 @@ int16_t CYDeviceImpl::GetNextAudioBuffer(float*& pBuffer, uint32_t& nNumFrames,
     return m_ptrControl->GetNextAudioBuffer(pBuffer, nNumFrames, nTimestamp);
 }
 
+int16_t CYDeviceImpl::ReadAudio(void* pBuffer, uint32_t nNumFrames, uint32_t nTimeoutMs, uint32_t& nReadFrames, uint64_t& nTimestamp)
+{
+    IfTrueThrow(!m_ptrControl, TEXT("The control object is not created!"));
+    return m_ptrControl->ReadAudio(pBuffer, nNumFrames, nTimeoutMs, nReadFrames, nTimestamp);
+}
+
+int16_t CYDeviceImpl::GetAudioLevels(TAudioLevels& objLevels)
+{
+    IfTrueThrow(!m_ptrControl, TEXT("The control object is not created!"));
+    return m_ptrControl->GetAudioLevels(objLevels);
+}
+
+int16_t CYDeviceImpl::GetAudioSchedulingStats(TAudioSchedulingStats& objStats)
+{
+    IfTrueThrow(!m_ptrControl, TEXT("The control object is not created!"));
+    return m_ptrControl->GetAudioSchedulingStats(objStats);
+}
+
+int16_t CYDeviceImpl::SetAudioStages(const TAudioStage* pStages, uint32_t nStages)
+{
+    IfTrueThrow(!m_ptrControl, TEXT("The control object is not created!"));
+    return m_ptrControl->SetAudioStages(pStages, nStages);
+}
+
+int16_t CYDeviceImpl::SubscribeAudio(const TAudioSubscription& objSubscription, uint32_t& nSubscriptionId)
+{
+    IfTrueThrow(!m_ptrControl, TEXT("The control object is not created!"));
+    return m_ptrControl->SubscribeAudio(objSubscription, nSubscriptionId);
+}
+
+int16_t CYDeviceImpl::UnsubscribeAudio(uint32_t nSubscriptionId)
+{
+    IfTrueThrow(!m_ptrControl, TEXT("The control object is not created!"));
+    return m_ptrControl->UnsubscribeAudio(nSubscriptionId);
+}
+
 CYDEVICE_NAMESPACE_END
\ No newline at end of file
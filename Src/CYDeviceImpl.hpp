@@ -17,9 +17,14 @@ public:
     /**
      * @brief Initialization and de-initialization of cry device.
     */
-    virtual int16_t Init(int nWidth/* = 1024*/, int nHeight/* = 768*/, int nFPS/* = 25*/, const wchar_t* pszDeviceName, const wchar_t* pszDeviceId, int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, bool bUseRender = true) override;
+    virtual int16_t Init(int nWidth/* = 1024*/, int nHeight/* = 768*/, int nFPS/* = 25*/, const wchar_t* pszDeviceName, const wchar_t* pszDeviceId, int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, bool bUseRender = true, const TAudioConfig* pAudioConfig = nullptr) override;
     virtual int16_t UnInit() override;
 
+    /**
+     * @brief Initialization of an audio only session.
+    */
+    virtual int16_t InitAudio(ECYAudioSource eSource, int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, const TAudioConfig* pAudioConfig = nullptr) override;
+
     /**
      * @brief Start Capture.
     */
@@ -31,6 +36,32 @@ public:
     */
     virtual int16_t GetNextAudioBuffer(float*& pBuffer, uint32_t& nNumFrames, uint64_t& nTimestamp) override;
 
+    /**
+     * @brief Read Audio Data.
+    */
+    virtual int16_t ReadAudio(void* pBuffer, uint32_t nNumFrames, uint32_t nTimeoutMs, uint32_t& nReadFrames, uint64_t& nTimestamp) override;
+
+    /**
+     * @brief Get Audio Levels.
+    */
+    virtual int16_t GetAudioLevels(TAudioLevels& objLevels) override;
+
+    /**
+     * @brief Get Audio Scheduling Stats.
+    */
+    virtual int16_t GetAudioSchedulingStats(TAudioSchedulingStats& objStats) override;
+
+    /**
+     * @brief Audio Stages.
+    */
+    virtual int16_t SetAudioStages(const TAudioStage* pStages, uint32_t nStages) override;
+
+    /**
+     * @brief Audio Subscriptions.
+    */
+    virtual int16_t SubscribeAudio(const TAudioSubscription& objSubscription, uint32_t& nSubscriptionId) override;
+    virtual int16_t UnsubscribeAudio(uint32_t nSubscriptionId) override;
+
 private:
     /**
      * @brief Control Object.
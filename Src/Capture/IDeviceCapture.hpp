@@ -12,7 +12,8 @@ public:
     virtual ~IDeviceCapture(){ }
 
 public:
-    virtual int16_t Init(int nWidth/* = 1024*/, int nHeight/* = 768*/, int nFPS/* = 25*/, const wchar_t* pszDeviceName, const wchar_t* pszDeviceId, int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, bool bUseRender = true) = 0;
+    virtual int16_t Init(int nWidth/* = 1024*/, int nHeight/* = 768*/, int nFPS/* = 25*/, const wchar_t* pszDeviceName, const wchar_t* pszDeviceId, int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, bool bUseRender = true, const TAudioConfig* pAudioConfig = nullptr) = 0;
+    virtual int16_t InitAudio(int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, const TAudioConfig* pAudioConfig = nullptr) = 0;
     virtual int16_t UnInit() = 0;
 
     virtual int16_t Start(ICYAudioDataCallBack* pAudioDataCallBack, ICYVideoDataCallBack* pVideoDataCallBack) = 0;
@@ -20,6 +21,14 @@ public:
 
     virtual int16_t GetNextAudioBuffer(float** buffer, uint32_t* numFrames, uint64_t* timestamp) = 0;
     virtual int16_t ReleaseAudioBuffer() = 0;
+    virtual int16_t ReadAudio(void* pBuffer, uint32_t nNumFrames, uint32_t nTimeoutMs, uint32_t& nReadFrames, uint64_t& nTimestamp) = 0;
+
+    virtual int16_t GetAudioLevels(TAudioLevels& objLevels) = 0;
+    virtual int16_t GetAudioSchedulingStats(TAudioSchedulingStats& objStats) = 0;
+    virtual int16_t SetAudioStages(const TAudioStage* pStages, uint32_t nStages) = 0;
+
+    virtual int16_t SubscribeAudio(const TAudioSubscription& objSubscription, uint32_t& nSubscriptionId) = 0;
+    virtual int16_t UnsubscribeAudio(uint32_t nSubscriptionId) = 0;
 };
 
 CYDEVICE_NAMESPACE_END
@@ -0,0 +1,198 @@
+#include "Capture/Synthetic/SyntheticAudioCaptrue.hpp"
+#include "Audio/CYAudioClock.hpp"
+#include "Common/CYAllocCheck.hpp"
+
+#include <chrono>
+#include <cmath>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+CSyntheticAudioCaptrue::CSyntheticAudioCaptrue()
+{
+}
+
+CSyntheticAudioCaptrue::~CSyntheticAudioCaptrue()
+{
+    Stop();
+    m_audioFanout.UnInit();
+    m_audioPipeline.UnInit();
+}
+
+int16_t CSyntheticAudioCaptrue::Init(int /*nWidth*/, int /*nHeight*/, int /*nFPS*/, const wchar_t* /*pszDeviceName*/, const wchar_t* /*pszDeviceId*/, int /*nSampleRateHz*/, const wchar_t* /*pszAudioName*/, const wchar_t* /*pszAudioID*/, bool /*bUseRender = true*/, const TAudioConfig* /*pAudioConfig = nullptr*/)
+{
+    CY_LOG_ERROR(TEXT("CYDevice: The synthetic source has no video, use InitAudio"));
+    return false;
+}
+
+int16_t CSyntheticAudioCaptrue::InitAudio(int nSampleRateHz, const wchar_t* /*pszAudioName*/, const wchar_t* /*pszAudioID*/, const TAudioConfig* pAudioConfig/* = nullptr*/)
+{
+    m_objAudioConfig = pAudioConfig ? *pAudioConfig : TAudioConfig();
+
+    TAudioSourceFormat objSourceFormat;
+    objSourceFormat.ePcmFormat = TYPE_PCM_S16;
+    objSourceFormat.nChannels = g_nSyntheticChannels;
+    objSourceFormat.nSampleRate = g_nSyntheticSampleRate;
+    objSourceFormat.nBlockAlign = g_nSyntheticChannels * sizeof(int16_t);
+
+    m_bInit = m_audioPipeline.Init(objSourceFormat, nSampleRateHz, m_objAudioConfig);
+    if (!m_bInit)
+    {
+        CY_LOG_ERROR(TEXT("CYDevice: Could not initialize the audio pipeline"));
+        return false;
+    }
+    if (!m_audioFanout.Init(objSourceFormat, m_objAudioConfig))
+        CY_LOG_WARN(TEXT("CYDevice: Could not initialize the audio fan-out, subscriptions are not available"));
+
+    // the pipeline keeps its own copy, the caller's matrix is only valid during Init.
+    m_objAudioConfig.pCustomMatrix = nullptr;
+
+    m_nPacketFrames = static_cast<uint32_t>(uint64_t(g_nSyntheticSampleRate) * g_nSyntheticPacketUs / 1000000);
+    m_vecPacket.assign(size_t(m_nPacketFrames) * g_nSyntheticChannels, 0);
+    m_dPhaseStep = 2.0 * 3.14159265358979323846 * g_fSyntheticToneHz / g_nSyntheticSampleRate;
+    m_fAmplitude = 32767.0f * std::pow(10.0f, g_fSyntheticLevelDb / 20.0f);
+    return true;
+}
+
+int16_t CSyntheticAudioCaptrue::UnInit()
+{
+    Stop();
+
+    // subscriptions end with the device, their callbacks are not called after this.
+    m_audioFanout.UnInit();
+    m_bInit = false;
+    return true;
+}
+
+int16_t CSyntheticAudioCaptrue::Start(ICYAudioDataCallBack* pAudioDataCallBack, ICYVideoDataCallBack* /*pVideoDataCallBack*/)
+{
+    if (!m_bInit)
+        return CYERR_FAILED;
+    if (m_bCapturing)
+        return CYERR_REPEAT_START_CAPTURE;
+
+    m_nFramePos = 0;
+    m_dPhase = 0.0;
+    m_bCapturing = true;
+    m_audioPipeline.Start(pAudioDataCallBack);
+    m_audioFanout.Start();
+
+    m_sourceThread = std::thread(&CSyntheticAudioCaptrue::OnSourceEntry, this);
+    return CYERR_SUCESS;
+}
+
+int16_t CSyntheticAudioCaptrue::Stop()
+{
+    if (!m_bCapturing)
+        return CYEER_NOT_START_CAPTURE;
+
+    {
+        UniqueLock locker(m_sourceMutex);
+        m_bCapturing = false;
+    }
+    m_sourceCV.notify_one();
+    if (m_sourceThread.joinable())
+        m_sourceThread.join();
+
+    m_audioPipeline.Flush();
+    m_audioFanout.Flush();
+    m_audioPipeline.Stop();
+    m_audioFanout.Stop();
+    return CYERR_SUCESS;
+}
+
+int16_t CSyntheticAudioCaptrue::GetNextAudioBuffer(float** bufferOut, uint32_t* numFramesOut, uint64_t* timestampOut)
+{
+    if (m_audioPipeline.GetSampleFormat() != TYPE_CYAUDIO_SAMPLE_F32 || (m_audioPipeline.IsPlanar() && m_audioPipeline.GetOutChannels() > 1))
+        return false;
+
+    TAudioPeriod objPeriod;
+    if (!m_audioPipeline.GetNextBuffer(objPeriod))
+        return false;
+
+    *bufferOut = static_cast<float*>(const_cast<void*>(objPeriod.pData));
+    *numFramesOut = objPeriod.nFrames;
+    *timestampOut = objPeriod.nTimeStamp;
+    return true;
+}
+
+int16_t CSyntheticAudioCaptrue::ReleaseAudioBuffer()
+{
+    m_audioPipeline.ReleasePeriod();
+    return CYERR_SUCESS;
+}
+
+int16_t CSyntheticAudioCaptrue::ReadAudio(void* pBuffer, uint32_t nNumFrames, uint32_t nTimeoutMs, uint32_t& nReadFrames, uint64_t& nTimestamp)
+{
+    return m_audioPipeline.Read(pBuffer, nNumFrames, nTimeoutMs, nReadFrames, nTimestamp) ? CYERR_SUCESS : CYERR_FAILED;
+}
+
+int16_t CSyntheticAudioCaptrue::GetAudioLevels(TAudioLevels& objLevels)
+{
+    return m_audioPipeline.GetLevels(objLevels) ? CYERR_SUCESS : CYERR_FAILED;
+}
+
+int16_t CSyntheticAudioCaptrue::GetAudioSchedulingStats(TAudioSchedulingStats& objStats)
+{
+    m_audioPipeline.GetSchedulingStats(objStats);
+    return CYERR_SUCESS;
+}
+
+int16_t CSyntheticAudioCaptrue::SetAudioStages(const TAudioStage* pStages, uint32_t nStages)
+{
+    return m_audioPipeline.SetStages(pStages, nStages) ? CYERR_SUCESS : CYERR_FAILED;
+}
+
+int16_t CSyntheticAudioCaptrue::SubscribeAudio(const TAudioSubscription& objSubscription, uint32_t& nSubscriptionId)
+{
+    return m_audioFanout.Subscribe(objSubscription, nSubscriptionId) ? CYERR_SUCESS : CYERR_FAILED;
+}
+
+int16_t CSyntheticAudioCaptrue::UnsubscribeAudio(uint32_t nSubscriptionId)
+{
+    return m_audioFanout.Unsubscribe(nSubscriptionId) ? CYERR_SUCESS : CYERR_FAILED;
+}
+
+void CSyntheticAudioCaptrue::GeneratePacket()
+{
+    int16_t* pSample = m_vecPacket.data();
+    for (uint32_t i = 0; i < m_nPacketFrames; ++i)
+    {
+        int16_t nValue = static_cast<int16_t>(std::lround(m_fAmplitude * std::sin(m_dPhase)));
+        for (uint32_t c = 0; c < g_nSyntheticChannels; ++c)
+            *pSample++ = nValue;
+
+        m_dPhase += m_dPhaseStep;
+    }
+    // keep the phase small so the tone does not lose precision over long runs.
+    m_dPhase = std::fmod(m_dPhase, 2.0 * 3.14159265358979323846);
+}
+
+void CSyntheticAudioCaptrue::OnSourceEntry()
+{
+    // packets are due on a fixed grid from the start, a late wake-up writes the next one right away.
+    std::chrono::steady_clock::time_point tpNext = std::chrono::steady_clock::now();
+    UniqueLock locker(m_sourceMutex);
+    while (m_bCapturing)
+    {
+        tpNext += std::chrono::microseconds(g_nSyntheticPacketUs);
+        if (m_sourceCV.wait_until(locker, tpNext, [this] { return !m_bCapturing; }))
+            break;
+        locker.unlock();
+
+        {
+            CY_ALLOC_CHECK_SCOPE();
+
+            GeneratePacket();
+            int64_t nHostUs = GetHostTimeUs();
+            int64_t nStreamUs = static_cast<int64_t>(m_nFramePos * 1000000 / g_nSyntheticSampleRate);
+            size_t nBytes = m_vecPacket.size() * sizeof(int16_t);
+            m_audioPipeline.Write(m_vecPacket.data(), nBytes, nHostUs, nStreamUs);
+            m_audioFanout.Write(m_vecPacket.data(), nBytes, nHostUs, nStreamUs);
+            m_nFramePos += m_nPacketFrames;
+        }
+
+        locker.lock();
+    }
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,84 @@
+#ifndef __SYNTHETIC_AUDIO_CAPTRUE_HPP__
+#define __SYNTHETIC_AUDIO_CAPTRUE_HPP__
+
+#include "Common/CYDevicePrivDefine.hpp"
+#include "Capture/IDeviceCapture.hpp"
+#include "Audio/CYAudioPipeline.hpp"
+#include "Audio/CYAudioFanout.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Format of the generated source, a tone of g_fSyntheticToneHz at g_fSyntheticLevelDb on every
+ * channel, written in packets of g_nSyntheticPacketUs.
+ */
+constexpr uint32_t g_nSyntheticSampleRate = 48000;
+constexpr uint32_t g_nSyntheticChannels = 2;
+constexpr uint32_t g_nSyntheticPacketUs = 10000;
+constexpr float g_fSyntheticToneHz = 1000.0f;
+constexpr float g_fSyntheticLevelDb = -20.0f;
+
+/**
+ * Audio only capture from a generated S16 source instead of a device.
+ *
+ * A source thread stands in for the device thread, it wakes every packet period and writes the next
+ * packet into the pipeline and the fan-out with the host time of the write and the stream time of
+ * its first frame. Nothing beyond those needs a platform API, so the audio path can be run anywhere.
+ */
+class CSyntheticAudioCaptrue : public IDeviceCapture
+{
+public:
+    CSyntheticAudioCaptrue();
+    virtual ~CSyntheticAudioCaptrue();
+
+    int16_t Init(int nWidth/* = 1024*/, int nHeight/* = 768*/, int nFPS/* = 25*/, const wchar_t* pszDeviceName, const wchar_t* pszDeviceId, int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, bool bUseRender = true, const TAudioConfig* pAudioConfig = nullptr) override;
+    int16_t InitAudio(int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, const TAudioConfig* pAudioConfig = nullptr) override;
+    int16_t UnInit() override;
+
+    int16_t Start(ICYAudioDataCallBack* pAudioDataCallBack, ICYVideoDataCallBack* pVideoDataCallBack) override;
+    int16_t Stop() override;
+
+    int16_t GetNextAudioBuffer(float** buffer, uint32_t* numFrames, uint64_t* timestamp) override;
+    int16_t ReleaseAudioBuffer() override;
+    int16_t ReadAudio(void* pBuffer, uint32_t nNumFrames, uint32_t nTimeoutMs, uint32_t& nReadFrames, uint64_t& nTimestamp) override;
+
+    int16_t GetAudioLevels(TAudioLevels& objLevels) override;
+    int16_t GetAudioSchedulingStats(TAudioSchedulingStats& objStats) override;
+    int16_t SetAudioStages(const TAudioStage* pStages, uint32_t nStages) override;
+
+    int16_t SubscribeAudio(const TAudioSubscription& objSubscription, uint32_t& nSubscriptionId) override;
+    int16_t UnsubscribeAudio(uint32_t nSubscriptionId) override;
+
+protected:
+    void GeneratePacket();
+    void OnSourceEntry();
+
+private:
+    CYAudioPipeline m_audioPipeline;
+    CYAudioFanout m_audioFanout;
+    TAudioConfig m_objAudioConfig;
+
+    bool m_bInit = false;
+    bool m_bCapturing = false;
+
+    // one packet of interleaved S16, filled in place by the source thread.
+    std::vector<int16_t> m_vecPacket;
+    uint32_t m_nPacketFrames = 0;
+    uint64_t m_nFramePos = 0;
+    double m_dPhase = 0.0;
+    double m_dPhaseStep = 0.0;
+    float m_fAmplitude = 0.0f;
+
+    std::mutex m_sourceMutex;
+    std::condition_variable m_sourceCV;
+    std::thread m_sourceThread;
+};
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __SYNTHETIC_AUDIO_CAPTRUE_HPP__
\ No newline at end of file
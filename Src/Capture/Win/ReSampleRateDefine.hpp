@@ -2,35 +2,12 @@
 #define __RESAMPLE_RATE_DEFINE_HPP__
 
 #include "Common/CYDevicePrivDefine.hpp"
-#include "libsamplerate/samplerate.h"
+#include "Common/CYAllocCheck.hpp"
 
 #include<windows.h>
 
 CYDEVICE_NAMESPACE_BEGIN
 
-/**
- * Resample Context.
- */
-struct TResamplerContext
-{
-    SRC_STATE* pResampler = nullptr;
-    UINT64     nJumpRange = 0;
-};
-
-/**
- * Triple Structure.
- */
-union UTriple
-{
-    LONG lVal;
-    struct
-    {
-        WORD wVal;
-        BYTE byTripleVal;
-        BYTE byLastByte;
-    };
-};
-
 /**
  * Audio Sample Data.
  */
@@ -38,6 +15,7 @@ struct TSampleData
 {
     LPBYTE lpData = nullptr;
     long nDataLength = 0;
+    long nCapacity = 0;
 
     int cx = 0, cy = 0;
 
@@ -58,6 +36,22 @@ struct TSampleData
         }
     }
 
+    // grows only, a sample buffer is reused by every frame that fits. The CRT realloc is not
+    // interposed, the allocation check is told about it here.
+    inline bool Reserve(long nLength)
+    {
+        if (nLength <= nCapacity)
+            return true;
+
+        CY_ALLOC_CHECK_NOTE(size_t(nLength));
+        LPBYTE lpNew = (LPBYTE)realloc(lpData, nLength);
+        if (!lpNew)
+            return false;
+        lpData = lpNew;
+        nCapacity = nLength;
+        return true;
+    }
+
     inline void AddRef()
     {
         ++refs;
@@ -69,14 +63,6 @@ struct TSampleData
     }
 };
 
-/**
- * Calculate the difference.
- */
-inline UINT64 GetQWDif(UINT64 nVal1, UINT64 nVal2)
-{
-    return (nVal1 > nVal2) ? (nVal1 - nVal2) : (nVal2 - nVal1);
-}
-
 /**
  * Find substrings.
  */
@@ -93,9 +79,6 @@ inline wchar_t* wstrstr(const wchar_t* strSrc, const wchar_t chr)
     return (wchar_t*)strSrc;
 }
 
-//////////////////////////////////////////////////////////////////////////
-#define MoreVariables static_cast<TResamplerContext*>(m_pResampler)
-
 CYDEVICE_NAMESPACE_END
 
 #endif // __RESAMPLE_RATE_DEFINE_HPP__
\ No newline at end of file
@@ -14,11 +14,11 @@
 #include "Common/Win/IVideoCaptureFilter.h"
 #include "Common/Win/CaptureFilter/CaptureFilter.h"
 #include "Common/CYStringHelper.hpp"
-#include "Capture/Win/ReSampleRateDefine.hpp"
 #include "Capture/Win/DShowCommonDefine.hpp"
-
-#include <xmmintrin.h>
-#include <emmintrin.h>
+#include "Common/CYAllocCheck.hpp"
+#include "Audio/CYAudioConvert.hpp"
+#include "Audio/CYAudioNegotiate.hpp"
+#include "Audio/CYAudioRemixer.hpp"
 
 #include "libyuv.h"
 
@@ -38,114 +38,250 @@ void CWinDeviceCaptrue::SetAudioInfo(AM_MEDIA_TYPE* audioMediaType, GUID& expect
         memcpy(&audioFormat, pFormat, sizeof(audioFormat));
 
         //WAVE_FORMAT_PCM
-        if (audioFormat.wFormatTag == WAVE_FORMAT_EXTENSIBLE)
+        inputChannelMask = 0;
+        if (audioFormat.wFormatTag == WAVE_FORMAT_EXTENSIBLE && audioMediaType->cbFormat >= sizeof(WAVEFORMATEXTENSIBLE))
         {
-            WAVEFORMATEXTENSIBLE* wfext = (WAVEFORMATEXTENSIBLE*)&audioFormat;
+            // audioFormat only holds the WAVEFORMATEX part, the extension is read from the media type.
+            WAVEFORMATEXTENSIBLE* wfext = reinterpret_cast<WAVEFORMATEXTENSIBLE*>(pFormat);
             if (wfext->SubFormat == KSDATAFORMAT_SUBTYPE_IEEE_FLOAT)
                 m_bFloat = true;
+            inputChannelMask = wfext->dwChannelMask;
         }
         else if (audioFormat.wFormatTag == WAVE_FORMAT_IEEE_FLOAT)
             m_bFloat = true;
 
         inputBitsPerSample = audioFormat.wBitsPerSample;
         inputBlockSize = audioFormat.nBlockAlign;
-        inputChannelMask = 0;
         inputChannels = audioFormat.nChannels;
         inputSamplesPerSec = audioFormat.nSamplesPerSec;
 
-        sampleFrameCount = inputSamplesPerSec / 100;
-        sampleSegmentSize = inputBlockSize * sampleFrameCount;
-
-        outputBuffer.reserve(sampleSegmentSize);
-
         CY_LOG_ERROR(TEXT("Device audio info - bits per sample: %u, channels: %u, samples per sec: %u, block size: %u"),
             audioFormat.wBitsPerSample, audioFormat.nChannels, audioFormat.nSamplesPerSec, audioFormat.nBlockAlign);
 
-        //avoid local resampling if possible
-        /*if(pFormat->nSamplesPerSec != 44100)
-        {
-            pFormat->nSamplesPerSec = 44100;
-            if(SUCCEEDED(audioConfig->SetFormat(audioMediaType)))
-            {
-                Log(TEXT("    also successfully set samples per sec to 44.1k"));
-                audioFormat.nSamplesPerSec = 44100;
-            }
-        }*/
+        TAudioSourceFormat objSourceFormat;
+        objSourceFormat.ePcmFormat = GetPcmFormat(inputBitsPerSample, m_bFloat);
+        objSourceFormat.nChannels = inputChannels;
+        objSourceFormat.nChannelMask = inputChannelMask;
+        objSourceFormat.nSampleRate = inputSamplesPerSec;
+        objSourceFormat.nBlockAlign = inputBlockSize;
 
-        if (m_nSampleRateHz != inputSamplesPerSec)
+        if (!m_audioPipeline.Init(objSourceFormat, m_nSampleRateHz, m_objAudioConfig))
+        {
+            CY_LOG_ERROR(TEXT("CYDevice: Could not initialize the audio pipeline"));
+            soundOutputType = 0;
+        }
+        else if (!m_audioFanout.Init(objSourceFormat, m_objAudioConfig))
         {
-            int errVal;
+            CY_LOG_WARN(TEXT("CYDevice: Could not initialize the audio fan-out, subscriptions are not available"));
+        }
 
-            int converterType = SRC_SINC_FASTEST;
-            MoreVariables->pResampler = src_new(converterType, 2, &errVal);
-            if (!MoreVariables->pResampler)
-                CY_LOG_WARN(TEXT("AudioSource::InitAudioData: Could not initiate pResampler"));
+        // the pipeline keeps its own copy, the caller's matrix is only valid during Init.
+        m_objAudioConfig.pCustomMatrix = nullptr;
+    }
+    else
+    {
+        CY_LOG_WARN(TEXT("CYDevice: Audio format was not a normal wave format"));
+        soundOutputType = 0;
+    }
 
-            resampleRatio = double(m_nSampleRateHz) / double(inputSamplesPerSec);
-            bResample = true;
+    DeleteMediaType(audioMediaType);
+}
 
-            //----------------------------------------------------
-            // hack to get rid of that weird first quirky resampled packet size
+bool CWinDeviceCaptrue::CreateGraph()
+{
+    IGraphBuilder* pGraph = nullptr;
+    HRESULT hResult = CoCreateInstance(CLSID_FilterGraph, nullptr, CLSCTX_INPROC_SERVER, (REFIID)IID_IFilterGraph, (void**)&pGraph);
+    if (FAILED(hResult))
+    {
+        CY_LOG_ERROR(TEXT("CYDevice: Failed to build IGraphBuilder, result = %08lX"), hResult);
+        return false;
+    }
 
-            SRC_DATA data;
-            data.src_ratio = resampleRatio;
+    m_ptrGraph.reset(pGraph);
+    ICaptureGraphBuilder2* pGraphBuilder = nullptr;
+    hResult = CoCreateInstance(CLSID_CaptureGraphBuilder2, nullptr, CLSCTX_INPROC_SERVER, (REFIID)IID_ICaptureGraphBuilder2, (void**)&pGraphBuilder);
+    if (FAILED(hResult))
+    {
+        CY_LOG_ERROR(TEXT("CYDevice: Failed to build ICaptureGraphBuilder2, result = %08lX"), hResult);
+        return false;
+    }
 
-            std::vector<float> blankBuffer;
-            blankBuffer.reserve(inputSamplesPerSec / 100 * 2);
+    m_ptrGraphBuilder.reset(pGraphBuilder);
+    m_ptrGraphBuilder->SetFiltergraph(m_ptrGraph.get());
+    return true;
+}
 
-            data.data_in = blankBuffer.data();
-            data.input_frames = inputSamplesPerSec / 100;
+AM_MEDIA_TYPE* CWinDeviceCaptrue::NegotiateAudioFormat(IAMStreamConfig* pAudioConfig)
+{
+    int nCount = 0, nSize = 0;
+    if (m_nSampleRateHz <= 0 || FAILED(pAudioConfig->GetNumberOfCapabilities(&nCount, &nSize)) || nSize != sizeof(AUDIO_STREAM_CONFIG_CAPS))
+        return nullptr;
 
-            UINT frameAdjust = UINT((double(data.input_frames) * resampleRatio) + 1.0);
-            UINT newFrameSize = frameAdjust * 2;
+    // every bit depth of a media type is a capability of its own, vecCapTypes maps them back.
+    std::vector<AM_MEDIA_TYPE*> vecMediaTypes;
+    std::vector<TAudioCapability> vecCaps;
+    std::vector<size_t> vecCapTypes;
 
-            tempResampleBuffer.reserve(newFrameSize);
+    for (int i = 0; i < nCount; ++i)
+    {
+        AM_MEDIA_TYPE* pMT = nullptr;
+        AUDIO_STREAM_CONFIG_CAPS objStreamCaps = {};
+        if (FAILED(pAudioConfig->GetStreamCaps(i, &pMT, (BYTE*)&objStreamCaps)))
+            continue;
 
-            data.data_out = tempResampleBuffer.data();
-            data.output_frames = frameAdjust;
+        if (pMT->majortype != MEDIATYPE_Audio || pMT->formattype != FORMAT_WaveFormatEx || pMT->cbFormat < sizeof(WAVEFORMATEX))
+        {
+            DeleteMediaType(pMT);
+            continue;
+        }
+
+        const WAVEFORMATEX* pFormat = reinterpret_cast<const WAVEFORMATEX*>(pMT->pbFormat);
+        bool bFloat = pFormat->wFormatTag == WAVE_FORMAT_IEEE_FLOAT;
+        if (pFormat->wFormatTag == WAVE_FORMAT_EXTENSIBLE && pMT->cbFormat >= sizeof(WAVEFORMATEXTENSIBLE))
+            bFloat = reinterpret_cast<const WAVEFORMATEXTENSIBLE*>(pFormat)->SubFormat == KSDATAFORMAT_SUBTYPE_IEEE_FLOAT;
+
+        // drivers that leave the ranges empty only offer the format of the media type.
+        TAudioCapability objCap;
+        objCap.nMinChannels = objStreamCaps.MinimumChannels ? objStreamCaps.MinimumChannels : pFormat->nChannels;
+        objCap.nMaxChannels = objStreamCaps.MaximumChannels ? objStreamCaps.MaximumChannels : pFormat->nChannels;
+        objCap.nChannelStep = objStreamCaps.ChannelsGranularity;
+        objCap.nMinSampleRate = objStreamCaps.MinimumSampleFrequency ? objStreamCaps.MinimumSampleFrequency : pFormat->nSamplesPerSec;
+        objCap.nMaxSampleRate = objStreamCaps.MaximumSampleFrequency ? objStreamCaps.MaximumSampleFrequency : pFormat->nSamplesPerSec;
+        objCap.nSampleRateStep = objStreamCaps.SampleFrequencyGranularity;
+
+        ULONG nMinBits = objStreamCaps.MinimumBitsPerSample ? objStreamCaps.MinimumBitsPerSample : pFormat->wBitsPerSample;
+        ULONG nMaxBits = MAX(objStreamCaps.MaximumBitsPerSample, nMinBits);
+        ULONG nBitsStep = objStreamCaps.BitsPerSampleGranularity ? objStreamCaps.BitsPerSampleGranularity : MAX(nMaxBits - nMinBits, 1ul);
+        for (ULONG nBits = nMinBits; nBits <= nMaxBits; nBits += nBitsStep)
+        {
+            objCap.ePcmFormat = GetPcmFormat(nBits, bFloat);
+            if (objCap.ePcmFormat == TYPE_PCM_UNKNOWN)
+                continue;
 
-            data.end_of_input = 0;
+            vecCaps.push_back(objCap);
+            vecCapTypes.push_back(vecMediaTypes.size());
+        }
+
+        vecMediaTypes.push_back(pMT);
+    }
 
-            int hResult = src_process(MoreVariables->pResampler, &data);
+    TAudioNegotiateTarget objTarget;
+    objTarget.Set((uint32_t)m_nSampleRateHz, m_objAudioConfig);
 
-            nop();
+    AM_MEDIA_TYPE* pSelected = nullptr;
+    TAudioNegotiateResult objResult;
+    if (CYAudioNegotiate::Select(vecCaps.data(), (uint32_t)vecCaps.size(), objTarget, objResult))
+    {
+        const TAudioSourceFormat& objFormat = objResult.objFormat;
+        AM_MEDIA_TYPE* pMT = vecMediaTypes[vecCapTypes[objResult.nCapability]];
+
+        WAVEFORMATEX* pFormat = reinterpret_cast<WAVEFORMATEX*>(pMT->pbFormat);
+        const WORD nOldChannels = pFormat->nChannels;
+        pFormat->nChannels = (WORD)objFormat.nChannels;
+        pFormat->nSamplesPerSec = objFormat.nSampleRate;
+        pFormat->wBitsPerSample = (WORD)(GetPcmBytesPerSample(objFormat.ePcmFormat) * 8);
+        pFormat->nBlockAlign = (WORD)objFormat.nBlockAlign;
+        pFormat->nAvgBytesPerSec = objFormat.nSampleRate * objFormat.nBlockAlign;
+        if (pFormat->wFormatTag == WAVE_FORMAT_EXTENSIBLE && pMT->cbFormat >= sizeof(WAVEFORMATEXTENSIBLE))
+        {
+            WAVEFORMATEXTENSIBLE* wfext = reinterpret_cast<WAVEFORMATEXTENSIBLE*>(pFormat);
+            wfext->Samples.wValidBitsPerSample = pFormat->wBitsPerSample;
+            if (nOldChannels != pFormat->nChannels)
+                wfext->dwChannelMask = CYAudioRemixer::GetDefaultChannelMask(objFormat.nChannels);
+        }
+
+        if (SUCCEEDED(pAudioConfig->SetFormat(pMT)))
+        {
+            CY_LOG_TRACE(TEXT("CYDevice: Negotiated %u channels at %u Hz, %u bits, cost %.1f"),
+                objFormat.nChannels, objFormat.nSampleRate, (UINT)pFormat->wBitsPerSample, objResult.fCost);
+            pSelected = pMT;
         }
+        else
+        {
+            CY_LOG_WARN(TEXT("CYDevice: Device rejected the negotiated audio format, using its current one"));
+        }
+    }
+
+    for (AM_MEDIA_TYPE* pMT : vecMediaTypes)
+    {
+        if (pMT != pSelected)
+            DeleteMediaType(pMT);
+    }
+
+    return pSelected;
+}
+
+void CWinDeviceCaptrue::ConfigureAudioPin(IPin* pAudioPin, GUID& expectedAudioType)
+{
+    HRESULT hResult;
+    IAMStreamConfig* audioConfig;
+    if (SUCCEEDED(pAudioPin->QueryInterface(IID_IAMStreamConfig, (void**)&audioConfig)))
+    {
+        AM_MEDIA_TYPE* audioMediaType;
+        if ((audioMediaType = NegotiateAudioFormat(audioConfig)) != nullptr)
+        {
+            SetAudioInfo(audioMediaType, expectedAudioType);
+        }
+        else if (SUCCEEDED(hResult = audioConfig->GetFormat(&audioMediaType)))
+        {
+            SetAudioInfo(audioMediaType, expectedAudioType);
+        }
+        else if (hResult == E_NOTIMPL) //elgato probably
+        {
+            IEnumMediaTypes* audioMediaTypes;
+            if (SUCCEEDED(hResult = pAudioPin->EnumMediaTypes(&audioMediaTypes)))
+            {
+                ULONG i = 0;
+                if ((hResult = audioMediaTypes->Next(1, &audioMediaType, &i)) == S_OK)
+                    SetAudioInfo(audioMediaType, expectedAudioType);
+                else
+                {
+                    CY_LOG_ERROR(TEXT("CYDevice: audioMediaTypes->Next failed, result = %08lX"), hResult);
+                    soundOutputType = 0;
+                }
+
+                audioMediaTypes->Release();
+            }
+            else
+            {
+                CY_LOG_ERROR(TEXT("CYDevice: audioMediaTypes->Next failed, result = %08lX"), hResult);
+                soundOutputType = 0;
+            }
+        }
+        else
+        {
+            CY_LOG_ERROR(TEXT("CYDevice: Could not get audio format, result = %08lX"), hResult);
+            soundOutputType = 0;
+        }
+
+        audioConfig->Release();
     }
     else
     {
-        CY_LOG_WARN(TEXT("CYDevice: Audio format was not a normal wave format"));
         soundOutputType = 0;
     }
-
-    DeleteMediaType(audioMediaType);
 }
 
 CWinDeviceCaptrue::CWinDeviceCaptrue()
     : IDeviceSource()
 {
-    m_pResampler = (void*)new TResamplerContext;
-    MoreVariables->nJumpRange = 70;
-    m_ptrSampleBuffer = std::make_unique<std::vector<BYTE>>();
 }
 
 CWinDeviceCaptrue::~CWinDeviceCaptrue()
 {
-    if (bResample)
-        src_delete(MoreVariables->pResampler);
-
-    delete (TResamplerContext*)m_pResampler;
-
-    if (m_ptrSampleBuffer)
-        m_ptrSampleBuffer->clear();
-    m_ptrSampleBuffer.reset();
+    m_audioFanout.UnInit();
+    m_audioPipeline.Stop();
+    m_audioPipeline.UnInit();
 }
 
-int16_t CWinDeviceCaptrue::Init(int nWidth, int nHeight, int nFPS, const wchar_t* pszDeviceName, const wchar_t* pszDeviceId, int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, bool bUseRender/* = true*/)
+int16_t CWinDeviceCaptrue::Init(int nWidth, int nHeight, int nFPS, const wchar_t* pszDeviceName, const wchar_t* pszDeviceId, int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, bool bUseRender/* = true*/, const TAudioConfig* pAudioConfig/* = nullptr*/)
 {
     m_nFPS = nFPS;
     m_nWidth = nWidth;
     m_nHeight = nHeight;
     m_nSampleRateHz = nSampleRateHz;
+    m_objAudioConfig = pAudioConfig ? *pAudioConfig : TAudioConfig();
+    m_bAudioOnly = false;
 
     bool bSucceeded = false;
     IAMStreamConfig* pStreamConfig = nullptr; SafeReleasePtr<IAMStreamConfig> ptrStreamConfig;
@@ -179,25 +315,8 @@ int16_t CWinDeviceCaptrue::Init(int nWidth, int nHeight, int nFPS, const wchar_t
     SharePtr<MediaOutputInfo> ptrBestOutput;
 
     HRESULT hResult = S_OK;
-    IGraphBuilder* pGraph = nullptr;
-    hResult = CoCreateInstance(CLSID_FilterGraph, nullptr, CLSCTX_INPROC_SERVER, (REFIID)IID_IFilterGraph, (void**)&pGraph);
-    if (FAILED(hResult))
-    {
-        CY_LOG_ERROR(TEXT("CYDevice: Failed to build IGraphBuilder, result = %08lX"), hResult);
+    if (!CreateGraph())
         return false;
-    }
-
-    m_ptrGraph.reset(pGraph);
-    ICaptureGraphBuilder2* pGraphBuilder = nullptr;
-    hResult = CoCreateInstance(CLSID_CaptureGraphBuilder2, nullptr, CLSCTX_INPROC_SERVER, (REFIID)IID_ICaptureGraphBuilder2, (void**)&pGraphBuilder);
-    if (FAILED(hResult))
-    {
-        CY_LOG_ERROR(TEXT("CYDevice: Failed to build ICaptureGraphBuilder2, result = %08lX"), hResult);
-        return false;
-    }
-
-    m_ptrGraphBuilder.reset(pGraphBuilder);
-    m_ptrGraphBuilder->SetFiltergraph(m_ptrGraph.get());
 
     if (pszDeviceName != nullptr && wcslen(pszDeviceName) > 0)
         m_pDeviceFilter = GetDeviceByValue(CLSID_VideoInputDeviceCategory, const_cast<wchar_t*>(L"FriendlyName"), pszDeviceName, const_cast<wchar_t*>(L"DevicePath"), pszDeviceId);
@@ -393,50 +512,7 @@ int16_t CWinDeviceCaptrue::Init(int nWidth, int nHeight, int nFPS, const wchar_t
     GUID expectedAudioType;
 
     if (soundOutputType == 1)
-    {
-        IAMStreamConfig* audioConfig;
-        if (SUCCEEDED(ptrAudioPin->QueryInterface(IID_IAMStreamConfig, (void**)&audioConfig)))
-        {
-            AM_MEDIA_TYPE* audioMediaType;
-            if (SUCCEEDED(hResult = audioConfig->GetFormat(&audioMediaType)))
-            {
-                SetAudioInfo(audioMediaType, expectedAudioType);
-            }
-            else if (hResult == E_NOTIMPL) //elgato probably
-            {
-                IEnumMediaTypes* audioMediaTypes;
-                if (SUCCEEDED(hResult = ptrAudioPin->EnumMediaTypes(&audioMediaTypes)))
-                {
-                    ULONG i = 0;
-                    if ((hResult = audioMediaTypes->Next(1, &audioMediaType, &i)) == S_OK)
-                        SetAudioInfo(audioMediaType, expectedAudioType);
-                    else
-                    {
-                        CY_LOG_ERROR(TEXT("CYDevice: audioMediaTypes->Next failed, result = %08lX"), hResult);
-                        soundOutputType = 0;
-                    }
-
-                    audioMediaTypes->Release();
-                }
-                else
-                {
-                    CY_LOG_ERROR(TEXT("CYDevice: audioMediaTypes->Next failed, result = %08lX"), hResult);
-                    soundOutputType = 0;
-                }
-            }
-            else
-            {
-                CY_LOG_ERROR(TEXT("CYDevice: Could not get audio format, result = %08lX"), hResult);
-                soundOutputType = 0;
-            }
-
-            audioConfig->Release();
-        }
-        else
-        {
-            soundOutputType = 0;
-        }
-    }
+        ConfigureAudioPin(ptrAudioPin.get(), expectedAudioType);
 
     // add video m_ptrGraphBuilder filter if any
 
@@ -564,6 +640,7 @@ int16_t CWinDeviceCaptrue::Init(int nWidth, int nHeight, int nFPS, const wchar_t
 
     lastSampleCX = renderCX;
     lastSampleCY = renderCY;
+    ReserveVideoBuffers(renderCX, renderCY);
 
     //------------------------------------------------
     // connect all pins and set up the whole m_ptrGraphBuilder thing
@@ -691,12 +768,106 @@ cleanFinish:
     return bSucceeded;
 }
 
+int16_t CWinDeviceCaptrue::InitAudio(int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, const TAudioConfig* pAudioConfig/* = nullptr*/)
+{
+    m_nSampleRateHz = nSampleRateHz;
+    m_objAudioConfig = pAudioConfig ? *pAudioConfig : TAudioConfig();
+    m_bAudioOnly = true;
+    m_bDeviceHasAudio = false;
+    m_bFloat = false;
+
+    bool bSucceeded = false;
+    bool bAddedAudioCapture = false, bAddedDevice = false;
+    IMediaControl* pControl = nullptr;
+    IPin* pAudioPin = nullptr;
+    SafeReleasePtr<IPin> ptrAudioPin;
+    GUID expectedAudioType;
+
+    HRESULT hResult = S_OK;
+    if (!CreateGraph())
+        return false;
+
+    // only the audio device joins the graph, no video pin is negotiated and no video buffer is reserved.
+    if (pszAudioName != nullptr && wcslen(pszAudioName) > 0)
+        m_pAudioDeviceFilter = GetDeviceByValue(CLSID_AudioInputDeviceCategory, const_cast<wchar_t*>(L"FriendlyName"), pszAudioName, const_cast<wchar_t*>(L"DevicePath"), pszAudioID);
+
+    if (!m_pAudioDeviceFilter)
+    {
+        CY_LOG_ERROR(TEXT("CYDevice: Could not create audio device filter"));
+        goto cleanFinish;
+    }
+
+    hResult = m_ptrGraphBuilder->FindPin(m_pAudioDeviceFilter, PINDIR_OUTPUT, &PIN_CATEGORY_CAPTURE, &MEDIATYPE_Audio, FALSE, 0, &pAudioPin);
+    if (FAILED(hResult) || !pAudioPin)
+    {
+        CY_LOG_ERROR(TEXT("CYDevice: No audio pin, result = %lX"), hResult);
+        goto cleanFinish;
+    }
+    ptrAudioPin.reset(pAudioPin);
+
+    soundOutputType = 1;
+    ConfigureAudioPin(ptrAudioPin.get(), expectedAudioType);
+    if (soundOutputType == 0)
+        goto cleanFinish;
+
+    m_pAudioFilter = new CaptureFilter(this, MEDIATYPE_Audio, expectedAudioType);
+    if (FAILED(hResult = m_ptrGraph->AddFilter(m_pAudioFilter, nullptr)))
+    {
+        CY_LOG_ERROR(TEXT("CYDevice: Failed to add audio m_ptrGraphBuilder filter to m_ptrGraph, result = %08lX"), hResult);
+        goto cleanFinish;
+    }
+    bAddedAudioCapture = true;
+
+    if (FAILED(hResult = m_ptrGraph->AddFilter(m_pAudioDeviceFilter, nullptr)))
+    {
+        CY_LOG_ERROR(TEXT("CYDevice: Failed to add audio device filter to m_ptrGraph, result = %08lX"), hResult);
+        goto cleanFinish;
+    }
+    bAddedDevice = true;
+
+    if (FAILED(hResult = m_ptrGraphBuilder->RenderStream(&PIN_CATEGORY_CAPTURE, &MEDIATYPE_Audio, m_pAudioDeviceFilter, nullptr, m_pAudioFilter)))
+    {
+        CY_LOG_ERROR(TEXT("CYDevice: Failed to connect the audio device pin to the audio m_ptrGraphBuilder pin, result = %08lX"), hResult);
+        goto cleanFinish;
+    }
+
+    if (FAILED(hResult = m_ptrGraph->QueryInterface(IID_IMediaControl, (void**)&pControl)))
+    {
+        CY_LOG_ERROR(TEXT("CYDevice: Failed to get IMediaControl, result = %08lX"), hResult);
+        goto cleanFinish;
+    }
+    ptrMediaControl.reset(pControl);
+    bSucceeded = true;
+
+cleanFinish:
+    ptrAudioPin.reset();
+
+    if (!bSucceeded)
+    {
+        if (bAddedAudioCapture)
+            m_ptrGraph->RemoveFilter(m_pAudioFilter);
+        if (bAddedDevice)
+            m_ptrGraph->RemoveFilter(m_pAudioDeviceFilter);
+
+        SafeRelease(m_pAudioDeviceFilter);
+        SafeRelease(m_pAudioFilter);
+        ptrMediaControl.reset();
+
+        soundOutputType = 0;
+    }
+
+    m_bFiltersLoaded = bSucceeded;
+    return bSucceeded;
+}
+
 int16_t CWinDeviceCaptrue::UnInit()
 {
     if (m_bFiltersLoaded)
     {
-        m_ptrGraph->RemoveFilter(m_pCaptureFilter);
-        m_ptrGraph->RemoveFilter(m_pDeviceFilter);
+        if (m_pCaptureFilter)
+            m_ptrGraph->RemoveFilter(m_pCaptureFilter);
+        if (m_pDeviceFilter)
+            m_ptrGraph->RemoveFilter(m_pDeviceFilter);
         if (!m_bDeviceHasAudio) m_ptrGraph->RemoveFilter(m_pAudioDeviceFilter);
 
         if (m_pAudioFilter)
@@ -714,6 +885,9 @@ int16_t CWinDeviceCaptrue::UnInit()
     m_ptrGraph.reset();
     ptrMediaControl.reset();
 
+    // subscriptions end with the device, their callbacks are not called after this.
+    m_audioFanout.UnInit();
+
     return true;
 }
 
@@ -730,13 +904,12 @@ int16_t CWinDeviceCaptrue::Start(ICYAudioDataCallBack* pAudioDataCallBack, ICYVi
     }
 
     m_pAudioDataCallBack = pAudioDataCallBack;
-    m_pVideoDataCallBack = pVideoDataCallBack;
+    m_pVideoDataCallBack = m_bAudioOnly ? nullptr : pVideoDataCallBack;
 
     m_bCapturing = true;
-    if (m_pAudioDataCallBack)
-    {
-        m_audioThread = std::thread(&CWinDeviceCaptrue::OnAudioEntry, this);
-    }
+    m_bVideoSampleReady = false;
+    m_audioPipeline.Start(m_pAudioDataCallBack);
+    m_audioFanout.Start();
 
     if (m_pVideoDataCallBack)
     {
@@ -760,471 +933,72 @@ int16_t CWinDeviceCaptrue::Stop()
         m_videoThread.join();
     }
 
-    if (m_audioThread.joinable())
-    {
-        m_audioThread.join();
-    }
+    m_audioPipeline.Stop();
+    m_audioFanout.Stop();
+
+    const uint32_t nVideoGrowCount = m_nVideoGrowCount.exchange(0, std::memory_order_relaxed);
+    if (nVideoGrowCount)
+        CY_LOG_WARN(TEXT("CYDevice: %u video frames exceeded the reserved buffer and grew it"), nVideoGrowCount);
 
     return CYERR_SUCESS;
 }
 
 int16_t CWinDeviceCaptrue::GetNextAudioBuffer(float** bufferOut, uint32_t* numFramesOut, uint64_t* timestampOut)
 {
-    LPVOID buffer;
-    UINT numAudioFrames;
-    ULONG64 newTimestamp;
-
-    if (m_ptrSampleBuffer->size() >= sampleSegmentSize)
-    {
-        {
-            std::unique_lock<std::mutex> m_locker(m_audioMutex);
-            std::vector<BYTE>* plstBuffer = m_ptrSampleBuffer.get();
-
-            memcpy(outputBuffer.data(), plstBuffer->data(), sampleSegmentSize);
-            m_ptrSampleBuffer->erase(m_ptrSampleBuffer->begin(), m_ptrSampleBuffer->begin() + sampleSegmentSize);
-        }
-
-        buffer = outputBuffer.data();
-        numAudioFrames = sampleFrameCount;
-
-        latestAudioTime += 10;
-        newTimestamp = latestAudioTime;
-    }
-    else
-    {
+    if (m_audioPipeline.GetSampleFormat() != TYPE_CYAUDIO_SAMPLE_F32 || (m_audioPipeline.IsPlanar() && m_audioPipeline.GetOutChannels() > 1))
         return false;
-    }
-
-    float* captureBuffer;
-
-    if (!m_bFloat)
-    {
-        UINT totalSamples = numAudioFrames * inputChannels;
-        if (convertBuffer.size() < totalSamples)
-            convertBuffer.reserve(totalSamples);
-
-        if (inputBitsPerSample == 8)
-        {
-            float* tempConvert = convertBuffer.data();
-            char* tempSByte = (char*)buffer;
-
-            while (totalSamples--)
-            {
-                *(tempConvert++) = float(*(tempSByte++)) / 127.0f;
-            }
-        }
-        else if (inputBitsPerSample == 16)
-        {
-            float* tempConvert = convertBuffer.data();
-            short* tempShort = (short*)buffer;
-
-            while (totalSamples--)
-            {
-                *(tempConvert++) = float(*(tempShort++)) / 32767.0f;
-            }
-        }
-        else if (inputBitsPerSample == 24)
-        {
-            float* tempConvert = convertBuffer.data();
-            BYTE* tempTriple = (BYTE*)buffer;
-            UTriple valOut;
-
-            while (totalSamples--)
-            {
-                UTriple& valIn = (UTriple&)tempTriple;
-
-                valOut.wVal = valIn.wVal;
-                valOut.byTripleVal = valIn.byTripleVal;
-                if (valOut.byTripleVal > 0x7F)
-                    valOut.byLastByte = 0xFF;
-
-                *(tempConvert++) = float(double(valOut.lVal) / 8388607.0);
-                tempTriple += 3;
-            }
-        }
-        else if (inputBitsPerSample == 32)
-        {
-            float* tempConvert = convertBuffer.data();
-            long* tempShort = (long*)buffer;
-
-            while (totalSamples--)
-            {
-                *(tempConvert++) = float(double(*(tempShort++)) / 2147483647.0);
-            }
-        }
-
-        captureBuffer = convertBuffer.data();
-    }
-    else
-        captureBuffer = (float*)buffer;
-
-    //------------------------------------------------------------
-    // channel upmix/downmix
-
-    if (tempBuffer.size() < numAudioFrames * 2)
-        tempBuffer.reserve(numAudioFrames * 2);
-
-    float* dataOutputBuffer = tempBuffer.data();
-    float* tempOut = dataOutputBuffer;
-
-    if (inputChannels == 1)
-    {
-        UINT  numFloats = numAudioFrames;
-        float* inputTemp = (float*)captureBuffer;
-        float* outputTemp = dataOutputBuffer;
-
-        if ((UPARAM(inputTemp) & 0xF) == 0 && (UPARAM(outputTemp) & 0xF) == 0)
-        {
-            UINT alignedFloats = numFloats & 0xFFFFFFFC;
-            for (UINT i = 0; i < alignedFloats; i += 4)
-            {
-                __m128 inVal = _mm_load_ps(inputTemp + i);
-
-                __m128 outVal1 = _mm_unpacklo_ps(inVal, inVal);
-                __m128 outVal2 = _mm_unpackhi_ps(inVal, inVal);
-
-                _mm_store_ps(outputTemp + (i * 2), outVal1);
-                _mm_store_ps(outputTemp + (i * 2) + 4, outVal2);
-            }
-
-            numFloats -= alignedFloats;
-            inputTemp += alignedFloats;
-            outputTemp += alignedFloats * 2;
-        }
-
-        while (numFloats--)
-        {
-            float inputVal = *inputTemp;
-            *(outputTemp++) = inputVal;
-            *(outputTemp++) = inputVal;
-
-            inputTemp++;
-        }
-    }
-    else if (inputChannels == 2) //straight up copy
-    {
-        memcpy(dataOutputBuffer, captureBuffer, numAudioFrames * 2 * sizeof(float));
-    }
-    else
-    {
-        //todo: downmix optimization, also support for other speaker configurations than ones I can merely "think" of.  ugh.
-        float* inputTemp = (float*)captureBuffer;
-        float* outputTemp = dataOutputBuffer;
-
-        if (inputChannelMask == KSAUDIO_SPEAKER_QUAD)
-        {
-            UINT numFloats = numAudioFrames * 4;
-            float* endTemp = inputTemp + numFloats;
-
-            while (inputTemp < endTemp)
-            {
-                float left = inputTemp[0];
-                float right = inputTemp[1];
-                float rearLeft = inputTemp[2] * g_fSurroundMix4;
-                float rearRight = inputTemp[3] * g_fSurroundMix4;
-
-                // When in doubt, use only left and right .... and rear left and rear right :)
-                // Same idea as with 5.1 downmix
-
-                *(outputTemp++) = (left + rearLeft) * g_fAttn4dotX;
-                *(outputTemp++) = (right + rearRight) * g_fAttn4dotX;
-
-                inputTemp += 4;
-            }
-        }
-        else if (inputChannelMask == KSAUDIO_SPEAKER_2POINT1)
-        {
-            UINT numFloats = numAudioFrames * 3;
-            float* endTemp = inputTemp + numFloats;
-
-            while (inputTemp < endTemp)
-            {
-                float left = inputTemp[0];
-                float right = inputTemp[1];
-
-                // Drop LFE since we don't need it
-                //float lfe       = inputTemp[2]*g_fLowFreqMix;
-
-                *(outputTemp++) = left;
-                *(outputTemp++) = right;
-
-                inputTemp += 3;
-            }
-        }
-        else if (inputChannelMask == KSAUDIO_SPEAKER_3POINT1)
-        {
-            UINT numFloats = numAudioFrames * 4;
-            float* endTemp = inputTemp + numFloats;
-
-            while (inputTemp < endTemp)
-            {
-                float left = inputTemp[0];
-                float right = inputTemp[1];
-                float frontCenter = inputTemp[2];
-                float lowFreq = inputTemp[3];
-
-                *(outputTemp++) = left;
-                *(outputTemp++) = right;
-
-                inputTemp += 4;
-            }
-        }
-        else if (inputChannelMask == KSAUDIO_SPEAKER_4POINT1)
-        {
-            UINT numFloats = numAudioFrames * 5;
-            float* endTemp = inputTemp + numFloats;
-
-            while (inputTemp < endTemp)
-            {
-                float left = inputTemp[0];
-                float right = inputTemp[1];
-
-                // Skip LFE , we don't really need it.
-                //float lfe       = inputTemp[2];
-
-                float rearLeft = inputTemp[3] * g_fSurroundMix4;
-                float rearRight = inputTemp[4] * g_fSurroundMix4;
-
-                // Same idea as with 5.1 downmix
-
-                *(outputTemp++) = (left + rearLeft) * g_fAttn4dotX;
-                *(outputTemp++) = (right + rearRight) * g_fAttn4dotX;
-
-                inputTemp += 5;
-            }
-        }
-        else if (inputChannelMask == KSAUDIO_SPEAKER_SURROUND)
-        {
-            UINT numFloats = numAudioFrames * 4;
-            float* endTemp = inputTemp + numFloats;
-
-            while (inputTemp < endTemp)
-            {
-                float left = inputTemp[0];
-                float right = inputTemp[1];
-                float frontCenter = inputTemp[2];
-                float rearCenter = inputTemp[3];
-
-                // When in doubt, use only left and right :) Seriously.
-                // THIS NEEDS TO BE PROPERLY IMPLEMENTED!
-
-                *(outputTemp++) = left;
-                *(outputTemp++) = right;
-
-                inputTemp += 4;
-            }
-        }
-        // Both speakers configs share the same format, the difference is in rear speakers position
-        // See: http://msdn.microsoft.com/en-us/library/windows/hardware/ff537083(v=vs.85).aspx
-        // Probably for KSAUDIO_SPEAKER_5POINT1_SURROUND we will need a different coefficient for rear left/right
-        else if (inputChannelMask == KSAUDIO_SPEAKER_5POINT1 || inputChannelMask == KSAUDIO_SPEAKER_5POINT1_SURROUND)
-        {
-            UINT numFloats = numAudioFrames * 6;
-            float* endTemp = inputTemp + numFloats;
-
-            while (inputTemp < endTemp)
-            {
-                float left = inputTemp[0];
-                float right = inputTemp[1];
-                float center = inputTemp[2] * g_fCenterMix;
-
-                //We don't need LFE channel so skip it (see below)
-                //float lowFreq   = inputTemp[3]*g_fLowFreqMix;
-
-                float rearLeft = inputTemp[4] * g_fSurroundMix;
-                float rearRight = inputTemp[5] * g_fSurroundMix;
-
-                // According to ITU-R  BS.775-1 recommendation, the downmix from a 3/2 source to stereo
-                // is the following:
-                // L = FL + k0*C + k1*RL
-                // R = FR + k0*C + k1*RR
-                // FL = front left
-                // FR = front right
-                // C  = center
-                // RL = rear left
-                // RR = rear right
-                // k0 = g_fCenterMix   = g_fDbMinus3 = 0.7071067811865476 [for k0 we can use g_fDbMinus6 = 0.5 too, probably it's better]
-                // k1 = g_fSurroundMix = g_fDbMinus3 = 0.7071067811865476
-
-                // The output (L,R) can be out of (-1,1) domain so we attenuate it [ g_fAttn5dot1 = 1/(1 + g_fCenterMix + g_fSurroundMix) ]
-                // Note: this method of downmixing is far from "perfect" (pretty sure it's not the correct way) but the resulting downmix is "okayish", at least no more bleeding ears.
-                // (maybe have a look at http://forum.doom9.org/archive/index.php/t-148228.html too [ 5.1 -> stereo ] the approach seems almost the same [but different coefficients])
-
-                // http://acousticsfreq.com/blog/wp-content/uploads/2012/01/ITU-R-BS775-1.pdf
-                // http://ir.lib.nctu.edu.tw/bitstream/987654321/22934/1/030104001.pdf
-
-                *(outputTemp++) = (left + center + rearLeft) * g_fAttn5dot1;
-                *(outputTemp++) = (right + center + rearRight) * g_fAttn5dot1;
-
-                inputTemp += 6;
-            }
-        }
-
-        // According to http://msdn.microsoft.com/en-us/library/windows/hardware/ff537083(v=vs.85).aspx
-        // KSAUDIO_SPEAKER_7POINT1 is obsolete and no longer supported in Windows Vista and later versions of Windows
-        // Not sure what to do about it, meh , drop front left of center/front right of center -> 5.1 -> stereo;
-
-        else if (inputChannelMask == KSAUDIO_SPEAKER_7POINT1)
-        {
-            UINT numFloats = numAudioFrames * 8;
-            float* endTemp = inputTemp + numFloats;
-
-            while (inputTemp < endTemp)
-            {
-                float left = inputTemp[0];
-                float right = inputTemp[1];
-
-                float center = inputTemp[2] * g_fCenterMix;
-
-                // Drop LFE since we don't need it
-                //float lowFreq       = inputTemp[3]*g_fLowFreqMix;
 
-                float rearLeft = inputTemp[4] * g_fSurroundMix;
-                float rearRight = inputTemp[5] * g_fSurroundMix;
-
-                // Drop SPEAKER_FRONT_LEFT_OF_CENTER , SPEAKER_FRONT_RIGHT_OF_CENTER
-                //float centerLeft    = inputTemp[6];
-                //float centerRight   = inputTemp[7];
-
-                // Downmix from 5.1 to stereo
-                *(outputTemp++) = (left + center + rearLeft) * g_fAttn5dot1;
-                *(outputTemp++) = (right + center + rearRight) * g_fAttn5dot1;
-
-                inputTemp += 8;
-            }
-        }
-
-        // Downmix to 5.1 (easy stuff) then downmix to stereo as done in KSAUDIO_SPEAKER_5POINT1
-        else if (inputChannelMask == KSAUDIO_SPEAKER_7POINT1_SURROUND)
-        {
-            UINT numFloats = numAudioFrames * 8;
-            float* endTemp = inputTemp + numFloats;
-
-            while (inputTemp < endTemp)
-            {
-                float left = inputTemp[0];
-                float right = inputTemp[1];
-                float center = inputTemp[2] * g_fCenterMix;
-
-                // Skip LFE we don't need it
-                //float lowFreq   = inputTemp[3]*g_fLowFreqMix;
-
-                float rearLeft = inputTemp[4];
-                float rearRight = inputTemp[5];
-                float sideLeft = inputTemp[6];
-                float sideRight = inputTemp[7];
-
-                // combine the rear/side channels first , baaam! 5.1
-                rearLeft = (rearLeft + sideLeft) * 0.5f;
-                rearRight = (rearRight + sideRight) * 0.5f;
-
-                // downmix to stereo as in 5.1 case
-                *(outputTemp++) = (left + center + rearLeft * g_fSurroundMix) * g_fAttn5dot1;
-                *(outputTemp++) = (right + center + rearRight * g_fSurroundMix) * g_fAttn5dot1;
-
-                inputTemp += 8;
-            }
-        }
-    }
-
-    ReleaseAudioBuffer();
-
-    //------------------------------------------------------------
-     // resample
-
-    if (bResample)
-    {
-        UINT frameAdjust = UINT((double(numAudioFrames) * resampleRatio) + 1.0);
-        UINT newFrameSize = frameAdjust * 2;
-
-        if (tempResampleBuffer.size() < newFrameSize)
-            tempResampleBuffer.reserve(newFrameSize);
-
-        SRC_DATA data;
-        data.src_ratio = resampleRatio;
-
-        data.data_in = tempBuffer.data();
-        data.input_frames = numAudioFrames;
-
-        data.data_out = tempResampleBuffer.data();
-        data.output_frames = frameAdjust;
-
-        data.end_of_input = 0;
-
-        int hResult = src_process(MoreVariables->pResampler, &data);
-        if (hResult)
-        {
-            CY_LOG_ERROR(TEXT("AudioSource::QueryAudio: Was unable to resample audio for device"));
-            return false;
-        }
-
-        if (data.input_frames_used != numAudioFrames)
-        {
-            CY_LOG_ERROR(TEXT("AudioSource::QueryAudio: Failed to downsample buffer completely, which shouldn't actually happen because it should be using 10ms of samples"));
-            return false;
-        }
-
-        numAudioFrames = data.output_frames_gen;
-    }
-
-    //------------------------------------------------------
-    // timestamp smoothing (keep audio within 70ms of target time)
-
-    if (!lastUsedTimestamp)
-        lastUsedTimestamp = newTimestamp;
-    else
-        lastUsedTimestamp += 10;
-
-    UINT64 difVal = GetQWDif(newTimestamp, lastUsedTimestamp);
+    TAudioPeriod objPeriod;
+    if (!m_audioPipeline.GetNextBuffer(objPeriod))
+        return false;
 
-    if (difVal > MoreVariables->nJumpRange /*|| (bCanBurstHack && newTimestamp < lastUsedTimestamp)*/)
-    {
-        /*QWORD curTimeMS = App->GetVideoTime()-App->GetSceneTimestamp();
-        UINT curTimeTotalSec = (UINT)(curTimeMS/1000);
-        UINT curTimeTotalMin = curTimeTotalSec/60;
-        UINT curTimeHr  = curTimeTotalMin/60;
-        UINT curTimeMin = curTimeTotalMin-(curTimeHr*60);
-        UINT curTimeSec = curTimeTotalSec-(curTimeTotalMin*60);
-
-        Log(TEXT("A timestamp adjustment was encountered for device %s, approximate stream time is: %u:%u:%u, prev value: %llu, new value: %llu"), GetDeviceName(), curTimeHr, curTimeMin, curTimeSec, lastUsedTimestamp, newTimestamp);*/
-        //if (difVal >= 70)
-        //    Log(TEXT("A timestamp adjustment was encountered for device %s, diffVal: %llu, nJumpRange: %llu, newTimestamp: %llu, lastUsedTimestamp: %llu"),
-        //    GetDeviceName(), difVal, MoreVariables->nJumpRange, newTimestamp, lastUsedTimestamp);
-        lastUsedTimestamp = newTimestamp;
-    }
+    *bufferOut = static_cast<float*>(const_cast<void*>(objPeriod.pData));
+    *numFramesOut = objPeriod.nFrames;
+    *timestampOut = objPeriod.nTimeStamp;
+    return true;
+}
 
-    //if (sstri(GetDeviceName(), L"avermedia") != nullptr)
-    //    Log(L"newTimestamp: %llu, lastUsedTimestamp: %llu", newTimestamp, lastUsedTimestamp);
+int16_t CWinDeviceCaptrue::ReleaseAudioBuffer()
+{
+    m_audioPipeline.ReleasePeriod();
+    return CYERR_SUCESS;
+}
 
-    //-----------------------------------------------------------------------------
+int16_t CWinDeviceCaptrue::ReadAudio(void* pBuffer, uint32_t nNumFrames, uint32_t nTimeoutMs, uint32_t& nReadFrames, uint64_t& nTimestamp)
+{
+    return m_audioPipeline.Read(pBuffer, nNumFrames, nTimeoutMs, nReadFrames, nTimestamp) ? CYERR_SUCESS : CYERR_FAILED;
+}
 
-    float* newBuffer = (bResample) ? tempResampleBuffer.data() : tempBuffer.data();
+int16_t CWinDeviceCaptrue::GetAudioLevels(TAudioLevels& objLevels)
+{
+    return m_audioPipeline.GetLevels(objLevels) ? CYERR_SUCESS : CYERR_FAILED;
+}
 
-    bool bCanBurstHack = true;
-    bool overshotAudio = (lastUsedTimestamp < lastSentTimestamp + 10);
-    if (bCanBurstHack || !overshotAudio)
-    {
-        lastSentTimestamp = lastUsedTimestamp;
-    }
+int16_t CWinDeviceCaptrue::GetAudioSchedulingStats(TAudioSchedulingStats& objStats)
+{
+    m_audioPipeline.GetSchedulingStats(objStats);
+    return CYERR_SUCESS;
+}
 
-    *bufferOut = newBuffer;
-    *numFramesOut = numAudioFrames;
-    *timestampOut = lastUsedTimestamp;
+int16_t CWinDeviceCaptrue::SetAudioStages(const TAudioStage* pStages, uint32_t nStages)
+{
+    return m_audioPipeline.SetStages(pStages, nStages) ? CYERR_SUCESS : CYERR_FAILED;
+}
 
-    return true;
+int16_t CWinDeviceCaptrue::SubscribeAudio(const TAudioSubscription& objSubscription, uint32_t& nSubscriptionId)
+{
+    return m_audioFanout.Subscribe(objSubscription, nSubscriptionId) ? CYERR_SUCESS : CYERR_FAILED;
 }
 
-int16_t CWinDeviceCaptrue::ReleaseAudioBuffer()
+int16_t CWinDeviceCaptrue::UnsubscribeAudio(uint32_t nSubscriptionId)
 {
-    std::unique_lock<std::mutex> m_locker(m_audioMutex);
-    m_ptrSampleBuffer->clear();
-    return CYERR_SUCESS;
+    return m_audioFanout.Unsubscribe(nSubscriptionId) ? CYERR_SUCESS : CYERR_FAILED;
 }
 
 void CWinDeviceCaptrue::FlushSamples()
 {
-    std::unique_lock<std::mutex> m_locker(m_audioMutex);
-    m_ptrSampleBuffer->clear();
+    m_audioPipeline.Flush();
+    m_audioFanout.Flush();
 }
 
 void CWinDeviceCaptrue::ReceiveMediaSample(IMediaSample* sample, bool bAudio)
@@ -1239,20 +1013,21 @@ void CWinDeviceCaptrue::ReceiveMediaSample(IMediaSample* sample, bool bAudio)
     if (!nLength)
         return;
 
+    CY_ALLOC_CHECK_SCOPE();
+
     if (SUCCEEDED(sample->GetPointer(&pointer)))
     {
         if (bAudio)
         {
-            std::unique_lock<std::mutex> m_locker(m_audioMutex);
-            m_ptrSampleBuffer->insert(m_ptrSampleBuffer->end(), pointer, pointer + nLength);
-            CY_LOG_TRACE(TEXT("Audio Length=%d Time=%d"), nLength, GetTickCount() - m_dwStartTime);
-            m_dwStartTime = GetTickCount();
-            m_audioCV.notify_one();
+            // the stream time of the sample lets the pipeline find gaps and overlaps between packets.
+            REFERENCE_TIME nStartTime = 0, nStopTime = 0;
+            int64_t nStreamUs = (SUCCEEDED(sample->GetTime(&nStartTime, &nStopTime)) && nStartTime >= 0) ? nStartTime / 10 : -1;
+            int64_t nHostUs = GetHostTimeUs();
+            m_audioPipeline.Write(pointer, nLength, nHostUs, nStreamUs);
+            m_audioFanout.Write(pointer, nLength, nHostUs, nStreamUs);
         }
         else
         {
-            std::unique_ptr<TSampleData> ptrdata;
-
             AM_MEDIA_TYPE* mt = nullptr;
             if (sample->GetMediaType(&mt) == S_OK)
             {
@@ -1262,50 +1037,32 @@ void CWinDeviceCaptrue::ReceiveMediaSample(IMediaSample* sample, bool bAudio)
                 DeleteMediaType(mt);
             }
 
-            ptrdata = std::make_unique<TSampleData>();
-            ptrdata->bAudio = bAudio;
-            ptrdata->nDataLength = nLength;
-            ptrdata->lpData = (LPBYTE)malloc(ptrdata->nDataLength);//pointer; //
-            ptrdata->cx = lastSampleCX;
-            ptrdata->cy = lastSampleCY;
-            /*data->sample = sample;
-            sample->AddRef();*/
+            // only a frame larger than the negotiated format grows the buffer, Stop logs how often it did.
+            TSampleData& objSample = m_arrVideoSamples[m_nVideoWriteIndex];
+            if (nLength > objSample.nCapacity)
+                m_nVideoGrowCount.fetch_add(1, std::memory_order_relaxed);
+            if (!objSample.Reserve(nLength))
+                return;
 
-            memcpy(ptrdata->lpData, pointer, ptrdata->nDataLength);
+            objSample.bAudio = bAudio;
+            objSample.nDataLength = nLength;
+            objSample.cx = lastSampleCX;
+            objSample.cy = lastSampleCY;
+            memcpy(objSample.lpData, pointer, nLength);
 
             LONGLONG stopTime;
-            sample->GetTime(&stopTime, &ptrdata->nTimestamp);
+            sample->GetTime(&stopTime, &objSample.nTimestamp);
 
             {
                 UniqueLock locker(m_videoMutex);
-                latestVideoSample = std::move(ptrdata);
+                std::swap(m_nVideoWriteIndex, m_nVideoLatestIndex);
+                m_bVideoSampleReady = true;
             }
             m_videoCV.notify_one();
         }
     }
 }
 
-void CWinDeviceCaptrue::OnAudioEntry()
-{
-    while (m_bCapturing)
-    {
-        {
-            UniqueLock locker(m_audioMutex);
-            m_audioCV.wait_for(locker, std::chrono::milliseconds(10), [this]() { return m_ptrSampleBuffer->size() >= sampleSegmentSize; });
-        }
-
-        if (!m_bCapturing) break;
-
-        float* pBuffer = nullptr;
-        uint32_t numAudioFrames = 0;
-        uint64_t newTimestamp = 0;
-        if (GetNextAudioBuffer((float**)&pBuffer, &numAudioFrames, &newTimestamp))
-        {
-            if (m_pAudioDataCallBack) m_pAudioDataCallBack->OnAudioData(pBuffer, numAudioFrames, 2, newTimestamp);
-        }
-    }
-}
-
 int ConvertVideoType(ECYVideoOutputType eVideoType)
 {
     switch (eVideoType)
@@ -1382,20 +1139,59 @@ size_t CalcBufferSize(ECYVideoOutputType eType, int width, int height)
     return buffer_size;
 }
 
+// the largest frame a sample buffer holds, compressed frames stay below three bytes a pixel.
+static size_t CalcSampleCapacity(ECYVideoOutputType eType, int width, int height)
+{
+    switch (eType)
+    {
+    case TYPE_VIDEO_OUTPUT_I420:
+    case TYPE_VIDEO_OUTPUT_YV12:
+    case TYPE_VIDEO_OUTPUT_RGB565:
+    case TYPE_VIDEO_OUTPUT_YUY2:
+    case TYPE_VIDEO_OUTPUT_YVYU:
+    case TYPE_VIDEO_OUTPUT_UYVY:
+    case TYPE_VIDEO_OUTPUT_RGB24:
+    case TYPE_VIDEO_OUTPUT_ARGB32:
+    case TYPE_VIDEO_OUTPUT_RGB32:
+        return CalcBufferSize(eType, width, height);
+    default:
+        return size_t(width) * height * 3;
+    }
+}
+
+void CWinDeviceCaptrue::ReserveVideoBuffers(int nWidth, int nHeight)
+{
+    nHeight = abs(nHeight);
+    if (nWidth <= 0 || !nHeight)
+        return;
+
+    const long nCapacity = long(CalcSampleCapacity(m_eColorType, nWidth, nHeight));
+    for (TSampleData& objSample : m_arrVideoSamples)
+    {
+        if (!objSample.Reserve(nCapacity))
+            CY_LOG_ERROR(TEXT("CYDevice: Could not reserve %ld bytes for video frames"), nCapacity);
+    }
+    m_vecI420.resize(size_t(nWidth) * nHeight * 3 / 2);
+}
+
 void CWinDeviceCaptrue::OnVideoEntry()
 {
     while (m_bCapturing)
     {
-        UniqueLock locker(m_videoMutex);
-        m_videoCV.wait_for(locker, std::chrono::milliseconds(10), [this]() { return latestVideoSample != nullptr; });
+        // the newest frame is swapped in under the lock, converting it no longer holds up the capture thread.
+        {
+            UniqueLock locker(m_videoMutex);
+            m_videoCV.wait_for(locker, std::chrono::milliseconds(10), [this]() { return m_bVideoSampleReady; });
+            if (!m_bVideoSampleReady)
+                continue;
 
-        if (!m_bCapturing) break;
+            std::swap(m_nVideoReadIndex, m_nVideoLatestIndex);
+            m_bVideoSampleReady = false;
+        }
 
-        std::unique_ptr<TSampleData> lastSample;
-        lastSample = std::move(latestVideoSample);
-        latestVideoSample.reset();
+        if (!m_bCapturing) break;
 
-        if (lastSample)
+        const TSampleData* lastSample = &m_arrVideoSamples[m_nVideoReadIndex];
         {
             newCX = lastSample->cx;
             newCY = lastSample->cy;
@@ -1419,19 +1215,24 @@ void CWinDeviceCaptrue::OnVideoEntry()
 
             libyuv::RotationMode rotation_mode = libyuv::kRotate0;
 
-            std::unique_ptr<char[]> ptrYUVBuffer = std::make_unique<char[]>(width * height * 3 / 2);
+            if (m_vecI420.size() < size_t(width) * abs(height) * 3 / 2)
+                m_vecI420.resize(size_t(width) * abs(height) * 3 / 2);
 
-            uint8_t* dst_y = (uint8_t*)ptrYUVBuffer.get();
+            uint8_t* dst_y = m_vecI420.data();
             uint8_t* dst_u = dst_y + width * height;
             uint8_t* dst_v = dst_u + width * height / 4;
 
-            const int conversionResult = libyuv::ConvertToI420(
-                lastSample->lpData, lastSample->nDataLength, dst_y,
-                stride_y, dst_u,
-                stride_uv, dst_v,
-                stride_uv, 0, 0,  // No Cropping
-                width, height, target_width, target_height, rotation_mode,
-                ConvertVideoType(m_eColorType));
+            int conversionResult = 0;
+            {
+                CY_ALLOC_CHECK_SCOPE();
+                conversionResult = libyuv::ConvertToI420(
+                    lastSample->lpData, lastSample->nDataLength, dst_y,
+                    stride_y, dst_u,
+                    stride_uv, dst_v,
+                    stride_uv, 0, 0,  // No Cropping
+                    width, height, target_width, target_height, rotation_mode,
+                    ConvertVideoType(m_eColorType));
+            }
             if (conversionResult < 0)
             {
                 CY_LOG_ERROR("Failed to convert capture frame from type %d to I420.", (int)m_eColorType);
@@ -1442,8 +1243,6 @@ void CWinDeviceCaptrue::OnVideoEntry()
             {
                 m_pVideoDataCallBack->OnVideoData(dst_y, width * height * 3 / 2, width, height, lastSample->nTimestamp);
             }
-
-            lastSample.reset();
         }
     }
 }
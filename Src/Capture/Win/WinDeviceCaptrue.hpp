@@ -7,9 +7,13 @@
 #include "Common/Win/IDeviceSource.h"
 #include "Common/CYDevicePrivDefine.hpp"
 #include "Capture/IDeviceCapture.hpp"
+#include "Audio/CYAudioPipeline.hpp"
+#include "Audio/CYAudioFanout.hpp"
+#include "Capture/Win/ReSampleRateDefine.hpp"
 
 #include <vector>
 #include <mutex>
+#include <atomic>
 
 class CaptureFilter;
 
@@ -26,14 +30,14 @@ template<typename T>
 template<typename T, void (*Fn)(T*) = CYSafeRelease>
 using SafeReleasePtr = std::unique_ptr<typename std::remove_pointer_t<T>, PointerDel<Fn>>;
 
-struct TSampleData;
 class CWinDeviceCaptrue : public IDeviceSource, public IDeviceCapture
 {
 public:
     CWinDeviceCaptrue();
     virtual ~CWinDeviceCaptrue();
 
-    int16_t Init(int nWidth/* = 1024*/, int nHeight/* = 768*/, int nFPS/* = 25*/, const wchar_t* pszDeviceName, const wchar_t* pszDeviceId, int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, bool bUseRender = true) override;
+    int16_t Init(int nWidth/* = 1024*/, int nHeight/* = 768*/, int nFPS/* = 25*/, const wchar_t* pszDeviceName, const wchar_t* pszDeviceId, int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, bool bUseRender = true, const TAudioConfig* pAudioConfig = nullptr) override;
+    int16_t InitAudio(int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, const TAudioConfig* pAudioConfig = nullptr) override;
     int16_t UnInit() override;
 
     int16_t Start(ICYAudioDataCallBack* pAudioDataCallBack, ICYVideoDataCallBack* pVideoDataCallBack) override;
@@ -41,14 +45,25 @@ public:
 
     int16_t GetNextAudioBuffer(float** buffer, uint32_t* numFrames, uint64_t* timestamp) override;
     int16_t ReleaseAudioBuffer() override;
+    int16_t ReadAudio(void* pBuffer, uint32_t nNumFrames, uint32_t nTimeoutMs, uint32_t& nReadFrames, uint64_t& nTimestamp) override;
+
+    int16_t GetAudioLevels(TAudioLevels& objLevels) override;
+    int16_t GetAudioSchedulingStats(TAudioSchedulingStats& objStats) override;
+    int16_t SetAudioStages(const TAudioStage* pStages, uint32_t nStages) override;
+
+    int16_t SubscribeAudio(const TAudioSubscription& objSubscription, uint32_t& nSubscriptionId) override;
+    int16_t UnsubscribeAudio(uint32_t nSubscriptionId) override;
 
 protected:
+    bool CreateGraph();
+    void ConfigureAudioPin(IPin* pAudioPin, GUID& expectedAudioType);
+    AM_MEDIA_TYPE* NegotiateAudioFormat(IAMStreamConfig* pAudioConfig);
     void SetAudioInfo(AM_MEDIA_TYPE* audioMediaType, GUID& expectedAudioType);
 
     virtual void FlushSamples() override;
     virtual void ReceiveMediaSample(IMediaSample* sample, bool bAudio) override;
 
-    void OnAudioEntry();
+    void ReserveVideoBuffers(int nWidth, int nHeight);
     void OnVideoEntry();
 
 private:
@@ -59,9 +74,10 @@ private:
 
     IBaseFilter* m_pDeviceFilter = nullptr;
     IBaseFilter* m_pAudioDeviceFilter = nullptr;
-    CaptureFilter* m_pCaptureFilter;
-    IBaseFilter* m_pAudioFilter; // Audio renderer filter
+    CaptureFilter* m_pCaptureFilter = nullptr;
+    IBaseFilter* m_pAudioFilter = nullptr; // Audio renderer filter
 
+    bool m_bAudioOnly = false;
     bool m_bDeviceHasAudio = true;
     bool m_bUseCustomResolution = false;
 
@@ -75,8 +91,6 @@ private:
     UINT  inputBlockSize;
     DWORD inputChannelMask;
 
-    UINT sampleSegmentSize, sampleFrameCount;
-
     UINT imageCX, imageCY;
 
     UINT bufferTime;				// 100-nsec units (same as REFERENCE_TIME)
@@ -91,35 +105,25 @@ private:
     UINT            newCX, newCY;
     UINT            preferredOutputType = -1;
 
-    UINT64          lastUsedTimestamp = 0;
-    UINT64          lastSentTimestamp = 0;
-    double          resampleRatio;
-
-    LPVOID          m_pResampler = nullptr;
-    bool            bResample = false;
-
-
-
-    std::mutex m_audioMutex;
-    std::condition_variable m_audioCV;
-    std::unique_ptr<std::vector<BYTE>> m_ptrSampleBuffer;
-    std::unique_ptr<TSampleData> latestVideoSample;
-
-    ULONG64 latestAudioTime = 0;
-    std::vector<float> outputBuffer;
-
-    std::vector<float> convertBuffer;
+    CYAudioPipeline m_audioPipeline;
+    CYAudioFanout m_audioFanout;
+    TAudioConfig m_objAudioConfig;
 
-    std::vector<float> tempBuffer;
-    std::vector<float> tempResampleBuffer;
+    // video frames rotate through three buffers sized at Init, the capture thread fills one, the newest
+    // frame waits in the next and the video thread converts the third, so neither side allocates.
+    TSampleData m_arrVideoSamples[3];
+    uint32_t m_nVideoWriteIndex = 0;
+    uint32_t m_nVideoLatestIndex = 1;
+    uint32_t m_nVideoReadIndex = 2;
+    bool m_bVideoSampleReady = false;
+    std::atomic<uint32_t> m_nVideoGrowCount{ 0 };
+    std::vector<uint8_t> m_vecI420;
 
     std::mutex m_videoMutex;
     std::condition_variable m_videoCV;
 
-    std::thread m_audioThread;
     std::thread m_videoThread;
 
-    DWORD   m_dwStartTime = GetTickCount();
     ICYAudioDataCallBack* m_pAudioDataCallBack = nullptr;
     ICYVideoDataCallBack* m_pVideoDataCallBack = nullptr;
 
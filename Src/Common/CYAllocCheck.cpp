@@ -0,0 +1,235 @@
+#include "Common/CYAllocCheck.hpp"
+
+#if defined(CYDEVICE_ALLOC_CHECK)
+
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <dlfcn.h>
+#endif
+
+// malloc reads the flags, their TLS access must not allocate in turn.
+#if defined(_WIN32)
+#define CY_ALLOC_CHECK_TLS          thread_local
+#else
+#define CY_ALLOC_CHECK_TLS          __attribute__((tls_model("initial-exec"))) thread_local
+#endif
+
+// glibc declares the C allocator noexcept, the replacements must match.
+#if defined(__GLIBC__)
+#define CY_ALLOC_NOEXCEPT           noexcept
+#else
+#define CY_ALLOC_NOEXCEPT
+#endif
+
+CYDEVICE_NAMESPACE_BEGIN
+
+static CY_ALLOC_CHECK_TLS uint32_t t_nAllocCheckScopes = 0;
+static CY_ALLOC_CHECK_TLS bool t_bAllocCheck = false;
+
+CYAllocCheckScope::CYAllocCheckScope()
+    : m_bPrevious(t_bAllocCheck)
+{
+    if (t_nAllocCheckScopes < g_nAllocCheckWarmup)
+        ++t_nAllocCheckScopes;
+    else
+        t_bAllocCheck = true;
+}
+
+CYAllocCheckScope::~CYAllocCheckScope()
+{
+    t_bAllocCheck = m_bPrevious;
+}
+
+// the check is dropped before reporting, stdio must not trip it again.
+static void CheckAlloc(size_t nSize)
+{
+    if (!t_bAllocCheck)
+        return;
+
+    t_bAllocCheck = false;
+    fprintf(stderr, "CYDevice: %zu bytes allocated on a capture thread after warm-up\n", nSize);
+    abort();
+}
+
+void CYAllocCheckNote(size_t nSize)
+{
+    CheckAlloc(nSize);
+}
+
+static void* Allocate(size_t nSize)
+{
+    CheckAlloc(nSize);
+    return malloc(nSize ? nSize : 1);
+}
+
+#if !defined(_WIN32)
+
+using PFN_MALLOC = void* (*)(size_t);
+using PFN_CALLOC = void* (*)(size_t, size_t);
+using PFN_REALLOC = void* (*)(void*, size_t);
+using PFN_FREE = void (*)(void*);
+
+// The next allocator in the lookup order, found on the first call. dlsym may allocate while it runs,
+// those blocks come from a static arena and are never freed.
+static PFN_MALLOC g_pfnMalloc = nullptr;
+static PFN_CALLOC g_pfnCalloc = nullptr;
+static PFN_REALLOC g_pfnRealloc = nullptr;
+static PFN_FREE g_pfnFree = nullptr;
+static bool g_bResolving = false;
+
+alignas(16) static unsigned char g_arrBootstrap[16384];
+static size_t g_nBootstrapUsed = 0;
+
+static bool ResolveAllocator()
+{
+    if (!g_pfnFree && !g_bResolving)
+    {
+        g_bResolving = true;
+        g_pfnMalloc = reinterpret_cast<PFN_MALLOC>(dlsym(RTLD_NEXT, "malloc"));
+        g_pfnCalloc = reinterpret_cast<PFN_CALLOC>(dlsym(RTLD_NEXT, "calloc"));
+        g_pfnRealloc = reinterpret_cast<PFN_REALLOC>(dlsym(RTLD_NEXT, "realloc"));
+        PFN_FREE pfnFree = reinterpret_cast<PFN_FREE>(dlsym(RTLD_NEXT, "free"));
+        if (!g_pfnMalloc || !g_pfnCalloc || !g_pfnRealloc || !pfnFree)
+        {
+            fprintf(stderr, "CYDevice: The allocation check could not find the C allocator\n");
+            abort();
+        }
+        g_pfnFree = pfnFree;
+        g_bResolving = false;
+    }
+    return g_pfnFree != nullptr;
+}
+
+// zeroed like the static arena is, so it serves calloc as well.
+static void* BootstrapAllocate(size_t nSize)
+{
+    const size_t nAligned = (nSize + 15) & ~size_t(15);
+    if (nAligned > sizeof(g_arrBootstrap) - g_nBootstrapUsed)
+        return nullptr;
+
+    void* p = g_arrBootstrap + g_nBootstrapUsed;
+    g_nBootstrapUsed += nAligned;
+    return p;
+}
+
+static bool IsBootstrap(const void* p)
+{
+    return p >= g_arrBootstrap && p < g_arrBootstrap + sizeof(g_arrBootstrap);
+}
+
+#endif
+
+CYDEVICE_NAMESPACE_END
+
+#if !defined(_WIN32)
+
+// Replaced for the whole process like operator new below, C code and the third party libraries
+// allocate through these.
+extern "C" void* malloc(size_t nSize) CY_ALLOC_NOEXCEPT
+{
+    if (!CYDEVICE_NAMESPACE::ResolveAllocator())
+        return CYDEVICE_NAMESPACE::BootstrapAllocate(nSize);
+    CYDEVICE_NAMESPACE::CheckAlloc(nSize);
+    return CYDEVICE_NAMESPACE::g_pfnMalloc(nSize);
+}
+
+extern "C" void* calloc(size_t nCount, size_t nSize) CY_ALLOC_NOEXCEPT
+{
+    if (nSize && nCount > SIZE_MAX / nSize)
+        return nullptr;
+    if (!CYDEVICE_NAMESPACE::ResolveAllocator())
+        return CYDEVICE_NAMESPACE::BootstrapAllocate(nCount * nSize);
+    CYDEVICE_NAMESPACE::CheckAlloc(nCount * nSize);
+    return CYDEVICE_NAMESPACE::g_pfnCalloc(nCount, nSize);
+}
+
+extern "C" void* realloc(void* p, size_t nSize) CY_ALLOC_NOEXCEPT
+{
+    if (!CYDEVICE_NAMESPACE::ResolveAllocator())
+        return p ? nullptr : CYDEVICE_NAMESPACE::BootstrapAllocate(nSize);
+    CYDEVICE_NAMESPACE::CheckAlloc(nSize);
+
+    // an arena block moves to the heap, it is at most as long as what follows it in the arena.
+    if (CYDEVICE_NAMESPACE::IsBootstrap(p))
+    {
+        void* pNew = CYDEVICE_NAMESPACE::g_pfnMalloc(nSize);
+        if (pNew)
+        {
+            const size_t nAvailable = size_t(CYDEVICE_NAMESPACE::g_arrBootstrap + sizeof(CYDEVICE_NAMESPACE::g_arrBootstrap) - static_cast<unsigned char*>(p));
+            memcpy(pNew, p, (nSize < nAvailable) ? nSize : nAvailable);
+        }
+        return pNew;
+    }
+    return CYDEVICE_NAMESPACE::g_pfnRealloc(p, nSize);
+}
+
+extern "C" void free(void* p) CY_ALLOC_NOEXCEPT
+{
+    if (!p || CYDEVICE_NAMESPACE::IsBootstrap(p))
+        return;
+    if (CYDEVICE_NAMESPACE::ResolveAllocator())
+        CYDEVICE_NAMESPACE::g_pfnFree(p);
+}
+
+#endif
+
+// Replaced for the whole process, only the aligned forms keep the default allocator.
+void* operator new(size_t nSize)
+{
+    if (void* p = CYDEVICE_NAMESPACE::Allocate(nSize))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t nSize)
+{
+    if (void* p = CYDEVICE_NAMESPACE::Allocate(nSize))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t nSize, const std::nothrow_t&) noexcept
+{
+    return CYDEVICE_NAMESPACE::Allocate(nSize);
+}
+
+void* operator new[](size_t nSize, const std::nothrow_t&) noexcept
+{
+    return CYDEVICE_NAMESPACE::Allocate(nSize);
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    free(p);
+}
+
+#endif
\ No newline at end of file
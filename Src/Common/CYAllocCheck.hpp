@@ -0,0 +1,59 @@
+#ifndef __CY_ALLOC_CHECK_HPP__
+#define __CY_ALLOC_CHECK_HPP__
+
+#include "CYDevice/CYDeviceDefine.hpp"
+
+#include <stddef.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Scopes a thread enters before its allocations are checked, the first periods and frames may still
+ * set up logger, driver and library state.
+ */
+constexpr uint32_t g_nAllocCheckWarmup = 16;
+
+#if defined(CYDEVICE_ALLOC_CHECK)
+
+/**
+ * Steady state work of a capture thread, built with CYDEVICE_ALLOC_CHECK only.
+ *
+ * Once the thread has entered g_nAllocCheckWarmup of these scopes, any operator new inside one aborts
+ * the process with the size asked for. Callbacks into the application must stay outside the scope.
+ *
+ * Outside Windows malloc, calloc and realloc are interposed as well, so C code and third party
+ * libraries are checked too. The Windows CRT cannot be replaced that way, there only operator new and
+ * the C allocations marked with CY_ALLOC_CHECK_NOTE are seen. The video path only exists in the
+ * Windows capture and is checked there alone.
+ */
+class CYAllocCheckScope
+{
+public:
+    CYAllocCheckScope();
+    ~CYAllocCheckScope();
+
+    CYAllocCheckScope(const CYAllocCheckScope&) = delete;
+    CYAllocCheckScope& operator=(const CYAllocCheckScope&) = delete;
+
+private:
+    bool m_bPrevious = false;
+};
+
+/**
+ * @brief Checks a C allocation of nSize bytes the interposition does not see.
+*/
+void CYAllocCheckNote(size_t nSize);
+
+#define CY_ALLOC_CHECK_SCOPE()      CYDEVICE_NAMESPACE::CYAllocCheckScope objAllocCheckScope
+#define CY_ALLOC_CHECK_NOTE(nSize)  CYDEVICE_NAMESPACE::CYAllocCheckNote(nSize)
+
+#else
+
+#define CY_ALLOC_CHECK_SCOPE()      ((void)0)
+#define CY_ALLOC_CHECK_NOTE(nSize)  ((void)0)
+
+#endif
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_ALLOC_CHECK_HPP__
\ No newline at end of file
@@ -77,11 +77,6 @@ constexpr float g_fSurroundMix = g_fDbMinus3;
 constexpr float g_fCenterMix = g_fDbMinus6;
 constexpr float g_fLowFreqMix = g_fDbMinus3;
 
-constexpr float g_fSurroundMix4 = g_fDbMinus6;
-
-constexpr float g_fAttn5dot1 = 1.0f / (1.0f + g_fCenterMix + g_fSurroundMix);
-constexpr float g_fAttn4dotX = 1.0f / (1.0f + g_fSurroundMix4);
-
 CYDEVICE_NAMESPACE_END
 
 #define ExceptionLog(e)		CY_LOG_ERROR(CYCOROUTINE_NAMESPACE::AtoT(e))
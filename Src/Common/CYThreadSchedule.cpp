@@ -0,0 +1,259 @@
+#include "Common/CYThreadSchedule.hpp"
+#include "Common/CYDevicePrivDefine.hpp"
+
+#include <bit>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/prctl.h>
+#endif
+#endif
+
+CYDEVICE_NAMESPACE_BEGIN
+
+#if defined(_WIN32)
+
+// Windows has no real-time policy for a single thread, both map to the top priorities of the class.
+static bool ApplyPolicy(const TThreadSchedule& objSchedule, TThreadScheduleResult& objResult)
+{
+    const int nPriority = (objSchedule.nPriority >= 50) ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_HIGHEST;
+    if (!SetThreadPriority(GetCurrentThread(), nPriority))
+    {
+        CY_LOG_WARN(TEXT("CYDevice: Raising the audio thread priority failed (error %u)"), (uint32_t)GetLastError());
+        return false;
+    }
+
+    objResult.ePolicy = objSchedule.ePolicy;
+    objResult.nPriority = objSchedule.nPriority;
+    return true;
+}
+
+static bool ApplyAffinity(uint64_t nCpuMask)
+{
+    if (!SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(nCpuMask)))
+    {
+        CY_LOG_WARN(TEXT("CYDevice: Pinning the audio thread failed (error %u)"), (uint32_t)GetLastError());
+        return false;
+    }
+    return true;
+}
+
+static bool ApplyTimerSlack(uint32_t)
+{
+    return true;
+}
+
+static bool LockMemory()
+{
+    CY_LOG_WARN(TEXT("CYDevice: Locking the process memory is not supported on this platform"));
+    return false;
+}
+
+#else
+
+static bool ApplyPolicy(const TThreadSchedule& objSchedule, TThreadScheduleResult& objResult)
+{
+    const int nPolicy = (objSchedule.ePolicy == TYPE_CYTHREAD_POLICY_RR) ? SCHED_RR : SCHED_FIFO;
+    const int nMinPriority = sched_get_priority_min(nPolicy);
+    sched_param objParam{};
+    objParam.sched_priority = MIN(MAX(objSchedule.nPriority, nMinPriority), sched_get_priority_max(nPolicy));
+    int nError = pthread_setschedparam(pthread_self(), nPolicy, &objParam);
+
+#if defined(RLIMIT_RTPRIO)
+    // without CAP_SYS_NICE an unprivileged process may still go up to its RLIMIT_RTPRIO.
+    rlimit objLimit;
+    if (nError == EPERM && getrlimit(RLIMIT_RTPRIO, &objLimit) == 0 && objLimit.rlim_cur != RLIM_INFINITY &&
+        int(objLimit.rlim_cur) >= nMinPriority && int(objLimit.rlim_cur) < objParam.sched_priority)
+    {
+        objParam.sched_priority = int(objLimit.rlim_cur);
+        nError = pthread_setschedparam(pthread_self(), nPolicy, &objParam);
+    }
+#endif
+
+    if (nError)
+    {
+        CY_LOG_WARN(TEXT("CYDevice: Real-time scheduling at priority %d was refused (error %d), the audio thread keeps the default policy"), objSchedule.nPriority, nError);
+        return false;
+    }
+
+    objResult.ePolicy = objSchedule.ePolicy;
+    objResult.nPriority = objParam.sched_priority;
+    if (objParam.sched_priority != objSchedule.nPriority)
+    {
+        CY_LOG_WARN(TEXT("CYDevice: The audio thread runs at real-time priority %d instead of %d"), objParam.sched_priority, objSchedule.nPriority);
+        return false;
+    }
+    return true;
+}
+
+static bool ApplyAffinity(uint64_t nCpuMask)
+{
+#if defined(__linux__)
+    cpu_set_t objSet;
+    CPU_ZERO(&objSet);
+    for (uint32_t nCpu = 0; nCpu < 64 && nCpu < CPU_SETSIZE; ++nCpu)
+    {
+        if ((nCpuMask >> nCpu) & 1)
+            CPU_SET(nCpu, &objSet);
+    }
+
+    const int nError = pthread_setaffinity_np(pthread_self(), sizeof(objSet), &objSet);
+    if (nError)
+    {
+        CY_LOG_WARN(TEXT("CYDevice: Pinning the audio thread failed (error %d)"), nError);
+        return false;
+    }
+    return true;
+#else
+    (void)nCpuMask;
+    CY_LOG_WARN(TEXT("CYDevice: Pinning threads is not supported on this platform"));
+    return false;
+#endif
+}
+
+static bool ApplyTimerSlack(uint32_t nTimerSlackNs)
+{
+#if defined(__linux__)
+    // the slack the kernel may add to every timed wait of the thread, 50 us by default.
+    if (prctl(PR_SET_TIMERSLACK, (unsigned long)nTimerSlackNs, 0, 0, 0) != 0)
+    {
+        CY_LOG_WARN(TEXT("CYDevice: Setting the audio thread timer slack failed (error %d)"), errno);
+        return false;
+    }
+#else
+    (void)nTimerSlackNs;
+#endif
+    return true;
+}
+
+static bool LockMemory()
+{
+    // future pages are only locked as well when the lock limit cannot make later allocations fail.
+    int nFlags = MCL_CURRENT;
+    rlimit objLimit;
+    if (geteuid() == 0 || (getrlimit(RLIMIT_MEMLOCK, &objLimit) == 0 && objLimit.rlim_cur == RLIM_INFINITY))
+        nFlags |= MCL_FUTURE;
+
+    if (mlockall(nFlags) != 0)
+    {
+        CY_LOG_WARN(TEXT("CYDevice: Locking the process memory failed (error %d)"), errno);
+        return false;
+    }
+    return true;
+}
+
+#endif
+
+bool ApplyThreadSchedule(const TThreadSchedule& objSchedule, TThreadScheduleResult& objResult)
+{
+    objResult = TThreadScheduleResult();
+
+    bool bApplied = true;
+    if (objSchedule.ePolicy != TYPE_CYTHREAD_POLICY_DEFAULT)
+        bApplied &= ApplyPolicy(objSchedule, objResult);
+    if (objSchedule.nCpuMask)
+        bApplied &= ApplyAffinity(objSchedule.nCpuMask);
+    if (objSchedule.nTimerSlackNs)
+        bApplied &= ApplyTimerSlack(objSchedule.nTimerSlackNs);
+    if (objSchedule.bLockMemory)
+    {
+        objResult.bMemoryLocked = LockMemory();
+        bApplied &= objResult.bMemoryLocked;
+    }
+
+    return bApplied;
+}
+
+//------------------------------------------------------------
+
+CYWakeLatency::CYWakeLatency()
+{
+    Reset();
+}
+
+CYWakeLatency::~CYWakeLatency()
+{
+}
+
+void CYWakeLatency::Reset()
+{
+    m_nPolicy = TYPE_CYTHREAD_POLICY_DEFAULT;
+    m_nPriority = 0;
+    m_bMemoryLocked = false;
+    m_nCount = 0;
+    m_nLateCount = 0;
+    m_nSumUs = 0;
+    m_nMaxUs = 0;
+    for (std::atomic<uint64_t>& nBucket : m_arrBuckets)
+        nBucket = 0;
+}
+
+void CYWakeLatency::SetSchedule(const TThreadScheduleResult& objResult)
+{
+    m_nPolicy.store(objResult.ePolicy, std::memory_order_relaxed);
+    m_nPriority.store(objResult.nPriority, std::memory_order_relaxed);
+    m_bMemoryLocked.store(objResult.bMemoryLocked, std::memory_order_relaxed);
+}
+
+void CYWakeLatency::Add(int64_t nLatencyUs, int64_t nLateUs)
+{
+    const uint64_t nUs = uint64_t(MAX(nLatencyUs, int64_t(0)));
+
+    // bucket n holds [2^(n-1), 2^n) us, the first one less than a microsecond.
+    const uint32_t nBucket = MIN(uint32_t(std::bit_width(nUs)), s_nBuckets - 1);
+    m_arrBuckets[nBucket].fetch_add(1, std::memory_order_relaxed);
+    m_nSumUs.fetch_add(nUs, std::memory_order_relaxed);
+    if (nLatencyUs > nLateUs)
+        m_nLateCount.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t nMaxUs = m_nMaxUs.load(std::memory_order_relaxed);
+    while (nUs > nMaxUs && !m_nMaxUs.compare_exchange_weak(nMaxUs, nUs, std::memory_order_relaxed))
+        ;
+    m_nCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CYWakeLatency::Get(TAudioSchedulingStats& objStats) const
+{
+    objStats = TAudioSchedulingStats();
+    objStats.eThreadPolicy = ECYThreadPolicy(m_nPolicy.load(std::memory_order_relaxed));
+    objStats.nThreadPriority = m_nPriority.load(std::memory_order_relaxed);
+    objStats.bMemoryLocked = m_bMemoryLocked.load(std::memory_order_relaxed);
+
+    uint64_t arrBuckets[s_nBuckets];
+    uint64_t nCount = 0;
+    for (uint32_t i = 0; i < s_nBuckets; ++i)
+    {
+        arrBuckets[i] = m_arrBuckets[i].load(std::memory_order_relaxed);
+        nCount += arrBuckets[i];
+    }
+    if (!nCount)
+        return;
+
+    const uint64_t nMaxUs = m_nMaxUs.load(std::memory_order_relaxed);
+    objStats.nWakeups = nCount;
+    objStats.nLateWakeups = m_nLateCount.load(std::memory_order_relaxed);
+    objStats.nMeanLatencyUs = uint32_t(MIN(m_nSumUs.load(std::memory_order_relaxed) / nCount, uint64_t(UINT32_MAX)));
+    objStats.nMaxLatencyUs = uint32_t(MIN(nMaxUs, uint64_t(UINT32_MAX)));
+
+    const uint64_t nTarget = nCount - nCount / 100;
+    uint64_t nSeen = 0;
+    for (uint32_t i = 0; i < s_nBuckets; ++i)
+    {
+        nSeen += arrBuckets[i];
+        if (nSeen >= nTarget)
+        {
+            objStats.nP99LatencyUs = uint32_t(MIN(uint64_t(1) << i, nMaxUs));
+            break;
+        }
+    }
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
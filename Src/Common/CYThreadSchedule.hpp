@@ -0,0 +1,77 @@
+#ifndef __CY_THREAD_SCHEDULE_HPP__
+#define __CY_THREAD_SCHEDULE_HPP__
+
+#include "CYDevice/CYDeviceDefine.hpp"
+
+#include <atomic>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * Scheduling a thread asks for, see TAudioConfig::eThreadPolicy.
+ */
+struct TThreadSchedule
+{
+    ECYThreadPolicy ePolicy = TYPE_CYTHREAD_POLICY_DEFAULT;
+    int32_t nPriority = 0;
+    uint64_t nCpuMask = 0;
+    uint32_t nTimerSlackNs = 0;
+    bool bLockMemory = false;
+};
+
+/**
+ * Scheduling the thread got, lower than asked for when it lacks the rights.
+ */
+struct TThreadScheduleResult
+{
+    ECYThreadPolicy ePolicy = TYPE_CYTHREAD_POLICY_DEFAULT;
+    int32_t nPriority = 0;
+    bool bMemoryLocked = false;
+};
+
+/**
+ * Apply objSchedule to the calling thread. Every part that cannot be applied is logged and left at
+ * the default, a real-time policy without the rights for it first retries at the highest priority
+ * RLIMIT_RTPRIO allows. False when anything was not applied as asked.
+ */
+bool ApplyThreadSchedule(const TThreadSchedule& objSchedule, TThreadScheduleResult& objResult);
+
+/**
+ * Wake-up latency of one thread, recorded by it and read from any thread.
+ *
+ * Latencies are kept as a count, sum and maximum and in power of two buckets of microseconds, the
+ * percentile is the upper edge of its bucket.
+ */
+class CYWakeLatency
+{
+public:
+    CYWakeLatency();
+    ~CYWakeLatency();
+
+public:
+    void Reset();
+    void SetSchedule(const TThreadScheduleResult& objResult);
+
+    /**
+     * @brief nLateUs is the latency counted as a missed deadline.
+    */
+    void Add(int64_t nLatencyUs, int64_t nLateUs);
+    void Get(TAudioSchedulingStats& objStats) const;
+
+private:
+    static constexpr uint32_t s_nBuckets = 24;
+
+    std::atomic<int32_t> m_nPolicy{ TYPE_CYTHREAD_POLICY_DEFAULT };
+    std::atomic<int32_t> m_nPriority{ 0 };
+    std::atomic<bool> m_bMemoryLocked{ false };
+
+    std::atomic<uint64_t> m_nCount{ 0 };
+    std::atomic<uint64_t> m_nLateCount{ 0 };
+    std::atomic<uint64_t> m_nSumUs{ 0 };
+    std::atomic<uint64_t> m_nMaxUs{ 0 };
+    std::atomic<uint64_t> m_arrBuckets[s_nBuckets];
+};
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_THREAD_SCHEDULE_HPP__
\ No newline at end of file
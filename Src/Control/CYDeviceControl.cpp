@@ -1,6 +1,8 @@
 #include "Control/CYDeviceControl.hpp"
 #include "Common/CYDevicePrivDefine.hpp"
 
+#include "Capture/Synthetic/SyntheticAudioCaptrue.hpp"
+
 #ifdef _WIN32
 #include "Capture/Win/WinDeviceCaptrue.hpp"
 #endif
@@ -15,7 +17,7 @@ CYDeviceControl::~CYDeviceControl()
 {
 }
 
-int16_t CYDeviceControl::Init(int nWidth/* = 1024*/, int nHeight/* = 768*/, int nFPS/* = 25*/, const wchar_t* pszDeviceName, const wchar_t* pszDeviceId, int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, bool bUseRender/* = true*/)
+int16_t CYDeviceControl::Init(int nWidth/* = 1024*/, int nHeight/* = 768*/, int nFPS/* = 25*/, const wchar_t* pszDeviceName, const wchar_t* pszDeviceId, int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, bool bUseRender/* = true*/, const TAudioConfig* pAudioConfig/* = nullptr*/)
 {
     EXCEPTION_BEGIN
     {
@@ -27,7 +29,31 @@ int16_t CYDeviceControl::Init(int nWidth/* = 1024*/, int nHeight/* = 768*/, int
         IfTrueThrow(!m_ptrDeviceCapture, TEXT("Failed to create a device capture object!"));
     }
     EXCEPTION_END
-    return m_ptrDeviceCapture->Init(nWidth, nHeight, nFPS, pszDeviceName, pszDeviceId, nSampleRateHz, pszAudioName, pszAudioID, bUseRender);
+    return m_ptrDeviceCapture->Init(nWidth, nHeight, nFPS, pszDeviceName, pszDeviceId, nSampleRateHz, pszAudioName, pszAudioID, bUseRender, pAudioConfig);
+}
+
+int16_t CYDeviceControl::InitAudio(ECYAudioSource eSource, int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, const TAudioConfig* pAudioConfig/* = nullptr*/)
+{
+    int nRet = CYERR_FAILED;
+    EXCEPTION_BEGIN
+    {
+        if (eSource == TYPE_CYAUDIO_SOURCE_SYNTHETIC)
+        {
+            m_ptrDeviceCapture = MakeUnique<CSyntheticAudioCaptrue>();
+        }
+        else
+        {
+#ifdef _WIN32
+            m_ptrDeviceCapture = MakeUnique<CWinDeviceCaptrue>();
+#else
+
+#endif
+        }
+        IfTrueThrow(!m_ptrDeviceCapture, TEXT("Failed to create a device capture object!"));
+        nRet = m_ptrDeviceCapture->InitAudio(nSampleRateHz, pszAudioName, pszAudioID, pAudioConfig);
+    }
+    EXCEPTION_END
+    return nRet;
 }
 
 int16_t CYDeviceControl::UnInit()
@@ -78,4 +104,76 @@ int16_t CYDeviceControl::GetNextAudioBuffer(float*& pBuffer, uint32_t& nNumFrame
     return nRet;
 }
 
+int16_t CYDeviceControl::ReadAudio(void* pBuffer, uint32_t nNumFrames, uint32_t nTimeoutMs, uint32_t& nReadFrames, uint64_t& nTimestamp)
+{
+    int nRet = CYERR_FAILED;
+    EXCEPTION_BEGIN
+    {
+        IfTrueThrow(!m_ptrDeviceCapture, TEXT("The device capture object is not created!"));
+        nRet = m_ptrDeviceCapture->ReadAudio(pBuffer, nNumFrames, nTimeoutMs, nReadFrames, nTimestamp);
+    }
+    EXCEPTION_END
+    return nRet;
+}
+
+int16_t CYDeviceControl::GetAudioLevels(TAudioLevels& objLevels)
+{
+    int nRet = CYERR_FAILED;
+    EXCEPTION_BEGIN
+    {
+        IfTrueThrow(!m_ptrDeviceCapture, TEXT("The device capture object is not created!"));
+        nRet = m_ptrDeviceCapture->GetAudioLevels(objLevels);
+    }
+    EXCEPTION_END
+    return nRet;
+}
+
+int16_t CYDeviceControl::GetAudioSchedulingStats(TAudioSchedulingStats& objStats)
+{
+    int nRet = CYERR_FAILED;
+    EXCEPTION_BEGIN
+    {
+        IfTrueThrow(!m_ptrDeviceCapture, TEXT("The device capture object is not created!"));
+        nRet = m_ptrDeviceCapture->GetAudioSchedulingStats(objStats);
+    }
+    EXCEPTION_END
+    return nRet;
+}
+
+int16_t CYDeviceControl::SetAudioStages(const TAudioStage* pStages, uint32_t nStages)
+{
+    int nRet = CYERR_FAILED;
+    EXCEPTION_BEGIN
+    {
+        IfTrueThrow(!m_ptrDeviceCapture, TEXT("The device capture object is not created!"));
+        nRet = m_ptrDeviceCapture->SetAudioStages(pStages, nStages);
+    }
+    EXCEPTION_END
+    return nRet;
+}
+
+int16_t CYDeviceControl::SubscribeAudio(const TAudioSubscription& objSubscription, uint32_t& nSubscriptionId)
+{
+    int nRet = CYERR_FAILED;
+    EXCEPTION_BEGIN
+    {
+        IfTrueThrow(!m_ptrDeviceCapture, TEXT("The device capture object is not created!"));
+        nRet = m_ptrDeviceCapture->SubscribeAudio(objSubscription, nSubscriptionId);
+    }
+    EXCEPTION_END
+    return nRet;
+}
+
+int16_t CYDeviceControl::UnsubscribeAudio(uint32_t nSubscriptionId)
+{
+    int nRet = CYERR_FAILED;
+    EXCEPTION_BEGIN
+    {
+        IfTrueThrow(!m_ptrDeviceCapture, TEXT("The device capture object is not created!"));
+        nRet = m_ptrDeviceCapture->UnsubscribeAudio(nSubscriptionId);
+    }
+    EXCEPTION_END
+    return nRet;
+}
+
 CYDEVICE_NAMESPACE_END
\ No newline at end of file
@@ -29,6 +29,7 @@
 #include "config.h"
 #include "float_cast.h"
 #include "common.h"
+#include "src_sinc_simd.h"
 
 #define	SINC_MAGIC_MARKER	MAKE_MAGIC (' ', 's', 'i', 'n', 'c', ' ')
 
@@ -64,6 +65,9 @@ typedef struct
 
 	coeff_t const	*coeffs ;
 
+	/* SIMD filter accumulation, NULL for the scalar code. */
+	sinc_accum_func	accum ;
+
 	int		b_current, b_end, b_real_end, b_len ;
 
 	/* Sure hope noone does more than 128 channels at once. */
@@ -198,6 +202,8 @@ sinc_set_converter (SRC_PRIVATE *psrc, int src_enum)
 		} ;
 	psrc->reset = sinc_reset ;
 
+	temp_filter.accum = sinc_get_accum_func (psrc->channels) ;
+
 	switch (src_enum)
 	{	case SRC_SINC_FASTEST :
 				temp_filter.coeffs = fastest_coeffs.coeffs ;
@@ -273,12 +279,58 @@ sinc_reset (SRC_PRIVATE *psrc)
 **	Beware all ye who dare pass this point. There be dragons here.
 */
 
+/*
+**	Both halves of the filter for any channel count with the SIMD accumulator.
+**	The halves are walked in memory order, so the left half runs its filter
+**	index down and the right half runs it up, covering the same taps as the
+**	scalar loops below.
+*/
+static inline void
+calc_output_simd (SINC_FILTER *filter, increment_t increment, increment_t start_filter_index, int channels, double scale, float * output)
+{	float		accum [128] ;
+	increment_t	filter_index, max_filter_index ;
+	int			coeff_count, frames, ch ;
+
+	/* Convert input parameters into fixed point. */
+	max_filter_index = int_to_fp (filter->coeff_half_len) ;
+
+	memset (accum, 0, sizeof (accum [0]) * channels) ;
+
+	/* Left half, taps while the filter index stays >= 0. */
+	coeff_count = (max_filter_index - start_filter_index) / increment ;
+	filter_index = start_filter_index + coeff_count * increment ;
+	frames = filter_index / increment + 1 ;
+
+	filter->accum (filter->coeffs, filter->buffer + filter->b_current - channels * coeff_count, frames, channels,
+					filter_index, -increment, accum) ;
+
+	/* Right half, taps while the filter index stays > 0. */
+	filter_index = increment - start_filter_index ;
+	coeff_count = (max_filter_index - filter_index) / increment ;
+	filter_index = filter_index + coeff_count * increment ;
+	frames = (filter_index > 0) ? (filter_index - 1) / increment + 1 : 1 ;
+	filter_index -= (frames - 1) * increment ;
+
+	filter->accum (filter->coeffs, filter->buffer + filter->b_current + channels * (1 + coeff_count - (frames - 1)), frames, channels,
+					filter_index, increment, accum) ;
+
+	for (ch = 0 ; ch < channels ; ch++)
+		output [ch] = scale * accum [ch] ;
+} /* calc_output_simd */
+
 static inline double
 calc_output_single (SINC_FILTER *filter, increment_t increment, increment_t start_filter_index)
 {	double		fraction, left, right, icoeff ;
 	increment_t	filter_index, max_filter_index ;
 	int			data_index, coeff_count, indx ;
 
+	if (filter->accum != NULL)
+	{	float output ;
+
+		calc_output_simd (filter, increment, start_filter_index, 1, 1.0, &output) ;
+		return output ;
+		} ;
+
 	/* Convert input parameters into fixed point. */
 	max_filter_index = int_to_fp (filter->coeff_half_len) ;
 
@@ -425,6 +477,11 @@ calc_output_stereo (SINC_FILTER *filter, increment_t increment, increment_t star
 	increment_t	filter_index, max_filter_index ;
 	int			data_index, coeff_count, indx ;
 
+	if (filter->accum != NULL)
+	{	calc_output_simd (filter, increment, start_filter_index, 2, scale, output) ;
+		return ;
+		} ;
+
 	/* Convert input parameters into fixed point. */
 	max_filter_index = int_to_fp (filter->coeff_half_len) ;
 
@@ -573,6 +630,11 @@ calc_output_quad (SINC_FILTER *filter, increment_t increment, increment_t start_
 	increment_t	filter_index, max_filter_index ;
 	int			data_index, coeff_count, indx ;
 
+	if (filter->accum != NULL)
+	{	calc_output_simd (filter, increment, start_filter_index, 4, scale, output) ;
+		return ;
+		} ;
+
 	/* Convert input parameters into fixed point. */
 	max_filter_index = int_to_fp (filter->coeff_half_len) ;
 
@@ -727,6 +789,11 @@ calc_output_hex (SINC_FILTER *filter, increment_t increment, increment_t start_f
 	increment_t	filter_index, max_filter_index ;
 	int			data_index, coeff_count, indx ;
 
+	if (filter->accum != NULL)
+	{	calc_output_simd (filter, increment, start_filter_index, 6, scale, output) ;
+		return ;
+		} ;
+
 	/* Convert input parameters into fixed point. */
 	max_filter_index = int_to_fp (filter->coeff_half_len) ;
 
@@ -889,6 +956,11 @@ calc_output_multi (SINC_FILTER *filter, increment_t increment, increment_t start
 	increment_t	filter_index, max_filter_index ;
 	int			data_index, coeff_count, indx, ch ;
 
+	if (filter->accum != NULL)
+	{	calc_output_simd (filter, increment, start_filter_index, channels, scale, output) ;
+		return ;
+		} ;
+
 	left = filter->left_calc ;
 	right = filter->right_calc ;
 
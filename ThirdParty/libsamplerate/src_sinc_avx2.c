@@ -0,0 +1,197 @@
+/*
+** This file is part of the bundled libsamplerate and is distributed under the
+** same license, see src_sinc.c.
+*/
+
+/*
+** AVX2/FMA filter accumulation for the sinc converters, eight frames per step.
+** Built with AVX2 code generation, only reached when the CPU reports both.
+*/
+
+#include "config.h"
+#include "float_cast.h"
+#include "src_sinc_simd.h"
+
+#ifdef SRC_SIMD_X86
+
+#include <immintrin.h>
+
+static inline __m256
+avx2_coeffs (const float *coeffs, __m256i filter_index)
+{	__m256i	indx = _mm256_srai_epi32 (filter_index, SRC_SIMD_SHIFT_BITS) ;
+	__m256	fraction, lower, upper ;
+
+	fraction = _mm256_cvtepi32_ps (_mm256_and_si256 (filter_index, _mm256_set1_epi32 (SRC_SIMD_FRACTION_MASK))) ;
+	fraction = _mm256_mul_ps (fraction, _mm256_set1_ps (SRC_SIMD_INV_FP_ONE)) ;
+
+	lower = _mm256_i32gather_ps (coeffs, indx, 4) ;
+	upper = _mm256_i32gather_ps (coeffs + 1, indx, 4) ;
+
+	return _mm256_fmadd_ps (fraction, _mm256_sub_ps (upper, lower), lower) ;
+} /* avx2_coeffs */
+
+static inline __m256i
+avx2_first_index (int32_t filter_index, int32_t filter_step)
+{	return _mm256_add_epi32 (_mm256_set1_epi32 (filter_index),
+				_mm256_mullo_epi32 (_mm256_set1_epi32 (filter_step), _mm256_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7))) ;
+} /* avx2_first_index */
+
+static inline float
+avx2_sum (__m256 value)
+{	__m128 sum = _mm_add_ps (_mm256_castps256_ps128 (value), _mm256_extractf128_ps (value, 1)) ;
+
+	sum = _mm_add_ps (sum, _mm_movehl_ps (sum, sum)) ;
+	sum = _mm_add_ss (sum, _mm_shuffle_ps (sum, sum, 1)) ;
+	return _mm_cvtss_f32 (sum) ;
+} /* avx2_sum */
+
+static void
+avx2_accum_mono (const float *coeffs, const float *data, int frames, int channels,
+						int32_t filter_index, int32_t filter_step, float *accum)
+{	__m256i	vindex = avx2_first_index (filter_index, filter_step), vstep = _mm256_set1_epi32 (8 * filter_step) ;
+	__m256	vsum = _mm256_setzero_ps () ;
+	int		k ;
+
+	for (k = 0 ; k + 8 <= frames ; k += 8)
+	{	vsum = _mm256_fmadd_ps (avx2_coeffs (coeffs, vindex), _mm256_loadu_ps (data + k), vsum) ;
+		vindex = _mm256_add_epi32 (vindex, vstep) ;
+		} ;
+
+	accum [0] += avx2_sum (vsum) ;
+
+	sinc_accum_tail (coeffs, data + k, frames - k, channels, filter_index + k * filter_step, filter_step, accum) ;
+} /* avx2_accum_mono */
+
+static void
+avx2_accum_stereo (const float *coeffs, const float *data, int frames, int channels,
+						int32_t filter_index, int32_t filter_step, float *accum)
+{	__m256i	vindex = avx2_first_index (filter_index, filter_step), vstep = _mm256_set1_epi32 (8 * filter_step) ;
+	__m256	vsum = _mm256_setzero_ps (), vcoeff, vlow, vhigh ;
+	float	sums [8] ;
+	int		k ;
+
+	/* Lanes hold L R L R ..., the coefficients are duplicated to match. */
+	for (k = 0 ; k + 8 <= frames ; k += 8)
+	{	vcoeff = avx2_coeffs (coeffs, vindex) ;
+		vlow = _mm256_unpacklo_ps (vcoeff, vcoeff) ;
+		vhigh = _mm256_unpackhi_ps (vcoeff, vcoeff) ;
+
+		vsum = _mm256_fmadd_ps (_mm256_permute2f128_ps (vlow, vhigh, 0x20), _mm256_loadu_ps (data + 2 * k), vsum) ;
+		vsum = _mm256_fmadd_ps (_mm256_permute2f128_ps (vlow, vhigh, 0x31), _mm256_loadu_ps (data + 2 * k + 8), vsum) ;
+		vindex = _mm256_add_epi32 (vindex, vstep) ;
+		} ;
+
+	_mm256_storeu_ps (sums, vsum) ;
+	accum [0] += (sums [0] + sums [2]) + (sums [4] + sums [6]) ;
+	accum [1] += (sums [1] + sums [3]) + (sums [5] + sums [7]) ;
+
+	sinc_accum_tail (coeffs, data + 2 * k, frames - k, channels, filter_index + k * filter_step, filter_step, accum) ;
+} /* avx2_accum_stereo */
+
+static void
+avx2_accum_quad (const float *coeffs, const float *data, int frames, int channels,
+						int32_t filter_index, int32_t filter_step, float *accum)
+{	__m256i	vindex = avx2_first_index (filter_index, filter_step), vstep = _mm256_set1_epi32 (8 * filter_step) ;
+	__m256i	vpair = _mm256_setr_epi32 (0, 0, 0, 0, 1, 1, 1, 1), vtwo = _mm256_set1_epi32 (2), vlane ;
+	__m256	vsum = _mm256_setzero_ps (), vcoeff ;
+	float	sums [8] ;
+	int		k, j ;
+
+	/* Every vector holds two frames. */
+	for (k = 0 ; k + 8 <= frames ; k += 8)
+	{	vcoeff = avx2_coeffs (coeffs, vindex) ;
+		vlane = vpair ;
+		for (j = 0 ; j < 4 ; j++)
+		{	vsum = _mm256_fmadd_ps (_mm256_permutevar8x32_ps (vcoeff, vlane), _mm256_loadu_ps (data + 4 * k + 8 * j), vsum) ;
+			vlane = _mm256_add_epi32 (vlane, vtwo) ;
+			} ;
+		vindex = _mm256_add_epi32 (vindex, vstep) ;
+		} ;
+
+	_mm256_storeu_ps (sums, vsum) ;
+	for (j = 0 ; j < 4 ; j++)
+		accum [j] += sums [j] + sums [j + 4] ;
+
+	sinc_accum_tail (coeffs, data + 4 * k, frames - k, channels, filter_index + k * filter_step, filter_step, accum) ;
+} /* avx2_accum_quad */
+
+static void
+avx2_accum_hex (const float *coeffs, const float *data, int frames, int channels,
+						int32_t filter_index, int32_t filter_step, float *accum)
+{	__m256i	vindex = avx2_first_index (filter_index, filter_step), vstep = _mm256_set1_epi32 (8 * filter_step) ;
+	/* Four frames are three vectors, lane i of the three sums belongs to channel i % 6. */
+	const __m256i vlane0 = _mm256_setr_epi32 (0, 0, 0, 0, 0, 0, 1, 1) ;
+	const __m256i vlane1 = _mm256_setr_epi32 (1, 1, 1, 1, 2, 2, 2, 2) ;
+	const __m256i vlane2 = _mm256_setr_epi32 (2, 2, 3, 3, 3, 3, 3, 3) ;
+	const __m256i vfour = _mm256_set1_epi32 (4) ;
+	__m256	vsum0 = _mm256_setzero_ps (), vsum1 = _mm256_setzero_ps (), vsum2 = _mm256_setzero_ps (), vcoeff ;
+	float	sums [24] ;
+	int		k ;
+
+	for (k = 0 ; k + 8 <= frames ; k += 8)
+	{	const float *frame = data + 6 * k ;
+
+		vcoeff = avx2_coeffs (coeffs, vindex) ;
+		vsum0 = _mm256_fmadd_ps (_mm256_permutevar8x32_ps (vcoeff, vlane0), _mm256_loadu_ps (frame), vsum0) ;
+		vsum1 = _mm256_fmadd_ps (_mm256_permutevar8x32_ps (vcoeff, vlane1), _mm256_loadu_ps (frame + 8), vsum1) ;
+		vsum2 = _mm256_fmadd_ps (_mm256_permutevar8x32_ps (vcoeff, vlane2), _mm256_loadu_ps (frame + 16), vsum2) ;
+		vsum0 = _mm256_fmadd_ps (_mm256_permutevar8x32_ps (vcoeff, _mm256_add_epi32 (vlane0, vfour)), _mm256_loadu_ps (frame + 24), vsum0) ;
+		vsum1 = _mm256_fmadd_ps (_mm256_permutevar8x32_ps (vcoeff, _mm256_add_epi32 (vlane1, vfour)), _mm256_loadu_ps (frame + 32), vsum1) ;
+		vsum2 = _mm256_fmadd_ps (_mm256_permutevar8x32_ps (vcoeff, _mm256_add_epi32 (vlane2, vfour)), _mm256_loadu_ps (frame + 40), vsum2) ;
+		vindex = _mm256_add_epi32 (vindex, vstep) ;
+		} ;
+
+	_mm256_storeu_ps (sums, vsum0) ;
+	_mm256_storeu_ps (sums + 8, vsum1) ;
+	_mm256_storeu_ps (sums + 16, vsum2) ;
+	for (k = 0 ; k < 24 ; k++)
+		accum [k % 6] += sums [k] ;
+
+	k = frames & ~7 ;
+	sinc_accum_tail (coeffs, data + 6 * k, frames - k, channels, filter_index + k * filter_step, filter_step, accum) ;
+} /* avx2_accum_hex */
+
+static void
+avx2_accum_multi (const float *coeffs, const float *data, int frames, int channels,
+						int32_t filter_index, int32_t filter_step, float *accum)
+{	__m256i	vindex = avx2_first_index (filter_index, filter_step), vstep = _mm256_set1_epi32 (8 * filter_step) ;
+	__m256	vcoeff ;
+	float	icoeff [8] ;
+	int		k, j, ch ;
+
+	for (k = 0 ; k + 8 <= frames ; k += 8)
+	{	_mm256_storeu_ps (icoeff, avx2_coeffs (coeffs, vindex)) ;
+		vindex = _mm256_add_epi32 (vindex, vstep) ;
+
+		for (j = 0 ; j < 8 ; j++)
+		{	const float *frame = data + (k + j) * channels ;
+
+			vcoeff = _mm256_set1_ps (icoeff [j]) ;
+			for (ch = 0 ; ch + 8 <= channels ; ch += 8)
+				_mm256_storeu_ps (accum + ch, _mm256_fmadd_ps (vcoeff, _mm256_loadu_ps (frame + ch), _mm256_loadu_ps (accum + ch))) ;
+			for ( ; ch < channels ; ch++)
+				accum [ch] += icoeff [j] * frame [ch] ;
+			} ;
+		} ;
+
+	sinc_accum_tail (coeffs, data + k * channels, frames - k, channels, filter_index + k * filter_step, filter_step, accum) ;
+} /* avx2_accum_multi */
+
+sinc_accum_func
+sinc_get_accum_func_avx2 (int channels)
+{
+	switch (channels)
+	{	case 1 :
+			return avx2_accum_mono ;
+		case 2 :
+			return avx2_accum_stereo ;
+		case 4 :
+			return avx2_accum_quad ;
+		case 6 :
+			return avx2_accum_hex ;
+		default :
+			return avx2_accum_multi ;
+		} ;
+} /* sinc_get_accum_func_avx2 */
+
+#endif
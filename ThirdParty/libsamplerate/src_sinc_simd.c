@@ -0,0 +1,437 @@
+/*
+** This file is part of the bundled libsamplerate and is distributed under the
+** same license, see src_sinc.c.
+*/
+
+/*
+** SSE2 and NEON filter accumulation for the sinc converters, plus the runtime
+** selection. The AVX2 versions live in src_sinc_avx2.c, which is the only file
+** built with AVX2 code generation.
+*/
+
+#include <stdlib.h>
+
+#include "config.h"
+#include "float_cast.h"
+#include "src_sinc_simd.h"
+
+#if defined (SRC_SIMD_X86) && (defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SRC_SIMD_SSE2	1
+#endif
+
+#ifdef SRC_SIMD_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#ifdef SRC_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef SRC_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+/*========================================================================================
+*/
+
+#ifdef SRC_SIMD_X86
+
+static void
+cpu_id (int leaf, unsigned int regs [4])
+{
+#ifdef _MSC_VER
+	int info [4] ;
+	int k ;
+
+	__cpuidex (info, leaf, 0) ;
+	for (k = 0 ; k < 4 ; k++)
+		regs [k] = (unsigned int) info [k] ;
+#else
+	__cpuid_count (leaf, 0, regs [0], regs [1], regs [2], regs [3]) ;
+#endif
+} /* cpu_id */
+
+static int
+cpu_has_avx2_fma (void)
+{	unsigned int	regs [4], max_leaf ;
+	unsigned long long xcr0 ;
+	int				has_fma ;
+
+	cpu_id (0, regs) ;
+	max_leaf = regs [0] ;
+	if (max_leaf < 7)
+		return 0 ;
+
+	/* The OS has to save the AVX state as well. */
+	cpu_id (1, regs) ;
+	if ((regs [2] & (1u << 27)) == 0)
+		return 0 ;
+	has_fma = (regs [2] & (1u << 12)) != 0 ;
+
+#ifdef _MSC_VER
+	xcr0 = _xgetbv (0) ;
+#else
+	{	unsigned int eax, edx ;
+		__asm__ volatile ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0)) ;
+		xcr0 = ((unsigned long long) edx << 32) | eax ;
+		}
+#endif
+	if ((xcr0 & 0x6) != 0x6)
+		return 0 ;
+
+	cpu_id (7, regs) ;
+	return has_fma && (regs [1] & (1u << 5)) != 0 ;
+} /* cpu_has_avx2_fma */
+
+#endif
+
+/*========================================================================================
+**	SSE2, four frames per step.
+*/
+
+#ifdef SRC_SIMD_SSE2
+
+static inline __m128
+sse2_coeffs (const float *coeffs, __m128i filter_index)
+{	int32_t	indx [4] ;
+	__m128	fraction, lower, upper ;
+
+	_mm_storeu_si128 ((__m128i *) indx, _mm_srai_epi32 (filter_index, SRC_SIMD_SHIFT_BITS)) ;
+	fraction = _mm_cvtepi32_ps (_mm_and_si128 (filter_index, _mm_set1_epi32 (SRC_SIMD_FRACTION_MASK))) ;
+	fraction = _mm_mul_ps (fraction, _mm_set1_ps (SRC_SIMD_INV_FP_ONE)) ;
+
+	lower = _mm_setr_ps (coeffs [indx [0]], coeffs [indx [1]], coeffs [indx [2]], coeffs [indx [3]]) ;
+	upper = _mm_setr_ps (coeffs [indx [0] + 1], coeffs [indx [1] + 1], coeffs [indx [2] + 1], coeffs [indx [3] + 1]) ;
+
+	return _mm_add_ps (lower, _mm_mul_ps (fraction, _mm_sub_ps (upper, lower))) ;
+} /* sse2_coeffs */
+
+static inline __m128i
+sse2_first_index (int32_t filter_index, int32_t filter_step)
+{	return _mm_add_epi32 (_mm_set1_epi32 (filter_index), _mm_setr_epi32 (0, filter_step, 2 * filter_step, 3 * filter_step)) ;
+} /* sse2_first_index */
+
+static void
+sse2_accum_mono (const float *coeffs, const float *data, int frames, int channels,
+						int32_t filter_index, int32_t filter_step, float *accum)
+{	__m128i	vindex = sse2_first_index (filter_index, filter_step), vstep = _mm_set1_epi32 (4 * filter_step) ;
+	__m128	vsum = _mm_setzero_ps () ;
+	float	sums [4] ;
+	int		k ;
+
+	for (k = 0 ; k + 4 <= frames ; k += 4)
+	{	vsum = _mm_add_ps (vsum, _mm_mul_ps (sse2_coeffs (coeffs, vindex), _mm_loadu_ps (data + k))) ;
+		vindex = _mm_add_epi32 (vindex, vstep) ;
+		} ;
+
+	_mm_storeu_ps (sums, vsum) ;
+	accum [0] += (sums [0] + sums [1]) + (sums [2] + sums [3]) ;
+
+	sinc_accum_tail (coeffs, data + k, frames - k, channels, filter_index + k * filter_step, filter_step, accum) ;
+} /* sse2_accum_mono */
+
+static void
+sse2_accum_stereo (const float *coeffs, const float *data, int frames, int channels,
+						int32_t filter_index, int32_t filter_step, float *accum)
+{	__m128i	vindex = sse2_first_index (filter_index, filter_step), vstep = _mm_set1_epi32 (4 * filter_step) ;
+	__m128	vsum = _mm_setzero_ps (), vcoeff ;
+	float	sums [4] ;
+	int		k ;
+
+	/* Lanes hold L R L R. */
+	for (k = 0 ; k + 4 <= frames ; k += 4)
+	{	vcoeff = sse2_coeffs (coeffs, vindex) ;
+		vsum = _mm_add_ps (vsum, _mm_mul_ps (_mm_unpacklo_ps (vcoeff, vcoeff), _mm_loadu_ps (data + 2 * k))) ;
+		vsum = _mm_add_ps (vsum, _mm_mul_ps (_mm_unpackhi_ps (vcoeff, vcoeff), _mm_loadu_ps (data + 2 * k + 4))) ;
+		vindex = _mm_add_epi32 (vindex, vstep) ;
+		} ;
+
+	_mm_storeu_ps (sums, vsum) ;
+	accum [0] += sums [0] + sums [2] ;
+	accum [1] += sums [1] + sums [3] ;
+
+	sinc_accum_tail (coeffs, data + 2 * k, frames - k, channels, filter_index + k * filter_step, filter_step, accum) ;
+} /* sse2_accum_stereo */
+
+static void
+sse2_accum_quad (const float *coeffs, const float *data, int frames, int channels,
+						int32_t filter_index, int32_t filter_step, float *accum)
+{	__m128i	vindex = sse2_first_index (filter_index, filter_step), vstep = _mm_set1_epi32 (4 * filter_step) ;
+	__m128	vsum = _mm_loadu_ps (accum), vcoeff ;
+	int		k ;
+
+	for (k = 0 ; k + 4 <= frames ; k += 4)
+	{	vcoeff = sse2_coeffs (coeffs, vindex) ;
+		vsum = _mm_add_ps (vsum, _mm_mul_ps (_mm_shuffle_ps (vcoeff, vcoeff, _MM_SHUFFLE (0, 0, 0, 0)), _mm_loadu_ps (data + 4 * k))) ;
+		vsum = _mm_add_ps (vsum, _mm_mul_ps (_mm_shuffle_ps (vcoeff, vcoeff, _MM_SHUFFLE (1, 1, 1, 1)), _mm_loadu_ps (data + 4 * k + 4))) ;
+		vsum = _mm_add_ps (vsum, _mm_mul_ps (_mm_shuffle_ps (vcoeff, vcoeff, _MM_SHUFFLE (2, 2, 2, 2)), _mm_loadu_ps (data + 4 * k + 8))) ;
+		vsum = _mm_add_ps (vsum, _mm_mul_ps (_mm_shuffle_ps (vcoeff, vcoeff, _MM_SHUFFLE (3, 3, 3, 3)), _mm_loadu_ps (data + 4 * k + 12))) ;
+		vindex = _mm_add_epi32 (vindex, vstep) ;
+		} ;
+
+	_mm_storeu_ps (accum, vsum) ;
+
+	sinc_accum_tail (coeffs, data + 4 * k, frames - k, channels, filter_index + k * filter_step, filter_step, accum) ;
+} /* sse2_accum_quad */
+
+static void
+sse2_accum_hex (const float *coeffs, const float *data, int frames, int channels,
+						int32_t filter_index, int32_t filter_step, float *accum)
+{	__m128i	vindex = sse2_first_index (filter_index, filter_step), vstep = _mm_set1_epi32 (4 * filter_step) ;
+	__m128	vsum0 = _mm_setzero_ps (), vsum1 = _mm_setzero_ps (), vsum2 = _mm_setzero_ps (), vcoeff ;
+	float	sums [12] ;
+	int		k ;
+
+	/* Two frames are three vectors, lane i of the three sums belongs to channel i % 6. */
+	for (k = 0 ; k + 4 <= frames ; k += 4)
+	{	const float *frame = data + 6 * k ;
+
+		vcoeff = sse2_coeffs (coeffs, vindex) ;
+		vsum0 = _mm_add_ps (vsum0, _mm_mul_ps (_mm_shuffle_ps (vcoeff, vcoeff, _MM_SHUFFLE (0, 0, 0, 0)), _mm_loadu_ps (frame))) ;
+		vsum1 = _mm_add_ps (vsum1, _mm_mul_ps (_mm_shuffle_ps (vcoeff, vcoeff, _MM_SHUFFLE (1, 1, 0, 0)), _mm_loadu_ps (frame + 4))) ;
+		vsum2 = _mm_add_ps (vsum2, _mm_mul_ps (_mm_shuffle_ps (vcoeff, vcoeff, _MM_SHUFFLE (1, 1, 1, 1)), _mm_loadu_ps (frame + 8))) ;
+		vsum0 = _mm_add_ps (vsum0, _mm_mul_ps (_mm_shuffle_ps (vcoeff, vcoeff, _MM_SHUFFLE (2, 2, 2, 2)), _mm_loadu_ps (frame + 12))) ;
+		vsum1 = _mm_add_ps (vsum1, _mm_mul_ps (_mm_shuffle_ps (vcoeff, vcoeff, _MM_SHUFFLE (3, 3, 2, 2)), _mm_loadu_ps (frame + 16))) ;
+		vsum2 = _mm_add_ps (vsum2, _mm_mul_ps (_mm_shuffle_ps (vcoeff, vcoeff, _MM_SHUFFLE (3, 3, 3, 3)), _mm_loadu_ps (frame + 20))) ;
+		vindex = _mm_add_epi32 (vindex, vstep) ;
+		} ;
+
+	_mm_storeu_ps (sums, vsum0) ;
+	_mm_storeu_ps (sums + 4, vsum1) ;
+	_mm_storeu_ps (sums + 8, vsum2) ;
+	for (k = 0 ; k < 12 ; k++)
+		accum [k % 6] += sums [k] ;
+
+	k = frames & ~3 ;
+	sinc_accum_tail (coeffs, data + 6 * k, frames - k, channels, filter_index + k * filter_step, filter_step, accum) ;
+} /* sse2_accum_hex */
+
+static void
+sse2_accum_multi (const float *coeffs, const float *data, int frames, int channels,
+						int32_t filter_index, int32_t filter_step, float *accum)
+{	__m128i	vindex = sse2_first_index (filter_index, filter_step), vstep = _mm_set1_epi32 (4 * filter_step) ;
+	__m128	vcoeff ;
+	float	icoeff [4] ;
+	int		k, j, ch ;
+
+	for (k = 0 ; k + 4 <= frames ; k += 4)
+	{	_mm_storeu_ps (icoeff, sse2_coeffs (coeffs, vindex)) ;
+		vindex = _mm_add_epi32 (vindex, vstep) ;
+
+		for (j = 0 ; j < 4 ; j++)
+		{	const float *frame = data + (k + j) * channels ;
+
+			vcoeff = _mm_set1_ps (icoeff [j]) ;
+			for (ch = 0 ; ch + 4 <= channels ; ch += 4)
+				_mm_storeu_ps (accum + ch, _mm_add_ps (_mm_loadu_ps (accum + ch), _mm_mul_ps (vcoeff, _mm_loadu_ps (frame + ch)))) ;
+			for ( ; ch < channels ; ch++)
+				accum [ch] += icoeff [j] * frame [ch] ;
+			} ;
+		} ;
+
+	sinc_accum_tail (coeffs, data + k * channels, frames - k, channels, filter_index + k * filter_step, filter_step, accum) ;
+} /* sse2_accum_multi */
+
+#endif
+
+/*========================================================================================
+**	NEON, four frames per step.
+*/
+
+#ifdef SRC_SIMD_NEON
+
+static inline float32x4_t
+neon_coeffs (const float *coeffs, int32x4_t filter_index)
+{	int32_t		indx [4] ;
+	float		lower [4], upper [4] ;
+	float32x4_t	fraction, vlower ;
+	int			k ;
+
+	vst1q_s32 (indx, vshrq_n_s32 (filter_index, SRC_SIMD_SHIFT_BITS)) ;
+	fraction = vcvtq_f32_s32 (vandq_s32 (filter_index, vdupq_n_s32 (SRC_SIMD_FRACTION_MASK))) ;
+	fraction = vmulq_n_f32 (fraction, SRC_SIMD_INV_FP_ONE) ;
+
+	for (k = 0 ; k < 4 ; k++)
+	{	lower [k] = coeffs [indx [k]] ;
+		upper [k] = coeffs [indx [k] + 1] ;
+		} ;
+
+	vlower = vld1q_f32 (lower) ;
+	return vfmaq_f32 (vlower, fraction, vsubq_f32 (vld1q_f32 (upper), vlower)) ;
+} /* neon_coeffs */
+
+static inline int32x4_t
+neon_first_index (int32_t filter_index, int32_t filter_step)
+{	const int32_t lanes [4] = { 0, filter_step, 2 * filter_step, 3 * filter_step } ;
+
+	return vaddq_s32 (vdupq_n_s32 (filter_index), vld1q_s32 (lanes)) ;
+} /* neon_first_index */
+
+static void
+neon_accum_mono (const float *coeffs, const float *data, int frames, int channels,
+						int32_t filter_index, int32_t filter_step, float *accum)
+{	int32x4_t	vindex = neon_first_index (filter_index, filter_step), vstep = vdupq_n_s32 (4 * filter_step) ;
+	float32x4_t	vsum = vdupq_n_f32 (0.0f) ;
+	int			k ;
+
+	for (k = 0 ; k + 4 <= frames ; k += 4)
+	{	vsum = vfmaq_f32 (vsum, neon_coeffs (coeffs, vindex), vld1q_f32 (data + k)) ;
+		vindex = vaddq_s32 (vindex, vstep) ;
+		} ;
+
+	accum [0] += vaddvq_f32 (vsum) ;
+
+	sinc_accum_tail (coeffs, data + k, frames - k, channels, filter_index + k * filter_step, filter_step, accum) ;
+} /* neon_accum_mono */
+
+static void
+neon_accum_stereo (const float *coeffs, const float *data, int frames, int channels,
+						int32_t filter_index, int32_t filter_step, float *accum)
+{	int32x4_t	vindex = neon_first_index (filter_index, filter_step), vstep = vdupq_n_s32 (4 * filter_step) ;
+	float32x4_t	vsum0 = vdupq_n_f32 (0.0f), vsum1 = vdupq_n_f32 (0.0f), vcoeff ;
+	float32x4x2_t vframes ;
+	int			k ;
+
+	for (k = 0 ; k + 4 <= frames ; k += 4)
+	{	vcoeff = neon_coeffs (coeffs, vindex) ;
+		vframes = vld2q_f32 (data + 2 * k) ;
+		vsum0 = vfmaq_f32 (vsum0, vcoeff, vframes.val [0]) ;
+		vsum1 = vfmaq_f32 (vsum1, vcoeff, vframes.val [1]) ;
+		vindex = vaddq_s32 (vindex, vstep) ;
+		} ;
+
+	accum [0] += vaddvq_f32 (vsum0) ;
+	accum [1] += vaddvq_f32 (vsum1) ;
+
+	sinc_accum_tail (coeffs, data + 2 * k, frames - k, channels, filter_index + k * filter_step, filter_step, accum) ;
+} /* neon_accum_stereo */
+
+static void
+neon_accum_quad (const float *coeffs, const float *data, int frames, int channels,
+						int32_t filter_index, int32_t filter_step, float *accum)
+{	int32x4_t	vindex = neon_first_index (filter_index, filter_step), vstep = vdupq_n_s32 (4 * filter_step) ;
+	float32x4_t	vsum [4], vcoeff ;
+	float32x4x4_t vframes ;
+	int			k, ch ;
+
+	for (ch = 0 ; ch < 4 ; ch++)
+		vsum [ch] = vdupq_n_f32 (0.0f) ;
+
+	for (k = 0 ; k + 4 <= frames ; k += 4)
+	{	vcoeff = neon_coeffs (coeffs, vindex) ;
+		vframes = vld4q_f32 (data + 4 * k) ;
+		for (ch = 0 ; ch < 4 ; ch++)
+			vsum [ch] = vfmaq_f32 (vsum [ch], vcoeff, vframes.val [ch]) ;
+		vindex = vaddq_s32 (vindex, vstep) ;
+		} ;
+
+	for (ch = 0 ; ch < 4 ; ch++)
+		accum [ch] += vaddvq_f32 (vsum [ch]) ;
+
+	sinc_accum_tail (coeffs, data + 4 * k, frames - k, channels, filter_index + k * filter_step, filter_step, accum) ;
+} /* neon_accum_quad */
+
+static void
+neon_accum_hex (const float *coeffs, const float *data, int frames, int channels,
+						int32_t filter_index, int32_t filter_step, float *accum)
+{	int32x4_t	vindex = neon_first_index (filter_index, filter_step), vstep = vdupq_n_s32 (4 * filter_step) ;
+	float32x4_t	vsum0 = vdupq_n_f32 (0.0f), vsum1 = vdupq_n_f32 (0.0f), vsum2 = vdupq_n_f32 (0.0f), vcoeff ;
+	float		sums [12] ;
+	int			k ;
+
+	/* Two frames are three vectors, lane i of the three sums belongs to channel i % 6. */
+	for (k = 0 ; k + 4 <= frames ; k += 4)
+	{	const float *frame = data + 6 * k ;
+
+		vcoeff = neon_coeffs (coeffs, vindex) ;
+		vsum0 = vfmaq_laneq_f32 (vsum0, vld1q_f32 (frame), vcoeff, 0) ;
+		vsum1 = vfmaq_f32 (vsum1, vcombine_f32 (vdup_laneq_f32 (vcoeff, 0), vdup_laneq_f32 (vcoeff, 1)), vld1q_f32 (frame + 4)) ;
+		vsum2 = vfmaq_laneq_f32 (vsum2, vld1q_f32 (frame + 8), vcoeff, 1) ;
+		vsum0 = vfmaq_laneq_f32 (vsum0, vld1q_f32 (frame + 12), vcoeff, 2) ;
+		vsum1 = vfmaq_f32 (vsum1, vcombine_f32 (vdup_laneq_f32 (vcoeff, 2), vdup_laneq_f32 (vcoeff, 3)), vld1q_f32 (frame + 16)) ;
+		vsum2 = vfmaq_laneq_f32 (vsum2, vld1q_f32 (frame + 20), vcoeff, 3) ;
+		vindex = vaddq_s32 (vindex, vstep) ;
+		} ;
+
+	vst1q_f32 (sums, vsum0) ;
+	vst1q_f32 (sums + 4, vsum1) ;
+	vst1q_f32 (sums + 8, vsum2) ;
+	for (k = 0 ; k < 12 ; k++)
+		accum [k % 6] += sums [k] ;
+
+	k = frames & ~3 ;
+	sinc_accum_tail (coeffs, data + 6 * k, frames - k, channels, filter_index + k * filter_step, filter_step, accum) ;
+} /* neon_accum_hex */
+
+static void
+neon_accum_multi (const float *coeffs, const float *data, int frames, int channels,
+						int32_t filter_index, int32_t filter_step, float *accum)
+{	int32x4_t	vindex = neon_first_index (filter_index, filter_step), vstep = vdupq_n_s32 (4 * filter_step) ;
+	float		icoeff [4] ;
+	int			k, j, ch ;
+
+	for (k = 0 ; k + 4 <= frames ; k += 4)
+	{	vst1q_f32 (icoeff, neon_coeffs (coeffs, vindex)) ;
+		vindex = vaddq_s32 (vindex, vstep) ;
+
+		for (j = 0 ; j < 4 ; j++)
+		{	const float *frame = data + (k + j) * channels ;
+
+			for (ch = 0 ; ch + 4 <= channels ; ch += 4)
+				vst1q_f32 (accum + ch, vfmaq_n_f32 (vld1q_f32 (accum + ch), vld1q_f32 (frame + ch), icoeff [j])) ;
+			for ( ; ch < channels ; ch++)
+				accum [ch] += icoeff [j] * frame [ch] ;
+			} ;
+		} ;
+
+	sinc_accum_tail (coeffs, data + k * channels, frames - k, channels, filter_index + k * filter_step, filter_step, accum) ;
+} /* neon_accum_multi */
+
+#endif
+
+/*========================================================================================
+*/
+
+sinc_accum_func
+sinc_get_accum_func (int channels)
+{
+#ifdef SRC_SIMD_X86
+	if (cpu_has_avx2_fma ())
+		return sinc_get_accum_func_avx2 (channels) ;
+#endif
+
+#if defined (SRC_SIMD_SSE2)
+	switch (channels)
+	{	case 1 :
+			return sse2_accum_mono ;
+		case 2 :
+			return sse2_accum_stereo ;
+		case 4 :
+			return sse2_accum_quad ;
+		case 6 :
+			return sse2_accum_hex ;
+		default :
+			return sse2_accum_multi ;
+		} ;
+#elif defined (SRC_SIMD_NEON)
+	switch (channels)
+	{	case 1 :
+			return neon_accum_mono ;
+		case 2 :
+			return neon_accum_stereo ;
+		case 4 :
+			return neon_accum_quad ;
+		case 6 :
+			return neon_accum_hex ;
+		default :
+			return neon_accum_multi ;
+		} ;
+#endif
+
+	(void) channels ;
+	return NULL ;
+} /* sinc_get_accum_func */
@@ -0,0 +1,71 @@
+/*
+** This file is part of the bundled libsamplerate and is distributed under the
+** same license, see src_sinc.c.
+*/
+
+/*
+** SIMD filter accumulation for the sinc converters, selected at runtime.
+**
+** An accumulator walks 'frames' interleaved frames of 'channels' samples in
+** memory order. Frame j uses the coefficient interpolated at the fixed point
+** position filter_index + j * filter_step, with the same linear interpolation
+** as the scalar code, and adds coefficient * sample to accum [ch]. Sums are
+** kept in float, so results match the scalar double path to float tolerance.
+*/
+
+#ifndef SRC_SINC_SIMD_H_INCLUDED
+#define SRC_SINC_SIMD_H_INCLUDED
+
+#include "common.h"
+
+#ifndef SRC_DISABLE_SIMD
+
+#if defined (_M_X64) || defined (_M_IX86) || defined (__x86_64__) || defined (__i386__)
+#define SRC_SIMD_X86	1
+#endif
+
+#if defined (_M_ARM64) || defined (__aarch64__)
+#define SRC_SIMD_NEON	1
+#endif
+
+#endif
+
+/* Same fixed point format as src_sinc.c. */
+#define	SRC_SIMD_SHIFT_BITS		12
+#define	SRC_SIMD_FRACTION_MASK	((1 << SRC_SIMD_SHIFT_BITS) - 1)
+#define	SRC_SIMD_INV_FP_ONE		(1.0f / (1 << SRC_SIMD_SHIFT_BITS))
+
+typedef void (*sinc_accum_func) (const float *coeffs, const float *data, int frames, int channels,
+						int32_t filter_index, int32_t filter_step, float *accum) ;
+
+/*
+** Return the best accumulator for this CPU and channel count, or NULL to keep
+** the scalar code. Building with SRC_DISABLE_SIMD defined always keeps it.
+*/
+sinc_accum_func sinc_get_accum_func (int channels) ;
+
+#ifdef SRC_SIMD_X86
+sinc_accum_func sinc_get_accum_func_avx2 (int channels) ;
+#endif
+
+/* Scalar tail shared by the SIMD versions. */
+static inline void
+sinc_accum_tail (const float *coeffs, const float *data, int frames, int channels,
+						int32_t filter_index, int32_t filter_step, float *accum)
+{	float	fraction, icoeff ;
+	int		indx, ch, k ;
+
+	for (k = 0 ; k < frames ; k++)
+	{	indx = filter_index >> SRC_SIMD_SHIFT_BITS ;
+		fraction = (filter_index & SRC_SIMD_FRACTION_MASK) * SRC_SIMD_INV_FP_ONE ;
+		icoeff = coeffs [indx] + fraction * (coeffs [indx + 1] - coeffs [indx]) ;
+
+		for (ch = 0 ; ch < channels ; ch++)
+			accum [ch] += icoeff * data [ch] ;
+
+		data += channels ;
+		filter_index += filter_step ;
+		} ;
+} /* sinc_accum_tail */
+
+#endif /* SRC_SINC_SIMD_H_INCLUDED */
@@ -0,0 +1,119 @@
+#include "CYAudioBench.hpp"
+#include "Audio/Simd/CYAudioKernels.hpp"
+
+#include <math.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#if defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+CYDEVICE_NAMESPACE_BEGIN
+
+static const TBenchCase g_arrBenchCases[] =
+{
+    { "period", "callback rate and delivery CPU per period length", BenchPeriod },
+    { "sinc", "libsamplerate sinc converters per tier and channel count", BenchSinc },
+    { "meter", "per period level metering against the plain format conversion", BenchMeter },
+    { "stages", "cost of each built-in DSP stage per period", BenchStages },
+    { "fixed", "remix drivers compiled for the used channel count against the generic ones", BenchFixedRemix },
+    { "mixer", "mixing thread cost and input health per input count", BenchMixer },
+    { "batch", "delivery thread wake-ups and context switches per batching mode", BenchBatch },
+};
+
+int64_t GetThreadCpuUs()
+{
+#if defined(_WIN32)
+    FILETIME ftCreation, ftExit, ftKernel, ftUser;
+    if (!GetThreadTimes(GetCurrentThread(), &ftCreation, &ftExit, &ftKernel, &ftUser))
+        return 0;
+    const uint64_t nKernel = (uint64_t(ftKernel.dwHighDateTime) << 32) | ftKernel.dwLowDateTime;
+    const uint64_t nUser = (uint64_t(ftUser.dwHighDateTime) << 32) | ftUser.dwLowDateTime;
+    return int64_t((nKernel + nUser) / 10);
+#else
+    timespec objTime;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &objTime))
+        return 0;
+    return int64_t(objTime.tv_sec) * 1000000 + objTime.tv_nsec / 1000;
+#endif
+}
+
+bool GetThreadContextSwitches(uint64_t& nSwitches)
+{
+#if defined(__linux__)
+    rusage objUsage;
+    if (getrusage(RUSAGE_THREAD, &objUsage))
+        return false;
+    nSwitches = uint64_t(objUsage.ru_nvcsw) + uint64_t(objUsage.ru_nivcsw);
+    return true;
+#else
+    nSwitches = 0;
+    return false;
+#endif
+}
+
+std::vector<uint8_t> MakeBenchPcm(ECYPcmFormat ePcmFormat, uint32_t nChannels, uint32_t nFrames)
+{
+    const uint32_t nSampleBytes = (ePcmFormat == TYPE_PCM_S8) ? 1 : (ePcmFormat == TYPE_PCM_S16) ? 2 : (ePcmFormat == TYPE_PCM_S24) ? 3 : 4;
+    std::vector<uint8_t> vecPcm(size_t(nFrames) * nChannels * nSampleBytes);
+    uint8_t* pOut = vecPcm.data();
+
+    for (uint32_t nFrame = 0; nFrame < nFrames; ++nFrame)
+    {
+        for (uint32_t nChannel = 0; nChannel < nChannels; ++nChannel, pOut += nSampleBytes)
+        {
+            const float fValue = 0.5f * sinf(float(nFrame) * 0.0654f + float(nChannel) * 0.7f);
+            if (ePcmFormat == TYPE_PCM_F32)
+            {
+                memcpy(pOut, &fValue, sizeof(fValue));
+                continue;
+            }
+
+            // the integer formats are little endian two's complement of their full scale.
+            const int32_t nValue = int32_t(lrintf(fValue * ((nSampleBytes == 1) ? 127.0f : (nSampleBytes == 2) ? 32767.0f : 8388607.0f)));
+            const int32_t nStored = (nSampleBytes == 4) ? nValue * 256 : nValue;
+            for (uint32_t nByte = 0; nByte < nSampleBytes; ++nByte)
+                pOut[nByte] = uint8_t(uint32_t(nStored) >> (8 * nByte));
+        }
+    }
+    return vecPcm;
+}
+
+CYDEVICE_NAMESPACE_END
+
+using namespace CYDEVICE_NAMESPACE;
+
+int main(int argc, char* argv[])
+{
+    printf("CYDevice audio benchmark, SIMD level %d\n", (int)GetAudioKernels().eLevel);
+
+    int nRun = 0;
+    for (const TBenchCase& objCase : g_arrBenchCases)
+    {
+        bool bSelected = (argc < 2);
+        for (int i = 1; i < argc && !bSelected; ++i)
+            bSelected = !strcmp(argv[i], objCase.pszName);
+        if (!bSelected)
+            continue;
+
+        printf("\n[%s] %s\n", objCase.pszName, objCase.pszTitle);
+        fflush(stdout);
+        objCase.pfnRun();
+        ++nRun;
+    }
+
+    if (!nRun)
+    {
+        fprintf(stderr, "no case matched, the cases are:");
+        for (const TBenchCase& objCase : g_arrBenchCases)
+            fprintf(stderr, " %s", objCase.pszName);
+        fprintf(stderr, "\n");
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
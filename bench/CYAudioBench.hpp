@@ -0,0 +1,121 @@
+#ifndef __CY_AUDIO_BENCH_HPP__
+#define __CY_AUDIO_BENCH_HPP__
+
+#include "Common/CYDevicePrivDefine.hpp"
+#include "Audio/CYAudioDefine.hpp"
+
+#include <stdio.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+/**
+ * One benchmark case, it prints its own result lines.
+ */
+typedef void (*PFN_BenchCase)();
+
+struct TBenchCase
+{
+    const char* pszName = nullptr;
+    const char* pszTitle = nullptr;
+    PFN_BenchCase pfnRun = nullptr;
+};
+
+/**
+ * Cases, one per feature, in the order they run.
+ */
+void BenchPeriod();
+void BenchSinc();
+void BenchMeter();
+void BenchStages();
+void BenchFixedRemix();
+void BenchMixer();
+void BenchBatch();
+
+/**
+ * Monotonic wall clock in microseconds.
+ */
+inline int64_t GetBenchTimeUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Best time of nRounds rounds in nanoseconds per call, every round runs fnCall for at least
+ * g_nBenchRoundUs. The best round is the one least disturbed by the rest of the system.
+ */
+constexpr int64_t g_nBenchRoundUs = 20000;
+constexpr uint32_t g_nBenchRounds = 7;
+
+template <class TCall>
+double MeasureNsPerCall(TCall&& fnCall, uint32_t nRounds = g_nBenchRounds)
+{
+    // warm the caches and the branch predictors before timing.
+    fnCall();
+
+    double dBestNs = 0.0;
+    for (uint32_t nRound = 0; nRound < nRounds; ++nRound)
+    {
+        uint64_t nCalls = 0;
+        const int64_t nStartUs = GetBenchTimeUs();
+        int64_t nElapsedUs = 0;
+        do
+        {
+            fnCall();
+            ++nCalls;
+            nElapsedUs = GetBenchTimeUs() - nStartUs;
+        } while (nElapsedUs < g_nBenchRoundUs);
+
+        const double dNs = double(nElapsedUs) * 1000.0 / double(nCalls);
+        if (!nRound || dNs < dBestNs)
+            dBestNs = dNs;
+    }
+    return dBestNs;
+}
+
+/**
+ * CPU time of the calling thread in microseconds.
+ */
+int64_t GetThreadCpuUs();
+
+/**
+ * Voluntary and involuntary context switches of the calling thread, false where the platform does
+ * not count them per thread.
+ */
+bool GetThreadContextSwitches(uint64_t& nSwitches);
+
+/**
+ * Interleaved device PCM of a -6 dBFS tone, nChannels channels of nFrames frames, the channels
+ * offset in phase so a remix does not cancel out.
+ */
+std::vector<uint8_t> MakeBenchPcm(ECYPcmFormat ePcmFormat, uint32_t nChannels, uint32_t nFrames);
+
+/**
+ * Write the PCM to fnWrite in chunks of nChunkUs for nDurationUs, paced on the wall clock like a
+ * device thread, looping over vecPcm.
+ */
+template <class TWrite>
+void WriteRealTime(const std::vector<uint8_t>& vecPcm, uint32_t nBlockAlign, uint32_t nSampleRate, uint32_t nChunkUs, int64_t nDurationUs, TWrite&& fnWrite)
+{
+    const size_t nChunkFrames = size_t(uint64_t(nSampleRate) * nChunkUs / 1000000);
+    const size_t nPcmFrames = vecPcm.size() / nBlockAlign;
+    const int64_t nStartUs = GetBenchTimeUs();
+    size_t nFramePos = 0;
+
+    for (int64_t nChunk = 1; int64_t(nChunk * nChunkUs) <= nDurationUs; ++nChunk)
+    {
+        const int64_t nDueUs = nStartUs + nChunk * nChunkUs;
+        while (GetBenchTimeUs() < nDueUs)
+            std::this_thread::sleep_for(std::chrono::microseconds(MIN(int64_t(200), nDueUs - GetBenchTimeUs())));
+
+        const size_t nOffset = nFramePos % (nPcmFrames - nChunkFrames + 1);
+        fnWrite(vecPcm.data() + nOffset * nBlockAlign, nChunkFrames * nBlockAlign);
+        nFramePos += nChunkFrames;
+    }
+}
+
+CYDEVICE_NAMESPACE_END
+
+#endif // __CY_AUDIO_BENCH_HPP__
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "CYAudioBench.hpp"
+#include "Audio/CYAudioPipeline.hpp"
+
+#include <atomic>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+constexpr uint32_t g_nBenchBatchWriteUs = 1000;
+constexpr int64_t g_nBenchBatchRunUs = 2000000;
+
+namespace
+{
+    class CBatchCounter : public ICYAudioDataCallBack
+    {
+    public:
+        void OnAudioPeriod(const TAudioPeriod& /*objPeriod*/) override
+        {
+            OnDelivery(1);
+        }
+
+        void OnAudioPeriods(const TAudioPeriod* /*pPeriods*/, uint32_t nPeriods) override
+        {
+            OnDelivery(nPeriods);
+        }
+
+    public:
+        std::atomic<uint64_t> m_nCalls{ 0 };
+        uint64_t m_nPeriods = 0;
+        bool m_bSwitches = false;
+        uint64_t m_nFirstSwitches = 0;
+        uint64_t m_nLastSwitches = 0;
+        int64_t m_nFirstCpuUs = 0;
+        int64_t m_nLastCpuUs = 0;
+
+    private:
+        void OnDelivery(uint32_t nPeriods)
+        {
+            // context switches and CPU time of the delivery thread between the first and the last call.
+            uint64_t nSwitches = 0;
+            m_bSwitches = GetThreadContextSwitches(nSwitches);
+            const int64_t nCpuUs = GetThreadCpuUs();
+            if (!m_nCalls)
+            {
+                m_nFirstSwitches = nSwitches;
+                m_nFirstCpuUs = nCpuUs;
+            }
+            m_nLastSwitches = nSwitches;
+            m_nLastCpuUs = nCpuUs;
+            m_nPeriods += nPeriods;
+            m_nCalls.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+}
+
+void BenchBatch()
+{
+    TAudioSourceFormat objFormat;
+    objFormat.ePcmFormat = TYPE_PCM_S16;
+    objFormat.nChannels = 2;
+    objFormat.nSampleRate = 48000;
+    objFormat.nBlockAlign = 4;
+    const std::vector<uint8_t> vecPcm = MakeBenchPcm(objFormat.ePcmFormat, objFormat.nChannels, objFormat.nSampleRate);
+
+    struct TBatchCase
+    {
+        const char* pszName;
+        uint32_t nBatchPeriods;
+        uint32_t nBatchLatencyUs;
+    };
+    const TBatchCase arrCases[] =
+    {
+        { "unbatched", 0, 0 },
+        { "batch 4", 4, 0 },
+        { "batch 8", 8, 0 },
+        { "batch 16", 16, 0 },
+        { "batch 4, 15 ms", 4, 15000 },
+    };
+
+    printf("10 ms periods, %u us writes for %lld ms\n", g_nBenchBatchWriteUs, (long long)(g_nBenchBatchRunUs / 1000));
+    printf("%-16s %10s %10s %12s %8s\n", "mode", "calls/s", "periods/s", "switches/s", "cpu %");
+    for (const TBatchCase& objCase : arrCases)
+    {
+        TAudioConfig objConfig;
+        objConfig.nBatchPeriods = objCase.nBatchPeriods;
+        objConfig.nBatchLatencyUs = objCase.nBatchLatencyUs;
+
+        CYAudioPipeline objPipeline;
+        CBatchCounter objCounter;
+        if (!objPipeline.Init(objFormat, 0, objConfig) || !objPipeline.Start(&objCounter))
+        {
+            printf("%-16s init failed\n", objCase.pszName);
+            continue;
+        }
+
+        WriteRealTime(vecPcm, objFormat.nBlockAlign, objFormat.nSampleRate, g_nBenchBatchWriteUs, g_nBenchBatchRunUs,
+            [&objPipeline](const uint8_t* pData, size_t nBytes) { objPipeline.Write(pData, nBytes); });
+        objPipeline.Stop();
+
+        const double dSeconds = double(g_nBenchBatchRunUs) / 1000000.0;
+        const double dCalls = double(objCounter.m_nCalls.load(std::memory_order_relaxed));
+        const double dCpuUs = double(objCounter.m_nLastCpuUs - objCounter.m_nFirstCpuUs);
+        if (objCounter.m_bSwitches)
+            printf("%-16s %10.1f %10.1f %12.1f %8.3f\n", objCase.pszName, dCalls / dSeconds, double(objCounter.m_nPeriods) / dSeconds,
+                double(objCounter.m_nLastSwitches - objCounter.m_nFirstSwitches) / dSeconds, dCpuUs * 100.0 / double(g_nBenchBatchRunUs));
+        else
+            printf("%-16s %10.1f %10.1f %12s %8.3f\n", objCase.pszName, dCalls / dSeconds, double(objCounter.m_nPeriods) / dSeconds, "n/a",
+                dCpuUs * 100.0 / double(g_nBenchBatchRunUs));
+    }
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
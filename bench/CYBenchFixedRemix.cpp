@@ -0,0 +1,58 @@
+#include "CYAudioBench.hpp"
+#include "Audio/Simd/CYAudioKernels.hpp"
+
+CYDEVICE_NAMESPACE_BEGIN
+
+constexpr uint32_t g_nBenchRemixFrames = 480;
+
+void BenchFixedRemix()
+{
+    const TAudioKernels& objKernels = GetAudioKernels();
+    std::vector<float> vecOut(size_t(g_nBenchRemixFrames) * 2);
+
+    struct TRemixCase
+    {
+        const char* pszName;
+        ECYRemixShape eShape;
+        uint32_t nInChannels;
+        uint32_t nUsed;
+    };
+    const TRemixCase arrCases[] =
+    {
+        { "2 to 1", TYPE_REMIX_MONO, 2, 2 },
+        { "1 to 2", TYPE_REMIX_STEREO, 1, 1 },
+        { "2 to 2", TYPE_REMIX_STEREO, 2, 2 },
+        { "6 to 2 (2 used)", TYPE_REMIX_STEREO, 6, 2 },
+    };
+
+    printf("%d frames per call\n", (int)g_nBenchRemixFrames);
+    printf("%-16s %6s %12s %12s %8s\n", "plan", "format", "generic ns", "fixed ns", "change");
+    for (const TRemixCase& objCase : arrCases)
+    {
+        TRemixPlan objPlan;
+        objPlan.eShape = objCase.eShape;
+        objPlan.nInChannels = objCase.nInChannels;
+        objPlan.nOutChannels = (objCase.eShape == TYPE_REMIX_MONO) ? 1 : 2;
+        objPlan.nUsedChannels = objCase.nUsed;
+        for (uint32_t nCol = 0; nCol < objCase.nUsed; ++nCol)
+        {
+            objPlan.arrUsedChannels[nCol] = nCol;
+            for (uint32_t nOut = 0; nOut < objPlan.nOutChannels; ++nOut)
+                objPlan.arrCoeffs[nOut * g_nMaxRemixChannels + nCol] = (nOut == nCol || objCase.nUsed == 1) ? 0.7f : 0.3f;
+        }
+
+        for (ECYPcmFormat ePcmFormat : { TYPE_PCM_S16, TYPE_PCM_S24, TYPE_PCM_F32 })
+        {
+            const std::vector<uint8_t> vecPcm = MakeBenchPcm(ePcmFormat, objCase.nInChannels, g_nBenchRemixFrames);
+            const PFN_ConvertRemix pfnGeneric = objKernels.arrConvertRemix[ePcmFormat - TYPE_PCM_S8][objCase.eShape];
+            const PFN_ConvertRemix pfnFixed = objKernels.arrConvertRemixFixed[ePcmFormat - TYPE_PCM_S8][objCase.eShape - TYPE_REMIX_MONO][objCase.nUsed - 1];
+
+            const double dGenericNs = MeasureNsPerCall([&]() { pfnGeneric(objPlan, vecPcm.data(), vecOut.data(), g_nBenchRemixFrames); });
+            const double dFixedNs = MeasureNsPerCall([&]() { pfnFixed(objPlan, vecPcm.data(), vecOut.data(), g_nBenchRemixFrames); });
+            printf("%-16s %6s %12.1f %12.1f %7.1f%%\n", objCase.pszName, (ePcmFormat == TYPE_PCM_S16) ? "S16" : (ePcmFormat == TYPE_PCM_S24) ? "S24" : "F32",
+                dGenericNs, dFixedNs, (dFixedNs - dGenericNs) * 100.0 / dGenericNs);
+        }
+    }
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,42 @@
+#include "CYAudioBench.hpp"
+#include "Audio/Simd/CYAudioKernels.hpp"
+
+CYDEVICE_NAMESPACE_BEGIN
+
+constexpr uint32_t g_nBenchMeterFrames = 480;
+
+void BenchMeter()
+{
+    const TAudioKernels& objKernels = GetAudioKernels();
+
+    printf("S16 to float to S16 round trip of %u frames, metered like a delivered period\n", g_nBenchMeterFrames);
+    printf("%8s %14s %14s %14s %10s\n", "channels", "convert ns", "metered ns", "scalar meter", "overhead");
+    for (uint32_t nChannels : { 1u, 2u, 6u, 8u })
+    {
+        const size_t nSamples = size_t(g_nBenchMeterFrames) * nChannels;
+        const std::vector<uint8_t> vecPcm = MakeBenchPcm(TYPE_PCM_S16, nChannels, g_nBenchMeterFrames);
+        std::vector<float> vecFloat(nSamples);
+        std::vector<int16_t> vecOut(nSamples);
+        TAudioMeter objMeter;
+
+        auto convert = [&]()
+        {
+            objKernels.pfnS16ToFloat(vecPcm.data(), vecFloat.data(), nSamples);
+            objKernels.pfnFloatToS16(vecFloat.data(), 1, vecOut.data(), nSamples, nullptr);
+        };
+        auto meter = [&](PFN_Meter pfnMeter)
+        {
+            objKernels.pfnS16ToFloat(vecPcm.data(), vecFloat.data(), nSamples);
+            objMeter = TAudioMeter();
+            pfnMeter(vecFloat.data(), nChannels, g_nBenchMeterFrames, objMeter);
+            objKernels.pfnFloatToS16(vecFloat.data(), 1, vecOut.data(), nSamples, nullptr);
+        };
+
+        const double dConvertNs = MeasureNsPerCall(convert);
+        const double dMeteredNs = MeasureNsPerCall([&]() { meter(objKernels.pfnMeter); });
+        const double dScalarNs = MeasureNsPerCall([&]() { meter(MeterScalar); });
+        printf("%8u %14.1f %14.1f %14.1f %9.1f%%\n", nChannels, dConvertNs, dMeteredNs, dScalarNs, (dMeteredNs - dConvertNs) * 100.0 / dConvertNs);
+    }
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
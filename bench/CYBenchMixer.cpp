@@ -0,0 +1,117 @@
+#include "CYAudioBench.hpp"
+#include "Audio/CYAudioMixer.hpp"
+#include "Capture/Synthetic/SyntheticAudioCaptrue.hpp"
+
+#include <atomic>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+constexpr int64_t g_nBenchMixerRunUs = 2000000;
+
+namespace
+{
+    /**
+     * The synthetic source as a device, the mixer only subscribes to it.
+     */
+    class CBenchDevice : public ICYDevice
+    {
+    public:
+        int16_t Init(int /*nWidth*/, int /*nHeight*/, int /*nFPS*/, const wchar_t* /*pszDeviceName*/, const wchar_t* /*pszDeviceId*/, int /*nSampleRateHz*/,
+            const wchar_t* /*pszAudioName*/, const wchar_t* /*pszAudioID*/, bool /*bUseRender*/, const TAudioConfig* /*pAudioConfig*/) override { return CYERR_FAILED; }
+        int16_t UnInit() override { return m_objSource.UnInit(); }
+        int16_t InitAudio(ECYAudioSource /*eSource*/, int nSampleRateHz, const wchar_t* pszAudioName, const wchar_t* pszAudioID, const TAudioConfig* pAudioConfig) override
+        {
+            return m_objSource.InitAudio(nSampleRateHz, pszAudioName, pszAudioID, pAudioConfig);
+        }
+        int16_t StartCapture(ICYAudioDataCallBack* pAudioDataCallBack, ICYVideoDataCallBack* pVideoDataCallBack) override { return m_objSource.Start(pAudioDataCallBack, pVideoDataCallBack); }
+        int16_t StopCapture() override { return m_objSource.Stop(); }
+        int16_t GetNextAudioBuffer(float*& /*pBuffer*/, uint32_t& /*nNumFrames*/, uint64_t& /*nTimestamp*/) override { return CYERR_FAILED; }
+        int16_t ReadAudio(void* /*pBuffer*/, uint32_t /*nNumFrames*/, uint32_t /*nTimeoutMs*/, uint32_t& /*nReadFrames*/, uint64_t& /*nTimestamp*/) override { return CYERR_FAILED; }
+        int16_t GetAudioLevels(TAudioLevels& objLevels) override { return m_objSource.GetAudioLevels(objLevels); }
+        int16_t GetAudioSchedulingStats(TAudioSchedulingStats& objStats) override { return m_objSource.GetAudioSchedulingStats(objStats); }
+        int16_t SetAudioStages(const TAudioStage* pStages, uint32_t nStages) override { return m_objSource.SetAudioStages(pStages, nStages); }
+        int16_t SubscribeAudio(const TAudioSubscription& objSubscription, uint32_t& nSubscriptionId) override { return m_objSource.SubscribeAudio(objSubscription, nSubscriptionId); }
+        int16_t UnsubscribeAudio(uint32_t nSubscriptionId) override { return m_objSource.UnsubscribeAudio(nSubscriptionId); }
+
+    private:
+        CSyntheticAudioCaptrue m_objSource;
+    };
+
+    class CMixCounter : public ICYAudioDataCallBack
+    {
+    public:
+        void OnAudioPeriod(const TAudioPeriod& /*objPeriod*/) override
+        {
+            // CPU time of the mixing thread between the first and the last period.
+            const int64_t nCpuUs = GetThreadCpuUs();
+            if (!m_nPeriods)
+                m_nFirstCpuUs = nCpuUs;
+            m_nLastCpuUs = nCpuUs;
+            m_nPeriods.fetch_add(1, std::memory_order_relaxed);
+        }
+
+    public:
+        std::atomic<uint64_t> m_nPeriods{ 0 };
+        int64_t m_nFirstCpuUs = 0;
+        int64_t m_nLastCpuUs = 0;
+    };
+}
+
+void BenchMixer()
+{
+    const TAudioMixerConfig objConfig;
+    printf("synthetic 48 kHz stereo inputs, %u us stereo mix for %lld ms\n", objConfig.nPeriodUs, (long long)(g_nBenchMixerRunUs / 1000));
+    printf("%6s %10s %14s %12s %10s %10s\n", "inputs", "periods", "cpu us/period", "wake p99 us", "underruns", "dropped");
+    for (uint32_t nInputs : { 1u, 2u, 4u, 8u, 16u, 32u })
+    {
+        std::vector<UniquePtr<CBenchDevice>> vecDevices;
+        std::vector<uint32_t> vecInputIds(nInputs);
+        CYAudioMixer objMixer;
+        CMixCounter objCounter;
+        bool bReady = objMixer.Init(objConfig) == CYERR_SUCESS;
+        for (uint32_t nInput = 0; bReady && nInput < nInputs; ++nInput)
+        {
+            vecDevices.push_back(MakeUnique<CBenchDevice>());
+            TAudioMixerInput objInput;
+            objInput.fGain = 1.0f / float(nInputs);
+            objInput.fPan = (nInputs > 1) ? -1.0f + 2.0f * float(nInput) / float(nInputs - 1) : 0.0f;
+            // the capture objects report a successful InitAudio as true, like the device does.
+            bReady = vecDevices.back()->InitAudio(TYPE_CYAUDIO_SOURCE_SYNTHETIC, 48000, nullptr, nullptr, nullptr) &&
+                objMixer.AddInput(vecDevices.back().get(), objInput, vecInputIds[nInput]) == CYERR_SUCESS;
+        }
+        if (!bReady)
+        {
+            printf("%6u init failed\n", nInputs);
+            continue;
+        }
+
+        for (UniquePtr<CBenchDevice>& ptrDevice : vecDevices)
+            ptrDevice->StartCapture(nullptr, nullptr);
+        objMixer.Start(&objCounter);
+        std::this_thread::sleep_for(std::chrono::microseconds(g_nBenchMixerRunUs));
+
+        TAudioSchedulingStats objSchedulingStats;
+        objMixer.GetSchedulingStats(objSchedulingStats);
+        uint64_t nUnderruns = 0, nDropped = 0;
+        for (uint32_t nInputId : vecInputIds)
+        {
+            TAudioMixerInputStats objStats;
+            objMixer.GetInputStats(nInputId, objStats);
+            nUnderruns += objStats.nUnderrunCount;
+            nDropped += objStats.nDroppedPeriods;
+        }
+        objMixer.Stop();
+        for (UniquePtr<CBenchDevice>& ptrDevice : vecDevices)
+            ptrDevice->StopCapture();
+        objMixer.UnInit();
+        for (UniquePtr<CBenchDevice>& ptrDevice : vecDevices)
+            ptrDevice->UnInit();
+
+        const uint64_t nPeriods = objCounter.m_nPeriods.load(std::memory_order_relaxed);
+        const double dCpuUs = double(objCounter.m_nLastCpuUs - objCounter.m_nFirstCpuUs);
+        printf("%6u %10llu %14.2f %12u %10llu %10llu\n", nInputs, (unsigned long long)nPeriods, (nPeriods > 1) ? dCpuUs / double(nPeriods - 1) : 0.0,
+            objSchedulingStats.nP99LatencyUs, (unsigned long long)nUnderruns, (unsigned long long)nDropped);
+    }
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "CYAudioBench.hpp"
+#include "Audio/CYAudioPipeline.hpp"
+
+#include <atomic>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+// the device writes every millisecond, so even the shortest period is cut from several writes.
+constexpr uint32_t g_nBenchPeriodWriteUs = 1000;
+constexpr int64_t g_nBenchPeriodRunUs = 1000000;
+
+namespace
+{
+    class CPeriodCounter : public ICYAudioDataCallBack
+    {
+    public:
+        void OnAudioPeriod(const TAudioPeriod& objPeriod) override
+        {
+            // CPU time of the delivery thread between the first and the last period.
+            const int64_t nCpuUs = GetThreadCpuUs();
+            if (!m_nPeriods)
+                m_nFirstCpuUs = nCpuUs;
+            m_nLastCpuUs = nCpuUs;
+            m_nFrames += objPeriod.nFrames;
+            m_nPeriods.fetch_add(1, std::memory_order_relaxed);
+        }
+
+    public:
+        std::atomic<uint64_t> m_nPeriods{ 0 };
+        uint64_t m_nFrames = 0;
+        int64_t m_nFirstCpuUs = 0;
+        int64_t m_nLastCpuUs = 0;
+    };
+}
+
+void BenchPeriod()
+{
+    TAudioSourceFormat objFormat;
+    objFormat.ePcmFormat = TYPE_PCM_S16;
+    objFormat.nChannels = 2;
+    objFormat.nSampleRate = 48000;
+    objFormat.nBlockAlign = 4;
+    const std::vector<uint8_t> vecPcm = MakeBenchPcm(objFormat.ePcmFormat, objFormat.nChannels, objFormat.nSampleRate);
+
+    printf("%10s %12s %14s %12s\n", "period us", "periods/s", "cpu us/period", "cpu %");
+    for (uint32_t nPeriodUs : { 2500u, 5000u, 10000u, 20000u, 50000u, 100000u })
+    {
+        TAudioConfig objConfig;
+        objConfig.nPeriodUs = nPeriodUs;
+
+        CYAudioPipeline objPipeline;
+        CPeriodCounter objCounter;
+        if (!objPipeline.Init(objFormat, 0, objConfig) || !objPipeline.Start(&objCounter))
+        {
+            printf("%10u init failed\n", nPeriodUs);
+            continue;
+        }
+
+        WriteRealTime(vecPcm, objFormat.nBlockAlign, objFormat.nSampleRate, g_nBenchPeriodWriteUs, g_nBenchPeriodRunUs,
+            [&objPipeline](const uint8_t* pData, size_t nBytes) { objPipeline.Write(pData, nBytes); });
+        objPipeline.Stop();
+
+        const uint64_t nPeriods = objCounter.m_nPeriods.load(std::memory_order_relaxed);
+        const double dCpuUs = double(objCounter.m_nLastCpuUs - objCounter.m_nFirstCpuUs);
+        printf("%10u %12.1f %14.2f %12.3f\n", nPeriodUs, double(nPeriods) * 1000000.0 / double(g_nBenchPeriodRunUs),
+            (nPeriods > 1) ? dCpuUs / double(nPeriods - 1) : 0.0, dCpuUs * 100.0 / double(g_nBenchPeriodRunUs));
+    }
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
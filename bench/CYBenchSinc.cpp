@@ -0,0 +1,41 @@
+#include "CYAudioBench.hpp"
+#include "Audio/Resample/ICYAudioResampler.hpp"
+
+#include <math.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+// one 10 ms period of a 48 kHz device, converted to 44.1 kHz so every output frame runs the filter.
+constexpr uint32_t g_nBenchSincInRate = 48000;
+constexpr uint32_t g_nBenchSincOutRate = 44100;
+constexpr uint32_t g_nBenchSincFrames = 480;
+
+void BenchSinc()
+{
+    printf("%u to %u Hz, %u frames per call\n", g_nBenchSincInRate, g_nBenchSincOutRate, g_nBenchSincFrames);
+    printf("%-8s %8s %12s %16s %12s\n", "tier", "channels", "ns/period", "ns/frame/ch", "realtime x");
+    for (ECYAudioResampleQuality eQuality : { TYPE_CYAUDIO_RESAMPLE_SINC_FASTEST, TYPE_CYAUDIO_RESAMPLE_SINC_MEDIUM })
+    {
+        for (uint32_t nChannels : { 1u, 2u, 4u, 6u, 8u })
+        {
+            UniquePtr<ICYAudioResampler> pResampler = CreateAudioResampler(eQuality, g_nBenchSincInRate, g_nBenchSincOutRate);
+            if (!pResampler || !pResampler->Init(g_nBenchSincInRate, g_nBenchSincOutRate, nChannels, g_nBenchSincFrames))
+            {
+                printf("%-8s %8u init failed\n", (eQuality == TYPE_CYAUDIO_RESAMPLE_SINC_FASTEST) ? "fastest" : "medium", nChannels);
+                continue;
+            }
+
+            std::vector<float> vecIn(size_t(g_nBenchSincFrames) * nChannels);
+            for (size_t i = 0; i < vecIn.size(); ++i)
+                vecIn[i] = 0.5f * sinf(float(i / nChannels) * 0.0577f + float(i % nChannels));
+            std::vector<float> vecOut(size_t(pResampler->GetMaxOutFrames(g_nBenchSincFrames)) * nChannels);
+
+            const double dNs = MeasureNsPerCall([&]() { pResampler->Process(vecIn.data(), g_nBenchSincFrames, vecOut.data()); });
+            const double dPeriodNs = double(g_nBenchSincFrames) * 1e9 / double(g_nBenchSincInRate);
+            printf("%-8s %8u %12.0f %16.2f %12.0f\n", (eQuality == TYPE_CYAUDIO_RESAMPLE_SINC_FASTEST) ? "fastest" : "medium", nChannels,
+                dNs, dNs / double(g_nBenchSincFrames * nChannels), dPeriodNs / dNs);
+        }
+    }
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "CYAudioBench.hpp"
+#include "Audio/CYAudioStages.hpp"
+#include "Audio/Simd/CYAudioKernels.hpp"
+
+#include <math.h>
+#include <string.h>
+
+CYDEVICE_NAMESPACE_BEGIN
+
+constexpr uint32_t g_nBenchStageFrames = 480;
+constexpr uint32_t g_nBenchStageRate = 48000;
+
+static std::vector<float> MakeBenchFloat(uint32_t nChannels, uint32_t nFrames)
+{
+    std::vector<float> vecData(size_t(nFrames) * nChannels);
+    for (size_t i = 0; i < vecData.size(); ++i)
+        vecData[i] = 0.5f * sinf(float(i / nChannels) * 0.0577f + float(i % nChannels));
+    return vecData;
+}
+
+static TAudioStage MakeBiquadStage(uint32_t nSections)
+{
+    // a 4.8 kHz Butterworth low-pass section at 48 kHz, repeated.
+    TAudioStage objStage;
+    objStage.eType = TYPE_CYAUDIO_STAGE_BIQUAD;
+    objStage.nBiquads = nSections;
+    for (uint32_t nSection = 0; nSection < nSections; ++nSection)
+        objStage.arrBiquads[nSection] = { 0.0675f, 0.1349f, 0.0675f, -1.1430f, 0.4128f };
+    return objStage;
+}
+
+void BenchStages()
+{
+    struct TStageCase
+    {
+        const char* pszName;
+        TAudioStage objStage;
+    };
+    TStageCase arrCases[] =
+    {
+        { "biquad x2", MakeBiquadStage(2) },
+        { "biquad x4", MakeBiquadStage(4) },
+        { "dc removal", TAudioStage() },
+        { "highpass 4", TAudioStage() },
+        { "agc", TAudioStage() },
+    };
+    arrCases[2].objStage.eType = TYPE_CYAUDIO_STAGE_DC_REMOVAL;
+    arrCases[3].objStage.eType = TYPE_CYAUDIO_STAGE_HIGHPASS;
+    arrCases[3].objStage.nOrder = 4;
+    arrCases[4].objStage.eType = TYPE_CYAUDIO_STAGE_AGC;
+
+    // every call filters a fresh copy of the period, a decaying signal would time denormals instead.
+    printf("one stage over %u frames at %u Hz, ns per period including a %u frame copy\n", g_nBenchStageFrames, g_nBenchStageRate, g_nBenchStageFrames);
+    printf("%-12s %8s %12s %12s\n", "stage", "channels", "chain ns", "scalar ns");
+    for (const TStageCase& objCase : arrCases)
+    {
+        for (uint32_t nChannels : { 1u, 2u, 6u, 8u })
+        {
+            CYAudioStageChain objChain;
+            if (!objChain.Init(&objCase.objStage, 1, nChannels, g_nBenchStageRate))
+            {
+                printf("%-12s %8u init failed\n", objCase.pszName, nChannels);
+                continue;
+            }
+
+            const std::vector<float> vecSource = MakeBenchFloat(nChannels, g_nBenchStageFrames);
+            std::vector<float> vecData(vecSource.size());
+            const size_t nBytes = vecSource.size() * sizeof(float);
+            const double dChainNs = MeasureNsPerCall([&]()
+            {
+                memcpy(vecData.data(), vecSource.data(), nBytes);
+                objChain.Process(vecData.data(), g_nBenchStageFrames);
+            });
+
+            // the biquad cascades also run through the scalar kernel, for reference.
+            if (objCase.objStage.eType == TYPE_CYAUDIO_STAGE_BIQUAD)
+            {
+                std::vector<float> vecState(size_t(objCase.objStage.nBiquads) * 2 * nChannels);
+                const double dScalarNs = MeasureNsPerCall([&]()
+                {
+                    memcpy(vecData.data(), vecSource.data(), nBytes);
+                    BiquadScalar(vecData.data(), nChannels, g_nBenchStageFrames, objCase.objStage.arrBiquads, objCase.objStage.nBiquads, vecState.data());
+                });
+                printf("%-12s %8u %12.0f %12.0f\n", objCase.pszName, nChannels, dChainNs, dScalarNs);
+            }
+            else
+                printf("%-12s %8u %12.0f %12s\n", objCase.pszName, nChannels, dChainNs, "-");
+        }
+    }
+}
+
+CYDEVICE_NAMESPACE_END
\ No newline at end of file
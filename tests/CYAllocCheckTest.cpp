@@ -0,0 +1,99 @@
+#include "CYTestDefine.hpp"
+#include "Capture/Synthetic/SyntheticAudioCaptrue.hpp"
+#include "Common/CYAllocCheck.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#if !defined(CYDEVICE_ALLOC_CHECK)
+#error "CYAllocCheckTest must be linked against the CYDEVICE_ALLOC_CHECK build of the audio path"
+#endif
+
+using namespace CYDEVICE_NAMESPACE;
+
+/**
+ * Steady state after warm-up, every configuration runs the synthetic source this long. An allocation
+ * on the source or the delivery thread aborts the process, which fails the test.
+ */
+constexpr uint32_t g_nAllocTestRunMs = 3000;
+
+namespace
+{
+    class CPeriodCounter : public ICYAudioDataCallBack
+    {
+    public:
+        void OnAudioPeriod(const TAudioPeriod& objPeriod) override
+        {
+            m_nFrames.fetch_add(objPeriod.nFrames, std::memory_order_relaxed);
+        }
+
+    public:
+        std::atomic<uint64_t> m_nFrames{ 0 };
+    };
+}
+
+static void RunConfiguration(const char* pszName, int nSampleRateHz, const TAudioConfig& objConfig, bool bSubscribe = false)
+{
+    CSyntheticAudioCaptrue objSource;
+    CPeriodCounter objCounter;
+    CPeriodCounter objSubscriber;
+
+    CY_TEST_CHECK(objSource.InitAudio(nSampleRateHz, nullptr, nullptr, &objConfig), "%s: InitAudio failed", pszName);
+
+    // a second consumer at another rate and period takes the fan-out path as well.
+    if (bSubscribe)
+    {
+        TAudioSubscription objSubscription;
+        objSubscription.nSampleRate = 16000;
+        objSubscription.objConfig.nPeriodUs = 20000;
+        objSubscription.pAudioDataCallBack = &objSubscriber;
+        uint32_t nSubscriptionId = 0;
+        CY_TEST_CHECK(objSource.SubscribeAudio(objSubscription, nSubscriptionId) == CYERR_SUCESS, "%s: SubscribeAudio failed", pszName);
+    }
+
+    CY_TEST_CHECK(objSource.Start(&objCounter, nullptr) == CYERR_SUCESS, "%s: Start failed", pszName);
+    std::this_thread::sleep_for(std::chrono::milliseconds(g_nAllocTestRunMs));
+    objSource.Stop();
+    objSource.UnInit();
+
+    // most of the run must have been delivered, or the check did not see a steady state.
+    const uint64_t nExpected = uint64_t(nSampleRateHz) * g_nAllocTestRunMs / 1000;
+    const uint64_t nFrames = objCounter.m_nFrames.load(std::memory_order_relaxed);
+    CY_TEST_CHECK(nFrames >= nExpected * 3 / 4, "%s: %llu frames delivered of %llu", pszName, (unsigned long long)nFrames, (unsigned long long)nExpected);
+    if (bSubscribe)
+        CY_TEST_CHECK(objSubscriber.m_nFrames.load(std::memory_order_relaxed) > 0, "%s: the subscriber got no audio", pszName);
+
+    printf("%s: %llu frames in %u ms without an allocation\n", pszName, (unsigned long long)nFrames, g_nAllocTestRunMs);
+}
+
+int main()
+{
+    TAudioConfig objBatch;
+    objBatch.nBatchPeriods = 4;
+    RunConfiguration("batch", 48000, objBatch);
+
+    TAudioConfig objJitter;
+    objJitter.bJitterBuffer = true;
+    RunConfiguration("jitter", 48000, objJitter);
+
+    // the polyphase tier with every per period feature on top, and a subscriber through the fan-out.
+    TAudioStage arrStages[2];
+    arrStages[0].eType = TYPE_CYAUDIO_STAGE_HIGHPASS;
+    arrStages[1].eType = TYPE_CYAUDIO_STAGE_AGC;
+    TAudioConfig objResample;
+    objResample.eSampleFormat = TYPE_CYAUDIO_SAMPLE_S16;
+    objResample.bMetering = true;
+    objResample.eGateMode = TYPE_CYAUDIO_GATE_FLAG;
+    objResample.pStages = arrStages;
+    objResample.nStages = 2;
+    RunConfiguration("resample", 44100, objResample, true);
+
+    TAudioConfig objPacket;
+    objPacket.nPeriodFrames = 960;
+    objPacket.bDriftCompensation = true;
+    objPacket.eResampleQuality = TYPE_CYAUDIO_RESAMPLE_SINC_FASTEST;
+    RunConfiguration("packet", 48000, objPacket);
+
+    return CY_TEST_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include "CYTestDefine.hpp"
+#include "Audio/CYAudioClock.hpp"
+#include "Audio/CYAudioPipeline.hpp"
+
+#include <math.h>
+#include <vector>
+
+using namespace CYDEVICE_NAMESPACE;
+
+// 48 kHz device audio written in 10 ms packets against a simulated host clock.
+constexpr uint32_t g_nTestRate = 48000;
+constexpr uint32_t g_nTestPacketFrames = 480;
+constexpr int64_t g_nTestOriginUs = 1000000;
+
+// packets arrive up to this late, the same sequence on every run.
+constexpr uint32_t g_nTestJitterUs = 2000;
+
+namespace
+{
+    /**
+     * Host clock of a device running dDriftPpm fast, with the delivery jitter of a capture thread.
+     */
+    class CSkewedHost
+    {
+    public:
+        explicit CSkewedHost(double dDriftPpm) : m_dFrameUs(1e6 / (g_nTestRate * (1.0 + dDriftPpm * 1e-6))) {}
+
+        // host time device frame nFramePos was captured at.
+        int64_t GetFrameUs(uint64_t nFramePos) const { return g_nTestOriginUs + int64_t(llround(double(nFramePos) * m_dFrameUs)); }
+
+        // host time a write ending at nFramePos arrives at.
+        int64_t GetArrivalUs(uint64_t nFramePos)
+        {
+            m_nSeed = m_nSeed * 1664525u + 1013904223u;
+            return GetFrameUs(nFramePos) + int64_t((m_nSeed >> 8) % g_nTestJitterUs);
+        }
+
+    private:
+        double m_dFrameUs;
+        uint32_t m_nSeed = 1;
+    };
+}
+
+static void CheckDrift(double dDriftPpm)
+{
+    CYAudioClock objClock;
+    objClock.Init(g_nTestRate);
+    CSkewedHost objHost(dDriftPpm);
+
+    // the loop locks after g_dClockLockSeconds and tracks the drift from there.
+    uint64_t nFramePos = 0;
+    bool bEarlyLock = false;
+    double dMaxDriftError = 0.0;
+    int64_t nMaxTimeError = 0;
+    for (uint32_t nWrite = 0; nWrite < 100 * 40; ++nWrite)
+    {
+        nFramePos += g_nTestPacketFrames;
+        objClock.Update(nFramePos, objHost.GetArrivalUs(nFramePos));
+
+        const double dSeconds = double(nFramePos) / g_nTestRate;
+        if (dSeconds < g_dClockLockSeconds * 0.9)
+            bEarlyLock |= objClock.IsLocked();
+        else if (dSeconds >= 20.0)
+        {
+            // settled, the loop follows the mean arrival, half the jitter behind the capture.
+            dMaxDriftError = MAX(dMaxDriftError, fabs(objClock.GetDriftPpm() - dDriftPpm));
+            const int64_t nExpectedUs = objHost.GetFrameUs(nFramePos) + g_nTestJitterUs / 2;
+            nMaxTimeError = MAX(nMaxTimeError, llabs(objClock.GetFrameTimeUs(nFramePos) - nExpectedUs));
+        }
+    }
+
+    CY_TEST_CHECK(!bEarlyLock, "%+.0f ppm: locked before %.0f s", dDriftPpm, g_dClockLockSeconds);
+    CY_TEST_CHECK(objClock.IsLocked(), "%+.0f ppm: not locked after 40 s", dDriftPpm);
+    CY_TEST_CHECK(dMaxDriftError < 10.0, "%+.0f ppm: the drift is measured %.1f ppm off", dDriftPpm, dMaxDriftError);
+    CY_TEST_CHECK(nMaxTimeError < 300, "%+.0f ppm: a frame time %lld us off", dDriftPpm, (long long)nMaxTimeError);
+    CY_TEST_CHECK(!objClock.GetResyncCount(), "%+.0f ppm: %llu resyncs", dDriftPpm, (unsigned long long)objClock.GetResyncCount());
+    printf("%+.0f ppm: measured within %.2f ppm, frame times within %lld us\n", dDriftPpm, dMaxDriftError, (long long)nMaxTimeError);
+}
+
+static void CheckResync()
+{
+    CYAudioClock objClock;
+    objClock.Init(g_nTestRate);
+    CSkewedHost objHost(100.0);
+
+    uint64_t nFramePos = 0;
+    for (uint32_t nWrite = 0; nWrite < 100 * 15; ++nWrite)
+    {
+        nFramePos += g_nTestPacketFrames;
+        objClock.Update(nFramePos, objHost.GetArrivalUs(nFramePos));
+    }
+    CY_TEST_CHECK(objClock.IsLocked(), "resync: not locked after 15 s");
+
+    // frames dropped on overrun move the position on without entering the stream.
+    objClock.Skip(g_nTestPacketFrames * 10);
+    for (uint32_t nWrite = 0; nWrite < 100; ++nWrite)
+    {
+        nFramePos += g_nTestPacketFrames;
+        objClock.Update(nFramePos, objHost.GetArrivalUs(nFramePos + g_nTestPacketFrames * 10));
+    }
+    CY_TEST_CHECK(!objClock.GetResyncCount() && objClock.IsLocked(), "resync: skipped frames lost the lock");
+
+    // a writer stalled for a second restarts the loop.
+    nFramePos += g_nTestPacketFrames;
+    objClock.Update(nFramePos, objHost.GetArrivalUs(nFramePos + g_nTestPacketFrames * 10) + 1000000);
+    CY_TEST_CHECK(objClock.GetResyncCount() == 1, "resync: %llu resyncs after a stall", (unsigned long long)objClock.GetResyncCount());
+    CY_TEST_CHECK(fabs(objClock.GetResyncError() - 1.0) < 0.01, "resync: %.3f s error reported for a 1 s stall", objClock.GetResyncError());
+    CY_TEST_CHECK(objClock.IsValid() && !objClock.IsLocked(), "resync: still locked after the restart");
+}
+
+/**
+ * Runs 40 s of a device dDriftPpm fast through the pipeline at the device rate. Returns how far the
+ * delivered frames moved against the host clock between 20 s and 40 s, in microseconds.
+ */
+static int64_t MeasureDeliveredDrift(double dDriftPpm, bool bDriftCompensation, double& dReportedPpm)
+{
+    TAudioSourceFormat objFormat;
+    objFormat.ePcmFormat = TYPE_PCM_F32;
+    objFormat.nChannels = 1;
+    objFormat.nSampleRate = g_nTestRate;
+    objFormat.nBlockAlign = sizeof(float);
+
+    TAudioConfig objConfig;
+    objConfig.eChannelLayout = TYPE_CYAUDIO_LAYOUT_MONO;
+    objConfig.bDriftCompensation = bDriftCompensation;
+
+    CYAudioPipeline objPipeline;
+    if (!objPipeline.Init(objFormat, 0, objConfig))
+    {
+        CY_TEST_CHECK(false, "%+.0f ppm: Init failed", dDriftPpm);
+        return 0;
+    }
+
+    CSkewedHost objHost(dDriftPpm);
+    std::vector<float> vecPcm(g_nTestPacketFrames, 0.0f);
+    uint64_t nFramePos = 0;
+    int64_t nStartOffsetUs = 0;
+    int64_t nEndOffsetUs = 0;
+    for (uint32_t nWrite = 0; nWrite < 100 * 40; ++nWrite)
+    {
+        const int64_t nStreamUs = int64_t(nFramePos * 1000000 / g_nTestRate);
+        nFramePos += g_nTestPacketFrames;
+        objPipeline.Write(vecPcm.data(), vecPcm.size() * sizeof(float), objHost.GetArrivalUs(nFramePos), nStreamUs);
+
+        // the stamp is the host time of the period, the frame position its time at the nominal rate.
+        TAudioPeriod objPeriod;
+        while (objPipeline.GetNextBuffer(objPeriod))
+        {
+            const int64_t nOffsetUs = int64_t(objPeriod.nTimeStampUs) - int64_t(objPeriod.nFramePos * 1000000 / g_nTestRate);
+            if (nWrite < 100 * 20)
+                nStartOffsetUs = nOffsetUs;
+            nEndOffsetUs = nOffsetUs;
+            dReportedPpm = objPeriod.dClockDriftPpm;
+            objPipeline.ReleasePeriod();
+        }
+    }
+    return nEndOffsetUs - nStartOffsetUs;
+}
+
+static void CheckCompensation(double dDriftPpm)
+{
+    // left alone the periods run ahead of the host clock by the drift, 6 ms over 20 s at 300 ppm.
+    double dReportedPpm = 0.0;
+    const int64_t nFreeUs = MeasureDeliveredDrift(dDriftPpm, false, dReportedPpm);
+    const int64_t nExpectedUs = -int64_t(dDriftPpm * 20.0);
+    CY_TEST_CHECK(llabs(nFreeUs - nExpectedUs) < 1000, "%+.0f ppm: the free running periods moved %lld us, %lld expected",
+        dDriftPpm, (long long)nFreeUs, (long long)nExpectedUs);
+    CY_TEST_CHECK(fabs(dReportedPpm - dDriftPpm) < 10.0, "%+.0f ppm: the periods report %.1f ppm", dDriftPpm, dReportedPpm);
+
+    // compensated, the resampler holds the delivered frames on the host clock.
+    const int64_t nLockedUs = MeasureDeliveredDrift(dDriftPpm, true, dReportedPpm);
+    CY_TEST_CHECK(llabs(nLockedUs) < 1000, "%+.0f ppm: the compensated periods moved %lld us", dDriftPpm, (long long)nLockedUs);
+    printf("%+.0f ppm: periods moved %lld us free running, %lld us compensated\n", dDriftPpm, (long long)nFreeUs, (long long)nLockedUs);
+}
+
+int main()
+{
+    for (double dDriftPpm : { 0.0, 300.0, -300.0, 900.0 })
+        CheckDrift(dDriftPpm);
+    CheckResync();
+    for (double dDriftPpm : { 300.0, -300.0 })
+        CheckCompensation(dDriftPpm);
+    return CY_TEST_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "CYTestDefine.hpp"
+#include "Audio/CYAudioPipeline.hpp"
+
+#include <math.h>
+#include <vector>
+
+using namespace CYDEVICE_NAMESPACE;
+
+// 48 kHz mono F32 device audio in 10 ms packets, the ring holds one second of it.
+constexpr uint32_t g_nTestRate = 48000;
+constexpr uint32_t g_nTestPacketFrames = 480;
+constexpr uint32_t g_nTestRingFrames = 48000;
+
+// a 150 Hz tone, half a cycle every 10 ms of jump, so a splice that is not concealed steps the signal.
+constexpr double g_dTestToneHz = 150.0;
+constexpr float g_fTestAmplitude = 0.5f;
+
+// the largest sample step the tone has on its own, and what the fades may add to it.
+const float g_fToneStep = float(g_fTestAmplitude * 2.0 * 3.14159265358979323846 * g_dTestToneHz / g_nTestRate);
+const float g_fMaxStep = 3.0f * g_fToneStep;
+
+namespace
+{
+    class CConcealStream
+    {
+    public:
+        bool Init()
+        {
+            TAudioSourceFormat objFormat;
+            objFormat.ePcmFormat = TYPE_PCM_F32;
+            objFormat.nChannels = 1;
+            objFormat.nSampleRate = g_nTestRate;
+            objFormat.nBlockAlign = sizeof(float);
+
+            TAudioConfig objConfig;
+            objConfig.eChannelLayout = TYPE_CYAUDIO_LAYOUT_MONO;
+            return m_objPipeline.Init(objFormat, 0, objConfig);
+        }
+
+        // nFrames of the tone as the source stamps them at nStreamUs, the tone follows the stamps.
+        void Write(int64_t nStreamUs, uint32_t nFrames)
+        {
+            m_vecPcm.resize(nFrames);
+            for (uint32_t i = 0; i < nFrames; ++i)
+                m_vecPcm[i] = g_fTestAmplitude * float(sin(2.0 * 3.14159265358979323846 * g_dTestToneHz * (double(nStreamUs) / 1000000.0 + double(i) / g_nTestRate)));
+            m_objPipeline.Write(m_vecPcm.data(), m_vecPcm.size() * sizeof(float), nStreamUs + 1000000, nStreamUs);
+            m_nWrittenFrames += nFrames;
+            m_nNextStreamUs = nStreamUs + int64_t(nFrames) * 1000000 / g_nTestRate;
+        }
+
+        void WritePackets(uint32_t nPackets)
+        {
+            for (uint32_t i = 0; i < nPackets; ++i)
+                Write(m_nNextStreamUs, g_nTestPacketFrames);
+        }
+
+        // every complete period, checked to follow on from the one before.
+        void Drain()
+        {
+            TAudioPeriod objPeriod;
+            while (m_objPipeline.GetNextBuffer(objPeriod))
+            {
+                CY_TEST_CHECK(objPeriod.nFramePos == m_vecOutput.size(), "a period starts at frame %llu after %zu delivered", (unsigned long long)objPeriod.nFramePos, m_vecOutput.size());
+                const float* pData = static_cast<const float*>(objPeriod.pData);
+                m_vecOutput.insert(m_vecOutput.end(), pData, pData + objPeriod.nFrames);
+                m_nDiscontinuityPeriods += objPeriod.bDiscontinuity;
+                m_objLast = objPeriod;
+                m_objPipeline.ReleasePeriod();
+            }
+        }
+
+    public:
+        CYAudioPipeline m_objPipeline;
+        std::vector<float> m_vecPcm;
+        std::vector<float> m_vecOutput;
+        TAudioPeriod m_objLast;
+        int64_t m_nNextStreamUs = 0;
+        uint64_t m_nWrittenFrames = 0;
+        uint32_t m_nDiscontinuityPeriods = 0;
+    };
+}
+
+// largest step between neighbouring output samples, and where it is.
+static float GetMaxStep(const std::vector<float>& vecOutput, size_t& nAt)
+{
+    float fMax = 0.0f;
+    nAt = 0;
+    for (size_t i = 1; i < vecOutput.size(); ++i)
+    {
+        if (fabsf(vecOutput[i] - vecOutput[i - 1]) > fMax)
+        {
+            fMax = fabsf(vecOutput[i] - vecOutput[i - 1]);
+            nAt = i;
+        }
+    }
+    return fMax;
+}
+
+int main()
+{
+    CConcealStream objStream;
+    if (!objStream.Init())
+    {
+        CY_TEST_CHECK(false, "Init failed");
+        return CY_TEST_RESULT();
+    }
+
+    // a continuous stream is delivered as it is.
+    objStream.WritePackets(10);
+    objStream.Drain();
+    CY_TEST_CHECK(objStream.m_objLast.nDiscontinuityCount == 0 && !objStream.m_nDiscontinuityPeriods, "a continuous stream counted a discontinuity");
+
+    // a 10 ms gap is filled with as much silence.
+    objStream.Write(objStream.m_nNextStreamUs + 10000, g_nTestPacketFrames);
+    objStream.WritePackets(5);
+    objStream.Drain();
+    CY_TEST_CHECK(objStream.m_objLast.nDiscontinuityCount == 1 && objStream.m_objLast.nInsertedFrames == g_nTestPacketFrames && objStream.m_objLast.nDroppedFrames == 0,
+        "gap: %u discontinuities, %llu frames inserted, %llu dropped", objStream.m_objLast.nDiscontinuityCount,
+        (unsigned long long)objStream.m_objLast.nInsertedFrames, (unsigned long long)objStream.m_objLast.nDroppedFrames);
+
+    // a packet stamped 10 ms before the end of the last one loses those 10 ms off its front.
+    objStream.Write(objStream.m_nNextStreamUs - 10000, 2 * g_nTestPacketFrames);
+    objStream.WritePackets(5);
+    objStream.Drain();
+    CY_TEST_CHECK(objStream.m_objLast.nDiscontinuityCount == 2 && objStream.m_objLast.nDroppedFrames == g_nTestPacketFrames,
+        "overlap: %u discontinuities, %llu frames dropped", objStream.m_objLast.nDiscontinuityCount, (unsigned long long)objStream.m_objLast.nDroppedFrames);
+
+    // 105 ms more than the ring holds in one write, the tail that does not fit is dropped.
+    const uint32_t nOverrunFrames = 5040;
+    objStream.Write(objStream.m_nNextStreamUs, g_nTestRingFrames + nOverrunFrames);
+    objStream.Drain();
+    objStream.WritePackets(5);
+    objStream.Drain();
+    CY_TEST_CHECK(objStream.m_objLast.nDiscontinuityCount == 3 && objStream.m_objLast.nDroppedFrames == g_nTestPacketFrames + nOverrunFrames,
+        "overrun: %u discontinuities, %llu frames dropped", objStream.m_objLast.nDiscontinuityCount, (unsigned long long)objStream.m_objLast.nDroppedFrames);
+    CY_TEST_CHECK(objStream.m_nDiscontinuityPeriods == 3, "%u periods flagged for 3 discontinuities", objStream.m_nDiscontinuityPeriods);
+
+    // every frame written, inserted or dropped is accounted for.
+    const uint64_t nExpected = objStream.m_nWrittenFrames + objStream.m_objLast.nInsertedFrames - objStream.m_objLast.nDroppedFrames;
+    CY_TEST_CHECK(objStream.m_vecOutput.size() == nExpected, "%zu frames delivered, %llu expected", objStream.m_vecOutput.size(), (unsigned long long)nExpected);
+
+    // the fades leave no step larger than the tone itself takes.
+    size_t nAt = 0;
+    const float fMaxStep = GetMaxStep(objStream.m_vecOutput, nAt);
+    CY_TEST_CHECK(fMaxStep <= g_fMaxStep, "a step of %.4f at frame %zu, the tone steps %.4f", fMaxStep, nAt, g_fToneStep);
+    printf("%zu frames, largest step %.4f at frame %zu, the tone steps %.4f\n", objStream.m_vecOutput.size(), fMaxStep, nAt, g_fToneStep);
+
+    return CY_TEST_RESULT();
+}
\ No newline at end of file
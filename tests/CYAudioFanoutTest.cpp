@@ -0,0 +1,152 @@
+#include "CYTestDefine.hpp"
+#include "Capture/Synthetic/SyntheticAudioCaptrue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <math.h>
+#include <thread>
+
+using namespace CYDEVICE_NAMESPACE;
+
+// the subscriptions run this long on the synthetic 48 kHz stereo tone, one of them is dropped halfway.
+constexpr uint32_t g_nFanoutRunMs = 400;
+
+namespace
+{
+    /**
+     * Checks every period against the rate, layout and period its subscription asked for.
+     */
+    class CSubscriber : public ICYAudioDataCallBack
+    {
+    public:
+        CSubscriber(const char* pszName, uint32_t nSampleRate, uint32_t nChannels, ECYAudioSampleFormat eSampleFormat, bool bPlanar, uint32_t nMinFrames, uint32_t nMaxFrames)
+            : m_pszName(pszName), m_nSampleRate(nSampleRate), m_nChannels(nChannels), m_eSampleFormat(eSampleFormat), m_bPlanar(bPlanar),
+            m_nMinFrames(nMinFrames), m_nMaxFrames(nMaxFrames)
+        {
+        }
+
+        void OnAudioPeriod(const TAudioPeriod& objPeriod) override
+        {
+            m_nBadFormats += (objPeriod.nSampleRate != m_nSampleRate || objPeriod.nChannels != m_nChannels ||
+                objPeriod.eSampleFormat != m_eSampleFormat || objPeriod.bPlanar != m_bPlanar);
+            m_nBadLengths += (objPeriod.nFrames < m_nMinFrames || objPeriod.nFrames > m_nMaxFrames);
+            m_nBadPositions += (objPeriod.nFramePos != m_nFrames.load(std::memory_order_relaxed));
+
+            // full scale of the delivered format, the tone peaks at -20 dBFS in every one of them.
+            const size_t nSamples = size_t(objPeriod.nFrames) * objPeriod.nChannels;
+            if (objPeriod.eSampleFormat == TYPE_CYAUDIO_SAMPLE_S16)
+            {
+                for (size_t i = 0; i < nSamples; ++i)
+                    m_fPeak = MAX(m_fPeak, fabsf(static_cast<const int16_t*>(objPeriod.pData)[i] / 32768.0f));
+            }
+            else if (objPeriod.eSampleFormat == TYPE_CYAUDIO_SAMPLE_S32)
+            {
+                for (size_t i = 0; i < nSamples; ++i)
+                    m_fPeak = MAX(m_fPeak, fabsf(float(static_cast<const int32_t*>(objPeriod.pData)[i] / 2147483648.0)));
+            }
+            else
+            {
+                for (size_t i = 0; i < nSamples; ++i)
+                    m_fPeak = MAX(m_fPeak, fabsf(static_cast<const float*>(objPeriod.pData)[i]));
+            }
+            m_nFrames.fetch_add(objPeriod.nFrames, std::memory_order_relaxed);
+        }
+
+        void Check(uint32_t nRunMs, float fLevel) const
+        {
+            const uint64_t nFrames = m_nFrames.load(std::memory_order_relaxed);
+            const uint64_t nExpected = uint64_t(m_nSampleRate) * nRunMs / 1000;
+            CY_TEST_CHECK(nFrames >= nExpected * 3 / 4 && nFrames <= nExpected * 5 / 4, "%s: %llu frames delivered in %u ms, %llu expected",
+                m_pszName, (unsigned long long)nFrames, nRunMs, (unsigned long long)nExpected);
+            CY_TEST_CHECK(!m_nBadFormats, "%s: %u periods in another format", m_pszName, m_nBadFormats);
+            CY_TEST_CHECK(!m_nBadLengths, "%s: %u periods outside %u to %u frames", m_pszName, m_nBadLengths, m_nMinFrames, m_nMaxFrames);
+            CY_TEST_CHECK(!m_nBadPositions, "%s: %u periods do not follow on", m_pszName, m_nBadPositions);
+            CY_TEST_CHECK(fabsf(m_fPeak - fLevel) < fLevel * 0.1f, "%s: the tone peaks at %.4f, %.4f expected", m_pszName, m_fPeak, fLevel);
+            printf("%s: %llu frames in %u ms, peak %.4f\n", m_pszName, (unsigned long long)nFrames, nRunMs, m_fPeak);
+        }
+
+    public:
+        std::atomic<uint64_t> m_nFrames{ 0 };
+
+    private:
+        const char* m_pszName;
+        uint32_t m_nSampleRate;
+        uint32_t m_nChannels;
+        ECYAudioSampleFormat m_eSampleFormat;
+        bool m_bPlanar;
+        uint32_t m_nMinFrames;
+        uint32_t m_nMaxFrames;
+
+        uint32_t m_nBadFormats = 0;
+        uint32_t m_nBadLengths = 0;
+        uint32_t m_nBadPositions = 0;
+        float m_fPeak = 0.0f;
+    };
+
+    class CMainConsumer : public ICYAudioDataCallBack
+    {
+    public:
+        void OnAudioPeriod(const TAudioPeriod&) override {}
+    };
+}
+
+int main()
+{
+    CSyntheticAudioCaptrue objSource;
+    CY_TEST_CHECK(objSource.InitAudio(0, nullptr, nullptr, nullptr), "InitAudio failed");
+
+    // a voice path, 16 kHz mono S16 in 20 ms periods.
+    CSubscriber objVoice("voice", 16000, 1, TYPE_CYAUDIO_SAMPLE_S16, false, 320, 320);
+    TAudioSubscription objVoiceSubscription;
+    objVoiceSubscription.nSampleRate = 16000;
+    objVoiceSubscription.objConfig.eChannelLayout = TYPE_CYAUDIO_LAYOUT_MONO;
+    objVoiceSubscription.objConfig.eSampleFormat = TYPE_CYAUDIO_SAMPLE_S16;
+    objVoiceSubscription.objConfig.nPeriodUs = 20000;
+    objVoiceSubscription.pAudioDataCallBack = &objVoice;
+
+    // an encoder at the device rate, planar float in packets of 960 frames.
+    CSubscriber objEncoder("encoder", 48000, 2, TYPE_CYAUDIO_SAMPLE_F32, true, 960, 960);
+    TAudioSubscription objEncoderSubscription;
+    objEncoderSubscription.objConfig.bPlanar = true;
+    objEncoderSubscription.objConfig.nPeriodFrames = 960;
+    objEncoderSubscription.pAudioDataCallBack = &objEncoder;
+
+    // a recorder at 44.1 kHz S32 with 6 dB less gain, 5 ms periods alternate between 220 and 221 frames.
+    CSubscriber objRecorder("recorder", 44100, 2, TYPE_CYAUDIO_SAMPLE_S32, false, 220, 221);
+    TAudioSubscription objRecorderSubscription;
+    objRecorderSubscription.nSampleRate = 44100;
+    objRecorderSubscription.objConfig.eSampleFormat = TYPE_CYAUDIO_SAMPLE_S32;
+    objRecorderSubscription.objConfig.nPeriodUs = 5000;
+    objRecorderSubscription.objConfig.fGain = 0.5f;
+    objRecorderSubscription.pAudioDataCallBack = &objRecorder;
+
+    uint32_t nVoiceId = 0, nEncoderId = 0, nRecorderId = 0;
+    CY_TEST_CHECK(objSource.SubscribeAudio(objVoiceSubscription, nVoiceId) == CYERR_SUCESS, "voice: SubscribeAudio failed");
+    CY_TEST_CHECK(objSource.SubscribeAudio(objEncoderSubscription, nEncoderId) == CYERR_SUCESS, "encoder: SubscribeAudio failed");
+    CY_TEST_CHECK(nVoiceId != nEncoderId, "two subscriptions share the id %u", nVoiceId);
+
+    // a subscription needs a consumer.
+    TAudioSubscription objNoConsumer;
+    uint32_t nNoConsumerId = 0;
+    CY_TEST_CHECK(objSource.SubscribeAudio(objNoConsumer, nNoConsumerId) == CYERR_FAILED, "a subscription without a consumer was accepted");
+
+    CMainConsumer objMain;
+    CY_TEST_CHECK(objSource.Start(&objMain, nullptr) == CYERR_SUCESS, "Start failed");
+    std::this_thread::sleep_for(std::chrono::milliseconds(g_nFanoutRunMs / 2));
+
+    // joining while capturing starts right away, leaving stops the deliveries to that consumer only.
+    CY_TEST_CHECK(objSource.SubscribeAudio(objRecorderSubscription, nRecorderId) == CYERR_SUCESS, "recorder: SubscribeAudio failed");
+    CY_TEST_CHECK(objSource.UnsubscribeAudio(nVoiceId) == CYERR_SUCESS, "voice: UnsubscribeAudio failed");
+    CY_TEST_CHECK(objSource.UnsubscribeAudio(nVoiceId) == CYERR_FAILED, "voice: a second UnsubscribeAudio did not fail");
+    const uint64_t nVoiceFrames = objVoice.m_nFrames.load(std::memory_order_relaxed);
+    std::this_thread::sleep_for(std::chrono::milliseconds(g_nFanoutRunMs / 2));
+    objSource.Stop();
+
+    CY_TEST_CHECK(objVoice.m_nFrames.load(std::memory_order_relaxed) == nVoiceFrames, "voice: periods were delivered after UnsubscribeAudio");
+    objVoice.Check(g_nFanoutRunMs / 2, 0.1f);
+    objEncoder.Check(g_nFanoutRunMs, 0.1f);
+    objRecorder.Check(g_nFanoutRunMs / 2, 0.05f);
+
+    objSource.UnInit();
+    return CY_TEST_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "CYTestDefine.hpp"
+#include "Audio/CYAudioPipeline.hpp"
+
+#include <vector>
+
+using namespace CYDEVICE_NAMESPACE;
+
+// 48 kHz mono F32 in 10 ms periods, the gate at its default thresholds and hold.
+constexpr uint32_t g_nTestRate = 48000;
+constexpr uint32_t g_nTestPeriodFrames = 480;
+
+// constant levels, their RMS is the level itself. -50 dBFS lies between the close and open thresholds.
+constexpr float g_fTestLoud = 0.1f;                 // -20 dBFS
+constexpr float g_fTestBetween = 0.00316f;          // -50 dBFS
+
+struct TGateStep
+{
+    float fLevel;
+    uint32_t nPeriods;
+};
+
+// silence, speech, a pause the hysteresis keeps open, silence past the 300 ms hold, a level too low to
+// reopen and speech again.
+static const TGateStep g_arrTestSteps[] =
+{
+    { 0.0f, 10 },
+    { g_fTestLoud, 5 },
+    { g_fTestBetween, 20 },
+    { 0.0f, 40 },
+    { g_fTestBetween, 10 },
+    { g_fTestLoud, 5 },
+};
+
+// the gate opens at periods 10 and 85 and closes after the 31st silent period from 35, at 65.
+static bool IsOpenPeriod(uint32_t nPeriod)
+{
+    return (nPeriod >= 10 && nPeriod < 65) || nPeriod >= 85;
+}
+
+static void CheckGate(ECYAudioGateMode eGateMode)
+{
+    const bool bSkip = eGateMode == TYPE_CYAUDIO_GATE_SKIP;
+    const char* pszMode = bSkip ? "skip" : "flag";
+
+    TAudioSourceFormat objFormat;
+    objFormat.ePcmFormat = TYPE_PCM_F32;
+    objFormat.nChannels = 1;
+    objFormat.nSampleRate = g_nTestRate;
+    objFormat.nBlockAlign = sizeof(float);
+
+    TAudioConfig objConfig;
+    objConfig.eChannelLayout = TYPE_CYAUDIO_LAYOUT_MONO;
+    objConfig.eGateMode = eGateMode;
+
+    CYAudioPipeline objPipeline;
+    if (!objPipeline.Init(objFormat, 0, objConfig))
+    {
+        CY_TEST_CHECK(false, "%s: Init failed", pszMode);
+        return;
+    }
+
+    std::vector<float> vecPcm(g_nTestPeriodFrames);
+    uint32_t nPeriod = 0;
+    uint32_t nDelivered = 0;
+    uint32_t nBadStates = 0;
+    uint32_t nBadResumes = 0;
+    uint64_t nNextFramePos = 0;
+    for (const TGateStep& objStep : g_arrTestSteps)
+    {
+        vecPcm.assign(g_nTestPeriodFrames, objStep.fLevel);
+        for (uint32_t i = 0; i < objStep.nPeriods; ++i, ++nPeriod)
+        {
+            objPipeline.Write(vecPcm.data(), vecPcm.size() * sizeof(float));
+
+            TAudioPeriod objPeriod;
+            if (!objPipeline.GetNextBuffer(objPeriod))
+            {
+                // skipped periods never reach the consumer.
+                CY_TEST_CHECK(bSkip && !IsOpenPeriod(nPeriod), "%s: period %u was not delivered", pszMode, nPeriod);
+                continue;
+            }
+
+            const bool bOpen = IsOpenPeriod(nPeriod);
+            const bool bResume = bOpen && nPeriod && !IsOpenPeriod(nPeriod - 1);
+            CY_TEST_CHECK(objPeriod.nFramePos == uint64_t(nPeriod) * g_nTestPeriodFrames, "%s: period %u delivered at frame %llu",
+                pszMode, nPeriod, (unsigned long long)objPeriod.nFramePos);
+            nBadStates += (objPeriod.bSilent == bOpen);
+            nBadResumes += (objPeriod.bResume != bResume);
+
+            // the resumed period counts the frames skipped right before it, flagged periods are not skipped.
+            const uint64_t nGatedFrames = (bSkip && bResume) ? objPeriod.nFramePos - nNextFramePos : 0;
+            CY_TEST_CHECK(objPeriod.nGatedFrames == nGatedFrames, "%s: period %u follows %llu gated frames, %llu expected",
+                pszMode, nPeriod, (unsigned long long)objPeriod.nGatedFrames, (unsigned long long)nGatedFrames);
+
+            nNextFramePos = objPeriod.nFramePos + objPeriod.nFrames;
+            objPipeline.ReleasePeriod();
+            ++nDelivered;
+        }
+    }
+
+    uint32_t nOpenPeriods = 0;
+    for (uint32_t i = 0; i < nPeriod; ++i)
+        nOpenPeriods += IsOpenPeriod(i);
+    const uint32_t nExpected = bSkip ? nOpenPeriods : nPeriod;
+    CY_TEST_CHECK(nDelivered == nExpected, "%s: %u periods delivered, %u expected", pszMode, nDelivered, nExpected);
+    CY_TEST_CHECK(!nBadStates, "%s: %u periods with the wrong gate state", pszMode, nBadStates);
+    CY_TEST_CHECK(!nBadResumes, "%s: %u periods with the wrong resume marker", pszMode, nBadResumes);
+    printf("%s: %u of %u periods delivered, %u open\n", pszMode, nDelivered, nPeriod, nOpenPeriods);
+}
+
+int main()
+{
+    CheckGate(TYPE_CYAUDIO_GATE_FLAG);
+    CheckGate(TYPE_CYAUDIO_GATE_SKIP);
+    return CY_TEST_RESULT();
+}
\ No newline at end of file
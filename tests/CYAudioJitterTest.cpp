@@ -0,0 +1,171 @@
+#include "CYTestDefine.hpp"
+#include "Audio/CYAudioClock.hpp"
+#include "Audio/CYAudioJitter.hpp"
+#include "Audio/CYAudioPipeline.hpp"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace CYDEVICE_NAMESPACE;
+
+// 48 kHz mono F32 in 10 ms packets, a bursty device hands over g_nTestBurstPackets of them at once.
+constexpr uint32_t g_nTestRate = 48000;
+constexpr uint32_t g_nTestPacketFrames = 480;
+constexpr int64_t g_nTestPacketUs = 10000;
+constexpr uint32_t g_nTestBurstPackets = 4;
+constexpr uint32_t g_nTestBursts = 50;
+
+/**
+ * Feeds the delay arrivals nLateUs late every packet for nDurationUs, from nHostUs on. Returns the
+ * largest drop of the delay within one packet and updates nHostUs.
+ */
+static double FeedJitter(CYAudioJitter& objJitter, int64_t& nHostUs, int64_t nDurationUs, int64_t nLateUs)
+{
+    double dMaxDropUs = 0.0;
+    for (const int64_t nEndUs = nHostUs + nDurationUs; nHostUs < nEndUs; nHostUs += g_nTestPacketUs)
+    {
+        const double dDelayUs = objJitter.GetDelayUs();
+        objJitter.Update(nLateUs, nHostUs);
+        dMaxDropUs = MAX(dMaxDropUs, dDelayUs - objJitter.GetDelayUs());
+    }
+    return dMaxDropUs;
+}
+
+static void CheckAdaptation()
+{
+    TAudioConfig objConfig;
+    CYAudioJitter objJitter;
+    objJitter.Init(objConfig, 500000);
+
+    // steady arrivals keep the delay at their lateness and the margin.
+    int64_t nHostUs = 0;
+    FeedJitter(objJitter, nHostUs, 1000000, 2000);
+    CY_TEST_CHECK(objJitter.GetDelayUs() == 2000 + g_nAudioJitterMarginUs, "steady: delay %u us", objJitter.GetDelayUs());
+
+    // a late burst grows the delay at once.
+    objJitter.Update(60000, nHostUs);
+    nHostUs += g_nTestPacketUs;
+    CY_TEST_CHECK(objJitter.GetDelayUs() == 60000 + g_nAudioJitterMarginUs, "burst: delay %u us", objJitter.GetDelayUs());
+
+    // it is held while the burst is inside the window, then shrinks no faster than the release rate.
+    FeedJitter(objJitter, nHostUs, g_nAudioJitterWindowUs / 2, 2000);
+    CY_TEST_CHECK(objJitter.GetDelayUs() == 60000 + g_nAudioJitterMarginUs, "hold: delay %u us after %u ms", objJitter.GetDelayUs(), g_nAudioJitterWindowUs / 2000);
+    const double dMaxDropUs = FeedJitter(objJitter, nHostUs, 10000000, 2000);
+    CY_TEST_CHECK(dMaxDropUs <= g_nTestPacketUs * g_dAudioJitterReleaseRate + 1.0, "release: the delay dropped %.1f us in one packet", dMaxDropUs);
+    CY_TEST_CHECK(objJitter.GetDelayUs() == 2000 + g_nAudioJitterMarginUs, "release: delay %u us after the burst left", objJitter.GetDelayUs());
+
+    // the configured bounds hold the delay, the buffer limit caps the maximum.
+    objConfig.nJitterMinUs = 20000;
+    objConfig.nJitterMaxUs = 30000;
+    objJitter.Init(objConfig, 500000);
+    nHostUs = 0;
+    FeedJitter(objJitter, nHostUs, 1000000, 2000);
+    CY_TEST_CHECK(objJitter.GetDelayUs() == 20000, "bounds: delay %u us under the minimum", objJitter.GetDelayUs());
+    FeedJitter(objJitter, nHostUs, 1000000, 60000);
+    CY_TEST_CHECK(objJitter.GetDelayUs() == 30000, "bounds: delay %u us over the maximum", objJitter.GetDelayUs());
+    objJitter.Init(objConfig, 25000);
+    FeedJitter(objJitter, nHostUs, 1000000, 60000);
+    CY_TEST_CHECK(objJitter.GetDelayUs() == 25000, "bounds: delay %u us over the buffer limit", objJitter.GetDelayUs());
+}
+
+namespace
+{
+    class CPacingConsumer : public ICYAudioDataCallBack
+    {
+    public:
+        CPacingConsumer() { m_vecReleaseUs.reserve(g_nTestBursts * g_nTestBurstPackets + 16); }
+
+        void OnAudioPeriod(const TAudioPeriod& objPeriod) override
+        {
+            if (m_vecReleaseUs.size() < m_vecReleaseUs.capacity())
+                m_vecReleaseUs.push_back(GetHostTimeUs());
+            m_nDelayUs = objPeriod.nJitterDelayUs;
+            m_nUnderruns = objPeriod.nJitterUnderrunCount;
+        }
+
+    public:
+        std::vector<int64_t> m_vecReleaseUs;
+        uint32_t m_nDelayUs = 0;
+        uint32_t m_nUnderruns = 0;
+    };
+}
+
+/**
+ * Runs bursts of packets through a started pipeline and returns the share of periods delivered less
+ * than 3 ms after the previous one, once the first second has settled.
+ */
+static double MeasurePacing(bool bJitterBuffer, CPacingConsumer& objConsumer)
+{
+    TAudioSourceFormat objFormat;
+    objFormat.ePcmFormat = TYPE_PCM_F32;
+    objFormat.nChannels = 1;
+    objFormat.nSampleRate = g_nTestRate;
+    objFormat.nBlockAlign = sizeof(float);
+
+    TAudioConfig objConfig;
+    objConfig.eChannelLayout = TYPE_CYAUDIO_LAYOUT_MONO;
+    objConfig.bJitterBuffer = bJitterBuffer;
+
+    CYAudioPipeline objPipeline;
+    if (!objPipeline.Init(objFormat, 0, objConfig) || !objPipeline.Start(&objConsumer))
+    {
+        CY_TEST_CHECK(false, "%s: the pipeline did not start", bJitterBuffer ? "buffered" : "direct");
+        return 1.0;
+    }
+
+    // the packets are captured every 10 ms but arrive together with the last one of their burst.
+    std::vector<float> vecPcm(g_nTestPacketFrames, 0.0f);
+    const int64_t nStartUs = GetHostTimeUs();
+    uint64_t nFrames = 0;
+    for (uint32_t nBurst = 0; nBurst < g_nTestBursts; ++nBurst)
+    {
+        const int64_t nDueUs = nStartUs + g_nTestPacketUs * g_nTestBurstPackets * (nBurst + 1);
+        std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::microseconds(nDueUs)));
+        for (uint32_t i = 0; i < g_nTestBurstPackets; ++i)
+        {
+            objPipeline.Write(vecPcm.data(), vecPcm.size() * sizeof(float), nDueUs, int64_t(nFrames * 1000000 / g_nTestRate));
+            nFrames += g_nTestPacketFrames;
+        }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    objPipeline.Stop();
+
+    const std::vector<int64_t>& vecReleaseUs = objConsumer.m_vecReleaseUs;
+    uint32_t nIntervals = 0, nBunched = 0;
+    for (size_t i = 1; i < vecReleaseUs.size(); ++i)
+    {
+        if (vecReleaseUs[i] - nStartUs < 1000000)
+            continue;
+        ++nIntervals;
+        nBunched += (vecReleaseUs[i] - vecReleaseUs[i - 1] < 3000);
+    }
+    return nIntervals ? double(nBunched) / nIntervals : 1.0;
+}
+
+static void CheckPacing()
+{
+    // without the buffer the periods go out as the bursts arrive.
+    CPacingConsumer objDirect;
+    const double dDirectBunched = MeasurePacing(false, objDirect);
+    CY_TEST_CHECK(dDirectBunched > 0.5, "direct: %.0f%% of the periods delivered in bursts", dDirectBunched * 100.0);
+
+    // with it they are released on the device clock, delayed by about a burst.
+    CPacingConsumer objBuffered;
+    const double dBufferedBunched = MeasurePacing(true, objBuffered);
+    CY_TEST_CHECK(dBufferedBunched < 0.1, "buffered: %.0f%% of the periods delivered in bursts", dBufferedBunched * 100.0);
+    CY_TEST_CHECK(objBuffered.m_nDelayUs >= 20000 && objBuffered.m_nDelayUs <= 60000, "buffered: delay %u us for %lld ms bursts",
+        objBuffered.m_nDelayUs, (long long)(g_nTestPacketUs * g_nTestBurstPackets / 1000));
+    CY_TEST_CHECK(objBuffered.m_nUnderruns <= 2, "buffered: %u periods missed their release time", objBuffered.m_nUnderruns);
+    CY_TEST_CHECK(objBuffered.m_vecReleaseUs.size() + 1 >= g_nTestBursts * g_nTestBurstPackets, "buffered: %u periods of %u delivered",
+        uint32_t(objBuffered.m_vecReleaseUs.size()), g_nTestBursts * g_nTestBurstPackets);
+    printf("pacing: %.0f%% bunched direct, %.0f%% buffered, delay %u us, %u underruns\n", dDirectBunched * 100.0, dBufferedBunched * 100.0,
+        objBuffered.m_nDelayUs, objBuffered.m_nUnderruns);
+}
+
+int main()
+{
+    CheckAdaptation();
+    CheckPacing();
+    return CY_TEST_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,242 @@
+#include "CYTestDefine.hpp"
+#include "Audio/Simd/CYAudioKernels.hpp"
+
+#include <string.h>
+#include <vector>
+
+using namespace CYDEVICE_NAMESPACE;
+
+// samples per call, the SIMD kernels are also run on every short length and source offset for their tails.
+constexpr size_t g_nTestChunkSamples = 1 << 16;
+constexpr size_t g_nTestMaxTail = 67;
+
+static const char* GetLevelName(ECYSimdLevel eLevel)
+{
+    switch (eLevel)
+    {
+    case TYPE_SIMD_SSE2:
+        return "SSE2";
+    case TYPE_SIMD_AVX2:
+        return "AVX2";
+    case TYPE_SIMD_AVX512:
+        return "AVX512";
+    case TYPE_SIMD_NEON:
+        return "NEON";
+    default:
+        return "scalar";
+    }
+}
+
+// the same requirements GetAudioKernels applies when it picks the level of the host.
+static bool IsLevelSupported(ECYSimdLevel eLevel)
+{
+    const TCpuFeatures& objFeatures = GetCpuFeatures();
+    switch (eLevel)
+    {
+    case TYPE_SIMD_SSE2:
+        return objFeatures.bSSE2;
+    case TYPE_SIMD_AVX2:
+        return objFeatures.bAVX2 && objFeatures.bFMA;
+    case TYPE_SIMD_AVX512:
+        return objFeatures.bAVX512F && objFeatures.bAVX512BW && objFeatures.bFMA;
+    case TYPE_SIMD_NEON:
+        return objFeatures.bNEON;
+    default:
+        return true;
+    }
+}
+
+// nSamples samples of nBytes little endian bytes, counting up from nFirst so every code is covered.
+static void FillCounting(std::vector<uint8_t>& vecPcm, uint32_t nBytes, uint64_t nFirst, size_t nSamples)
+{
+    vecPcm.resize(nSamples * nBytes + 4);
+    for (size_t i = 0; i < nSamples; ++i)
+    {
+        for (uint32_t nByte = 0; nByte < nBytes; ++nByte)
+            vecPcm[i * nBytes + nByte] = uint8_t((nFirst + i) >> (8 * nByte));
+    }
+}
+
+// a wider format is covered by a spread of codes instead, its extremes included.
+static void FillSpread(std::vector<uint8_t>& vecPcm, uint32_t nBytes, uint32_t nSeed, size_t nSamples)
+{
+    vecPcm.resize(nSamples * nBytes + 4);
+    uint32_t nState = nSeed;
+    for (size_t i = 0; i < nSamples; ++i)
+    {
+        nState ^= nState << 13;
+        nState ^= nState >> 17;
+        nState ^= nState << 5;
+        const uint32_t nCode = (i < 4) ? uint32_t(0x80000000u + i - 2) : nState;
+        for (uint32_t nByte = 0; nByte < nBytes; ++nByte)
+            vecPcm[i * nBytes + nByte] = uint8_t(nCode >> (8 * nByte));
+    }
+}
+
+static bool CompareFloats(const float* pExpected, const float* pActual, size_t nSamples, size_t& nMismatch)
+{
+    // bitwise, so a -0.0 for 0.0 or a different NaN also fails.
+    if (!memcmp(pExpected, pActual, nSamples * sizeof(float)))
+        return true;
+    for (nMismatch = 0; nMismatch < nSamples && !memcmp(pExpected + nMismatch, pActual + nMismatch, sizeof(float)); ++nMismatch)
+        ;
+    return false;
+}
+
+static void CheckConversion(const char* pszFormat, PFN_PcmToFloat pfnReference, PFN_PcmToFloat pfnKernel, ECYSimdLevel eLevel,
+    const std::vector<uint8_t>& vecPcm, uint32_t nBytes, size_t nSamples)
+{
+    std::vector<float> vecExpected(nSamples);
+    std::vector<float> vecActual(nSamples);
+    size_t nMismatch = 0;
+
+    pfnReference(vecPcm.data(), vecExpected.data(), nSamples);
+    pfnKernel(vecPcm.data(), vecActual.data(), nSamples);
+    CY_TEST_CHECK(CompareFloats(vecExpected.data(), vecActual.data(), nSamples, nMismatch),
+        "%s %s sample %zu: %.9g instead of %.9g", GetLevelName(eLevel), pszFormat, nMismatch, vecActual[nMismatch], vecExpected[nMismatch]);
+
+    // short runs from every offset, so the tails and unaligned sources take each path once.
+    for (size_t nOffset = 0; nOffset < 4; ++nOffset)
+    {
+        for (size_t nCount = 0; nCount <= g_nTestMaxTail && nOffset + nCount <= nSamples; ++nCount)
+        {
+            const uint8_t* pSrc = vecPcm.data() + nOffset * nBytes;
+            float arrExpected[g_nTestMaxTail + 1];
+            float arrActual[g_nTestMaxTail + 1];
+            memset(arrActual, 0xA5, sizeof(arrActual));
+
+            pfnReference(pSrc, arrExpected, nCount);
+            pfnKernel(pSrc, arrActual, nCount);
+            CY_TEST_CHECK(CompareFloats(arrExpected, arrActual, nCount, nMismatch), "%s %s offset %zu count %zu sample %zu",
+                GetLevelName(eLevel), pszFormat, nOffset, nCount, nMismatch);
+            uint32_t nGuard = 0;
+            memcpy(&nGuard, arrActual + nCount, sizeof(nGuard));
+            CY_TEST_CHECK(nGuard == 0xA5A5A5A5u, "%s %s offset %zu count %zu wrote past the end",
+                GetLevelName(eLevel), pszFormat, nOffset, nCount);
+        }
+    }
+}
+
+static void CheckPcmToFloat(ECYSimdLevel eLevel)
+{
+    const TAudioKernels objReference = BuildAudioKernels(TYPE_SIMD_SCALAR);
+    const TAudioKernels objKernels = BuildAudioKernels(eLevel);
+    std::vector<uint8_t> vecPcm;
+
+    // every S8 and S16 code, every S24 code in chunks, and a spread of S32 codes.
+    FillCounting(vecPcm, 1, 0, 256);
+    CheckConversion("S8", objReference.pfnS8ToFloat, objKernels.pfnS8ToFloat, eLevel, vecPcm, 1, 256);
+    FillCounting(vecPcm, 2, 0, 65536);
+    CheckConversion("S16", objReference.pfnS16ToFloat, objKernels.pfnS16ToFloat, eLevel, vecPcm, 2, 65536);
+    for (uint64_t nFirst = 0; nFirst < (1u << 24); nFirst += g_nTestChunkSamples)
+    {
+        FillCounting(vecPcm, 3, nFirst, g_nTestChunkSamples);
+        CheckConversion("S24", objReference.pfnS24ToFloat, objKernels.pfnS24ToFloat, eLevel, vecPcm, 3, g_nTestChunkSamples);
+    }
+    for (uint32_t nSeed = 1; nSeed <= 16; ++nSeed)
+    {
+        FillSpread(vecPcm, 4, nSeed * 2654435761u, g_nTestChunkSamples);
+        CheckConversion("S32", objReference.pfnS32ToFloat, objKernels.pfnS32ToFloat, eLevel, vecPcm, 4, g_nTestChunkSamples);
+    }
+}
+
+// mono and stereo plans over nUsed of nInChannels, with distinct coefficients so a swapped channel shows.
+static TRemixPlan MakeFixedPlan(ECYRemixShape eShape, uint32_t nInChannels, uint32_t nUsed)
+{
+    TRemixPlan objPlan;
+    objPlan.eShape = eShape;
+    objPlan.nInChannels = nInChannels;
+    objPlan.nOutChannels = (eShape == TYPE_REMIX_MONO) ? 1 : 2;
+    objPlan.nUsedChannels = nUsed;
+    for (uint32_t nCol = 0; nCol < nUsed; ++nCol)
+    {
+        objPlan.arrUsedChannels[nCol] = (nInChannels - 1 - nCol * 2) % nInChannels;
+        for (uint32_t nOut = 0; nOut < objPlan.nOutChannels; ++nOut)
+            objPlan.arrCoeffs[nOut * g_nMaxRemixChannels + nCol] = 0.3f + 0.55f * float(nOut) - 0.21f * float(nCol);
+    }
+    return objPlan;
+}
+
+static void CheckFixedRemix(ECYSimdLevel eLevel)
+{
+    const TAudioKernels objReference = BuildAudioKernels(TYPE_SIMD_SCALAR);
+    const TAudioKernels objKernels = BuildAudioKernels(eLevel);
+    const uint32_t arrSampleBytes[g_nRemixPcmFormats] = { 1, 2, 3, 4, 4 };
+    const char* arrFormatNames[g_nRemixPcmFormats] = { "S8", "S16", "S24", "S32", "F32" };
+    std::vector<uint8_t> vecPcm;
+    std::vector<float> vecExpected;
+    std::vector<float> vecActual;
+    size_t nMismatch = 0;
+
+    for (uint32_t nFormat = 0; nFormat < g_nRemixPcmFormats; ++nFormat)
+    {
+        const uint32_t nBytes = arrSampleBytes[nFormat];
+        const size_t nMaxSamples = 1000 * 8;
+        FillSpread(vecPcm, nBytes, 0x9E3779B9u + nFormat, nMaxSamples);
+
+        // float input is kept in range, the integer codes are taken as they come.
+        if (nFormat == TYPE_PCM_F32 - TYPE_PCM_S8)
+        {
+            for (size_t i = 0; i < nMaxSamples; ++i)
+            {
+                const float fValue = float(int32_t(i % 401) - 200) / 200.0f;
+                memcpy(vecPcm.data() + i * 4, &fValue, sizeof(fValue));
+            }
+        }
+
+        for (ECYRemixShape eShape : { TYPE_REMIX_MONO, TYPE_REMIX_STEREO })
+        {
+            for (uint32_t nInChannels : { 1u, 2u, 3u, 6u, 8u })
+            {
+                for (uint32_t nUsed = 1; nUsed <= MIN(nInChannels, g_nMaxFixedRemixChannels); ++nUsed)
+                {
+                    const TRemixPlan objPlan = MakeFixedPlan(eShape, nInChannels, nUsed);
+                    const PFN_ConvertRemix pfnFixed = objKernels.arrConvertRemixFixed[nFormat][eShape - TYPE_REMIX_MONO][nUsed - 1];
+                    const PFN_ConvertRemix pfnGeneric = objKernels.arrConvertRemix[nFormat][eShape];
+                    const PFN_ConvertRemix pfnScalar = objReference.arrConvertRemixFixed[nFormat][eShape - TYPE_REMIX_MONO][nUsed - 1];
+
+                    for (size_t nFrames = 1; nFrames <= 1000; nFrames += (nFrames < g_nTestMaxTail) ? 1 : 311)
+                    {
+                        const size_t nSamples = nFrames * objPlan.nOutChannels;
+                        vecExpected.assign(nSamples, 0.0f);
+                        vecActual.assign(nSamples, 0.0f);
+
+                        // the fixed driver is the generic one of its level with the count unrolled, and both match scalar.
+                        pfnScalar(objPlan, vecPcm.data(), vecExpected.data(), nFrames);
+                        pfnFixed(objPlan, vecPcm.data(), vecActual.data(), nFrames);
+                        CY_TEST_CHECK(CompareFloats(vecExpected.data(), vecActual.data(), nSamples, nMismatch),
+                            "%s fixed %s %u in %u used %s frames %zu sample %zu: %.9g instead of %.9g", GetLevelName(eLevel), arrFormatNames[nFormat],
+                            nInChannels, nUsed, (eShape == TYPE_REMIX_MONO) ? "mono" : "stereo", nFrames, nMismatch, vecActual[nMismatch], vecExpected[nMismatch]);
+
+                        pfnGeneric(objPlan, vecPcm.data(), vecExpected.data(), nFrames);
+                        CY_TEST_CHECK(CompareFloats(vecExpected.data(), vecActual.data(), nSamples, nMismatch),
+                            "%s fixed %s %u in %u used %s frames %zu differs from the generic driver at sample %zu", GetLevelName(eLevel),
+                            arrFormatNames[nFormat], nInChannels, nUsed, (eShape == TYPE_REMIX_MONO) ? "mono" : "stereo", nFrames, nMismatch);
+                    }
+                }
+            }
+        }
+    }
+}
+
+int main()
+{
+    for (ECYSimdLevel eLevel : { TYPE_SIMD_SSE2, TYPE_SIMD_AVX2, TYPE_SIMD_AVX512, TYPE_SIMD_NEON })
+    {
+        if (!IsLevelSupported(eLevel))
+        {
+            printf("%s: not supported by this host, skipped\n", GetLevelName(eLevel));
+            continue;
+        }
+
+        const int nFailures = GetTestFailures();
+        CheckPcmToFloat(eLevel);
+        printf("%s: PCM to float %s\n", GetLevelName(eLevel), (GetTestFailures() == nFailures) ? "matches scalar" : "differs");
+
+        const int nRemixFailures = GetTestFailures();
+        CheckFixedRemix(eLevel);
+        printf("%s: fixed remix drivers %s\n", GetLevelName(eLevel), (GetTestFailures() == nRemixFailures) ? "match scalar" : "differ");
+    }
+
+    return CY_TEST_RESULT();
+}
\ No newline at end of file
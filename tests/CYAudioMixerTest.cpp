@@ -0,0 +1,247 @@
+#include "CYTestDefine.hpp"
+#include "Audio/CYAudioClock.hpp"
+#include "Audio/CYAudioFanout.hpp"
+#include "Audio/CYAudioMixer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <math.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace CYDEVICE_NAMESPACE;
+
+// mono F32 devices at 48 kHz writing 10 ms packets of a constant level, so every gain shows as the mean
+// of a mixed period and any step in the mix is a step of the gains.
+constexpr uint32_t g_nTestRate = 48000;
+constexpr uint32_t g_nTestPacketFrames = 480;
+
+// the two devices run this far off the host clock in opposite directions.
+constexpr double g_dTestSkewPpm = 300.0;
+
+// a period mean is this close to the gains once they settled, a fade moves the mix less per sample than
+// this, a cut to silence moves it by the whole level.
+constexpr float g_fLevelTolerance = 0.01f;
+constexpr float g_fMaxStep = 0.02f;
+
+namespace
+{
+    /**
+     * A device whose clock runs dSkewPpm fast against the host, the mixer only subscribes to it. A pause
+     * drops its audio, the stream time jumps over it as with a device that lost packets.
+     */
+    class CSkewedDevice : public ICYDevice
+    {
+    public:
+        ~CSkewedDevice() { StopCapture(); }
+
+        bool Open(float fLevel, double dSkewPpm)
+        {
+            TAudioSourceFormat objFormat;
+            objFormat.ePcmFormat = TYPE_PCM_F32;
+            objFormat.nChannels = 1;
+            objFormat.nSampleRate = g_nTestRate;
+            objFormat.nBlockAlign = sizeof(float);
+
+            m_vecPacket.assign(g_nTestPacketFrames, fLevel);
+            m_dSkewPpm = dSkewPpm;
+            return m_audioFanout.Init(objFormat, TAudioConfig());
+        }
+
+        void SetPaused(bool bPaused) { m_bPaused.store(bPaused, std::memory_order_relaxed); }
+
+        int16_t Init(int /*nWidth*/, int /*nHeight*/, int /*nFPS*/, const wchar_t* /*pszDeviceName*/, const wchar_t* /*pszDeviceId*/, int /*nSampleRateHz*/,
+            const wchar_t* /*pszAudioName*/, const wchar_t* /*pszAudioID*/, bool /*bUseRender*/, const TAudioConfig* /*pAudioConfig*/) override { return CYERR_FAILED; }
+        int16_t UnInit() override { StopCapture(); m_audioFanout.UnInit(); return CYERR_SUCESS; }
+        int16_t InitAudio(ECYAudioSource /*eSource*/, int /*nSampleRateHz*/, const wchar_t* /*pszAudioName*/, const wchar_t* /*pszAudioID*/, const TAudioConfig* /*pAudioConfig*/) override { return CYERR_FAILED; }
+        int16_t StartCapture(ICYAudioDataCallBack* /*pAudioDataCallBack*/, ICYVideoDataCallBack* /*pVideoDataCallBack*/) override
+        {
+            if (m_bRunning)
+                return CYERR_REPEAT_START_CAPTURE;
+            m_bRunning = true;
+            m_audioFanout.Start();
+            m_feedThread = std::thread(&CSkewedDevice::OnFeedEntry, this);
+            return CYERR_SUCESS;
+        }
+        int16_t StopCapture() override
+        {
+            if (!m_bRunning)
+                return CYEER_NOT_START_CAPTURE;
+            m_bRunning = false;
+            m_feedThread.join();
+            m_audioFanout.Stop();
+            return CYERR_SUCESS;
+        }
+        int16_t GetNextAudioBuffer(float*& /*pBuffer*/, uint32_t& /*nNumFrames*/, uint64_t& /*nTimestamp*/) override { return CYERR_FAILED; }
+        int16_t ReadAudio(void* /*pBuffer*/, uint32_t /*nNumFrames*/, uint32_t /*nTimeoutMs*/, uint32_t& /*nReadFrames*/, uint64_t& /*nTimestamp*/) override { return CYERR_FAILED; }
+        int16_t GetAudioLevels(TAudioLevels& /*objLevels*/) override { return CYERR_FAILED; }
+        int16_t GetAudioSchedulingStats(TAudioSchedulingStats& /*objStats*/) override { return CYERR_FAILED; }
+        int16_t SetAudioStages(const TAudioStage* /*pStages*/, uint32_t /*nStages*/) override { return CYERR_FAILED; }
+        int16_t SubscribeAudio(const TAudioSubscription& objSubscription, uint32_t& nSubscriptionId) override
+        {
+            return m_audioFanout.Subscribe(objSubscription, nSubscriptionId) ? CYERR_SUCESS : CYERR_FAILED;
+        }
+        int16_t UnsubscribeAudio(uint32_t nSubscriptionId) override { return m_audioFanout.Unsubscribe(nSubscriptionId) ? CYERR_SUCESS : CYERR_FAILED; }
+
+    private:
+        void OnFeedEntry()
+        {
+            // a fast device completes its packets that much sooner on the host clock. They are stamped with
+            // the time they were due rather than the wake-up, like a device stamps its capture time.
+            const int64_t nStartUs = GetHostTimeUs();
+            uint64_t nFrames = 0;
+            while (m_bRunning)
+            {
+                const int64_t nDueUs = nStartUs + int64_t(double(nFrames + g_nTestPacketFrames) * 1000000.0 / g_nTestRate / (1.0 + m_dSkewPpm * 1e-6));
+                std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::microseconds(nDueUs)));
+
+                const int64_t nStreamUs = int64_t(nFrames * 1000000 / g_nTestRate);
+                nFrames += g_nTestPacketFrames;
+                if (!m_bPaused.load(std::memory_order_relaxed))
+                    m_audioFanout.Write(m_vecPacket.data(), m_vecPacket.size() * sizeof(float), nDueUs, nStreamUs);
+            }
+        }
+
+    private:
+        CYAudioFanout m_audioFanout;
+        std::vector<float> m_vecPacket;
+        double m_dSkewPpm = 0.0;
+        std::atomic<bool> m_bRunning{ false };
+        std::atomic<bool> m_bPaused{ false };
+        std::thread m_feedThread;
+    };
+
+    class CMixConsumer : public ICYAudioDataCallBack
+    {
+    public:
+        void OnAudioPeriod(const TAudioPeriod& objPeriod) override
+        {
+            const float* pData = static_cast<const float*>(objPeriod.pData);
+            double arrSum[2] = {};
+            float fMaxStep = 0.0f;
+            for (uint32_t i = 0; i < objPeriod.nFrames; ++i)
+            {
+                for (uint32_t nChannel = 0; nChannel < 2; ++nChannel)
+                {
+                    const float fSample = pData[size_t(i) * 2 + nChannel];
+                    arrSum[nChannel] += fSample;
+                    if (m_bStarted)
+                        fMaxStep = MAX(fMaxStep, fabsf(fSample - m_arrLast[nChannel]));
+                    m_arrLast[nChannel] = fSample;
+                }
+                m_bStarted = true;
+            }
+
+            UniqueLock locker(m_mutex);
+            m_arrMean[0] = float(arrSum[0] / objPeriod.nFrames);
+            m_arrMean[1] = float(arrSum[1] / objPeriod.nFrames);
+            m_fMaxStep = MAX(m_fMaxStep, fMaxStep);
+            ++m_nPeriods;
+        }
+
+        void GetMean(float& fLeft, float& fRight)
+        {
+            UniqueLock locker(m_mutex);
+            fLeft = m_arrMean[0];
+            fRight = m_arrMean[1];
+        }
+
+        float GetMaxStep()
+        {
+            UniqueLock locker(m_mutex);
+            return m_fMaxStep;
+        }
+
+    private:
+        // mixing thread only, the last frame of the previous period.
+        bool m_bStarted = false;
+        float m_arrLast[2] = {};
+
+        std::mutex m_mutex;
+        float m_arrMean[2] = {};
+        float m_fMaxStep = 0.0f;
+        uint64_t m_nPeriods = 0;
+    };
+}
+
+static void CheckLevels(CMixConsumer& objConsumer, const char* pszName, float fLeft, float fRight)
+{
+    float fMeanLeft = 0.0f, fMeanRight = 0.0f;
+    objConsumer.GetMean(fMeanLeft, fMeanRight);
+    CY_TEST_CHECK(fabsf(fMeanLeft - fLeft) < g_fLevelTolerance && fabsf(fMeanRight - fRight) < g_fLevelTolerance,
+        "%s: the mix is %.4f / %.4f, %.4f / %.4f expected", pszName, fMeanLeft, fMeanRight, fLeft, fRight);
+}
+
+int main()
+{
+    TAudioMixerConfig objConfig;
+    CYAudioMixer objMixer;
+    CMixConsumer objConsumer;
+    CSkewedDevice objFast;
+    CSkewedDevice objSlow;
+    if (objMixer.Init(objConfig) != CYERR_SUCESS || !objFast.Open(0.5f, g_dTestSkewPpm) || !objSlow.Open(0.25f, -g_dTestSkewPpm))
+    {
+        CY_TEST_CHECK(false, "Init failed");
+        return CY_TEST_RESULT();
+    }
+
+    // panned hard to either side, the constant power law keeps the full level there.
+    TAudioMixerInput objFastInput;
+    objFastInput.fPan = -1.0f;
+    TAudioMixerInput objSlowInput;
+    objSlowInput.fPan = 1.0f;
+    uint32_t nFastId = 0, nSlowId = 0;
+    CY_TEST_CHECK(objMixer.AddInput(&objFast, objFastInput, nFastId) == CYERR_SUCESS && objMixer.AddInput(&objSlow, objSlowInput, nSlowId) == CYERR_SUCESS, "AddInput failed");
+
+    objFast.StartCapture(nullptr, nullptr);
+    objSlow.StartCapture(nullptr, nullptr);
+    CY_TEST_CHECK(objMixer.Start(&objConsumer) == CYERR_SUCESS, "Start failed");
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    CheckLevels(objConsumer, "pan", 0.5f, 0.25f);
+
+    // both devices are resampled onto the host clock, their skew shows as the drift of their input.
+    TAudioMixerInputStats objFastStats, objSlowStats;
+    objMixer.GetInputStats(nFastId, objFastStats);
+    objMixer.GetInputStats(nSlowId, objSlowStats);
+    CY_TEST_CHECK(fabs(objFastStats.dClockDriftPpm - g_dTestSkewPpm) < 100.0 && fabs(objSlowStats.dClockDriftPpm + g_dTestSkewPpm) < 100.0,
+        "drift: %.1f and %.1f ppm, +-%.0f expected", objFastStats.dClockDriftPpm, objSlowStats.dClockDriftPpm, g_dTestSkewPpm);
+    printf("drift %.1f and %.1f ppm\n", objFastStats.dClockDriftPpm, objSlowStats.dClockDriftPpm);
+
+    // gain and mute ramp to their new values within a period.
+    objSlowInput.fGain = 2.0f;
+    objMixer.SetInput(nSlowId, objSlowInput);
+    objFastInput.bMute = true;
+    objMixer.SetInput(nFastId, objFastInput);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    CheckLevels(objConsumer, "gain and mute", 0.0f, 0.5f);
+
+    objFastInput.bMute = false;
+    objFastInput.fPan = 0.0f;
+    objMixer.SetInput(nFastId, objFastInput);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    CheckLevels(objConsumer, "centre", 0.5f * 0.70710678f, 0.5f + 0.5f * 0.70710678f);
+
+    // a device that stops underruns its input, which fades out rather than cutting to silence.
+    objMixer.GetInputStats(nFastId, objFastStats);
+    const uint64_t nUnderruns = objFastStats.nUnderrunCount;
+    objFast.SetPaused(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    CheckLevels(objConsumer, "paused", 0.0f, 0.5f);
+    objFast.SetPaused(false);
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    CheckLevels(objConsumer, "resumed", 0.5f * 0.70710678f, 0.5f + 0.5f * 0.70710678f);
+
+    objMixer.GetInputStats(nFastId, objFastStats);
+    CY_TEST_CHECK(objFastStats.nUnderrunCount > nUnderruns, "the paused input did not underrun");
+    CY_TEST_CHECK(objConsumer.GetMaxStep() < g_fMaxStep, "the mix stepped by %.4f", objConsumer.GetMaxStep());
+    printf("%llu underruns, largest step %.5f\n", (unsigned long long)(objFastStats.nUnderrunCount - nUnderruns), objConsumer.GetMaxStep());
+
+    objMixer.Stop();
+    objFast.StopCapture();
+    objSlow.StopCapture();
+    objMixer.UnInit();
+    objFast.UnInit();
+    objSlow.UnInit();
+    return CY_TEST_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "CYTestDefine.hpp"
+#include "Audio/CYAudioNegotiate.hpp"
+#include "Audio/CYAudioConvert.hpp"
+
+#include <vector>
+
+using namespace CYDEVICE_NAMESPACE;
+
+namespace
+{
+    struct TNegotiateCase
+    {
+        const char* pszName = nullptr;
+        std::vector<TAudioCapability> vecCaps;
+        uint32_t nSampleRate = 0;
+        TAudioConfig objConfig;
+
+        // the expected choice.
+        uint32_t nCapability = 0;
+        ECYPcmFormat ePcmFormat = TYPE_PCM_UNKNOWN;
+        uint32_t nChannels = 0;
+        uint32_t nOutSampleRate = 0;
+    };
+}
+
+// a USB microphone, S16 at 44.1 or 48 kHz and an S24 range.
+static const std::vector<TAudioCapability> g_vecUsbCaps =
+{
+    { TYPE_PCM_S16, 1, 2, 1, 44100, 44100, 0 },
+    { TYPE_PCM_S16, 1, 2, 1, 48000, 48000, 0 },
+    { TYPE_PCM_S24, 2, 2, 1, 44100, 96000, 0 },
+};
+
+static TAudioConfig MakeConfig(ECYAudioChannelLayout eLayout, ECYAudioSampleFormat eSampleFormat = TYPE_CYAUDIO_SAMPLE_F32, bool bDriftCompensation = false)
+{
+    TAudioConfig objConfig;
+    objConfig.eChannelLayout = eLayout;
+    objConfig.eSampleFormat = eSampleFormat;
+    objConfig.bDriftCompensation = bDriftCompensation;
+    return objConfig;
+}
+
+static std::vector<TNegotiateCase> MakeCases()
+{
+    std::vector<TNegotiateCase> vecCases;
+    auto addCase = [&vecCases](const char* pszName, const std::vector<TAudioCapability>& vecCaps, uint32_t nSampleRate, const TAudioConfig& objConfig,
+        uint32_t nCapability, ECYPcmFormat ePcmFormat, uint32_t nChannels, uint32_t nOutSampleRate)
+    {
+        TNegotiateCase objCase;
+        objCase.pszName = pszName;
+        objCase.vecCaps = vecCaps;
+        objCase.nSampleRate = nSampleRate;
+        objCase.objConfig = objConfig;
+        objCase.nCapability = nCapability;
+        objCase.ePcmFormat = ePcmFormat;
+        objCase.nChannels = nChannels;
+        objCase.nOutSampleRate = nOutSampleRate;
+        vecCases.push_back(objCase);
+    };
+
+    // the requested rate and layout as S16 beats S24 of the same rate, it reads fewer bytes.
+    addCase("usb 48k stereo", g_vecUsbCaps, 48000, MakeConfig(TYPE_CYAUDIO_LAYOUT_STEREO), 1, TYPE_PCM_S16, 2, 48000);
+    addCase("usb 48k stereo s16 out", g_vecUsbCaps, 48000, MakeConfig(TYPE_CYAUDIO_LAYOUT_STEREO, TYPE_CYAUDIO_SAMPLE_S16), 1, TYPE_PCM_S16, 2, 48000);
+    addCase("usb 44.1k stereo", g_vecUsbCaps, 44100, MakeConfig(TYPE_CYAUDIO_LAYOUT_STEREO), 0, TYPE_PCM_S16, 2, 44100);
+
+    // mono is asked from the device instead of downmixed, 16k takes 48k through the decimator.
+    addCase("usb 48k mono", g_vecUsbCaps, 48000, MakeConfig(TYPE_CYAUDIO_LAYOUT_MONO), 1, TYPE_PCM_S16, 1, 48000);
+    addCase("usb 16k mono", g_vecUsbCaps, 16000, MakeConfig(TYPE_CYAUDIO_LAYOUT_MONO), 1, TYPE_PCM_S16, 1, 48000);
+
+    // only the S24 range reaches 96k, anything lower would lose audio.
+    addCase("usb 96k stereo", g_vecUsbCaps, 96000, MakeConfig(TYPE_CYAUDIO_LAYOUT_STEREO), 2, TYPE_PCM_S24, 2, 96000);
+    addCase("usb native 48k", g_vecUsbCaps, 48000, MakeConfig(TYPE_CYAUDIO_LAYOUT_NATIVE), 1, TYPE_PCM_S16, 2, 48000);
+    addCase("usb 48k drift", g_vecUsbCaps, 48000, MakeConfig(TYPE_CYAUDIO_LAYOUT_STEREO, TYPE_CYAUDIO_SAMPLE_F32, true), 1, TYPE_PCM_S16, 2, 48000);
+
+    // a continuous range is asked for exactly what is requested.
+    const std::vector<TAudioCapability> vecContinuous = { { TYPE_PCM_S16, 1, 8, 1, 8000, 192000, 1 } };
+    addCase("range 48k stereo", vecContinuous, 48000, MakeConfig(TYPE_CYAUDIO_LAYOUT_STEREO), 0, TYPE_PCM_S16, 2, 48000);
+    addCase("range 22.05k mono", vecContinuous, 22050, MakeConfig(TYPE_CYAUDIO_LAYOUT_MONO), 0, TYPE_PCM_S16, 1, 22050);
+
+    // a stepped range without 44.1k takes the next rate above it, not the one below.
+    const std::vector<TAudioCapability> vecGrid = { { TYPE_PCM_S16, 2, 2, 1, 8000, 48000, 4000 } };
+    addCase("grid 44.1k", vecGrid, 44100, MakeConfig(TYPE_CYAUDIO_LAYOUT_STEREO), 0, TYPE_PCM_S16, 2, 48000);
+
+    // twice the rate is decimated, a lower rate would lose audio whatever it costs.
+    const std::vector<TAudioCapability> vecHigh = { { TYPE_PCM_F32, 2, 2, 1, 96000, 96000, 0 }, { TYPE_PCM_S16, 2, 2, 1, 32000, 32000, 0 } };
+    addCase("high 48k", vecHigh, 48000, MakeConfig(TYPE_CYAUDIO_LAYOUT_STEREO), 0, TYPE_PCM_F32, 2, 96000);
+    const std::vector<TAudioCapability> vecMulti = { { TYPE_PCM_S16, 2, 2, 1, 44100, 44100, 0 }, { TYPE_PCM_S16, 2, 2, 1, 96000, 96000, 0 } };
+    addCase("44.1k or 96k for 48k", vecMulti, 48000, MakeConfig(TYPE_CYAUDIO_LAYOUT_STEREO), 1, TYPE_PCM_S16, 2, 96000);
+
+    // equal candidates keep the first capability, the one the device prefers.
+    const std::vector<TAudioCapability> vecSame = { { TYPE_PCM_S16, 2, 2, 1, 48000, 48000, 0 }, { TYPE_PCM_S16, 2, 2, 1, 48000, 48000, 0 } };
+    addCase("tie", vecSame, 48000, MakeConfig(TYPE_CYAUDIO_LAYOUT_STEREO), 0, TYPE_PCM_S16, 2, 48000);
+    return vecCases;
+}
+
+static void CheckCase(const TNegotiateCase& objCase)
+{
+    TAudioNegotiateTarget objTarget;
+    objTarget.Set(objCase.nSampleRate, objCase.objConfig);
+
+    TAudioNegotiateResult objResult;
+    const bool bSelected = CYAudioNegotiate::Select(objCase.vecCaps.data(), uint32_t(objCase.vecCaps.size()), objTarget, objResult);
+    CY_TEST_CHECK(bSelected, "%s: nothing selected", objCase.pszName);
+    if (!bSelected)
+        return;
+
+    const TAudioSourceFormat& objFormat = objResult.objFormat;
+    CY_TEST_CHECK(objResult.nCapability == objCase.nCapability && objFormat.ePcmFormat == objCase.ePcmFormat &&
+        objFormat.nChannels == objCase.nChannels && objFormat.nSampleRate == objCase.nOutSampleRate,
+        "%s: capability %u format %d %u ch %u Hz, expected capability %u format %d %u ch %u Hz", objCase.pszName,
+        objResult.nCapability, (int)objFormat.ePcmFormat, objFormat.nChannels, objFormat.nSampleRate,
+        objCase.nCapability, (int)objCase.ePcmFormat, objCase.nChannels, objCase.nOutSampleRate);
+    CY_TEST_CHECK(objFormat.nBlockAlign == objFormat.nChannels * GetPcmBytesPerSample(objFormat.ePcmFormat),
+        "%s: block align %u for %u channels", objCase.pszName, objFormat.nBlockAlign, objFormat.nChannels);
+
+    // the reported cost is the one EstimateCost gives the chosen format.
+    CY_TEST_CHECK(objResult.fCost == CYAudioNegotiate::EstimateCost(objFormat, objTarget), "%s: cost %.3f differs from EstimateCost", objCase.pszName, objResult.fCost);
+    printf("%-24s capability %u, format %d, %u ch, %u Hz, cost %.2f\n", objCase.pszName, objResult.nCapability, (int)objFormat.ePcmFormat,
+        objFormat.nChannels, objFormat.nSampleRate, objResult.fCost);
+}
+
+static void CheckNoCandidate()
+{
+    TAudioNegotiateTarget objTarget;
+    objTarget.Set(48000, TAudioConfig());
+    TAudioNegotiateResult objResult;
+
+    const TAudioCapability objUnknown = { TYPE_PCM_UNKNOWN, 2, 2, 1, 48000, 48000, 0 };
+    CY_TEST_CHECK(!CYAudioNegotiate::Select(&objUnknown, 1, objTarget, objResult), "a table without a known PCM format selected a format");
+    CY_TEST_CHECK(!CYAudioNegotiate::Select(nullptr, 0, objTarget, objResult), "an empty table selected a format");
+}
+
+static void CheckCostOrder()
+{
+    TAudioNegotiateTarget objTarget;
+    objTarget.Set(48000, TAudioConfig());
+
+    auto getCost = [&objTarget](ECYPcmFormat ePcmFormat, uint32_t nChannels, uint32_t nSampleRate)
+    {
+        TAudioSourceFormat objFormat;
+        objFormat.ePcmFormat = ePcmFormat;
+        objFormat.nChannels = nChannels;
+        objFormat.nSampleRate = nSampleRate;
+        objFormat.nBlockAlign = nChannels * GetPcmBytesPerSample(ePcmFormat);
+        return CYAudioNegotiate::EstimateCost(objFormat, objTarget);
+    };
+
+    // no conversion beats a resampler, and any processing beats losing audio.
+    const float fExact = getCost(TYPE_PCM_S16, 2, 48000);
+    const float fDecimated = getCost(TYPE_PCM_S16, 2, 96000);
+    const float fMono = getCost(TYPE_PCM_S16, 1, 48000);
+    const float fLowRate = getCost(TYPE_PCM_S16, 2, 44100);
+    CY_TEST_CHECK(fExact < fDecimated, "48k costs %.2f, 96k %.2f", fExact, fDecimated);
+    CY_TEST_CHECK(fDecimated < fMono && fDecimated < fLowRate, "96k costs %.2f, mono %.2f, 44.1k %.2f", fDecimated, fMono, fLowRate);
+}
+
+int main()
+{
+    for (const TNegotiateCase& objCase : MakeCases())
+        CheckCase(objCase);
+
+    CheckNoCandidate();
+    CheckCostOrder();
+    return CY_TEST_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,208 @@
+#include "CYTestDefine.hpp"
+#include "Audio/CYAudioConvert.hpp"
+#include "Audio/CYAudioPipeline.hpp"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace CYDEVICE_NAMESPACE;
+
+// 48 kHz stereo S16 device audio in 10 ms periods, a few periods are enough to cover every sample code.
+constexpr uint32_t g_nTestRate = 48000;
+constexpr uint32_t g_nTestChannels = 2;
+constexpr uint32_t g_nTestPeriodFrames = 480;
+constexpr uint32_t g_nTestPeriods = 4;
+
+static const char* GetFormatName(ECYAudioSampleFormat eFormat)
+{
+    switch (eFormat)
+    {
+    case TYPE_CYAUDIO_SAMPLE_S16:
+        return "S16";
+    case TYPE_CYAUDIO_SAMPLE_S32:
+        return "S32";
+    default:
+        return "F32";
+    }
+}
+
+static TAudioSourceFormat MakeSourceFormat(ECYPcmFormat ePcmFormat, uint32_t nChannels)
+{
+    TAudioSourceFormat objFormat;
+    objFormat.ePcmFormat = ePcmFormat;
+    objFormat.nChannels = nChannels;
+    objFormat.nSampleRate = g_nTestRate;
+    objFormat.nBlockAlign = nChannels * ((ePcmFormat == TYPE_PCM_S16) ? 2 : 4);
+    return objFormat;
+}
+
+// interleaved S16 frames with a different code in every sample, the extremes included.
+static std::vector<int16_t> MakeS16Frames(uint32_t nFrames)
+{
+    std::vector<int16_t> vecPcm(size_t(nFrames) * g_nTestChannels);
+    for (size_t i = 0; i < vecPcm.size(); ++i)
+        vecPcm[i] = int16_t(int32_t((i * 2731) % 65535) - 32767);
+    vecPcm[0] = -32768;
+    vecPcm[1] = 32767;
+    return vecPcm;
+}
+
+// sample nChannel of nFrame in a period of nFrames frames, as the layout places it.
+static size_t GetSampleIndex(bool bPlanar, uint32_t nChannels, uint32_t nFrames, uint32_t nFrame, uint32_t nChannel)
+{
+    return bPlanar ? size_t(nChannel) * nFrames + nFrame : size_t(nFrame) * nChannels + nChannel;
+}
+
+static void CheckOutputFormat(ECYAudioSampleFormat eFormat, bool bPlanar)
+{
+    const char* pszLayout = bPlanar ? "planar" : "interleaved";
+    TAudioConfig objConfig;
+    objConfig.eSampleFormat = eFormat;
+    objConfig.bPlanar = bPlanar;
+
+    CYAudioPipeline objPipeline;
+    if (!objPipeline.Init(MakeSourceFormat(TYPE_PCM_S16, g_nTestChannels), 0, objConfig))
+    {
+        CY_TEST_CHECK(false, "%s %s: Init failed", GetFormatName(eFormat), pszLayout);
+        return;
+    }
+
+    const std::vector<int16_t> vecPcm = MakeS16Frames(g_nTestPeriodFrames * g_nTestPeriods);
+    objPipeline.Write(vecPcm.data(), vecPcm.size() * sizeof(int16_t));
+
+    uint32_t nMismatches = 0;
+    uint32_t nPeriods = 0;
+    TAudioPeriod objPeriod;
+    for (; nPeriods < g_nTestPeriods && objPipeline.GetNextBuffer(objPeriod); ++nPeriods)
+    {
+        CY_TEST_CHECK(objPeriod.nFrames == g_nTestPeriodFrames && objPeriod.nChannels == g_nTestChannels && objPeriod.eSampleFormat == eFormat && objPeriod.bPlanar == bPlanar,
+            "%s %s: period of %u frames %u channels format %d planar %d", GetFormatName(eFormat), pszLayout, objPeriod.nFrames, objPeriod.nChannels, (int)objPeriod.eSampleFormat, (int)objPeriod.bPlanar);
+
+        for (uint32_t nFrame = 0; nFrame < objPeriod.nFrames; ++nFrame)
+        {
+            for (uint32_t nChannel = 0; nChannel < g_nTestChannels; ++nChannel)
+            {
+                const int16_t nIn = vecPcm[(size_t(nPeriods) * g_nTestPeriodFrames + nFrame) * g_nTestChannels + nChannel];
+                const float fIn = float(nIn) / 32767.0f;
+                const size_t nIndex = GetSampleIndex(bPlanar, g_nTestChannels, objPeriod.nFrames, nFrame, nChannel);
+
+                // S16 comes back bit exact without dither, S32 within the precision of a float sample and
+                // clipped at full scale, which -32768 is just beyond.
+                bool bMatch = false;
+                if (eFormat == TYPE_CYAUDIO_SAMPLE_S16)
+                    bMatch = static_cast<const int16_t*>(objPeriod.pData)[nIndex] == nIn;
+                else if (eFormat == TYPE_CYAUDIO_SAMPLE_S32)
+                    bMatch = llabs(static_cast<const int32_t*>(objPeriod.pData)[nIndex] - MAX(llrint(double(fIn) * 2147483647.0), -2147483648ll)) <= 256;
+                else
+                    bMatch = static_cast<const float*>(objPeriod.pData)[nIndex] == fIn;
+                nMismatches += !bMatch;
+            }
+        }
+        objPipeline.ReleasePeriod();
+    }
+
+    CY_TEST_CHECK(nPeriods == g_nTestPeriods, "%s %s: %u periods of %u delivered", GetFormatName(eFormat), pszLayout, nPeriods, g_nTestPeriods);
+    CY_TEST_CHECK(!nMismatches, "%s %s: %u samples differ from the device audio", GetFormatName(eFormat), pszLayout, nMismatches);
+}
+
+static void CheckDither()
+{
+    // planar S16 is converted from float, dither on moves samples by one LSB at most.
+    TAudioConfig objConfig;
+    objConfig.eSampleFormat = TYPE_CYAUDIO_SAMPLE_S16;
+    objConfig.bPlanar = true;
+    objConfig.bDither = true;
+
+    CYAudioPipeline objPipeline;
+    CY_TEST_CHECK(objPipeline.Init(MakeSourceFormat(TYPE_PCM_S16, g_nTestChannels), 0, objConfig), "dither: Init failed");
+    const std::vector<int16_t> vecPcm = MakeS16Frames(g_nTestPeriodFrames);
+    objPipeline.Write(vecPcm.data(), vecPcm.size() * sizeof(int16_t));
+
+    TAudioPeriod objPeriod;
+    if (!objPipeline.GetNextBuffer(objPeriod))
+    {
+        CY_TEST_CHECK(false, "dither: no period delivered");
+        return;
+    }
+
+    uint32_t nChanged = 0;
+    int32_t nMaxError = 0;
+    for (uint32_t nFrame = 0; nFrame < objPeriod.nFrames; ++nFrame)
+    {
+        for (uint32_t nChannel = 0; nChannel < g_nTestChannels; ++nChannel)
+        {
+            const int32_t nOut = static_cast<const int16_t*>(objPeriod.pData)[GetSampleIndex(true, g_nTestChannels, objPeriod.nFrames, nFrame, nChannel)];
+            const int32_t nError = abs(nOut - vecPcm[size_t(nFrame) * g_nTestChannels + nChannel]);
+            nChanged += (nError != 0);
+            nMaxError = MAX(nMaxError, nError);
+        }
+    }
+    CY_TEST_CHECK(nChanged > 0 && nMaxError <= 1, "dither: %u samples changed, by %d at most", nChanged, nMaxError);
+}
+
+static void CheckPassthrough(const char* pszName, const TAudioSourceFormat& objFormat, uint32_t nOutSampleRate, const TAudioConfig& objConfig, bool bExpected)
+{
+    CYAudioPipeline objPipeline;
+    CY_TEST_CHECK(objPipeline.Init(objFormat, nOutSampleRate, objConfig), "%s: Init failed", pszName);
+    CY_TEST_CHECK(objPipeline.IsPassthrough() == bExpected, "%s: passthrough is %d", pszName, (int)objPipeline.IsPassthrough());
+}
+
+static void CheckPassthroughDecision()
+{
+    const TAudioSourceFormat objS16 = MakeSourceFormat(TYPE_PCM_S16, 2);
+    const TAudioSourceFormat objS16Mono = MakeSourceFormat(TYPE_PCM_S16, 1);
+    const TAudioSourceFormat objF32 = MakeSourceFormat(TYPE_PCM_F32, 2);
+
+    TAudioConfig objS16Out;
+    objS16Out.eSampleFormat = TYPE_CYAUDIO_SAMPLE_S16;
+    CheckPassthrough("S16 to S16", objS16, 0, objS16Out, true);
+    CheckPassthrough("S16 to S16 at 16 kHz", objS16, 16000, objS16Out, false);
+
+    TAudioConfig objF32Out;
+    CheckPassthrough("F32 to F32", objF32, 0, objF32Out, true);
+    CheckPassthrough("S16 to F32", objS16, 0, objF32Out, false);
+
+    // one plane is laid out like interleaved mono, two are not.
+    TAudioConfig objPlanar = objS16Out;
+    objPlanar.bPlanar = true;
+    objPlanar.eChannelLayout = TYPE_CYAUDIO_LAYOUT_MONO;
+    CheckPassthrough("S16 mono to planar S16", objS16Mono, 0, objPlanar, true);
+    objPlanar.eChannelLayout = TYPE_CYAUDIO_LAYOUT_STEREO;
+    CheckPassthrough("S16 to planar S16", objS16, 0, objPlanar, false);
+
+    TAudioConfig objGain = objS16Out;
+    objGain.fGain = 0.5f;
+    CheckPassthrough("S16 to S16 with gain", objS16, 0, objGain, false);
+
+    TAudioConfig objMono = objS16Out;
+    objMono.eChannelLayout = TYPE_CYAUDIO_LAYOUT_MONO;
+    CheckPassthrough("S16 stereo to S16 mono", objS16, 0, objMono, false);
+
+    TAudioConfig objDrift = objF32Out;
+    objDrift.bDriftCompensation = true;
+    objDrift.eResampleQuality = TYPE_CYAUDIO_RESAMPLE_SINC_FASTEST;
+    CheckPassthrough("F32 to F32 with drift compensation", objF32, 0, objDrift, false);
+
+    // the passthrough period is the device audio byte for byte.
+    CYAudioPipeline objPipeline;
+    CY_TEST_CHECK(objPipeline.Init(objS16, 0, objS16Out), "passthrough: Init failed");
+    const std::vector<int16_t> vecPcm = MakeS16Frames(g_nTestPeriodFrames);
+    objPipeline.Write(vecPcm.data(), vecPcm.size() * sizeof(int16_t));
+    TAudioPeriod objPeriod;
+    CY_TEST_CHECK(objPipeline.GetNextBuffer(objPeriod) && objPeriod.nFrames == g_nTestPeriodFrames
+        && !memcmp(objPeriod.pData, vecPcm.data(), vecPcm.size() * sizeof(int16_t)), "passthrough: the period differs from the device audio");
+}
+
+int main()
+{
+    for (ECYAudioSampleFormat eFormat : { TYPE_CYAUDIO_SAMPLE_S16, TYPE_CYAUDIO_SAMPLE_S32, TYPE_CYAUDIO_SAMPLE_F32 })
+    {
+        CheckOutputFormat(eFormat, false);
+        CheckOutputFormat(eFormat, true);
+    }
+    CheckDither();
+    CheckPassthroughDecision();
+    return CY_TEST_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "CYTestDefine.hpp"
+#include "Audio/CYAudioPipeline.hpp"
+
+#include <math.h>
+#include <vector>
+
+using namespace CYDEVICE_NAMESPACE;
+
+// two seconds of stereo F32 in 10 ms device packets, the host clock runs exactly with the device.
+constexpr uint32_t g_nTestChannels = 2;
+constexpr uint32_t g_nTestSeconds = 2;
+constexpr uint32_t g_nTestOutRate = 48000;
+
+// a packet may start this far from the time of its frame position, the clock loop settles first.
+constexpr int64_t g_nMaxStampErrorUs = 50;
+constexpr uint32_t g_nSettlePackets = 25;
+
+static void CheckPackets(uint32_t nDeviceRate, uint32_t nPacketFrames)
+{
+    TAudioSourceFormat objFormat;
+    objFormat.ePcmFormat = TYPE_PCM_F32;
+    objFormat.nChannels = g_nTestChannels;
+    objFormat.nSampleRate = nDeviceRate;
+    objFormat.nBlockAlign = g_nTestChannels * sizeof(float);
+
+    TAudioConfig objConfig;
+    objConfig.nPeriodFrames = nPacketFrames;
+
+    CYAudioPipeline objPipeline;
+    if (!objPipeline.Init(objFormat, g_nTestOutRate, objConfig))
+    {
+        CY_TEST_CHECK(false, "%u Hz, %u frames: Init failed", nDeviceRate, nPacketFrames);
+        return;
+    }
+
+    const uint32_t nDevicePacket = nDeviceRate / 100;
+    std::vector<float> vecPcm(size_t(nDevicePacket) * g_nTestChannels);
+    uint64_t nDeviceFrames = 0;
+    uint32_t nPackets = 0;
+    uint32_t nBadLengths = 0;
+    uint32_t nBadPositions = 0;
+    int64_t nMaxStampError = 0;
+    for (uint32_t nWrite = 0; nWrite < 100 * g_nTestSeconds; ++nWrite)
+    {
+        for (uint32_t i = 0; i < nDevicePacket; ++i)
+        {
+            const double dPhase = 2.0 * 3.14159265358979323846 * 440.0 * double(nDeviceFrames + i) / nDeviceRate;
+            vecPcm[size_t(i) * g_nTestChannels] = float(0.5 * sin(dPhase));
+            vecPcm[size_t(i) * g_nTestChannels + 1] = float(0.5 * cos(dPhase));
+        }
+
+        // stamped with the time of the first frame, arriving when the last one was captured.
+        const int64_t nStreamUs = int64_t(nDeviceFrames * 1000000 / nDeviceRate);
+        nDeviceFrames += nDevicePacket;
+        const int64_t nHostUs = int64_t(nDeviceFrames * 1000000 / nDeviceRate) + 1000000;
+        objPipeline.Write(vecPcm.data(), vecPcm.size() * sizeof(float), nHostUs, nStreamUs);
+
+        TAudioPeriod objPeriod;
+        while (objPipeline.GetNextBuffer(objPeriod))
+        {
+            nBadLengths += (objPeriod.nFrames != nPacketFrames || objPeriod.nSampleRate != g_nTestOutRate);
+            nBadPositions += (objPeriod.nFramePos != uint64_t(nPackets) * nPacketFrames);
+
+            // the stamp is the host time of the first frame, which the frame position gives at the output rate.
+            if (nPackets >= g_nSettlePackets)
+            {
+                const int64_t nExpectedUs = int64_t(objPeriod.nFramePos * 1000000 / g_nTestOutRate);
+                const int64_t nError = llabs(int64_t(objPeriod.nTimeStampUs) - nExpectedUs);
+                nMaxStampError = MAX(nMaxStampError, nError);
+                CY_TEST_CHECK(objPeriod.nTimeStamp == objPeriod.nTimeStampUs / 1000, "%u Hz, %u frames: the millisecond stamp differs", nDeviceRate, nPacketFrames);
+            }
+            objPipeline.ReleasePeriod();
+            ++nPackets;
+        }
+    }
+
+    // every packet the written audio completes is delivered, the resampler may still hold a few frames.
+    const uint64_t nOutFrames = nDeviceFrames * g_nTestOutRate / nDeviceRate;
+    const uint32_t nExpected = uint32_t(nOutFrames / nPacketFrames);
+    CY_TEST_CHECK(nPackets + 1 >= nExpected && nPackets <= nExpected, "%u Hz, %u frames: %u packets of %u", nDeviceRate, nPacketFrames, nPackets, nExpected);
+    CY_TEST_CHECK(!nBadLengths, "%u Hz, %u frames: %u packets of another length or rate", nDeviceRate, nPacketFrames, nBadLengths);
+    CY_TEST_CHECK(!nBadPositions, "%u Hz, %u frames: %u packets at a frame position that does not follow on", nDeviceRate, nPacketFrames, nBadPositions);
+    CY_TEST_CHECK(nMaxStampError <= g_nMaxStampErrorUs, "%u Hz, %u frames: a stamp %lld us off its frame position", nDeviceRate, nPacketFrames, (long long)nMaxStampError);
+    printf("%u Hz, %u frames: %u packets, stamps within %lld us\n", nDeviceRate, nPacketFrames, nPackets, (long long)nMaxStampError);
+}
+
+int main()
+{
+    // at the device rate the packets are cut from the ring, resampled ones are collected first.
+    for (uint32_t nDeviceRate : { g_nTestOutRate, 44100u })
+    {
+        for (uint32_t nPacketFrames : { 960u, 1024u, 320u })
+            CheckPackets(nDeviceRate, nPacketFrames);
+    }
+    return CY_TEST_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "CYTestDefine.hpp"
+#include "Audio/CYAudioPipeline.hpp"
+
+#include <chrono>
+#include <vector>
+
+using namespace CYDEVICE_NAMESPACE;
+
+// 48 kHz stereo S16 device audio in 10 ms periods.
+constexpr uint32_t g_nTestRate = 48000;
+constexpr uint32_t g_nTestChannels = 2;
+constexpr uint32_t g_nTestPeriodFrames = 480;
+
+// device sample nChannel of nFrame, unique over the frames a test writes.
+static int16_t GetTestSample(uint32_t nFrame, uint32_t nChannel)
+{
+    return int16_t((nFrame * g_nTestChannels + nChannel) % 30000);
+}
+
+static bool InitPipeline(CYAudioPipeline& objPipeline, bool bPlanar)
+{
+    TAudioSourceFormat objFormat;
+    objFormat.ePcmFormat = TYPE_PCM_S16;
+    objFormat.nChannels = g_nTestChannels;
+    objFormat.nSampleRate = g_nTestRate;
+    objFormat.nBlockAlign = g_nTestChannels * sizeof(int16_t);
+
+    TAudioConfig objConfig;
+    objConfig.eSampleFormat = TYPE_CYAUDIO_SAMPLE_S16;
+    objConfig.bPlanar = bPlanar;
+    return objPipeline.Init(objFormat, 0, objConfig);
+}
+
+static void WriteFrames(CYAudioPipeline& objPipeline, uint32_t nFirst, uint32_t nFrames)
+{
+    std::vector<int16_t> vecPcm(size_t(nFrames) * g_nTestChannels);
+    for (uint32_t i = 0; i < nFrames; ++i)
+    {
+        for (uint32_t nChannel = 0; nChannel < g_nTestChannels; ++nChannel)
+            vecPcm[size_t(i) * g_nTestChannels + nChannel] = GetTestSample(nFirst + i, nChannel);
+    }
+    objPipeline.Write(vecPcm.data(), vecPcm.size() * sizeof(int16_t));
+}
+
+static int64_t GetElapsedMs(std::chrono::steady_clock::time_point tpStart)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - tpStart).count();
+}
+
+static void CheckTimeouts()
+{
+    CYAudioPipeline objPipeline;
+    CY_TEST_CHECK(InitPipeline(objPipeline, false), "Init failed");
+    std::vector<int16_t> vecBuffer(size_t(4096) * g_nTestChannels);
+    uint32_t nReadFrames = 0;
+    uint64_t nTimeStamp = 0;
+
+    // the wait would only end on Stop, so there is nothing to read from before Start.
+    WriteFrames(objPipeline, 0, g_nTestPeriodFrames);
+    CY_TEST_CHECK(!objPipeline.Read(vecBuffer.data(), 100, 1000, nReadFrames, nTimeStamp) && !nReadFrames, "Read before Start did not fail");
+
+    CY_TEST_CHECK(objPipeline.Start(nullptr), "Start failed");
+    objPipeline.Flush();
+
+    // timeout 0 returns what is ready at once, here nothing.
+    auto tpStart = std::chrono::steady_clock::now();
+    CY_TEST_CHECK(objPipeline.Read(vecBuffer.data(), 100, 0, nReadFrames, nTimeStamp) && !nReadFrames, "timeout 0: %u frames read from an empty pipeline", nReadFrames);
+    CY_TEST_CHECK(GetElapsedMs(tpStart) < 20, "timeout 0: returned after %lld ms", (long long)GetElapsedMs(tpStart));
+
+    // a timeout returns the frames read so far, a period and a half in the ring is one period.
+    WriteFrames(objPipeline, 0, g_nTestPeriodFrames * 3 / 2);
+    tpStart = std::chrono::steady_clock::now();
+    CY_TEST_CHECK(objPipeline.Read(vecBuffer.data(), 1000, 50, nReadFrames, nTimeStamp), "timeout: Read failed");
+    const int64_t nElapsedMs = GetElapsedMs(tpStart);
+    CY_TEST_CHECK(nReadFrames == g_nTestPeriodFrames, "timeout: %u frames read, %u were complete", nReadFrames, g_nTestPeriodFrames);
+    CY_TEST_CHECK(nElapsedMs >= 45 && nElapsedMs < 1000, "timeout: returned after %lld ms of 50", (long long)nElapsedMs);
+
+    // Stop ends the capture, Read fails again.
+    objPipeline.Stop();
+    CY_TEST_CHECK(!objPipeline.Read(vecBuffer.data(), 100, 0, nReadFrames, nTimeStamp), "Read after Stop did not fail");
+}
+
+// reads in chunks that cross period boundaries, every frame must arrive once and in order.
+static void CheckCopies(bool bPlanar)
+{
+    const char* pszLayout = bPlanar ? "planar" : "interleaved";
+    CYAudioPipeline objPipeline;
+    CY_TEST_CHECK(InitPipeline(objPipeline, bPlanar), "%s: Init failed", pszLayout);
+    CY_TEST_CHECK(objPipeline.Start(nullptr), "%s: Start failed", pszLayout);
+
+    const uint32_t nPeriods = 12;
+    WriteFrames(objPipeline, 0, g_nTestPeriodFrames * nPeriods);
+
+    // 1000 frames take two whole periods straight into the buffer and split the third, the smaller
+    // reads then come out of the split period and the ones after it.
+    static const uint32_t arrChunks[] = { 1000, 200, 240, 1, 479, 1500, 100, 2240 };
+    std::vector<int16_t> vecBuffer;
+    uint32_t nFramePos = 0;
+    uint32_t nMismatches = 0;
+    for (uint32_t nChunk : arrChunks)
+    {
+        // the buffer is poisoned so a frame that was not written is noticed.
+        vecBuffer.assign(size_t(nChunk) * g_nTestChannels, int16_t(-1));
+        uint32_t nReadFrames = 0;
+        uint64_t nTimeStamp = 0;
+        CY_TEST_CHECK(objPipeline.Read(vecBuffer.data(), nChunk, 0, nReadFrames, nTimeStamp), "%s: Read failed", pszLayout);
+        CY_TEST_CHECK(nReadFrames == nChunk, "%s: %u frames read of %u", pszLayout, nReadFrames, nChunk);
+
+        // planar output is written as planes of the requested frame count.
+        for (uint32_t i = 0; i < nReadFrames; ++i)
+        {
+            for (uint32_t nChannel = 0; nChannel < g_nTestChannels; ++nChannel)
+            {
+                const size_t nIndex = bPlanar ? size_t(nChannel) * nChunk + i : size_t(i) * g_nTestChannels + nChannel;
+                nMismatches += (vecBuffer[nIndex] != GetTestSample(nFramePos + i, nChannel));
+            }
+        }
+        nFramePos += nReadFrames;
+    }
+
+    CY_TEST_CHECK(nFramePos == g_nTestPeriodFrames * nPeriods, "%s: %u frames read of %u", pszLayout, nFramePos, g_nTestPeriodFrames * nPeriods);
+    CY_TEST_CHECK(!nMismatches, "%s: %u samples differ from the device audio", pszLayout, nMismatches);
+    objPipeline.Stop();
+}
+
+int main()
+{
+    CheckTimeouts();
+    CheckCopies(false);
+    CheckCopies(true);
+    return CY_TEST_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "CYTestDefine.hpp"
+#include "Audio/CYAudioPipeline.hpp"
+
+#include <math.h>
+#include <vector>
+
+using namespace CYDEVICE_NAMESPACE;
+
+// 48 kHz F32 device audio, one 10 ms period is enough to read the whole matrix off it.
+constexpr uint32_t g_nTestRate = 48000;
+constexpr uint32_t g_nTestPeriodFrames = 480;
+constexpr float g_fTestLevel = 0.5f;
+constexpr float g_fTestTolerance = 1e-5f;
+
+// the downmix levels of the speaker folds.
+constexpr float g_fTestMinus3 = 0.70710678f;
+constexpr float g_fTestMinus6 = 0.5f;
+
+/**
+ * Frame k carries g_fTestLevel on channel k % nInChannels only, so output frame k is column k of the
+ * matrix the pipeline remixes with. Returns the delivered matrix, nOutChannels rows of nInChannels.
+ */
+static std::vector<float> MeasureMatrix(const char* pszName, uint32_t nInChannels, uint32_t nChannelMask, const TAudioConfig& objConfig, uint32_t nOutChannels)
+{
+    TAudioSourceFormat objFormat;
+    objFormat.ePcmFormat = TYPE_PCM_F32;
+    objFormat.nChannels = nInChannels;
+    objFormat.nChannelMask = nChannelMask;
+    objFormat.nSampleRate = g_nTestRate;
+    objFormat.nBlockAlign = nInChannels * sizeof(float);
+
+    std::vector<float> vecMatrix(size_t(nOutChannels) * nInChannels, -1.0f);
+    CYAudioPipeline objPipeline;
+    if (!objPipeline.Init(objFormat, 0, objConfig))
+    {
+        CY_TEST_CHECK(false, "%s: Init failed", pszName);
+        return vecMatrix;
+    }
+
+    std::vector<float> vecPcm(size_t(g_nTestPeriodFrames) * nInChannels, 0.0f);
+    for (uint32_t i = 0; i < g_nTestPeriodFrames; ++i)
+        vecPcm[size_t(i) * nInChannels + i % nInChannels] = g_fTestLevel;
+    objPipeline.Write(vecPcm.data(), vecPcm.size() * sizeof(float));
+
+    TAudioPeriod objPeriod;
+    if (!objPipeline.GetNextBuffer(objPeriod) || objPeriod.nChannels != nOutChannels)
+    {
+        CY_TEST_CHECK(false, "%s: no period of %u channels delivered", pszName, nOutChannels);
+        return vecMatrix;
+    }
+
+    const float* pData = static_cast<const float*>(objPeriod.pData);
+    for (uint32_t nIn = 0; nIn < nInChannels; ++nIn)
+    {
+        for (uint32_t nOut = 0; nOut < nOutChannels; ++nOut)
+            vecMatrix[size_t(nOut) * nInChannels + nIn] = pData[size_t(nIn) * nOutChannels + nOut] / g_fTestLevel;
+    }
+    return vecMatrix;
+}
+
+static void CheckMatrix(const char* pszName, uint32_t nInChannels, uint32_t nChannelMask, const TAudioConfig& objConfig, uint32_t nOutChannels, const std::vector<float>& vecExpected)
+{
+    const std::vector<float> vecMatrix = MeasureMatrix(pszName, nInChannels, nChannelMask, objConfig, nOutChannels);
+    for (uint32_t nOut = 0; nOut < nOutChannels; ++nOut)
+    {
+        for (uint32_t nIn = 0; nIn < nInChannels; ++nIn)
+        {
+            const size_t nIndex = size_t(nOut) * nInChannels + nIn;
+            CY_TEST_CHECK(fabsf(vecMatrix[nIndex] - vecExpected[nIndex]) < g_fTestTolerance, "%s: input %u reaches output %u at %.5f, %.5f expected",
+                pszName, nIn, nOut, vecMatrix[nIndex], vecExpected[nIndex]);
+        }
+    }
+}
+
+// every row scaled down together once one of them could exceed full scale.
+static std::vector<float> Normalize(std::vector<float> vecMatrix, uint32_t nInChannels)
+{
+    float fMaxSum = 0.0f;
+    for (size_t nRow = 0; nRow < vecMatrix.size() / nInChannels; ++nRow)
+    {
+        float fSum = 0.0f;
+        for (uint32_t nIn = 0; nIn < nInChannels; ++nIn)
+            fSum += fabsf(vecMatrix[nRow * nInChannels + nIn]);
+        fMaxSum = MAX(fMaxSum, fSum);
+    }
+    if (fMaxSum > 1.0f)
+    {
+        for (float& fCoeff : vecMatrix)
+            fCoeff /= fMaxSum;
+    }
+    return vecMatrix;
+}
+
+int main()
+{
+    TAudioConfig objStereo;
+    TAudioConfig objMono;
+    objMono.eChannelLayout = TYPE_CYAUDIO_LAYOUT_MONO;
+
+    // 5.1 with back surrounds, FL FR FC LFE BL BR. The center is mixed in at -6 dB, the surrounds at
+    // -3 dB and the LFE is dropped.
+    const float c = g_fTestMinus6, s = g_fTestMinus3;
+    CheckMatrix("5.1 to stereo", 6, 0, objStereo, 2, Normalize({
+        1, 0, c, 0, s, 0,
+        0, 1, c, 0, 0, s }, 6));
+
+    // the device mask places the surrounds, side ones fold the same way.
+    const uint32_t nSideMask = TYPE_SPEAKER_FRONT_LEFT | TYPE_SPEAKER_FRONT_RIGHT | TYPE_SPEAKER_FRONT_CENTER |
+        TYPE_SPEAKER_LOW_FREQUENCY | TYPE_SPEAKER_SIDE_LEFT | TYPE_SPEAKER_SIDE_RIGHT;
+    CheckMatrix("5.1 side to stereo", 6, nSideMask, objStereo, 2, Normalize({
+        1, 0, c, 0, s, 0,
+        0, 1, c, 0, 0, s }, 6));
+
+    // 7.1, FL FR FC LFE BL BR SL SR. Back and side pairs share a front speaker and are averaged.
+    CheckMatrix("7.1 to stereo", 8, 0, objStereo, 2, Normalize({
+        1, 0, c, 0, 0.5f * s, 0, 0.5f * s, 0,
+        0, 1, c, 0, 0, 0.5f * s, 0, 0.5f * s }, 8));
+
+    // mono takes the fronts at -3 dB, the center whole and the surrounds through their front speaker.
+    CheckMatrix("5.1 to mono", 6, 0, objMono, 1, Normalize({ s, s, 1, 0, s * s, s * s }, 6));
+    CheckMatrix("7.1 to mono", 8, 0, objMono, 1, Normalize({ s, s, 1, 0, 0.5f * s * s, 0.5f * s * s, 0.5f * s * s, 0.5f * s * s }, 8));
+
+    // stereo to mono folds both sides into the center.
+    CheckMatrix("stereo to mono", 2, 0, objMono, 1, Normalize({ s, s }, 2));
+
+    // a custom matrix is taken as it is, with the gain on top and no normalization.
+    const float arrCustom[] =
+    {
+        0.5f, 0.25f, 0.0f,
+        0.0f, 0.75f, 1.0f,
+    };
+    TAudioConfig objCustom;
+    objCustom.eChannelLayout = TYPE_CYAUDIO_LAYOUT_CUSTOM;
+    objCustom.nCustomInChannels = 3;
+    objCustom.nCustomOutChannels = 2;
+    objCustom.pCustomMatrix = arrCustom;
+    objCustom.fGain = 0.5f;
+    CheckMatrix("custom 3 to 2", 3, 0, objCustom, 2, {
+        0.25f, 0.125f, 0.0f,
+        0.0f, 0.375f, 0.5f });
+
+    // a custom matrix built for other device channels is dropped, the device audio is delivered as stereo.
+    CheckMatrix("custom on stereo", 2, 0, objCustom, 2, {
+        1, 0,
+        0, 1 });
+
+    return CY_TEST_RESULT();
+}
\ No newline at end of file
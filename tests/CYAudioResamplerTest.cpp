@@ -0,0 +1,146 @@
+#include "CYTestDefine.hpp"
+#include "Audio/Resample/ICYAudioResampler.hpp"
+
+#include <math.h>
+#include <vector>
+
+using namespace CYDEVICE_NAMESPACE;
+
+// two seconds of stereo input in chunks of uneven length, the longest at the Init bound.
+constexpr uint32_t g_nTestChannels = 2;
+constexpr uint32_t g_nTestSeconds = 2;
+constexpr uint32_t g_nTestMaxInFrames = 1024;
+static const uint32_t g_arrTestChunks[] = { 1, 480, 17, 1024, 333, 64, 7, 999, 256, 2 };
+
+struct TRatePair
+{
+    uint32_t nInRate;
+    uint32_t nOutRate;
+};
+
+static const TRatePair g_arrTestPairs[] =
+{
+    { 44100, 48000 },
+    { 48000, 44100 },
+    { 48000, 16000 },
+    { 32000, 48000 },
+    { 48000, 8000 },
+};
+
+static const char* GetTierName(ECYAudioResampleQuality eQuality)
+{
+    switch (eQuality)
+    {
+    case TYPE_CYAUDIO_RESAMPLE_LINEAR:
+        return "linear";
+    case TYPE_CYAUDIO_RESAMPLE_POLYPHASE:
+        return "polyphase";
+    case TYPE_CYAUDIO_RESAMPLE_SINC_MEDIUM:
+        return "sinc medium";
+    default:
+        return "sinc fastest";
+    }
+}
+
+// the rational tiers report the exact frame count of every call, the libsamplerate ones a bound.
+static bool IsRationalTier(ECYAudioResampleQuality eQuality)
+{
+    return eQuality == TYPE_CYAUDIO_RESAMPLE_LINEAR || eQuality == TYPE_CYAUDIO_RESAMPLE_POLYPHASE;
+}
+
+/**
+ * Stream a sine of fToneHz through the tier, returns the RMS of the second half of the output relative
+ * to the input RMS in dB, or 1 dB when the tier did not initialize.
+ */
+static double StreamTone(ECYAudioResampleQuality eQuality, const TRatePair& objPair, float fToneHz)
+{
+    UniquePtr<ICYAudioResampler> ptrResampler = CreateAudioResampler(eQuality, objPair.nInRate, objPair.nOutRate);
+    if (!ptrResampler || !ptrResampler->Init(objPair.nInRate, objPair.nOutRate, g_nTestChannels, g_nTestMaxInFrames))
+    {
+        CY_TEST_CHECK(false, "%s %u to %u: Init failed", GetTierName(eQuality), objPair.nInRate, objPair.nOutRate);
+        return 1.0;
+    }
+
+    const uint32_t nInFrames = objPair.nInRate * g_nTestSeconds;
+    const double dStep = 2.0 * 3.14159265358979323846 * fToneHz / objPair.nInRate;
+    std::vector<float> vecIn(size_t(g_nTestMaxInFrames) * g_nTestChannels);
+    std::vector<float> vecOut;
+    vecOut.reserve(size_t(uint64_t(nInFrames) * objPair.nOutRate / objPair.nInRate + 4096) * g_nTestChannels);
+
+    uint32_t nFramePos = 0;
+    uint32_t nBadCalls = 0;
+    for (size_t nChunk = 0; nFramePos < nInFrames; ++nChunk)
+    {
+        const uint32_t nFrames = MIN(g_arrTestChunks[nChunk % (sizeof(g_arrTestChunks) / sizeof(g_arrTestChunks[0]))], nInFrames - nFramePos);
+        for (uint32_t i = 0; i < nFrames; ++i)
+        {
+            const double dPhase = dStep * (nFramePos + i);
+            vecIn[size_t(i) * g_nTestChannels] = float(0.5 * sin(dPhase));
+            vecIn[size_t(i) * g_nTestChannels + 1] = float(0.5 * cos(dPhase));
+        }
+
+        const uint32_t nExpected = ptrResampler->GetOutFrames(nFrames);
+        const uint32_t nMax = ptrResampler->GetMaxOutFrames(nFrames);
+        const size_t nOutPos = vecOut.size();
+        vecOut.resize(nOutPos + size_t(nMax) * g_nTestChannels);
+        const uint32_t nOut = ptrResampler->Process(vecIn.data(), nFrames, vecOut.data() + nOutPos);
+        vecOut.resize(nOutPos + size_t(nOut) * g_nTestChannels);
+
+        nBadCalls += IsRationalTier(eQuality) ? (nOut != nExpected) : (nOut > nExpected || nOut > nMax);
+        nFramePos += nFrames;
+    }
+
+    // a rational stream writes every output frame whose time falls inside the input, libsamplerate
+    // holds its filter delay back.
+    const uint64_t nOutFrames = vecOut.size() / g_nTestChannels;
+    const uint64_t nIdeal = (uint64_t(nInFrames) * objPair.nOutRate + objPair.nInRate - 1) / objPair.nInRate;
+    CY_TEST_CHECK(!nBadCalls, "%s %u to %u: %u calls wrote another frame count than GetOutFrames reported",
+        GetTierName(eQuality), objPair.nInRate, objPair.nOutRate, nBadCalls);
+    if (IsRationalTier(eQuality))
+    {
+        CY_TEST_CHECK(nOutFrames == nIdeal, "%s %u to %u: %llu frames out, %llu expected",
+            GetTierName(eQuality), objPair.nInRate, objPair.nOutRate, (unsigned long long)nOutFrames, (unsigned long long)nIdeal);
+    }
+    else
+    {
+        CY_TEST_CHECK(nOutFrames <= nIdeal && nOutFrames + objPair.nOutRate / 50 >= nIdeal, "%s %u to %u: %llu frames out, %llu expected",
+            GetTierName(eQuality), objPair.nInRate, objPair.nOutRate, (unsigned long long)nOutFrames, (unsigned long long)nIdeal);
+    }
+
+    double dSum = 0.0;
+    const size_t nFirst = vecOut.size() / 2;
+    for (size_t i = nFirst; i < vecOut.size(); ++i)
+        dSum += double(vecOut[i]) * vecOut[i];
+    const double dRms = sqrt(dSum / MAX(vecOut.size() - nFirst, size_t(1)));
+    return 20.0 * log10(MAX(dRms, 1e-12) / (0.5 / sqrt(2.0)));
+}
+
+int main()
+{
+    for (ECYAudioResampleQuality eQuality : { TYPE_CYAUDIO_RESAMPLE_LINEAR, TYPE_CYAUDIO_RESAMPLE_POLYPHASE, TYPE_CYAUDIO_RESAMPLE_SINC_FASTEST, TYPE_CYAUDIO_RESAMPLE_SINC_MEDIUM })
+    {
+        for (const TRatePair& objPair : g_arrTestPairs)
+        {
+            // a tone well inside both bands passes at its level.
+            const double dPassDb = StreamTone(eQuality, objPair, 1000.0f);
+            CY_TEST_CHECK(fabs(dPassDb) < 0.5, "%s %u to %u: 1 kHz comes out at %.2f dB", GetTierName(eQuality), objPair.nInRate, objPair.nOutRate, dPassDb);
+
+            // a tone half way between the output and the input Nyquist rate must not alias into the output.
+            // The linear tier has no filter and is only held to the frame counts.
+            if (objPair.nOutRate >= objPair.nInRate)
+            {
+                printf("%s %u to %u: 1 kHz %.2f dB\n", GetTierName(eQuality), objPair.nInRate, objPair.nOutRate, dPassDb);
+                continue;
+            }
+            const float fStopHz = 0.25f * float(objPair.nOutRate + objPair.nInRate);
+            const double dStopDb = StreamTone(eQuality, objPair, fStopHz);
+            if (eQuality != TYPE_CYAUDIO_RESAMPLE_LINEAR)
+            {
+                CY_TEST_CHECK(dStopDb < -50.0, "%s %u to %u: a %.0f Hz tone comes out at %.1f dB", GetTierName(eQuality),
+                    objPair.nInRate, objPair.nOutRate, fStopHz, dStopDb);
+            }
+            printf("%s %u to %u: 1 kHz %.2f dB, %.0f Hz %.1f dB\n", GetTierName(eQuality), objPair.nInRate, objPair.nOutRate, dPassDb, fStopHz, dStopDb);
+        }
+    }
+    return CY_TEST_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "CYTestDefine.hpp"
+#include "Audio/CYAudioRingBuffer.hpp"
+
+#include <atomic>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+using namespace CYDEVICE_NAMESPACE;
+
+// 32-bit counting words streamed through the ring by the two thread run.
+constexpr uint32_t g_nStressWords = 1 << 22;
+
+// nBytes bytes counting up from nFirst, a mismatch after the ring shows where the order broke.
+static std::vector<uint8_t> MakeCounting(uint8_t nFirst, size_t nBytes)
+{
+    std::vector<uint8_t> vecData(nBytes);
+    for (size_t i = 0; i < nBytes; ++i)
+        vecData[i] = uint8_t(nFirst + i);
+    return vecData;
+}
+
+// the bytes a view points at, both spans in order.
+static std::vector<uint8_t> GetViewBytes(const TRingView& objView)
+{
+    std::vector<uint8_t> vecData(objView.pFirst, objView.pFirst + objView.nFirstBytes);
+    if (objView.nSecondBytes)
+        vecData.insert(vecData.end(), objView.pSecond, objView.pSecond + objView.nSecondBytes);
+    return vecData;
+}
+
+static void CheckMirror()
+{
+    // 48 bytes in and out put the read position 16 bytes before the wrap point.
+    CYAudioRingBuffer objRing;
+    CY_TEST_CHECK(objRing.Init(64, 4, 32), "Init failed");
+    const std::vector<uint8_t> vecFill = MakeCounting(0, 48);
+    CY_TEST_CHECK(objRing.Write(vecFill.data(), vecFill.size()) == 48, "the fill was not stored");
+    objRing.Consume(48);
+
+    const std::vector<uint8_t> vecData = MakeCounting(100, 32);
+    CY_TEST_CHECK(objRing.Write(vecData.data(), vecData.size()) == 32, "the wrapping write was not stored");
+    CY_TEST_CHECK(objRing.GetReadable() == 32, "%zu bytes readable after the wrap", objRing.GetReadable());
+
+    // a read inside the mirror is one contiguous span over the wrap point.
+    TRingView objView;
+    CY_TEST_CHECK(objRing.Peek(32, objView), "Peek over the wrap point failed");
+    CY_TEST_CHECK(objView.nFirstBytes == 32 && !objView.pSecond && !objView.nSecondBytes,
+        "the mirrored read is split %zu + %zu", objView.nFirstBytes, objView.nSecondBytes);
+    CY_TEST_CHECK(GetViewBytes(objView) == vecData, "the mirrored read differs from the written bytes");
+
+    // the mirror keeps up with later writes to the head of the ring.
+    objRing.Consume(16);
+    const std::vector<uint8_t> vecMore = MakeCounting(200, 16);
+    CY_TEST_CHECK(objRing.Write(vecMore.data(), vecMore.size()) == 16, "the write behind the wrap was not stored");
+    CY_TEST_CHECK(objRing.Peek(32, objView) && objView.nFirstBytes == 32, "the second mirrored read is not contiguous");
+    std::vector<uint8_t> vecExpected(vecData.begin() + 16, vecData.end());
+    vecExpected.insert(vecExpected.end(), vecMore.begin(), vecMore.end());
+    CY_TEST_CHECK(GetViewBytes(objView) == vecExpected, "the second mirrored read differs from the written bytes");
+}
+
+static void CheckSplitPeek()
+{
+    // an 8 byte mirror is too short for the same read, which comes back as two spans.
+    CYAudioRingBuffer objRing;
+    CY_TEST_CHECK(objRing.Init(64, 4, 8), "Init failed");
+    const std::vector<uint8_t> vecFill = MakeCounting(0, 48);
+    objRing.Write(vecFill.data(), vecFill.size());
+    objRing.Consume(48);
+
+    const std::vector<uint8_t> vecData = MakeCounting(50, 32);
+    objRing.Write(vecData.data(), vecData.size());
+
+    TRingView objView;
+    CY_TEST_CHECK(objRing.Peek(32, objView), "Peek across the wrap point failed");
+    CY_TEST_CHECK(objView.nFirstBytes == 16 && objView.nSecondBytes == 16, "the read is split %zu + %zu", objView.nFirstBytes, objView.nSecondBytes);
+    CY_TEST_CHECK(GetViewBytes(objView) == vecData, "the split read differs from the written bytes");
+
+    // Read copies both spans and consumes them.
+    std::vector<uint8_t> vecRead(32);
+    CY_TEST_CHECK(objRing.Read(vecRead.data(), vecRead.size()) == 32 && vecRead == vecData, "Read across the wrap point differs");
+    CY_TEST_CHECK(objRing.GetReadable() == 0, "%zu bytes left after the read", objRing.GetReadable());
+}
+
+static void CheckOverrun()
+{
+    CYAudioRingBuffer objRing;
+    CY_TEST_CHECK(objRing.Init(64, 4, 0), "Init failed");
+    const std::vector<uint8_t> vecData = MakeCounting(0, 70);
+
+    CY_TEST_CHECK(objRing.Write(vecData.data(), 60) == 60, "the first write was not stored");
+    CY_TEST_CHECK(objRing.GetOverrunCount() == 0, "a write that fit counted an overrun");
+
+    // 4 bytes are free, the rest of the write is dropped in whole blocks.
+    CY_TEST_CHECK(objRing.Write(vecData.data() + 60, 10) == 4, "the partial write stored the wrong byte count");
+    CY_TEST_CHECK(objRing.GetOverrunCount() == 1 && objRing.GetOverrunBytes() == 6,
+        "overrun %llu times %llu bytes after the partial write", (unsigned long long)objRing.GetOverrunCount(), (unsigned long long)objRing.GetOverrunBytes());
+
+    CY_TEST_CHECK(objRing.Write(vecData.data(), 8) == 0, "a write into the full ring stored bytes");
+    CY_TEST_CHECK(objRing.GetOverrunCount() == 2 && objRing.GetOverrunBytes() == 14,
+        "overrun %llu times %llu bytes after the full write", (unsigned long long)objRing.GetOverrunCount(), (unsigned long long)objRing.GetOverrunBytes());
+
+    // what was stored is the head of the writes in order, the dropped bytes left no gap.
+    std::vector<uint8_t> vecRead(64);
+    CY_TEST_CHECK(objRing.Read(vecRead.data(), vecRead.size()) == 64, "the ring did not hold the stored bytes");
+    CY_TEST_CHECK(!memcmp(vecRead.data(), vecData.data(), 64), "the stored bytes differ from the written ones");
+}
+
+static void CheckFlush()
+{
+    CYAudioRingBuffer objRing;
+    CY_TEST_CHECK(objRing.Init(64, 4, 16), "Init failed");
+    const std::vector<uint8_t> vecOld = MakeCounting(0, 32);
+    objRing.Write(vecOld.data(), vecOld.size());
+
+    // the producer sees the flush at once, the read position only moves on the consumer side.
+    objRing.Flush();
+    CY_TEST_CHECK(objRing.GetReadableForProducer() == 0, "the producer sees %zu bytes after the flush", objRing.GetReadableForProducer());
+    CY_TEST_CHECK(objRing.GetReadPos() == 0, "the flush moved the read position before the consumer applied it");
+
+    const std::vector<uint8_t> vecNew = MakeCounting(128, 16);
+    objRing.Write(vecNew.data(), vecNew.size());
+    CY_TEST_CHECK(objRing.GetReadableForProducer() == 16, "the producer sees %zu bytes written after the flush", objRing.GetReadableForProducer());
+
+    CY_TEST_CHECK(objRing.GetReadable() == 16, "the consumer sees %zu bytes after the flush", objRing.GetReadable());
+    CY_TEST_CHECK(objRing.GetReadPos() == 32, "the applied flush left the read position at %llu", (unsigned long long)objRing.GetReadPos());
+
+    TRingView objView;
+    CY_TEST_CHECK(objRing.Peek(16, objView) && GetViewBytes(objView) == vecNew, "the bytes after the flush differ from the written ones");
+
+    // a poll for more than is there is not an underrun, only the caller knows a period was due.
+    CY_TEST_CHECK(!objRing.Peek(32, objView) && !objView.pFirst, "Peek returned more bytes than written");
+    CY_TEST_CHECK(objRing.GetUnderrunCount() == 0, "a failed Peek counted an underrun");
+    objRing.CountUnderrun();
+    CY_TEST_CHECK(objRing.GetUnderrunCount() == 1, "CountUnderrun was not counted");
+}
+
+static void CheckProducerConsumer()
+{
+    // odd chunk sizes on both sides, so every offset in the ring and both read paths are crossed.
+    CYAudioRingBuffer objRing;
+    CY_TEST_CHECK(objRing.Init(4096, 4, 512), "Init failed");
+
+    std::thread producerThread([&objRing]()
+    {
+        uint32_t arrChunk[340];
+        uint32_t nNext = 0;
+        uint32_t nChunkWords = 1;
+        while (nNext < g_nStressWords)
+        {
+            const size_t nFreeWords = (objRing.GetCapacity() - objRing.GetReadableForProducer()) / sizeof(uint32_t);
+            uint32_t nWords = (nChunkWords < nFreeWords) ? nChunkWords : uint32_t(nFreeWords);
+            if (nWords > g_nStressWords - nNext)
+                nWords = g_nStressWords - nNext;
+            if (!nWords)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            for (uint32_t i = 0; i < nWords; ++i)
+                arrChunk[i] = nNext + i;
+            nNext += uint32_t(objRing.Write(arrChunk, nWords * sizeof(uint32_t)) / sizeof(uint32_t));
+            nChunkWords = nChunkWords % 333 + 7;
+        }
+    });
+
+    uint32_t nExpected = 0;
+    uint32_t nMismatches = 0;
+    uint32_t nChunkWords = 5;
+    uint32_t arrRead[200];
+    while (nExpected < g_nStressWords)
+    {
+        TRingView objView;
+        const size_t nBytes = size_t(nChunkWords) * sizeof(uint32_t);
+        if ((nChunkWords & 1) && objRing.Peek(nBytes, objView))
+        {
+            const std::vector<uint8_t> vecData = GetViewBytes(objView);
+            for (size_t i = 0; i < nChunkWords; ++i, ++nExpected)
+            {
+                uint32_t nWord = 0;
+                memcpy(&nWord, vecData.data() + i * sizeof(uint32_t), sizeof(nWord));
+                nMismatches += (nWord != nExpected);
+            }
+            objRing.Consume(nBytes);
+        }
+        else
+        {
+            const size_t nRead = objRing.Read(arrRead, nBytes) / sizeof(uint32_t);
+            for (size_t i = 0; i < nRead; ++i, ++nExpected)
+                nMismatches += (arrRead[i] != nExpected);
+            if (!nRead)
+                std::this_thread::yield();
+        }
+        nChunkWords = nChunkWords % 200 + 1;
+    }
+    producerThread.join();
+
+    CY_TEST_CHECK(!nMismatches, "%u words out of order in %u", nMismatches, g_nStressWords);
+    CY_TEST_CHECK(objRing.GetOverrunCount() == 0, "the producer overran the ring %llu times", (unsigned long long)objRing.GetOverrunCount());
+    CY_TEST_CHECK(objRing.GetReadPos() == uint64_t(g_nStressWords) * sizeof(uint32_t), "the read position ended at %llu", (unsigned long long)objRing.GetReadPos());
+}
+
+int main()
+{
+    CheckMirror();
+    CheckSplitPeek();
+    CheckOverrun();
+    CheckFlush();
+    CheckProducerConsumer();
+    return CY_TEST_RESULT();
+}
\ No newline at end of file
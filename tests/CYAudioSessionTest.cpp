@@ -0,0 +1,112 @@
+#include "CYTestDefine.hpp"
+#include "Control/CYDeviceControl.hpp"
+#include "Capture/Synthetic/SyntheticAudioCaptrue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <math.h>
+#include <thread>
+#include <vector>
+
+using namespace CYDEVICE_NAMESPACE;
+
+// the session runs this long at a rate the synthetic 48 kHz source is resampled to.
+constexpr uint32_t g_nSessionRunMs = 500;
+constexpr int g_nSessionRate = 16000;
+
+namespace
+{
+    class CSessionConsumer : public ICYAudioDataCallBack
+    {
+    public:
+        void OnAudioPeriod(const TAudioPeriod& objPeriod) override
+        {
+            m_nBadFormats += (objPeriod.nSampleRate != uint32_t(g_nSessionRate) || objPeriod.nChannels != 2 || objPeriod.eSampleFormat != TYPE_CYAUDIO_SAMPLE_F32);
+            m_nBadPositions += (objPeriod.nFramePos != m_nFrames.load(std::memory_order_relaxed));
+
+            // the tone is generated at -20 dBFS.
+            const float* pData = static_cast<const float*>(objPeriod.pData);
+            for (size_t i = 0; i < size_t(objPeriod.nFrames) * objPeriod.nChannels; ++i)
+                m_fPeak = MAX(m_fPeak, fabsf(pData[i]));
+            m_nFrames.fetch_add(objPeriod.nFrames, std::memory_order_relaxed);
+        }
+
+    public:
+        std::atomic<uint64_t> m_nFrames{ 0 };
+        uint32_t m_nBadFormats = 0;
+        uint32_t m_nBadPositions = 0;
+        float m_fPeak = 0.0f;
+    };
+}
+
+static void CheckStartBeforeInit()
+{
+    CSyntheticAudioCaptrue objSource;
+    CSessionConsumer objConsumer;
+    CY_TEST_CHECK(objSource.Start(&objConsumer, nullptr) == CYERR_FAILED, "Start before InitAudio did not fail");
+
+    // without a capture object every call fails the same way.
+    CYDeviceControl objControl;
+    CY_TEST_CHECK(objControl.StartCapture(&objConsumer, nullptr) == CYERR_FAILED, "StartCapture before InitAudio did not fail");
+}
+
+static void CheckCallbackSession()
+{
+    CYDeviceControl objControl;
+    CSessionConsumer objConsumer;
+
+    // the capture objects report a successful InitAudio as true, like the device does.
+    CY_TEST_CHECK(objControl.InitAudio(TYPE_CYAUDIO_SOURCE_SYNTHETIC, g_nSessionRate, nullptr, nullptr, nullptr), "InitAudio failed");
+    CY_TEST_CHECK(objControl.StartCapture(&objConsumer, nullptr) == CYERR_SUCESS, "StartCapture failed");
+    CY_TEST_CHECK(objControl.StartCapture(&objConsumer, nullptr) == CYERR_REPEAT_START_CAPTURE, "a second StartCapture was not refused");
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(g_nSessionRunMs));
+    CY_TEST_CHECK(objControl.StopCapture() == CYERR_SUCESS, "StopCapture failed");
+    const uint64_t nFrames = objConsumer.m_nFrames.load(std::memory_order_relaxed);
+
+    // nothing is delivered after Stop.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CY_TEST_CHECK(objConsumer.m_nFrames.load(std::memory_order_relaxed) == nFrames, "periods were delivered after StopCapture");
+    objControl.UnInit();
+
+    const uint64_t nExpected = uint64_t(g_nSessionRate) * g_nSessionRunMs / 1000;
+    CY_TEST_CHECK(nFrames >= nExpected * 3 / 4 && nFrames <= nExpected * 5 / 4, "callback: %llu frames delivered in %u ms, %llu expected",
+        (unsigned long long)nFrames, g_nSessionRunMs, (unsigned long long)nExpected);
+    CY_TEST_CHECK(!objConsumer.m_nBadFormats, "callback: %u periods in another format", objConsumer.m_nBadFormats);
+    CY_TEST_CHECK(!objConsumer.m_nBadPositions, "callback: %u periods do not follow on", objConsumer.m_nBadPositions);
+    CY_TEST_CHECK(fabsf(objConsumer.m_fPeak - 0.1f) < 0.01f, "callback: the tone peaks at %.4f", objConsumer.m_fPeak);
+    printf("callback: %llu frames in %u ms, peak %.4f\n", (unsigned long long)nFrames, g_nSessionRunMs, objConsumer.m_fPeak);
+}
+
+static void CheckReadSession()
+{
+    CYDeviceControl objControl;
+    TAudioConfig objConfig;
+    objConfig.eSampleFormat = TYPE_CYAUDIO_SAMPLE_S16;
+    CY_TEST_CHECK(objControl.InitAudio(TYPE_CYAUDIO_SOURCE_SYNTHETIC, g_nSessionRate, nullptr, nullptr, &objConfig), "read: InitAudio failed");
+    CY_TEST_CHECK(objControl.StartCapture(nullptr, nullptr) == CYERR_SUCESS, "read: StartCapture failed");
+
+    // a blocking read of 100 ms of audio returns it once the source has produced it.
+    const uint32_t nFrames = uint32_t(g_nSessionRate / 10);
+    std::vector<int16_t> vecBuffer(size_t(nFrames) * 2);
+    uint32_t nReadFrames = 0;
+    uint64_t nTimeStamp = 0;
+    CY_TEST_CHECK(objControl.ReadAudio(vecBuffer.data(), nFrames, 1000, nReadFrames, nTimeStamp) == CYERR_SUCESS, "read: ReadAudio failed");
+    CY_TEST_CHECK(nReadFrames == nFrames, "read: %u frames read of %u", nReadFrames, nFrames);
+
+    int32_t nPeak = 0;
+    for (int16_t nSample : vecBuffer)
+        nPeak = MAX(nPeak, abs(int32_t(nSample)));
+    CY_TEST_CHECK(nPeak > 2900 && nPeak < 3700, "read: the tone peaks at %d", nPeak);
+
+    objControl.StopCapture();
+    objControl.UnInit();
+}
+
+int main()
+{
+    CheckStartBeforeInit();
+    CheckCallbackSession();
+    CheckReadSession();
+    return CY_TEST_RESULT();
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#ifndef __CY_TEST_DEFINE_HPP__
+#define __CY_TEST_DEFINE_HPP__
+
+#include "Common/CYDevicePrivDefine.hpp"
+
+#include <stdio.h>
+
+/**
+ * Checks of the test executables, a failed check is printed and counted, main returns the count.
+ */
+inline int& GetTestFailures()
+{
+    static int s_nFailures = 0;
+    return s_nFailures;
+}
+
+#define CY_TEST_CHECK(expr, ...)                                                    \
+    do                                                                              \
+    {                                                                               \
+        if (!(expr))                                                                \
+        {                                                                           \
+            ++GetTestFailures();                                                    \
+            printf("%s:%d: check failed: %s: ", __FILE__, __LINE__, #expr);         \
+            printf(__VA_ARGS__);                                                    \
+            printf("\n");                                                           \
+        }                                                                           \
+    } while (0)
+
+#define CY_TEST_RESULT()            (GetTestFailures() ? (printf("%d checks failed\n", GetTestFailures()), 1) : (printf("passed\n"), 0))
+
+#endif // __CY_TEST_DEFINE_HPP__
\ No newline at end of file